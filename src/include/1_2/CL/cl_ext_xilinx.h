@@ -334,6 +334,122 @@ typedef cl_uint cl_program_target_type;
 #define CL_PROGRAM_TARGET_TYPE_SW_EMU   0x2
 #define CL_PROGRAM_TARGET_TYPE_HW_EMU   0x4
 
+/**
+ * cl_khr_command_buffer (provisional)
+ *
+ * Record a sequence of kernel commands once and replay it any number
+ * of times.  XRT supports recording of NDRange kernel commands and
+ * barriers.  A finalized command buffer is executed as one chained
+ * submission of prebuilt kernel commands.
+ *
+ * Definitions are provided here for OpenCL headers that predate the
+ * extension.  Entry points must be retrieved with
+ * clGetExtensionFunctionAddressForPlatform.
+ */
+#ifndef cl_khr_command_buffer
+#define cl_khr_command_buffer 1
+#define CL_KHR_COMMAND_BUFFER_EXTENSION_NAME "cl_khr_command_buffer"
+
+typedef cl_bitfield                     cl_device_command_buffer_capabilities_khr;
+typedef struct _cl_command_buffer_khr*  cl_command_buffer_khr;
+typedef cl_uint                         cl_sync_point_khr;
+typedef cl_uint                         cl_command_buffer_info_khr;
+typedef cl_uint                         cl_command_buffer_state_khr;
+typedef cl_ulong                        cl_command_buffer_properties_khr;
+typedef cl_bitfield                     cl_command_buffer_flags_khr;
+typedef cl_ulong                        cl_ndrange_kernel_command_properties_khr;
+typedef struct _cl_mutable_command_khr* cl_mutable_command_khr;
+
+/* cl_device_info */
+#define CL_DEVICE_COMMAND_BUFFER_CAPABILITIES_KHR              0x12A9
+#define CL_DEVICE_COMMAND_BUFFER_REQUIRED_QUEUE_PROPERTIES_KHR 0x12AA
+
+/* cl_device_command_buffer_capabilities_khr - bitfield */
+#define CL_COMMAND_BUFFER_CAPABILITY_KERNEL_PRINTF_KHR         (1 << 0)
+#define CL_COMMAND_BUFFER_CAPABILITY_DEVICE_SIDE_ENQUEUE_KHR   (1 << 1)
+#define CL_COMMAND_BUFFER_CAPABILITY_SIMULTANEOUS_USE_KHR      (1 << 2)
+#define CL_COMMAND_BUFFER_CAPABILITY_OUT_OF_ORDER_KHR          (1 << 3)
+
+/* cl_command_buffer_properties_khr */
+#define CL_COMMAND_BUFFER_FLAGS_KHR                            0x1293
+
+/* cl_command_buffer_flags_khr */
+#define CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR                 (1 << 0)
+
+/* Error codes */
+#define CL_INVALID_COMMAND_BUFFER_KHR                          -1138
+#define CL_INVALID_SYNC_POINT_WAIT_LIST_KHR                    -1139
+#define CL_INCOMPATIBLE_COMMAND_QUEUE_KHR                      -1140
+
+/* cl_command_buffer_info_khr */
+#define CL_COMMAND_BUFFER_QUEUES_KHR                           0x1294
+#define CL_COMMAND_BUFFER_NUM_QUEUES_KHR                       0x1295
+#define CL_COMMAND_BUFFER_REFERENCE_COUNT_KHR                  0x1296
+#define CL_COMMAND_BUFFER_STATE_KHR                            0x1297
+#define CL_COMMAND_BUFFER_PROPERTIES_ARRAY_KHR                 0x1298
+#define CL_COMMAND_BUFFER_CONTEXT_KHR                          0x1299
+
+/* cl_command_buffer_state_khr */
+#define CL_COMMAND_BUFFER_STATE_RECORDING_KHR                  0
+#define CL_COMMAND_BUFFER_STATE_EXECUTABLE_KHR                 1
+#define CL_COMMAND_BUFFER_STATE_PENDING_KHR                    2
+
+/* cl_command_type */
+#define CL_COMMAND_COMMAND_BUFFER_KHR                          0x12A8
+
+extern CL_API_ENTRY cl_command_buffer_khr CL_API_CALL
+clCreateCommandBufferKHR(cl_uint num_queues,
+                         const cl_command_queue* queues,
+                         const cl_command_buffer_properties_khr* properties,
+                         cl_int* errcode_ret);
+
+extern CL_API_ENTRY cl_int CL_API_CALL
+clFinalizeCommandBufferKHR(cl_command_buffer_khr command_buffer);
+
+extern CL_API_ENTRY cl_int CL_API_CALL
+clRetainCommandBufferKHR(cl_command_buffer_khr command_buffer);
+
+extern CL_API_ENTRY cl_int CL_API_CALL
+clReleaseCommandBufferKHR(cl_command_buffer_khr command_buffer);
+
+extern CL_API_ENTRY cl_int CL_API_CALL
+clEnqueueCommandBufferKHR(cl_uint num_queues,
+                          cl_command_queue* queues,
+                          cl_command_buffer_khr command_buffer,
+                          cl_uint num_events_in_wait_list,
+                          const cl_event* event_wait_list,
+                          cl_event* event);
+
+extern CL_API_ENTRY cl_int CL_API_CALL
+clCommandBarrierWithWaitListKHR(cl_command_buffer_khr command_buffer,
+                                cl_command_queue command_queue,
+                                cl_uint num_sync_points_in_wait_list,
+                                const cl_sync_point_khr* sync_point_wait_list,
+                                cl_sync_point_khr* sync_point,
+                                cl_mutable_command_khr* mutable_handle);
+
+extern CL_API_ENTRY cl_int CL_API_CALL
+clCommandNDRangeKernelKHR(cl_command_buffer_khr command_buffer,
+                          cl_command_queue command_queue,
+                          const cl_ndrange_kernel_command_properties_khr* properties,
+                          cl_kernel kernel,
+                          cl_uint work_dim,
+                          const size_t* global_work_offset,
+                          const size_t* global_work_size,
+                          const size_t* local_work_size,
+                          cl_uint num_sync_points_in_wait_list,
+                          const cl_sync_point_khr* sync_point_wait_list,
+                          cl_sync_point_khr* sync_point,
+                          cl_mutable_command_khr* mutable_handle);
+
+extern CL_API_ENTRY cl_int CL_API_CALL
+clGetCommandBufferInfoKHR(cl_command_buffer_khr command_buffer,
+                          cl_command_buffer_info_khr param_name,
+                          size_t param_value_size,
+                          void* param_value,
+                          size_t* param_value_size_ret);
+#endif // cl_khr_command_buffer
+
 ////////////////////////////////////////////////////////////////
 // DEPRECATED UNUSABLE STREAMING APIs
 // Decl is required for internal test code (xcl2.hpp)
@@ -4,6 +4,7 @@
  * Pybind11 module for XRT C++ APIs
  *
  * Copyright (C) 2019-2022 Xilinx, Inc
+ * Copyright (C) 2024 Advanced Micro Devices, Inc
  *
  * Authors: graham.schelle@xilinx.com
  *          sonal.santan@xilinx.com
@@ -14,7 +15,9 @@
 #include "xrt/xrt_kernel.h"
 #include "xrt/xrt_bo.h"
 #include "xrt/xrt_graph.h"
+#include "xrt/experimental/xrt_kernel.h"
 #include "xrt/experimental/xrt_message.h"
+#include "xrt/experimental/xrt_queue.h"
 #include "xrt/experimental/xrt_system.h"
 #include "xrt/experimental/xrt_xclbin.h"
 
@@ -25,12 +28,110 @@
 #include <pybind11/stl_bind.h>
 
 // C++11 includes
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <string>
 
 namespace py = pybind11;
 
+namespace {
+
+// Minimal DLPack ABI (dlpack.h v0.8) used to export mapped buffer
+// objects to frameworks such as NumPy and PyTorch without copying.
+// Only the subset needed for a 1-D host accessible uint8 tensor.
+struct DLDevice { int32_t device_type; int32_t device_id; };
+struct DLDataType { uint8_t code; uint8_t bits; uint16_t lanes; };
+struct DLTensor
+{
+    void* data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t* shape;
+    int64_t* strides;
+    uint64_t byte_offset;
+};
+struct DLManagedTensor
+{
+    DLTensor dl_tensor;
+    void* manager_ctx;
+    void (*deleter)(DLManagedTensor*);
+};
+
+constexpr int32_t dl_device_cpu = 1;  // kDLCPU
+constexpr uint8_t dl_dtype_uint = 1;  // kDLUInt
+
+// Context owned by an exported DLManagedTensor.  Holding a copy of
+// the xrt::bo keeps the mapped memory alive until the consumer
+// releases the tensor.
+struct dlpack_context
+{
+    xrt::bo bo;
+    int64_t shape;
+    DLManagedTensor tensor;
+};
+
+py::capsule
+to_dlpack(const xrt::bo& bo)
+{
+    auto ctx = std::make_unique<dlpack_context>();
+    ctx->bo = bo;
+    ctx->shape = static_cast<int64_t>(bo.size());
+    auto& t = ctx->tensor;
+    t.dl_tensor.data = ctx->bo.map();
+    t.dl_tensor.device = {dl_device_cpu, 0};
+    t.dl_tensor.ndim = 1;
+    t.dl_tensor.dtype = {dl_dtype_uint, 8, 1};
+    t.dl_tensor.shape = &ctx->shape;
+    t.dl_tensor.strides = nullptr;
+    t.dl_tensor.byte_offset = 0;
+    t.manager_ctx = ctx.get();
+    t.deleter = [](DLManagedTensor* self) {
+        delete static_cast<dlpack_context*>(self->manager_ctx);
+    };
+
+    // A consumer renames the capsule to "used_dltensor" and takes
+    // over ownership, otherwise the capsule destructor releases it.
+    auto capsule = py::capsule(&ctx->tensor, "dltensor", [](PyObject* obj) {
+        if (!PyCapsule_IsValid(obj, "dltensor"))
+            return;
+        auto t = static_cast<DLManagedTensor*>(PyCapsule_GetPointer(obj, "dltensor"));
+        t->deleter(t);
+    });
+    ctx.release();
+    return capsule;
+}
+
+// Python callable enqueued on an xrt::queue.  The callable is executed
+// by the queue worker thread, which must hold the GIL while calling
+// into Python and also when releasing the reference.
+std::shared_ptr<py::object>
+make_queue_callable(py::function fn)
+{
+    return std::shared_ptr<py::object>(new py::object(std::move(fn)), [](py::object* obj) {
+        py::gil_scoped_acquire acquire;
+        delete obj;
+    });
+}
+
+// Holder deleter of xrt::queue.  Destroying the queue joins the
+// worker threads, which may be waiting for the GIL to run an enqueued
+// Python callable, so the GIL is released while destroying.
+struct queue_deleter
+{
+    void
+    operator()(xrt::queue* q) const
+    {
+        py::gil_scoped_release release;
+        delete q;
+    }
+};
+
+} // namespace
+
 PYBIND11_MAKE_OPAQUE(std::vector<xrt::xclbin::ip>);
 
 PYBIND11_MODULE(pyxrt, m) {
@@ -130,10 +231,10 @@ PYBIND11_MODULE(pyxrt, m) {
                       }))
         .def("load_xclbin", [](xrt::device& d, const std::string& xclbin) {
                                 return d.load_xclbin(xclbin);
-                            }, "Load an xclbin given the path to the device")
+                            }, py::call_guard<py::gil_scoped_release>(), "Load an xclbin given the path to the device")
         .def("load_xclbin", [](xrt::device& d, const xrt::xclbin& xclbin) {
                                 return d.load_xclbin(xclbin);
-                            }, "Load the xclbin to the device")
+                            }, py::call_guard<py::gil_scoped_release>(), "Load the xclbin to the device")
         .def("register_xclbin", [](xrt::device& d, const xrt::xclbin& xclbin) {
                                 return d.register_xclbin(xclbin);
                             }, "Register an xclbin with the device")
@@ -191,7 +292,7 @@ PYBIND11_MODULE(pyxrt, m) {
         .def(py::init<const xrt::kernel &>())
         .def("start", [](xrt::run& r){
                           r.start();
-                      }, "Start one execution of a run")
+                      }, py::call_guard<py::gil_scoped_release>(), "Start one execution of a run")
         .def("set_arg", [](xrt::run& r, int i, xrt::bo& item){
                             r.set_arg(i, item);
                         }, "Set a specific kernel global argument for a run")
@@ -200,13 +301,76 @@ PYBIND11_MODULE(pyxrt, m) {
                         }, "Set a specific kernel scalar argument for this run")
         .def("wait", ([](xrt::run& r)  {
                            return r.wait(0);
-                      }), "Wait for the run to complete")
+                      }), py::call_guard<py::gil_scoped_release>(), "Wait for the run to complete")
         .def("wait", ([](xrt::run& r, unsigned int timeout_ms)  {
                           return r.wait(timeout_ms);
-                      }), "Wait for the specified milliseconds for the run to complete")
+                      }), py::call_guard<py::gil_scoped_release>(), "Wait for the specified milliseconds for the run to complete")
         .def("state", &xrt::run::state, "Check the current state of a run object")
         .def("add_callback", &xrt::run::add_callback, "Add a callback function for run state");
 
+/*
+ *
+ * xrt::runlist
+ *
+ */
+    py::class_<xrt::runlist>(m, "runlist", "A list of runs to execute as one submission")
+        .def(py::init<>())
+        .def(py::init<const xrt::hw_context&>())
+        .def("add", &xrt::runlist::add, "Add a run to the runlist")
+        .def("execute", &xrt::runlist::execute, py::call_guard<py::gil_scoped_release>(),
+             "Execute all runs in the runlist")
+        .def("wait", [](const xrt::runlist& rl) {
+                         rl.wait();
+                     }, py::call_guard<py::gil_scoped_release>(), "Wait for all runs in the runlist to complete")
+        .def("wait", [](const xrt::runlist& rl, unsigned int timeout_ms) {
+                         return rl.wait(std::chrono::milliseconds(timeout_ms)) == std::cv_status::no_timeout;
+                     }, py::call_guard<py::gil_scoped_release>(),
+             "Wait for the specified milliseconds for the runlist to complete, returns False on timeout")
+        .def("reset", &xrt::runlist::reset, "Reset the runlist for reuse");
+
+/*
+ *
+ * xrt::queue
+ *
+ */
+    py::class_<xrt::queue, std::unique_ptr<xrt::queue, queue_deleter>> pyqueue(m, "queue", "Producer / consumer queue executing tasks in order of enqueuing");
+
+    py::class_<xrt::queue::event>(pyqueue, "event", "Event of an enqueued task")
+        .def("wait", &xrt::queue::event::wait, py::call_guard<py::gil_scoped_release>(),
+             "Wait for the enqueued task to complete");
+
+    pyqueue.def(py::init<>())
+        .def("enqueue", [](xrt::queue& q, py::function fn) {
+                            auto callable = make_queue_callable(std::move(fn));
+                            return xrt::queue::event{q.enqueue([callable] {
+                                py::gil_scoped_acquire acquire;
+                                try {
+                                    (*callable)();
+                                }
+                                catch (py::error_already_set& ex) {
+                                    // Python exceptions cannot cross the queue
+                                    // worker thread, report them as unraisable
+                                    ex.discard_as_unraisable(__func__);
+                                }
+                            })};
+                        }, "Enqueue a Python callable")
+        .def("enqueue", [](xrt::queue& q, const xrt::queue::event& ev) {
+                            return xrt::queue::event{q.enqueue(ev)};
+                        }, "Enqueue an event of another queue, subsequent tasks wait for the event")
+        .def("enqueue", [](xrt::queue& q, xrt::run& r) {
+                            return xrt::queue::event{q.enqueue([r] {
+                                auto run = r;
+                                run.start();
+                                run.wait();
+                            })};
+                        }, "Enqueue execution of a run")
+        .def("enqueue", [](xrt::queue& q, xrt::bo& b, xclBOSyncDirection dir, size_t size, size_t offset) {
+                            return xrt::queue::event{q.enqueue([b, dir, size, offset] {
+                                auto bo = b;
+                                bo.sync(dir, size, offset);
+                            })};
+                        }, "Enqueue synchronization of a buffer object");
+
     py::class_<xrt::kernel> pyker(m, "kernel", "Represents a set of instances matching a specified name");
 
     py::enum_<xrt::kernel::cu_access_mode>(pyker, "cu_access_mode", "Compute unit access mode")
@@ -255,7 +419,11 @@ PYBIND11_MODULE(pyxrt, m) {
  * xrt::bo
  *
  */
-    py::class_<xrt::bo> pybo(m, "bo", "Represents a buffer object");
+    py::class_<xrt::bo> pybo(m, "bo", py::buffer_protocol(), "Represents a buffer object");
+
+    py::class_<xrt::bo::async_handle>(pybo, "async_handle", "Handle of an asynchronous buffer object operation")
+        .def("wait", &xrt::bo::async_handle::wait, py::call_guard<py::gil_scoped_release>(),
+             "Wait for the asynchronous operation to complete");
 
     py::enum_<xrt::bo::flags>(pybo, "flags", "Buffer object creation flags")
         .value("normal", xrt::bo::flags::normal)
@@ -270,23 +438,53 @@ PYBIND11_MODULE(pyxrt, m) {
         .def(py::init<xrt::bo, size_t, size_t>(), "Create a sub-buffer of an existing buffer object of specifed size and offset in the existing buffer")
         .def("write", ([](xrt::bo &b, py::buffer pyb, size_t seek)  {
                            py::buffer_info info = pyb.request();
+                           py::gil_scoped_release release;
                            b.write(info.ptr, info.itemsize * info.size , seek);
                        }), "Write the provided data into the buffer object starting at specified offset")
         .def("read", ([](xrt::bo &b, size_t size, size_t skip) {
                           py::array_t<char> result = py::array_t<char>(size);
                           py::buffer_info bufinfo = result.request();
-                          b.read(bufinfo.ptr, size, skip);
+                          {
+                              py::gil_scoped_release release;
+                              b.read(bufinfo.ptr, size, skip);
+                          }
                           return result;
                       }), "Read from the buffer object requested number of bytes starting from specified offset")
+        .def("read_into", ([](xrt::bo &b, py::buffer pyb, size_t skip) {
+                               py::buffer_info info = pyb.request(true);
+                               py::gil_scoped_release release;
+                               b.read(info.ptr, info.itemsize * info.size, skip);
+                           }), "Read from the buffer object into the provided writable buffer starting from specified offset")
         .def("sync", ([](xrt::bo &b, xclBOSyncDirection dir, size_t size, size_t offset)  {
                           b.sync(dir, size, offset);
-                      }), "Synchronize (DMA or cache flush/invalidation) the buffer in the requested direction")
+                      }), py::call_guard<py::gil_scoped_release>(),
+             "Synchronize (DMA or cache flush/invalidation) the buffer in the requested direction")
         .def("sync", ([](xrt::bo& b, xclBOSyncDirection dir) {
                           b.sync(dir);
-                      }), "Sync entire buffer content in specified direction.")
+                      }), py::call_guard<py::gil_scoped_release>(), "Sync entire buffer content in specified direction.")
+        .def("sync_async", ([](xrt::bo &b, xclBOSyncDirection dir, size_t size, size_t offset)  {
+                                return b.async(dir, size, offset);
+                            }), py::call_guard<py::gil_scoped_release>(),
+             "Start asynchronous synchronization of the buffer, returns a handle to wait on")
+        .def("sync_async", ([](xrt::bo& b, xclBOSyncDirection dir) {
+                                return b.async(dir);
+                            }), py::call_guard<py::gil_scoped_release>(),
+             "Start asynchronous synchronization of entire buffer, returns a handle to wait on")
         .def("map", ([](xrt::bo &b)  {
                          return py::memoryview::from_memory(b.map(), b.size());
                      }), "Create a byte accessible memory view of the buffer object")
+        .def_buffer([](xrt::bo& b) {
+                        // Zero-copy view of host mapped buffer, the view keeps
+                        // the Python bo object (and thus the mapping) alive
+                        return py::buffer_info(static_cast<uint8_t*>(b.map()), static_cast<py::ssize_t>(b.size()), false);
+                    })
+        .def("__dlpack__", [](xrt::bo& b, py::object /*stream*/) {
+                               return to_dlpack(b);
+                           }, py::arg("stream") = py::none(),
+             "Export the host mapped buffer as a DLPack capsule without copying")
+        .def("__dlpack_device__", [](xrt::bo&) {
+                                      return py::make_tuple(dl_device_cpu, 0);
+                                  }, "DLPack device of the exported buffer")
         .def("size", &xrt::bo::size, "Return the size of the buffer object")
         .def("address", &xrt::bo::address, "Return the device physical address of the buffer object");
 
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef XRT_COMMON_API_DIRTY_RANGE_H_
+#define XRT_COMMON_API_DIRTY_RANGE_H_
+
+// This file defines the dirty range tracking used by xrt::module to
+// sync only the patched parts of control code buffers.
+#include "core/include/xrt/xrt_bo.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace xrt_core {
+
+// struct dirty_range - byte ranges of a buffer modified since last sync
+//
+// Patching an argument records the bd words written.  At sync, the
+// ranges are coalesced and only the dirty ranges are synced, unless
+// they cover enough of the buffer that a full sync is cheaper.
+struct dirty_range
+{
+  // Ranges closer than this are synced as one range
+  static constexpr size_t coalesce_gap = 64;
+  // Sync full buffer if more ranges than this after coalescing
+  static constexpr size_t max_ranges = 16;
+
+  std::vector<std::pair<size_t, size_t>> m_ranges;  // [first, last)
+  bool m_all = false;
+
+  void
+  add(size_t first, size_t last)
+  {
+    if (!m_all)
+      m_ranges.emplace_back(first, last);
+  }
+
+  void
+  add_all()
+  {
+    m_all = true;
+    m_ranges.clear();
+  }
+
+  bool
+  empty() const
+  {
+    return !m_all && m_ranges.empty();
+  }
+
+  // Sync dirty ranges of a buffer object to device.  The buffer object
+  // holds bytes [bo_offset, bo_offset + bo.size()) of the buffer that
+  // ranges are relative to.  Return number of bytes synced.
+  //
+  // BufferObject is an xrt::bo, or a stand-in with the same size() and
+  // sync() members in unit tests.
+  template <typename BufferObject>
+  size_t
+  sync(BufferObject& bo, size_t bo_offset = 0)
+  {
+    if (empty() || !bo)
+      return 0;
+
+    auto bo_size = bo.size();
+    size_t synced = bo_size;
+    std::sort(m_ranges.begin(), m_ranges.end());
+    std::vector<std::pair<size_t, size_t>> coalesced;
+    size_t bytes = 0;
+    for (auto [first, last] : m_ranges) {
+      if (last <= bo_offset || first >= bo_offset + bo_size)
+        continue;
+
+      first = std::max(first, bo_offset) - bo_offset;
+      last = std::min(last, bo_offset + bo_size) - bo_offset;
+      if (first >= last)
+        continue;
+
+      if (!coalesced.empty() && first <= coalesced.back().second + coalesce_gap)
+        coalesced.back().second = std::max(coalesced.back().second, last);
+      else
+        coalesced.emplace_back(first, last);
+    }
+    for (const auto& [first, last] : coalesced)
+      bytes += last - first;
+
+    if (m_all || coalesced.size() > max_ranges || bytes * 2 > bo_size) {
+      bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    }
+    else {
+      for (const auto& [first, last] : coalesced)
+        bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, last - first, first);
+      synced = bytes;
+    }
+
+    m_ranges.clear();
+    m_all = false;
+    return synced;
+  }
+};
+
+} // xrt_core
+
+#endif
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Exercise the dirty range syncing of patched control code buffers
+// with a stand-in buffer object that records the syncs.
+#include "dirty_range.h"
+
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+struct sync_recorder
+{
+  size_t m_size;
+  std::vector<std::pair<size_t, size_t>> m_syncs;  // offset, size
+
+  explicit
+  sync_recorder(size_t size)
+    : m_size(size)
+  {}
+
+  size_t
+  size() const
+  {
+    return m_size;
+  }
+
+  explicit operator bool() const
+  {
+    return true;
+  }
+
+  void
+  sync(xclBOSyncDirection)
+  {
+    m_syncs.emplace_back(0, m_size);
+  }
+
+  void
+  sync(xclBOSyncDirection, size_t size, size_t offset)
+  {
+    m_syncs.emplace_back(offset, size);
+  }
+};
+
+using syncs = std::vector<std::pair<size_t, size_t>>;
+
+void
+check(bool cond, const std::string& what)
+{
+  if (!cond)
+    throw std::runtime_error(what);
+}
+
+void
+partial()
+{
+  xrt_core::dirty_range dirty;
+  sync_recorder bo(4096);
+  dirty.add(1024, 1060);
+  dirty.add(0, 36);
+  check(dirty.sync(bo) == 72, "partial: bytes synced");
+  check(bo.m_syncs == syncs{{0, 36}, {1024, 36}}, "partial: synced ranges");
+  check(dirty.empty(), "partial: not empty after sync");
+
+  bo.m_syncs.clear();
+  check(dirty.sync(bo) == 0 && bo.m_syncs.empty(), "partial: sync of clean buffer");
+}
+
+void
+coalesce()
+{
+  xrt_core::dirty_range dirty;
+  sync_recorder bo(4096);
+  dirty.add(100, 136);
+  dirty.add(0, 36);                // gap of 64 bytes to next range
+  dirty.add(120, 130);             // overlaps
+  check(dirty.sync(bo) == 136, "coalesce: bytes synced");
+  check(bo.m_syncs == syncs{{0, 136}}, "coalesce: synced ranges");
+}
+
+void
+full()
+{
+  // More ranges than max_ranges
+  {
+    xrt_core::dirty_range dirty;
+    sync_recorder bo(65536);
+    for (size_t i = 0; i <= xrt_core::dirty_range::max_ranges; ++i)
+      dirty.add(i * 1024, i * 1024 + 36);
+    check(dirty.sync(bo) == bo.size(), "full: too many ranges");
+    check(bo.m_syncs == syncs{{0, bo.size()}}, "full: too many ranges synced");
+  }
+
+  // Ranges cover more than half of the buffer
+  {
+    xrt_core::dirty_range dirty;
+    sync_recorder bo(1024);
+    dirty.add(0, 600);
+    check(dirty.sync(bo) == bo.size(), "full: dense ranges");
+    check(bo.m_syncs == syncs{{0, bo.size()}}, "full: dense ranges synced");
+  }
+
+  // Whole buffer marked dirty, later ranges are ignored
+  {
+    xrt_core::dirty_range dirty;
+    sync_recorder bo(4096);
+    dirty.add_all();
+    dirty.add(0, 36);
+    check(dirty.sync(bo) == bo.size(), "full: add_all");
+    check(bo.m_syncs == syncs{{0, bo.size()}}, "full: add_all synced");
+  }
+}
+
+void
+offset()
+{
+  // Buffer object holds bytes [8192, 12288) of the control code,
+  // ranges outside are dropped and ranges are clipped
+  xrt_core::dirty_range dirty;
+  sync_recorder bo(4096);
+  dirty.add(0, 36);
+  dirty.add(8180, 8200);
+  dirty.add(9216, 9252);
+  dirty.add(12288, 12324);
+  check(dirty.sync(bo, 8192) == 44, "offset: bytes synced");
+  check(bo.m_syncs == syncs{{0, 8}, {1024, 36}}, "offset: synced ranges");
+}
+
+} // namespace
+
+int
+main()
+{
+  try {
+    partial();
+    coalesce();
+    full();
+    offset();
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  std::cout << "PASSED TEST" << std::endl;
+  return 0;
+}
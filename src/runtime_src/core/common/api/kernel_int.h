@@ -84,6 +84,7 @@ size_t
 get_regmap_size(const xrt::kernel& kernel);
 
 // Get hw ctx using which this kernel is created
+XRT_CORE_COMMON_EXPORT
 xrt::hw_context
 get_hw_ctx(const xrt::kernel& kernel);
 
@@ -1,6 +1,6 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright (C) 2016-2022 Xilinx, Inc.  All rights reserved.
-// Copyright (C) 2022-2023 Advanced Micro Devices, Inc. All rights reserved.
+// Copyright (C) 2022-2024 Advanced Micro Devices, Inc. All rights reserved.
 #define XRT_CORE_COMMON_SOURCE
 #include "native_profile.h"
 
@@ -9,8 +9,19 @@
 #include "core/common/dlfcn.h"
 #include "core/common/time.h"
 
+#include <mutex>
+
 namespace xdp::native {
 
+// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<uint32_t> hook_mask {uninitialized_mask};
+hook_table hooks;
+
+// Categories the loaded plugin subscribed to, published to hook_mask
+// once loading is complete.
+static uint32_t subscribed_mask = 0;
+// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
+
 void
 load()
 {
@@ -20,16 +31,6 @@ load()
                       warning_function);
 }
 
-// Callbacks for generic start/stop function tracking
-// NOLINTBEGIN(cppcoreguidelines-avoid-non-const-global-variables)
-static std::function<void (const char*, uint64_t)> function_start_cb ;
-static std::function<void (const char*, uint64_t, uint64_t)> function_end_cb ;
-
-// Callbacks for individual functions to track start/stop and statistics
-static std::function<void (const char*, uint64_t, bool)> sync_start_cb ;
-static std::function<void (const char*, uint64_t, uint64_t, bool, uint64_t)> sync_end_cb ;
-// NOLINTEND(cppcoreguidelines-avoid-non-const-global-variables)
-  
 void
 register_functions(void* handle)
 {
@@ -37,59 +38,81 @@ register_functions(void* handle)
   using sync_start_type = void (*)(const char*, uint64_t, bool) ;
   using end_type        = void (*)(const char*, uint64_t, uint64_t) ;
   using end_sync_type   = void (*)(const char*, uint64_t, uint64_t, bool, uint64_t) ;
+  using categories_type = uint32_t (*)() ;
 
   // Generic callbacks
-  function_start_cb =
+  hooks.function_start =
     reinterpret_cast<start_type>(xrt_core::dlsym(handle, "native_function_start")) ;
 
-  function_end_cb =
+  hooks.function_end =
     reinterpret_cast<end_type>(xrt_core::dlsym(handle, "native_function_end")) ;
 
   // Sync callbacks
-  sync_start_cb =
+  hooks.sync_start =
     reinterpret_cast<sync_start_type>(xrt_core::dlsym(handle, "native_sync_start")) ;
 
-  sync_end_cb =
+  hooks.sync_end =
     reinterpret_cast<end_sync_type>(xrt_core::dlsym(handle, "native_sync_end")) ;
+
+  // A plugin subscribes to the categories for which it provides
+  // callbacks, optionally narrowed by the plugin itself
+  uint32_t mask = 0;
+  if (hooks.function_start && hooks.function_end)
+    mask |= static_cast<uint32_t>(api_category::generic)
+      | static_cast<uint32_t>(api_category::run)
+      | static_cast<uint32_t>(api_category::bo);
+
+  if (hooks.sync_start && hooks.sync_end)
+    mask |= static_cast<uint32_t>(api_category::sync);
+
+  auto categories =
+    reinterpret_cast<categories_type>(xrt_core::dlsym(handle, "native_api_categories")) ;
+  if (categories)
+    mask &= categories();
+
+  subscribed_mask = mask;
 }
 
 void warning_function()
 {}
 
-api_call_logger::
-api_call_logger(const char* function)
-  : m_funcid(0)
-  , m_fullname(function)
+bool
+initialize(api_category category)
 {
-  // With the addition of the generic "host_trace" feature, we have to
-  // check if we should load the plugin.  We only want to load it if
-  // native_xrt_trace is specified or if we are the topmost layer and
-  // host_trace was specified
-  static bool s_load_native =
-    (xrt_core::config::get_native_xrt_trace()
-     || xrt_core::utils::load_host_trace())
-    ? (load(), true)
-    : false;
-
-  if (s_load_native) {}
+  static std::once_flag flag;
+  std::call_once(flag, [] {
+    // With the addition of the generic "host_trace" feature, we have to
+    // check if we should load the plugin.  We only want to load it if
+    // native_xrt_trace is specified or if we are the topmost layer and
+    // host_trace was specified
+    if (xrt_core::config::get_native_xrt_trace()
+        || (xrt_core::config::get_host_trace() && xrt_core::utils::load_host_trace()))
+      load();
+
+    // Publish the hook table, call sites of categories not subscribed
+    // to are from now on reduced to a single not-taken branch
+    hook_mask.store(subscribed_mask, std::memory_order_release);
+  });
+
+  return (hook_mask.load(std::memory_order_acquire) & static_cast<uint32_t>(category)) != 0;
 }
 
 generic_api_call_logger::
 generic_api_call_logger(const char* function)
   : api_call_logger(function)
 {
-  if (function_start_cb) {
+  if (hooks.function_start) {
     m_funcid = xrt_core::utils::issue_id() ;
-    function_start_cb(m_fullname, m_funcid) ;
+    hooks.function_start(m_fullname, m_funcid) ;
   }
 }
 
 generic_api_call_logger::
 ~generic_api_call_logger()
 {
-  if (function_end_cb) {
+  if (hooks.function_end) {
     auto timestamp = static_cast<uint64_t>(xrt_core::time_ns());
-    function_end_cb(m_fullname, m_funcid, timestamp) ;
+    hooks.function_end(m_fullname, m_funcid, timestamp) ;
   }
 }
 
@@ -97,9 +120,9 @@ sync_logger::
 sync_logger(const char* function, bool w, size_t s)
   : api_call_logger(function), m_is_write(w), m_buffer_size(s)
 {
-  if (sync_start_cb) {
+  if (hooks.sync_start) {
     m_funcid = xrt_core::utils::issue_id() ;
-    sync_start_cb(m_fullname, m_funcid, m_is_write) ;
+    hooks.sync_start(m_fullname, m_funcid, m_is_write) ;
   }
 }
 
@@ -108,10 +131,9 @@ sync_logger::
 {
   auto timestamp = static_cast<uint64_t>(xrt_core::time_ns());
 
-  if (sync_end_cb) {
-    sync_end_cb(m_fullname, m_funcid, timestamp, m_is_write, static_cast<uint64_t>(m_buffer_size)) ;
+  if (hooks.sync_end) {
+    hooks.sync_end(m_fullname, m_funcid, timestamp, m_is_write, static_cast<uint64_t>(m_buffer_size)) ;
   }
 }
 
 } // end namespace xdp::native
-
@@ -1,16 +1,55 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright (C) 2016-2022 Xilinx, Inc.  All rights reserved.
-// Copyright (C) 2022-2023 Advanced Micro Devices, Inc. All rights reserved.
+// Copyright (C) 2022-2024 Advanced Micro Devices, Inc. All rights reserved.
 #ifndef NATIVE_PROFILE_DOT_H
 #define NATIVE_PROFILE_DOT_H
 #include "core/common/config.h"
 #include "core/common/config_reader.h"
 #include "core/include/xrt.h"
 
+#include <atomic>
+#include <cstdint>
+
 // This file contains the callback mechanisms for connecting the
 // Native XRT API (C/C++ layer) to the XDP plugin
 namespace xdp::native {
 
+// API categories that a plugin can subscribe to individually.  The
+// category of a call site is fixed at compile time, enabling one
+// category does not add any cost to call sites of other categories.
+enum class api_category : uint32_t
+{
+  generic = 0x1,  // all native APIs not in any of the categories below
+  run     = 0x2,  // xrt::run execution (start, wait, state)
+  bo      = 0x4,  // xrt::bo data movement (read, write, copy)
+  sync    = 0x8,  // xrt::bo::sync
+};
+
+// Bit set in the hook mask until the profiling configuration has been
+// resolved.  This forces the first profiled call through the slow
+// path, which loads the plugin if requested and publishes the final
+// category mask.
+constexpr uint32_t uninitialized_mask = 0x80000000;
+
+// Mask of enabled api categories.  The mask is written once when the
+// configuration is resolved and the plugin (if any) is loaded.
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+extern std::atomic<uint32_t> hook_mask;
+
+// Hook table resolved once when the plugin is loaded.  Entries are
+// plain function pointers to avoid indirection through std::function
+// on every profiled call.
+struct hook_table
+{
+  void (*function_start)(const char*, uint64_t) = nullptr;
+  void (*function_end)(const char*, uint64_t, uint64_t) = nullptr;
+  void (*sync_start)(const char*, uint64_t, bool) = nullptr;
+  void (*sync_end)(const char*, uint64_t, uint64_t, bool, uint64_t) = nullptr;
+};
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+extern hook_table hooks;
+
 // The functions responsible for loading and linking the plugin
 void
 load();
@@ -21,17 +60,37 @@ register_functions(void* handle);
 void
 warning_function();
 
+// Resolve profiling configuration, load the plugin if requested,
+// and publish the category mask.  Returns true if the category
+// is enabled after initialization.
+bool
+initialize(api_category category);
+
+// Check if a category is enabled.  After initialization this is a
+// single test and branch on the hook mask, which is predictably
+// not-taken when profiling is disabled.
+inline bool
+enabled(api_category category)
+{
+  auto mask = hook_mask.load(std::memory_order_acquire);
+  if ((mask & (static_cast<uint32_t>(category) | uninitialized_mask)) == 0)
+    return false;
+
+  return (mask & uninitialized_mask) ? initialize(category) : true;
+}
+
 // An instance of the api_call_logger class will be created in every
 // function we are monitoring.  The constructor marks the start time,
 // and the destructor marks the end time
 class api_call_logger
 {
  protected:
-  uint64_t m_funcid ;
+  uint64_t m_funcid = 0;
   const char* m_fullname = nullptr ;
  public:
-  explicit api_call_logger(const char* function);
-  virtual ~api_call_logger() = default ;
+  explicit api_call_logger(const char* function)
+    : m_fullname(function)
+  {}
 } ;
 
 class generic_api_call_logger : public api_call_logger
@@ -49,16 +108,23 @@ public:
 
 template <typename Callable, typename ...Args>
 auto
-profiling_wrapper(const char* function, Callable&& f, Args&&...args)
+profiling_wrapper(api_category category, const char* function, Callable&& f, Args&&...args)
 {
-  if (xrt_core::config::get_native_xrt_trace()
-      || xrt_core::config::get_host_trace()) {
+  if (enabled(category)) {
     generic_api_call_logger log_object(function) ;
     return f(std::forward<Args>(args)...) ;  // NOLINT, clang-tidy false positive [potential leak]
   }
   return f(std::forward<Args>(args)...) ;    // NOLINT, clang-tidy false positive [potential leak]
 }
 
+template <typename Callable, typename ...Args>
+auto
+profiling_wrapper(const char* function, Callable&& f, Args&&...args)
+{
+  return profiling_wrapper(api_category::generic, function,
+                           std::forward<Callable>(f), std::forward<Args>(args)...);
+}
+
 // Specializations of the logger for capturing different information
 // for use in summary tables.
 class sync_logger : public api_call_logger
@@ -81,8 +147,7 @@ template <typename Callable, typename ...Args>
 auto
 profiling_wrapper_sync(const char* function, xclBOSyncDirection dir, size_t size, Callable&& f, Args&&...args)
 {
-  if (xrt_core::config::get_native_xrt_trace() ||
-      xrt_core::config::get_host_trace()) {
+  if (enabled(api_category::sync)) {
     sync_logger log_object(function, (dir == XCL_BO_SYNC_BO_TO_DEVICE), size);
     return f(std::forward<Args>(args)...) ;
   }
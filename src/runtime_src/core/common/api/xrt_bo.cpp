@@ -1534,7 +1534,7 @@ void
 bo::
 write(const void* src, size_t size, size_t seek)
 {
-  xdp::native::profiling_wrapper("xrt::bo::write", [this, src, size, seek]{
+  xdp::native::profiling_wrapper(xdp::native::api_category::bo, "xrt::bo::write", [this, src, size, seek]{
     handle->write(src, size, seek);
   });
 }
@@ -1543,7 +1543,7 @@ void
 bo::
 read(void* dst, size_t size, size_t skip)
 {
-  xdp::native::profiling_wrapper("xrt::bo::read", [this, dst, size, skip]{
+  xdp::native::profiling_wrapper(xdp::native::api_category::bo, "xrt::bo::read", [this, dst, size, skip]{
     handle->read(dst, size, skip);
   });
 }
@@ -1552,7 +1552,7 @@ void
 bo::
 copy(const bo& src, size_t sz, size_t src_offset, size_t dst_offset)
 {
-  xdp::native::profiling_wrapper("xrt::bo::copy",
+  xdp::native::profiling_wrapper(xdp::native::api_category::bo, "xrt::bo::copy",
     [this, &src, sz, src_offset, dst_offset]{
       handle->copy(src.handle.get(), sz, src_offset, dst_offset);
     });
@@ -1813,6 +1813,7 @@ public:
 class run_impl
 {
   friend class mailbox_impl;
+  friend class detail::typed_binding_impl;
   using ipctx = std::shared_ptr<ip_context>;
   using control_type = kernel_impl::control_type;
   using kernel_type = kernel_impl::kernel_type;
@@ -2237,6 +2238,20 @@ public:
     return cumask;
   }
 
+  // Payload location of an argument if its value can be written
+  // directly to the command payload, nullptr otherwise.  Only
+  // AP_CTRL_HS and AP_CTRL_CHAIN kernels without an instruction
+  // module store argument values as is at the argument offset.
+  virtual uint8_t*
+  get_arg_payload(const argument& arg)
+  {
+    if (m_module || kernel->get_kernel_type() != kernel_type::pl
+        || kernel->get_ip_control_protocol() == control_type::fa)
+      return nullptr;
+
+    return reinterpret_cast<uint8_t*>(data) + arg.offset();
+  }
+
   arg_range<uint8_t>
   get_arg_value(const argument& arg)
   {
@@ -2765,6 +2780,13 @@ public:
   ////////////////////////////////////////////////////////////////
   // xrt::run_impl overrides
   ////////////////////////////////////////////////////////////////
+  // Mailbox tracks argument writes in its argument setter
+  uint8_t*
+  get_arg_payload(const argument&) override
+  {
+    return nullptr;
+  }
+
   std::unique_ptr<arg_setter>
   make_arg_setter() override
   {
@@ -2909,6 +2931,116 @@ public:
   {}
 };
 
+namespace detail {
+
+// class typed_binding_impl - Argument binding of xrt::typed_kernel
+//
+// The kernel arguments are resolved and the typed signature is
+// validated once at construction.  Setting an argument is by argument
+// index without lookup.  Global arguments are validated for CU
+// connectivity only when the memory bank of the argument changes.
+class typed_binding_impl
+{
+  using arg_type = typed_binding::arg_type;
+  using arg_kind = typed_binding::arg_kind;
+  static constexpr int32_t no_group = -1;
+
+  std::shared_ptr<run_impl> m_run;
+  std::vector<const argument*> m_args;  // nullptr for local and stream
+  std::vector<uint8_t*> m_payload;      // direct payload location or nullptr
+  std::vector<int32_t> m_groups;        // validated memory bank per global
+
+  static bool
+  is_global(const argument& arg)
+  {
+    return arg.type() == xrt_core::xclbin::kernel_argument::argtype::global || arg.type() == xrt_core::xclbin::kernel_argument::argtype::constant;
+  }
+
+public:
+  typed_binding_impl(std::shared_ptr<run_impl> run, const std::vector<arg_type>& signature)
+    : m_run(std::move(run))
+  {
+    auto kernel = m_run->get_kernel();
+    for (const auto& arg : kernel->get_args()) {
+      if (arg.index() == argument::no_index)
+        break;
+      m_args.push_back(&arg);
+    }
+
+    if (signature.size() != m_args.size())
+      throw xrt_core::error(EINVAL, "typed_kernel signature has " + std::to_string(signature.size())
+                            + " arguments, kernel '" + kernel->get_name() + "' has " + std::to_string(m_args.size()));
+
+    m_payload.resize(m_args.size(), nullptr);
+    m_groups.resize(m_args.size(), no_group);
+    for (size_t idx = 0; idx < m_args.size(); ++idx) {
+      auto arg = m_args[idx];
+      if (arg->type() == xrt_core::xclbin::kernel_argument::argtype::local || arg->type() == xrt_core::xclbin::kernel_argument::argtype::stream) {
+        m_args[idx] = nullptr;
+        continue;
+      }
+
+      auto global = is_global(*arg);
+      if (global != (signature[idx].kind == arg_kind::global))
+        throw xrt_core::error(EINVAL, "typed_kernel argument " + std::to_string(idx) + " ('" + arg->name() + "') must be "
+                              + (global ? "a global buffer" : "a scalar"));
+
+      if (!global && signature[idx].size != arg->size())
+        throw xrt_core::error(EINVAL, "typed_kernel argument " + std::to_string(idx) + " ('" + arg->name() + "') has size "
+                              + std::to_string(signature[idx].size) + ", kernel expects " + std::to_string(arg->size()));
+
+      if (global && arg->size() < sizeof(uint64_t))
+        continue;
+
+      m_payload[idx] = m_run->get_arg_payload(*arg);
+    }
+  }
+
+  uint8_t* const*
+  get_payload_locations() const
+  {
+    return m_payload.data();
+  }
+
+  void
+  set_global(size_t index, const xrt::bo& bo)
+  {
+    auto arg = m_args.at(index);
+    if (!arg)
+      return;
+
+    int32_t grp = xrt_core::bo::group_id(bo);
+    if (grp != m_groups[index]) {
+      auto vbo = m_run->validate_bo_at_index(index, bo);
+      if (vbo.get_handle() != bo.get_handle()) {
+        // Argument was copied to a connected bank, revalidate next time
+        m_groups[index] = no_group;
+        m_run->set_arg_value(*arg, vbo);
+        return;
+      }
+      m_groups[index] = grp;
+    }
+
+    if (auto dst = m_payload[index]) {
+      auto addr = bo.address();
+      std::memcpy(dst, &addr, sizeof(addr));
+      m_run->cmd->bind_arg_at_index(index, bo);
+      return;
+    }
+
+    m_run->set_arg_value(*arg, bo);
+  }
+
+  void
+  set_scalar(size_t index, const void* value, size_t bytes)
+  {
+    if (auto arg = m_args.at(index))
+      m_run->set_arg_value(*arg, value, bytes);
+  }
+};
+
+} // detail
+
 // class runlist_impl - The internals of a runlist
 //
 // Execution of a runlist is carved into multiple
@@ -3698,7 +3830,7 @@ start()
 {
   XRT_TRACE_POINT_SCOPE(xrt_run_start);
   xdp::native::profiling_wrapper
-    ("xrt::run::start", [this] {
+    (xdp::native::api_category::run, "xrt::run::start", [this] {
       handle->start();
     });
 }
@@ -3729,7 +3861,7 @@ run::
 wait(const std::chrono::milliseconds& timeout_ms) const
 {
   XRT_TRACE_POINT_SCOPE(xrt_run_wait);
-  return xdp::native::profiling_wrapper("xrt::run::wait",
+  return xdp::native::profiling_wrapper(xdp::native::api_category::run, "xrt::run::wait",
     [this, &timeout_ms] {
       return handle->wait(timeout_ms);
     });
@@ -3740,7 +3872,7 @@ run::
 wait2(const std::chrono::milliseconds& timeout_ms) const
 {
   XRT_TRACE_POINT_SCOPE(xrt_run_wait2);
-  return xdp::native::profiling_wrapper("xrt::run::wait",
+  return xdp::native::profiling_wrapper(xdp::native::api_category::run, "xrt::run::wait",
     [this, &timeout_ms] {
       return handle->wait_throw_on_error(timeout_ms);
     });
@@ -3750,7 +3882,7 @@ ert_cmd_state
 run::
 state() const
 {
-  return xdp::native::profiling_wrapper("xrt::run::state", [this]{
+  return xdp::native::profiling_wrapper(xdp::native::api_category::run, "xrt::run::state", [this]{
     return handle->state();
   });
 }
@@ -3759,7 +3891,7 @@ uint32_t
 run::
 return_code() const
 {
-  return xdp::native::profiling_wrapper("xrt::run::return_code", [this]{
+  return xdp::native::profiling_wrapper(xdp::native::api_category::run, "xrt::run::return_code", [this]{
     return handle->return_code();
   });
 }
@@ -4014,6 +4146,36 @@ reset()
   handle->reset();
 }
 
+namespace detail {
+
+typed_binding::
+typed_binding(const xrt::run& run, const std::vector<arg_type>& signature)
+  : detail::pimpl<typed_binding_impl>(std::make_shared<typed_binding_impl>(run.get_handle(), signature))
+{}
+
+uint8_t* const*
+typed_binding::
+get_payload_locations() const
+{
+  return handle->get_payload_locations();
+}
+
+void
+typed_binding::
+set_global(size_t index, const xrt::bo& bo)
+{
+  handle->set_global(index, bo);
+}
+
+void
+typed_binding::
+set_scalar(size_t index, const void* value, size_t bytes)
+{
+  handle->set_scalar(index, value, bytes);
+}
+
+} // detail
+
 } // namespace xrt
 
 ////////////////////////////////////////////////////////////////
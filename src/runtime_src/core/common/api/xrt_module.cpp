@@ -15,6 +15,7 @@
 
 #include "xrt/detail/ert.h"
 
+#include "dirty_range.h"
 #include "elf_int.h"
 #include "module_int.h"
 #include "core/common/debug.h"
@@ -23,11 +24,15 @@
 #include <elfio/elfio.hpp>
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <numeric>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <set>
 #include <string>
@@ -107,6 +112,8 @@ using instr_buf = buf;
 using control_packet = buf;
 using ctrlcode = buf; // represent control code for column or partition
 
+using xrt_core::dirty_range;
+
 // struct patcher - patcher for a symbol
 //
 // Manage patching of a symbol in the control code.  The symbol
@@ -147,8 +154,8 @@ struct patcher
     uint64_t offset_to_patch_buffer;
     uint32_t offset_to_base_bo_addr;
     uint32_t mask; // This field is valid only when patching scheme is scalar_32bit_kind
-    bool dirty = false; // Tells whether this entry is already patched or not
-    uint32_t bd_data_ptrs[max_bd_words]; // array to store bd ptrs original values
+    uint32_t bd_words = 0; // Number of valid words in bd_data_ptrs
+    uint32_t bd_data_ptrs[max_bd_words] = {}; // unpatched bd words, snapshot taken at ELF load
   };
 
   std::vector<patch_info> m_ctrlcode_patchinfo;
@@ -260,20 +267,74 @@ struct patcher
     bd_data_ptr[2] = (bd_data_ptr[2] & 0xFFFF0000) | (base_address >> 32);            // NOLINT
   }
 
+  // Bits of the bd words that a patching scheme adds the patch to.
+  // Only these bits are restored from the snapshot before a patch,
+  // other bits may have been patched since the snapshot was taken.
+  struct owned_word
+  {
+    uint32_t index;
+    uint32_t mask;
+  };
+
+  static const std::vector<owned_word>&
+  owned_words(symbol_type type)
+  {
+    static const std::vector<owned_word> none;
+    static const std::vector<owned_word> shim57 {{1, 0xFFFFFFFF}, {2, 0xFFFF}, {8, 0x1FF}};       // NOLINT
+    static const std::vector<owned_word> shim57_aie4 {{0, 0x1FFFFFF}, {1, 0xFFFFFFFF}};            // NOLINT
+    static const std::vector<owned_word> ctrlpkt {{2, 0xFFFFFFFF}, {3, 0xFFFF}};                   // NOLINT
+    static const std::vector<owned_word> shim48 {{1, 0xFFFFFFFF}, {2, 0xFFFF}};                    // NOLINT
+
+    switch (type) {
+    case symbol_type::shim_dma_base_addr_symbol_kind:
+      return shim57;
+    case symbol_type::shim_dma_aie4_base_addr_symbol_kind:
+      return shim57_aie4;
+    case symbol_type::control_packet_57:
+    case symbol_type::control_packet_48:
+      return ctrlpkt;
+    case symbol_type::shim_dma_48:
+      return shim48;
+    default:
+      // scalar_32bit_kind replaces the masked bits, nothing to restore
+      return none;
+    }
+  }
+
+  // Snapshot the unpatched bd words of each patch location.  The
+  // address bits owned by the patching scheme are restored from the
+  // snapshot before every patch so that an argument can be patched
+  // repeatedly.
+  //
+  // @param data - unpatched buffer that offsets are relative to
+  // @param size - size of unpatched buffer
   void
-  patch_it(uint8_t* base, uint64_t new_value)
+  snapshot(const uint8_t* data, size_t size)
   {
     for (auto& item : m_ctrlcode_patchinfo) {
+      if (item.offset_to_patch_buffer >= size)
+        throw std::runtime_error("Invalid patch offset " + std::to_string(item.offset_to_patch_buffer));
+
+      auto avail = (size - item.offset_to_patch_buffer) / sizeof(uint32_t);
+      item.bd_words = static_cast<uint32_t>(std::min(avail, max_bd_words));
+      for (const auto& word : owned_words(m_symbol_type))
+        if (word.index >= item.bd_words)
+          throw std::runtime_error("Invalid patch offset " + std::to_string(item.offset_to_patch_buffer));
+      std::memcpy(item.bd_data_ptrs, data + item.offset_to_patch_buffer, item.bd_words * sizeof(uint32_t));
+    }
+  }
+
+  // Patch all locations of the symbol.  If dirty is not null, the
+  // byte ranges written are recorded.
+  void
+  patch_it(uint8_t* base, uint64_t new_value, dirty_range* dirty = nullptr) const
+  {
+    for (const auto& item : m_ctrlcode_patchinfo) {
       auto bd_data_ptr = reinterpret_cast<uint32_t*>(base + item.offset_to_patch_buffer);
-      if (!item.dirty) {
-        // first time patching cache bd ptr values using bd ptrs array in patch info
-        std::copy(bd_data_ptr, bd_data_ptr + max_bd_words, item.bd_data_ptrs);
-        item.dirty = true;
-      }
-      else {
-        // not the first time patching, restore bd ptr values from patch info bd ptrs array
-        std::copy(item.bd_data_ptrs, item.bd_data_ptrs + max_bd_words, bd_data_ptr);
-      }
+      for (const auto& word : owned_words(m_symbol_type))
+        bd_data_ptr[word.index] = (bd_data_ptr[word.index] & ~word.mask) | (item.bd_data_ptrs[word.index] & word.mask);
+      if (dirty)
+        dirty->add(item.offset_to_patch_buffer, item.offset_to_patch_buffer + item.bd_words * sizeof(uint32_t));
 
       switch (m_symbol_type) {
       case symbol_type::scalar_32bit_kind:
@@ -485,6 +546,33 @@ public:
     throw std::runtime_error("Not supported");
   }
 
+  // Resolve the patcher for an argument in the patch plan of the module.
+  // The argument is looked up by name first, then by index.
+  //
+  // @param symbol - symbol name
+  // @param index - argument index
+  // @param buf_type - whether it is control-code, control-packet, preempt-save or preempt-restore
+  // @Return index of patcher in the patch plan, no_patcher if argument is not patched
+  static constexpr size_t no_patcher = std::numeric_limits<size_t>::max();
+
+  virtual size_t
+  resolve_patcher(const std::string&, size_t, patcher::buf_type) const
+  {
+    throw std::runtime_error("Not supported");
+  }
+
+  // Patch control code with resolved patcher
+  //
+  // @param base - base address of control code buffer object
+  // @param patcher_index - index of patcher as returned by resolve_patcher()
+  // @param patch - patch value
+  // @param dirty - if not null, records byte ranges patched
+  virtual void
+  patch_it(uint8_t*, size_t, uint64_t, dirty_range*) const
+  {
+    throw std::runtime_error("Not supported");
+  }
+
   // Get the number of patchers for arguments.  The returned
   // value is the number of arguments that must be patched before
   // the control code can be executed.
@@ -494,6 +582,15 @@ public:
     return 0;
   }
 
+  // Get the byte range [first, last) of all patch sites in a buffer
+  // type.  An empty range means that the buffer is never patched and
+  // can be shared by all run instances of the module.
+  virtual std::pair<size_t, size_t>
+  get_patch_range(patcher::buf_type) const
+  {
+    return { 0, 0 };
+  }
+
   // Check that all arguments have been patched and sync control code
   // buffer if necessary.  Throw if not all arguments have been patched.
   virtual void
@@ -533,7 +630,16 @@ class module_elf : public module_impl
   xrt::elf m_elf;
   uint8_t m_os_abi = Elf_Amd_Aie2p;
   std::vector<ctrlcode> m_ctrlcodes;
-  std::map<std::string, patcher> m_arg2patcher;
+
+  // Patch plan compiled at ELF load.  Patchers are addressed by index,
+  // the argument key (name or index and buffer type) is only used to
+  // resolve the index of a patcher.
+  std::vector<patcher> m_patchers;
+  std::map<std::string, size_t> m_key2patcher;
+
+  // Byte range of patch sites per buffer type
+  std::array<std::pair<size_t, size_t>, static_cast<size_t>(patcher::buf_type::buf_type_count)> m_patch_ranges {};
+
   instr_buf m_instr_buf;
   control_packet m_ctrl_packet;
   bool m_ctrl_packet_exist = false;
@@ -959,33 +1065,97 @@ class module_elf : public module_impl
     return arg2patcher;
   }
 
-  bool
-  patch_it(uint8_t* base, const std::string& argnm, size_t index, uint64_t patch, patcher::buf_type type) override
+  // Unpatched data of the buffer that a patcher applies to along with
+  // its size.  For aie2ps the control code and pad sections of all
+  // columns are one contiguous buffer.
+  std::pair<const uint8_t*, size_t>
+  get_unpatched_data(patcher::buf_type type, std::vector<uint8_t>& ctrlcode_data) const
   {
-    auto key_string = generate_key_string(argnm, type);
-    auto it = m_arg2patcher.find(key_string);
-    auto not_found_use_argument_name = (it == m_arg2patcher.end());
-    if (not_found_use_argument_name) {// Search using index
-      auto index_string = std::to_string(index);
-      const std::string key_index_string = generate_key_string(index_string, type);
-      it = m_arg2patcher.find(key_index_string);
-      if (it == m_arg2patcher.end())
-        return false;
+    if (m_os_abi == Elf_Amd_Aie2ps) {
+      if (ctrlcode_data.empty()) {
+        for (const auto& ctrlcode : m_ctrlcodes)
+          ctrlcode_data.insert(ctrlcode_data.end(), ctrlcode.data(), ctrlcode.data() + ctrlcode.size());
+      }
+      return { ctrlcode_data.data(), ctrlcode_data.size() };
     }
 
-    it->second.patch_it(base, patch);
-    if (xrt_core::config::get_xrt_debug()) {
-      if (not_found_use_argument_name) {
-        std::stringstream ss;
-        ss << "Patched " << patcher::to_string(type) << " using argument index " << index << " with value " << std::hex << patch;
-        xrt_core::message::send( xrt_core::message::severity_level::debug, "xrt_module", ss.str());
+    switch (type) {
+    case patcher::buf_type::ctrltext:
+      return { m_instr_buf.data(), m_instr_buf.size() };
+    case patcher::buf_type::ctrldata:
+      return { m_ctrl_packet.data(), m_ctrl_packet.size() };
+    case patcher::buf_type::preempt_save:
+      return { m_save_buf.data(), m_save_buf.size() };
+    case patcher::buf_type::preempt_restore:
+      return { m_restore_buf.data(), m_restore_buf.size() };
+    default:
+      throw std::runtime_error("Invalid patch buffer type " + std::string(patcher::to_string(type)));
+    }
+  }
+
+  // Compile the patch plan from the argument patchers.  The unpatched
+  // bd words of all patch locations are captured once here such that
+  // patching an argument is a walk over its patch locations.
+  void
+  compile_patch_plan(std::map<std::string, patcher>&& arg2patcher)
+  {
+    std::vector<uint8_t> ctrlcode_data;
+    m_patchers.reserve(arg2patcher.size());
+    for (auto& [key, ptchr] : arg2patcher) {
+      auto [data, size] = get_unpatched_data(ptchr.m_buf_type, ctrlcode_data);
+      ptchr.snapshot(data, size);
+      auto& range = m_patch_ranges[static_cast<size_t>(ptchr.m_buf_type)];
+      for (const auto& pi : ptchr.m_ctrlcode_patchinfo) {
+        auto first = static_cast<size_t>(pi.offset_to_patch_buffer);
+        auto last = first + pi.bd_words * sizeof(uint32_t);
+        range = (range.first == range.second)
+          ? std::make_pair(first, last)
+          : std::make_pair(std::min(range.first, first), std::max(range.second, last));
       }
-      else {
+      m_key2patcher.emplace(key, m_patchers.size());
+      m_patchers.push_back(std::move(ptchr));
+    }
+  }
+
+  size_t
+  resolve_patcher(const std::string& argnm, size_t index, patcher::buf_type type) const override
+  {
+    if (auto it = m_key2patcher.find(generate_key_string(argnm, type)); it != m_key2patcher.end())
+      return it->second;
+
+    // Search using index
+    if (auto it = m_key2patcher.find(generate_key_string(std::to_string(index), type)); it != m_key2patcher.end()) {
+      if (xrt_core::config::get_xrt_debug()) {
         std::stringstream ss;
-        ss << "Patched " << patcher::to_string(type) << " using argument name " << argnm << " with value " << std::hex << patch;
+        ss << "Resolved " << patcher::to_string(type) << " patcher of argument " << argnm << " using argument index " << index;
         xrt_core::message::send( xrt_core::message::severity_level::debug, "xrt_module", ss.str());
       }
+      return it->second;
     }
+
+    return no_patcher;
+  }
+
+  void
+  patch_it(uint8_t* base, size_t patcher_index, uint64_t patch, dirty_range* dirty) const override
+  {
+    const auto& ptchr = m_patchers.at(patcher_index);
+    ptchr.patch_it(base, patch, dirty);
+    if (xrt_core::config::get_xrt_debug()) {
+      std::stringstream ss;
+      ss << "Patched " << patcher::to_string(ptchr.m_buf_type) << " using patcher " << patcher_index << " with value " << std::hex << patch;
+      xrt_core::message::send( xrt_core::message::severity_level::debug, "xrt_module", ss.str());
+    }
+  }
+
+  bool
+  patch_it(uint8_t* base, const std::string& argnm, size_t index, uint64_t patch, patcher::buf_type type) override
+  {
+    auto patcher_index = resolve_patcher(argnm, index, type);
+    if (patcher_index == no_patcher)
+      return false;
+
+    patch_it(base, patcher_index, patch, nullptr);
     return true;
   }
 
@@ -1019,7 +1189,7 @@ public:
     if (m_os_abi == Elf_Amd_Aie2ps) {
       std::vector<size_t> pad_offsets;
       m_ctrlcodes = initialize_column_ctrlcode(xrt_core::elf_int::get_elfio(m_elf), pad_offsets);
-      m_arg2patcher = initialize_arg_patchers(xrt_core::elf_int::get_elfio(m_elf), m_ctrlcodes, pad_offsets);
+      compile_patch_plan(initialize_arg_patchers(xrt_core::elf_int::get_elfio(m_elf), m_ctrlcodes, pad_offsets));
     }
     else if (m_os_abi == Elf_Amd_Aie2p) {
       m_instr_buf = initialize_instr_buf(xrt_core::elf_int::get_elfio(m_elf));
@@ -1031,7 +1201,7 @@ public:
         throw std::runtime_error{ "Invalid elf because preempt save and restore is not paired" };
 
       initialize_ctrlpkt_pm_bufs(xrt_core::elf_int::get_elfio(m_elf));
-      m_arg2patcher = initialize_arg_patchers(xrt_core::elf_int::get_elfio(m_elf));
+      compile_patch_plan(initialize_arg_patchers(xrt_core::elf_int::get_elfio(m_elf)));
     }
   }
 
@@ -1086,7 +1256,13 @@ public:
   size_t
   number_of_arg_patchers() const override
   {
-    return m_arg2patcher.size();
+    return m_patchers.size();
+  }
+
+  std::pair<size_t, size_t>
+  get_patch_range(patcher::buf_type type) const override
+  {
+    return m_patch_ranges.at(static_cast<size_t>(type));
   }
 };
 
@@ -1141,15 +1317,36 @@ public:
 // Allocate a buffer object to hold the ctrlcodes for each column created
 // by parent module.  The ctrlcodes are concatenated into a single buffer
 // where buffer object address of offset for each column.
+//
+// With Runtime.share_module_buffers, buffers that have no patch sites
+// are allocated once per parent module and hw context and are shared
+// by all module_sram instances, only buffers with patch sites are
+// private to an instance.
 class module_sram : public module_impl
 {
+  // Unpatched buffers shared by module_sram instances of same parent
+  // module and hw context.  The aie2ps control code is the complete
+  // unpatched control code of all columns, instances use it for the
+  // columns outside of their private buffer.
+  struct shared_buffers
+  {
+    xrt::hw_context hwctx;
+    xrt::bo ctrlpkt;
+    std::map<std::string, xrt::bo> ctrlpkt_pm;
+    xrt::bo ctrlcode;
+  };
+
   std::shared_ptr<module_impl> m_parent;
   xrt::hw_context m_hwctx;
+  std::shared_ptr<shared_buffers> m_shared;
 
   // The instruction buffer object contains the ctrlcodes for each
   // column.  The ctrlcodes are concatenated into a single buffer
-  // padded at page size specific to hardware.
+  // padded at page size specific to hardware.  When buffers are
+  // shared, the buffer holds the columns with patch sites only,
+  // starting at byte m_buffer_offset of the concatenated ctrlcodes.
   xrt::bo m_buffer;
+  size_t m_buffer_offset = 0;
   xrt::bo m_instr_bo;
   xrt::bo m_ctrlpkt_bo;
   xrt::bo m_scratch_pad_mem;
@@ -1172,10 +1369,30 @@ class module_sram : public module_impl
   // Must match number of argument patchers in parent module
   std::set<std::string> m_patched_args;
 
+  // Patchers of kernel arguments in the patch plan of the parent
+  // module, indexed by argument index.  Resolved on first patch of an
+  // argument, re-patching an argument does no lookup.
+  struct arg_patchers
+  {
+    bool resolved = false;
+    size_t ctrltext = no_patcher;
+    size_t ctrldata = no_patcher;
+    size_t pad = no_patcher;
+  };
+  std::vector<arg_patchers> m_arg_patchers;
+
   // Dirty bit to indicate that patching was done prior to last
   // buffer sync to device.
   bool m_dirty{ false };
 
+  // Byte ranges of each buffer patched since last sync.  Ranges of
+  // the aie2ps control code are relative to the concatenated ctrlcodes.
+  dirty_range m_buffer_dirty;
+  dirty_range m_instr_dirty;
+  dirty_range m_ctrlpkt_dirty;
+  dirty_range m_preempt_save_dirty;
+  dirty_range m_preempt_restore_dirty;
+
   union debug_flag_union {
     struct debug_mode_struct {
       uint32_t dump_control_codes     : 1;
@@ -1216,16 +1433,35 @@ class module_sram : public module_impl
   {
     m_column_bo_address.clear();
     uint16_t ucidx = 0;
-    auto base_addr = m_buffer.address();
+    size_t offset = 0;
     for (const auto& ctrlcode : ctrlcodes) {
       if (auto size = ctrlcode.size())
-        m_column_bo_address.push_back({ ucidx, base_addr, size }); // NOLINT
+        m_column_bo_address.push_back({ ucidx, get_ctrlcode_address(offset), size }); // NOLINT
 
       ++ucidx;
-      base_addr += ctrlcode.size();
+      offset += ctrlcode.size();
     }
   }
 
+  // Device address of byte offset in the concatenated ctrlcodes
+  uint64_t
+  get_ctrlcode_address(size_t offset) const
+  {
+    if (m_shared && (offset < m_buffer_offset || offset >= m_buffer_offset + m_buffer.size()))
+      return m_shared->ctrlcode.address() + offset;
+
+    return m_buffer.address() + (offset - m_buffer_offset);
+  }
+
+  // Base for patching the concatenated ctrlcodes.  Patch offsets are
+  // relative to the start of the concatenated ctrlcodes, all of which
+  // fall inside the private buffer.
+  uint8_t*
+  get_ctrlcode_base()
+  {
+    return m_buffer.map<uint8_t*>() - m_buffer_offset;
+  }
+
   void
   fill_bo_addresses()
   {
@@ -1238,25 +1474,38 @@ class module_sram : public module_impl
   void
   fill_instruction_buffer(const std::vector<ctrlcode>& ctrlcodes)
   {
+    if (!m_buffer)
+      return;
+
+    // Copy the columns covered by the private buffer
     auto ptr = m_buffer.map<char*>();
+    size_t offset = 0;
     for (const auto& ctrlcode : ctrlcodes) {
-      std::memcpy(ptr, ctrlcode.data(), ctrlcode.size());
-      ptr += ctrlcode.size();
+      if (offset >= m_buffer_offset && offset < m_buffer_offset + m_buffer.size()) {
+        std::memcpy(ptr, ctrlcode.data(), ctrlcode.size());
+        ptr += ctrlcode.size();
+      }
+      offset += ctrlcode.size();
     }
 
     // Iterate over control packets of all columns & patch it in instruction
     // buffer
-    auto col_data = m_parent->get_data();
-    size_t offset = 0;
+    const auto& col_data = m_parent->get_data();
+    offset = 0;
     for (size_t i = 0; i < col_data.size(); ++i) {
       // find the control-code-* sym-name and patch it in instruction buffer
       // This name is an agreement between aiebu and XRT
       auto sym_name = std::string(Control_Code_Symbol) + "-" + std::to_string(i);
-      if (patch_instr_value(m_buffer, sym_name, std::numeric_limits<size_t>::max() , m_buffer.address() + offset, patcher::buf_type::ctrltext))
+      auto idx = m_parent->resolve_patcher(sym_name, std::numeric_limits<size_t>::max(), patcher::buf_type::ctrltext);
+      if (idx != no_patcher) {
+        m_parent->patch_it(get_ctrlcode_base(), idx, get_ctrlcode_address(offset), &m_buffer_dirty);
         m_patched_args.insert(sym_name);
+        m_dirty = true;
+      }
       offset += col_data[i].size();
     }
-    m_buffer.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    m_buffer_dirty.add_all();
+    m_buffer_dirty.sync(m_buffer, m_buffer_offset);
   }
 
   void
@@ -1371,6 +1620,11 @@ class module_sram : public module_impl
       return;
     }
 
+    if (m_shared && m_shared->ctrlpkt) {
+      m_ctrlpkt_bo = m_shared->ctrlpkt;
+      return;
+    }
+
     m_ctrlpkt_bo = xrt::ext::bo{ m_hwctx, sz };
 
     fill_ctrlpkt_buf(m_ctrlpkt_bo, data);
@@ -1388,6 +1642,11 @@ class module_sram : public module_impl
   void
   create_ctrlpkt_pm_bufs(const module_impl* parent)
   {
+    if (m_shared) {
+      m_ctrlpkt_pm_bos = m_shared->ctrlpkt_pm;
+      return;
+    }
+
     const auto& ctrlpkt_pm_info = parent->get_ctrlpkt_pm_bufs();
 
     for (const auto& [key, buf] : ctrlpkt_pm_info) {
@@ -1411,55 +1670,225 @@ class module_sram : public module_impl
       return;
     }
 
-    m_buffer = xrt::bo{ m_hwctx, sz, xrt::bo::flags::cacheable, 1 /* fix me */ };
+    // With shared buffers, the private buffer spans the columns
+    // from first to last column with patch sites
+    auto first = static_cast<size_t>(0);
+    auto last = sz;
+    if (m_shared) {
+      auto text = parent->get_patch_range(patcher::buf_type::ctrltext);
+      auto pad = parent->get_patch_range(patcher::buf_type::pad);
+      auto range = text.first == text.second
+        ? pad
+        : (pad.first == pad.second ? text : std::make_pair(std::min(text.first, pad.first), std::max(text.second, pad.second)));
+
+      first = last = 0;
+      size_t offset = 0;
+      for (const auto& ctrlcode : data) {
+        auto end = offset + ctrlcode.size();
+        if (range.first < range.second && range.first < end && offset < range.second) {
+          if (first == last)
+            first = offset;
+          last = end;
+        }
+        offset = end;
+      }
+    }
+
+    m_buffer_offset = first;
+    if (last > first)
+      m_buffer = xrt::bo{ m_hwctx, last - first, xrt::bo::flags::cacheable, 1 /* fix me */ };
 
     fill_instruction_buffer(data);
   }
 
+  // Create the buffers that have no patch sites.  The buffers are
+  // filled and synced once and never written after.
+  static std::shared_ptr<shared_buffers>
+  create_shared_buffers(const module_impl* parent, const xrt::hw_context& hwctx)
+  {
+    auto shared = std::make_shared<shared_buffers>();
+    shared->hwctx = hwctx;
+    auto fill = [](xrt::bo& bo, const buf& data) {
+      std::memcpy(bo.map<char*>(), data.data(), data.size());
+      bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    };
+
+    auto os_abi = parent->get_os_abi();
+    if (os_abi == Elf_Amd_Aie2p) {
+      const auto& ctrlpkt = parent->get_ctrlpkt();
+      auto range = parent->get_patch_range(patcher::buf_type::ctrldata);
+      if (ctrlpkt.size() && range.first == range.second) {
+        shared->ctrlpkt = xrt::ext::bo{ hwctx, ctrlpkt.size() };
+        fill(shared->ctrlpkt, ctrlpkt);
+      }
+
+      for (const auto& [key, data] : parent->get_ctrlpkt_pm_bufs()) {
+        auto& bo = shared->ctrlpkt_pm[key] = xrt::ext::bo{ hwctx, data.size() };
+        fill(bo, data);
+      }
+    }
+    else if (os_abi == Elf_Amd_Aie2ps) {
+      const auto& data = parent->get_data();
+      size_t sz = std::accumulate(data.begin(), data.end(), static_cast<size_t>(0), [](auto acc, const auto& ctrlcode) {
+        return acc + ctrlcode.size();
+      });
+      if (sz) {
+        shared->ctrlcode = xrt::bo{ hwctx, sz, xrt::bo::flags::cacheable, 1 /* fix me */ };
+        auto ptr = shared->ctrlcode.map<char*>();
+        for (const auto& ctrlcode : data) {
+          std::memcpy(ptr, ctrlcode.data(), ctrlcode.size());
+          ptr += ctrlcode.size();
+        }
+        shared->ctrlcode.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      }
+    }
+
+    return shared;
+  }
+
+  // Get the shared buffers of parent module in hw context, create
+  // them if this is the first instance.
+  static std::shared_ptr<shared_buffers>
+  get_shared_buffers(const std::shared_ptr<module_impl>& parent, const xrt::hw_context& hwctx)
+  {
+    static std::mutex mutex;
+    static std::map<std::pair<const module_impl*, const void*>, std::weak_ptr<shared_buffers>> cache;
+
+    std::lock_guard lk(mutex);
+    auto key = std::make_pair(parent.get(), static_cast<const void*>(hwctx.get_handle().get()));
+    if (auto it = cache.find(key); it != cache.end()) {
+      if (auto shared = it->second.lock())
+        return shared;
+    }
+
+    // Drop buffers of destroyed modules
+    for (auto it = cache.begin(); it != cache.end();)
+      it = it->second.expired() ? cache.erase(it) : std::next(it);
+
+    auto shared = create_shared_buffers(parent.get(), hwctx);
+    cache[key] = shared;
+    return shared;
+  }
+
+  // Bytes of buffer objects private to this instance and bytes of
+  // buffer objects shared with other instances
+  std::pair<size_t, size_t>
+  get_bo_footprint() const
+  {
+    size_t priv = 0;
+    size_t shared = 0;
+    auto add = [&priv, &shared](const xrt::bo& bo, bool is_shared) {
+      if (bo)
+        (is_shared ? shared : priv) += bo.size();
+    };
+
+    add(m_buffer, false);
+    add(m_instr_bo, false);
+    add(m_scratch_pad_mem, false);
+    add(m_preempt_save_bo, false);
+    add(m_preempt_restore_bo, false);
+    add(m_ctrlpkt_bo, is_shared_ctrlpkt());
+    for (const auto& [key, bo] : m_ctrlpkt_pm_bos)
+      add(bo, m_shared != nullptr);
+    if (m_shared)
+      add(m_shared->ctrlcode, true);
+
+    return { priv, shared };
+  }
+
+  bool
+  is_shared_ctrlpkt() const
+  {
+    return m_shared && m_shared->ctrlpkt && m_ctrlpkt_bo;
+  }
+
   void
   patch_instr(xrt::bo& bo_ctrlcode, const std::string& argnm, size_t index, const xrt::bo& bo, patcher::buf_type type) override
   {
     patch_instr_value(bo_ctrlcode, argnm, index, bo.address(), type);
   }
 
+  const arg_patchers&
+  resolve_arg_patchers(const std::string& argnm, size_t index)
+  {
+    if (index >= m_arg_patchers.size())
+      m_arg_patchers.resize(index + 1);
+
+    auto& ap = m_arg_patchers[index];
+    if (ap.resolved)
+      return ap;
+
+    ap.ctrltext = m_parent->resolve_patcher(argnm, index, patcher::buf_type::ctrltext);
+    if (m_parent->get_os_abi() == Elf_Amd_Aie2p) {
+      if (m_ctrlpkt_bo)
+        ap.ctrldata = m_parent->resolve_patcher(argnm, index, patcher::buf_type::ctrldata);
+    }
+    else {
+      ap.pad = m_parent->resolve_patcher(argnm, index, patcher::buf_type::pad);
+    }
+    ap.resolved = true;
+
+    if (ap.ctrltext != no_patcher || ap.ctrldata != no_patcher || ap.pad != no_patcher)
+      m_patched_args.insert(argnm);
+
+    return ap;
+  }
+
   void
   patch_value(const std::string& argnm, size_t index, uint64_t value)
   {
-    bool patched = false;
+    const auto& ap = resolve_arg_patchers(argnm, index);
     if (m_parent->get_os_abi() == Elf_Amd_Aie2p) {
       // patch control-packet buffer
-      if (m_ctrlpkt_bo) {
-        if (m_parent->patch_it(m_ctrlpkt_bo.map<uint8_t*>(), argnm, index, value, patcher::buf_type::ctrldata))
-          patched = true;
-      }
+      if (ap.ctrldata != no_patcher)
+        m_parent->patch_it(m_ctrlpkt_bo.map<uint8_t*>(), ap.ctrldata, value, &m_ctrlpkt_dirty);
       // patch instruction buffer
-      if (m_parent->patch_it(m_instr_bo.map<uint8_t*>(), argnm, index, value, patcher::buf_type::ctrltext))
-          patched = true;
+      if (ap.ctrltext != no_patcher)
+        m_parent->patch_it(m_instr_bo.map<uint8_t*>(), ap.ctrltext, value, &m_instr_dirty);
     }
     else {
-      if (m_parent->patch_it(m_buffer.map<uint8_t*>(), argnm, index, value, patcher::buf_type::ctrltext))
-        patched = true;
+      if (ap.ctrltext != no_patcher)
+        m_parent->patch_it(get_ctrlcode_base(), ap.ctrltext, value, &m_buffer_dirty);
 
-      if (m_parent->patch_it(m_buffer.map<uint8_t*>(), argnm, index, value, patcher::buf_type::pad))
-        patched = true;
+      if (ap.pad != no_patcher)
+        m_parent->patch_it(get_ctrlcode_base(), ap.pad, value, &m_buffer_dirty);
     }
 
-    if (patched) {
-      m_patched_args.insert(argnm);
+    if (ap.ctrltext != no_patcher || ap.ctrldata != no_patcher || ap.pad != no_patcher)
       m_dirty = true;
-    }
   }
 
   bool  
   patch_instr_value(xrt::bo& bo, const std::string& argnm, size_t index, uint64_t value, patcher::buf_type type)
   {
-    if (!m_parent->patch_it(bo.map<uint8_t*>(), argnm, index, value, type))
+    auto idx = m_parent->resolve_patcher(argnm, index, type);
+    if (idx == no_patcher)
       return false;
 
+    m_parent->patch_it(bo.map<uint8_t*>(), idx, value, &get_dirty_range(type));
     m_dirty = true;
     return true;
   }
 
+  dirty_range&
+  get_dirty_range(patcher::buf_type type)
+  {
+    switch (type) {
+    case patcher::buf_type::ctrltext:
+      return (m_parent->get_os_abi() == Elf_Amd_Aie2ps) ? m_buffer_dirty : m_instr_dirty;
+    case patcher::buf_type::ctrldata:
+      return m_ctrlpkt_dirty;
+    case patcher::buf_type::preempt_save:
+      return m_preempt_save_dirty;
+    case patcher::buf_type::preempt_restore:
+      return m_preempt_restore_dirty;
+    case patcher::buf_type::pad:
+      return m_buffer_dirty;
+    default:
+      throw std::runtime_error("No dirty range for buffer type " + std::string(patcher::to_string(type)));
+    }
+  }
+
   void
   patch(const std::string& argnm, size_t index, const xrt::bo& bo) override
   {
@@ -1476,14 +1905,15 @@ class module_sram : public module_impl
     patch_value(argnm, index, arg_value);
   }
 
-  // Check that all arguments have been patched and sync the buffer
-  // to device if it is dirty.
+  // Check that all arguments have been patched and sync the dirty
+  // ranges of the buffers to device.
   void
   sync_if_dirty() override
   {
     if (!m_dirty)
       return;
 
+    size_t synced = 0;
     auto os_abi = m_parent.get()->get_os_abi();
     if (os_abi == Elf_Amd_Aie2ps) {
       if (m_patched_args.size() != m_parent->number_of_arg_patchers()) {
@@ -1491,10 +1921,10 @@ class module_sram : public module_impl
             % m_parent->number_of_arg_patchers() % m_patched_args.size();
         throw std::runtime_error{ fmt.str() };
       }
-      m_buffer.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      synced += m_buffer_dirty.sync(m_buffer, m_buffer_offset);
     }
     else if (os_abi == Elf_Amd_Aie2p) {
-      m_instr_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      synced += m_instr_dirty.sync(m_instr_bo);
 
       if (is_dump_control_codes()) {
         std::string dump_file_name = "ctr_codes_post_patch" + std::to_string(get_id()) + ".bin";
@@ -1505,8 +1935,8 @@ class module_sram : public module_impl
         xrt_core::message::send(xrt_core::message::severity_level::debug, "xrt_module", ss.str());
       }
 
-      if (m_ctrlpkt_bo) {
-        m_ctrlpkt_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      if (!m_ctrlpkt_dirty.empty()) {
+        synced += m_ctrlpkt_dirty.sync(m_ctrlpkt_bo);
 
         if (is_dump_control_packet()) {
           std::string dump_file_name = "ctr_packet_post_patch" + std::to_string(get_id()) + ".bin";
@@ -1519,8 +1949,8 @@ class module_sram : public module_impl
       }
 
       if (m_preempt_save_bo && m_preempt_restore_bo) {
-        m_preempt_save_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
-        m_preempt_restore_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+        synced += m_preempt_save_dirty.sync(m_preempt_save_bo);
+        synced += m_preempt_restore_dirty.sync(m_preempt_restore_bo);
 
         if (is_dump_preemption_codes()) {
           std::string dump_file_name = "preemption_save_post_patch" + std::to_string(get_id()) + ".bin";
@@ -1540,6 +1970,12 @@ class module_sram : public module_impl
       }
     }
 
+    if (xrt_core::config::get_xrt_debug()) {
+      std::stringstream ss;
+      ss << "synced " << synced << " bytes of patched control code";
+      xrt_core::message::send(xrt_core::message::severity_level::debug, "xrt_module", ss.str());
+    }
+
     m_dirty = false;
   }
 
@@ -1606,6 +2042,8 @@ public:
     }
 
     auto os_abi = m_parent.get()->get_os_abi();
+    if (xrt_core::config::get_share_module_buffers())
+      m_shared = get_shared_buffers(m_parent, m_hwctx);
 
     if (os_abi == Elf_Amd_Aie2p) {
       // make sure to create control-packet buffers first because we may
@@ -1619,6 +2057,13 @@ public:
       create_instruction_buffer(m_parent.get());
       fill_column_bo_address(m_parent->get_data());
     }
+
+    if (xrt_core::config::get_xrt_debug()) {
+      auto [priv, shared] = get_bo_footprint();
+      std::stringstream ss;
+      ss << "module_sram buffer objects: " << priv << " bytes private, " << shared << " bytes shared";
+      xrt_core::message::send(xrt_core::message::severity_level::debug, "xrt_module", ss.str());
+    }
   }
 
   uint32_t*
@@ -8,72 +8,223 @@
 #define XRT_CORE_COMMON_SOURCE // in same dll as core_common
 #include "core/include/xrt/experimental/xrt_queue.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <set>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 #ifdef _WIN32
 # pragma warning( disable : 4244 )
 #endif
 
+namespace {
+
+// Queues with tasks waiting for an event.  A queue registers when it
+// first gets a task with a dependency and unregisters when destroyed.
+// Completion of any task wakes registered queues such that they can
+// check if dependencies are ready.
+std::mutex dependent_queues_mutex;
+std::set<xrt::queue_impl*> dependent_queues;
+
+// Number of tasks waiting for an event across all queues
+std::atomic<size_t> waiting_tasks {0};
+
+// Check interval of dependencies on events that are not completed by
+// a queue task, e.g. a future of a std::promise
+constexpr auto dependency_poll_interval = std::chrono::milliseconds(1);
+
+} // namespace
+
 namespace xrt {
 
 // class queue_impl - insulated implemention of an xrt::queue
 //
 // Manages and executes enqueued tasks.
-// Tasks are executed and completed in order of enqueuing.
+// Tasks are started in order of enqueuing, a task that depends on an
+// event is not started before the event is ready.
 //
-// A queue is associated with exactly one handler thread that executes
-// the task asynchronously to the enqueuer.
+// A queue is associated with one or more handler threads that execute
+// the tasks asynchronously to the enqueuer.  With one handler thread
+// tasks are executed and completed in order of enqueuing.
 class queue_impl
 {
-  std::queue<xrt::queue::task> m_queue;  // task queue
+  // Enqueued task with optional dependency.  The dependency is
+  // waited on by the worker before the task is executed, which runs
+  // the function of a deferred future.
+  struct entry
+  {
+    xrt::queue::event m_dependency;
+    xrt::queue::task m_task;
+    bool m_waiting = false;       // dependency was not ready, counted in m_waiting
+  };
+
+  // Ring buffer of entries in order of enqueuing, m_head and m_tail
+  // are positions of first and one past last entry, the capacity is
+  // a power of two.  An entry taken out of order by a handler thread
+  // is left empty until it reaches the head.  The ring grows when
+  // full and never shrinks, such that enqueue does not allocate in
+  // steady state.
+  std::vector<entry> m_ring;
+  size_t m_head = 0;
+  size_t m_tail = 0;
+
   std::mutex m_mutex;
   std::condition_variable m_work;
   bool m_stop = false;
+  bool m_registered = false;      // in dependent_queues
+  size_t m_waiting = 0;           // entries with pending dependency
+
+  // worker threads to run the tasks, the number of workers is set
+  // before any worker is started
+  const unsigned int m_num_workers;
+  std::vector<std::thread> m_workers;
+
+  entry&
+  at(size_t pos)
+  {
+    return m_ring[pos & (m_ring.size() - 1)];
+  }
+
+  void
+  grow()
+  {
+    std::vector<entry> ring(m_ring.size() * 2);
+    for (size_t pos = m_head; pos != m_tail; ++pos)
+      ring[pos - m_head] = std::move(at(pos));
+    m_tail -= m_head;
+    m_head = 0;
+    m_ring = std::move(ring);
+  }
+
+  // Find the first entry that can be started, must be called with
+  // m_mutex locked.  With a single worker only the head entry can be
+  // started.  Returns m_tail if no entry can be started.
+  size_t
+  find_ready()
+  {
+    auto end = (m_num_workers == 1) ? std::min(m_head + 1, m_tail) : m_tail;
+    for (size_t pos = m_head; pos != end; ++pos) {
+      auto& e = at(pos);
+      if (!e.m_task)
+        continue;
 
-  // single worker thread to run the tasks
-  std::thread m_worker;
+      if (!e.m_waiting)
+        return pos;
+
+      if (e.m_dependency.ready()) {
+        e.m_waiting = false;
+        --m_waiting;
+        --waiting_tasks;
+        return pos;
+      }
+
+      if (m_num_workers == 1)
+        break;
+    }
+    return m_tail;
+  }
+
+  // Take entry at pos and advance head past taken entries
+  entry
+  take(size_t pos)
+  {
+    auto e = std::move(at(pos));
+    at(pos) = {};
+    while (m_head != m_tail && !at(m_head).m_task)
+      ++m_head;
+    return e;
+  }
+
+  // Wake dependent queues after a task completed
+  static void
+  notify_dependents()
+  {
+    if (!waiting_tasks)
+      return;
+
+    std::lock_guard lk(dependent_queues_mutex);
+    for (auto q : dependent_queues)
+      q->wake();
+  }
 
   // worker thread, executes tasks as they become ready
   void
   run()
   {
-    while (!m_stop) {
-      xrt::queue::task task;
+    while (true) {
+      entry e;
 
       // exclusive synchronized region
       {
         std::unique_lock lk(m_mutex);
-        m_work.wait(lk, [this] { return m_stop || !m_queue.empty(); });
+        size_t pos = m_tail;
+        while (!m_stop && (pos = find_ready()) == m_tail) {
+          // tasks waiting for an event that is not completed by a
+          // queue task are not woken, check them periodically
+          if (m_waiting)
+            m_work.wait_for(lk, dependency_poll_interval);
+          else
+            m_work.wait(lk);
+        }
 
         if (m_stop)
           return;
 
-        task = std::move(m_queue.front());
-        m_queue.pop();
+        e = take(pos);
       }
 
       // allow enqueue while executing
-      task.execute();
+      e.m_dependency.wait();
+      e.m_task.execute();
+      notify_dependents();
     }
   }
 
+  void
+  push(entry&& e)
+  {
+    if (m_tail - m_head == m_ring.size())
+      grow();
+    at(m_tail++) = std::move(e);
+  }
+
 public:
-  queue_impl()
-    : m_worker([this] { run(); })
-  {}
+  explicit
+  queue_impl(unsigned int workers)
+    : m_ring(64)
+    , m_num_workers(workers)
+  {
+    if (!workers)
+      throw std::runtime_error("xrt::queue requires at least one worker");
 
-  // Shut down worker thread
+    m_workers.reserve(workers);
+    for (unsigned int i = 0; i < workers; ++i)
+      m_workers.emplace_back([this] { run(); });
+  }
+
+  // Shut down worker threads
   ~queue_impl()
   {
+    if (m_registered) {
+      std::lock_guard lk(dependent_queues_mutex);
+      dependent_queues.erase(this);
+    }
+
     {
       std::lock_guard lk(m_mutex);
       m_stop = true;
-      m_work.notify_one();
+      waiting_tasks -= m_waiting;
+      m_work.notify_all();
     }
-    m_worker.join();
+
+    for (auto& worker : m_workers)
+      worker.join();
   }
 
   queue_impl(const queue_impl&) = delete;
@@ -81,12 +232,52 @@ public:
   queue_impl& operator=(const queue_impl&) = delete;
   queue_impl& operator=(queue_impl&&) = delete;
 
+  // Wake workers to check dependencies of waiting tasks
+  void
+  wake()
+  {
+    std::lock_guard lk(m_mutex);
+    if (m_waiting)
+      m_work.notify_all();
+  }
+
   // Enqueue a task and notify worker
   void
   enqueue(queue::task&& t)
   {
     std::lock_guard lk(m_mutex);
-    m_queue.push(std::move(t));
+    push({{}, std::move(t), false});
+    m_work.notify_one();
+  }
+
+  // Enqueue a task that depends on an event and notify worker
+  void
+  enqueue(queue::event&& ev, queue::task&& t)
+  {
+    if (ev.ready()) {
+      std::lock_guard lk(m_mutex);
+      push({std::move(ev), std::move(t), false});
+      m_work.notify_one();
+      return;
+    }
+
+    // register outside of m_mutex, lock order is dependent_queues_mutex
+    // before m_mutex
+    bool registered = false;
+    {
+      std::lock_guard lk(m_mutex);
+      registered = m_registered;
+      m_registered = true;
+    }
+    if (!registered) {
+      std::lock_guard lk(dependent_queues_mutex);
+      dependent_queues.insert(this);
+    }
+
+    std::lock_guard lk(m_mutex);
+    push({std::move(ev), std::move(t), true});
+    ++m_waiting;
+    ++waiting_tasks;
     m_work.notify_one();
   }
 };
@@ -100,7 +291,12 @@ namespace xrt {
 
 queue::
 queue()
-  : m_impl(std::make_shared<queue_impl>())
+  : m_impl(std::make_shared<queue_impl>(1))
+{}
+
+queue::
+queue(unsigned int workers)
+  : m_impl(std::make_shared<queue_impl>(workers))
 {}
 
 void
@@ -110,4 +306,11 @@ add_task(task&& t)
   m_impl->enqueue(std::move(t));
 }
 
+void
+queue::
+add_task(event&& ev, task&& t)
+{
+  m_impl->enqueue(std::move(ev), std::move(t));
+}
+
 } // xrt
@@ -308,6 +308,15 @@ get_native_xrt_trace()
   return value;
 }
 
+// Comma separated list of native API categories to trace when
+// native_xrt_trace is enabled: all, generic, run, bo, sync
+inline std::string
+get_native_xrt_trace_categories()
+{
+  static std::string value = detail::get_string_value("Debug.native_xrt_trace_categories", "all");
+  return value;
+}
+
 inline bool
 get_opencl_trace()
 {
@@ -371,6 +380,39 @@ get_logging()
   return value;
 }
 
+/**
+ * Format messages logged to console or file, "text" or "json" for
+ * one JSON object per line
+ */
+inline std::string
+get_logging_format()
+{
+  static std::string value = detail::get_string_value("Runtime.runtime_log_format","text");
+  return value;
+}
+
+/**
+ * Log messages from a background thread, the sending thread only
+ * records the message
+ */
+inline bool
+get_logging_async()
+{
+  static bool value = detail::get_bool_value("Runtime.runtime_log_async",false);
+  return value;
+}
+
+/**
+ * Number of messages buffered per sending thread when logging
+ * asynchronously, messages sent to a full buffer are dropped
+ */
+inline unsigned int
+get_logging_async_buffer()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.runtime_log_async_buffer",1024);
+  return value;
+}
+
 inline bool
 get_trace_logging()
 {
@@ -600,6 +642,64 @@ get_noop_completion_delay_us()
   return delay;
 }
 
+/**
+ * Number of devices simulated by the noop shim
+ */
+inline unsigned int
+get_noop_devices()
+{
+  static unsigned int devices = detail::get_uint_value("Runtime.noop_devices", 1);
+  return devices;
+}
+
+/**
+ * Number of threads xrt-smi examine uses to collect reports, a value
+ * of 1 collects reports serially
+ */
+inline unsigned int
+get_examine_workers()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.examine_workers", 8);
+  return value;
+}
+
+/**
+ * Time in ms xrt-smi examine waits for a report once its collection
+ * has started, a report not collected in time fails.  0 waits
+ * indefinitely.  The timeout applies to a report as a whole, not to
+ * the individual queries of the report.  The threads of reports that
+ * timed out are abandoned when the output has been written, xrt-smi
+ * exits without waiting for them.
+ */
+inline unsigned int
+get_examine_timeout_ms()
+{
+  static unsigned int value = detail::get_uint_value("Runtime.examine_timeout_ms", 30000);
+  return value;
+}
+
+/**
+ * When true, xrt-smi examine runs a query shared by several reports
+ * once and reuses its result
+ */
+inline bool
+get_examine_query_cache()
+{
+  static bool value = detail::get_bool_value("Runtime.examine_query_cache", true);
+  return value;
+}
+
+/**
+ * When true, xbmgmt program writes only the flash sectors that differ
+ * from the new image rather than the whole image
+ */
+inline bool
+get_flash_delta()
+{
+  static bool value = detail::get_bool_value("Runtime.flash_delta", false);
+  return value;
+}
+
 /**
  * Set CMD BO cache size. CUrrently it is only used in xclCopyBO()
  */
@@ -732,6 +832,35 @@ get_hardware_context_type()
   return value;
 }
 
+/**
+ * Share control code buffers without patch sites between run
+ * instances of the same module within a hardware context
+ */
+inline bool
+get_share_module_buffers()
+{
+  static bool value = detail::get_bool_value("Runtime.share_module_buffers", false);
+  return value;
+}
+
+/**
+ * Tracking of host modifications to HIP host and registered memory
+ * used as kernel arguments.  Only modified ranges are synced to the
+ * device when a kernel is launched.
+ *
+ * none:     whole buffer is synced on every launch
+ * explicit: ranges written by HIP copy and set APIs are tracked, host
+ *           must not write the memory directly through its pointer
+ * mprotect: in addition pages are write protected after sync and
+ *           write faults mark pages modified (Linux only)
+ */
+inline std::string
+get_hip_host_mem_tracking()
+{
+  static std::string value = detail::get_string_value("Runtime.hip_host_mem_tracking", "none");
+  return value;
+}
+
 inline bool
 get_is_enable_prep_target()
 {
@@ -25,6 +25,7 @@
 #include <boost/format.hpp>
 #include <functional>
 #include <exception>
+#include <future>
 #include <string>
 #include <utility>
 #include <vector>
@@ -69,6 +70,47 @@ is_nodma() const
   return *m_nodma;
 }
 
+void
+device::
+enable_query_cache(bool enable)
+{
+  std::lock_guard lk(m_query_cache_mutex);
+  m_query_cache_enabled = enable;
+  if (!enable)
+    m_query_cache.clear();
+}
+
+std::any
+device::
+cached_query(query::key_type query_key) const
+{
+  std::promise<std::any> promise;
+  std::shared_future<std::any> result;
+  bool owner = false;
+  {
+    std::lock_guard lk(m_query_cache_mutex);
+    auto& entry = m_query_cache[query_key];
+    if (!entry.valid()) {
+      entry = promise.get_future().share();
+      owner = true;
+    }
+    result = entry;
+  }
+
+  // First caller runs the query, other callers wait for its result
+  if (owner) {
+    try {
+      auto& qr = lookup_query(query_key);
+      promise.set_value(qr.get(this));
+    }
+    catch (...) {
+      promise.set_exception(std::current_exception());
+    }
+  }
+
+  return result.get();
+}
+
 uuid
 device::
 get_xclbin_uuid() const
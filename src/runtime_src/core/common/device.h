@@ -19,11 +19,14 @@
 #include "core/include/xrt/experimental/xrt_xclbin.h"
 
 #include <any>
+#include <atomic>
 #include <cstdint>
+#include <future>
 #include <vector>
 #include <string>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <boost/property_tree/ptree.hpp>
 #include <boost/optional/optional.hpp>
 
@@ -200,6 +203,10 @@ public:
   virtual const query::request&
   lookup_query(query::key_type query_key) const = 0;
 
+  XRT_CORE_COMMON_EXPORT
+  std::any
+  cached_query(query::key_type query_key) const;
+
 public:
   /**
    * query() - Query the device for specific property
@@ -211,6 +218,9 @@ public:
   std::any
   query() const
   {
+    if (m_query_cache_enabled)
+      return cached_query(QueryRequestType::key);
+
     auto& qr = lookup_query(QueryRequestType::key);
     return qr.get(this);
   }
@@ -230,6 +240,38 @@ public:
     return qr.get(this, std::forward<Args>(args)...);
   }
 
+  /**
+   * query() - Query the device for a property identified by key
+   *
+   * @query_key: Key of a query request that takes no arguments
+   * Return: result_type value of the request wrapped as std::any.
+   *
+   * For requests not known at compile time, e.g. a list of sensor keys
+   */
+  std::any
+  query(query::key_type query_key) const
+  {
+    if (m_query_cache_enabled)
+      return cached_query(query_key);
+
+    auto& qr = lookup_query(query_key);
+    return qr.get(this);
+  }
+
+  /**
+   * enable_query_cache() - Memoize results of queries without arguments
+   *
+   * @enable: true to start caching, false to drop cached results
+   *
+   * Used by tools where several reports issue the same queries within
+   * one invocation.  Each query runs once, concurrent callers of a
+   * query in progress wait for its result.  Exceptions are cached as
+   * results.
+   */
+  XRT_CORE_COMMON_EXPORT
+  void
+  enable_query_cache(bool enable);
+
   /**
    * update() - Update a given property for this device
    *
@@ -485,6 +527,11 @@ public:
   xclbin_map m_xclbins;                       // currently loaded xclbins (multi-slot)
   mutable std::mutex m_mutex;
   std::shared_ptr<usage_metrics::base_logger> m_usage_logger = usage_metrics::get_usage_metrics_logger();
+
+  // Results of queries without arguments, see enable_query_cache()
+  std::atomic<bool> m_query_cache_enabled {false};
+  mutable std::mutex m_query_cache_mutex;
+  mutable std::map<query::key_type, std::shared_future<std::any>> m_query_cache;
 };
 
 /**
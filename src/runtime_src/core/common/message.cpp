@@ -27,8 +27,15 @@
 #include <thread>
 #include <mutex>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdarg>
 #include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
 #ifdef __linux__
 # include <syslog.h>
 # include <linux/limits.h>
@@ -65,6 +72,83 @@ get_exe_path()
 
 
 using severity_level = xrt_core::message::severity_level;
+using time_point = std::chrono::system_clock::time_point;
+
+// No static map such that messages written at exit, after static
+// destruction has started, can be named
+static const char*
+severity_name(severity_level l)
+{
+  switch (l) {
+  case severity_level::emergency: return "emergency";
+  case severity_level::alert:     return "alert";
+  case severity_level::critical:  return "critical";
+  case severity_level::error:     return "error";
+  case severity_level::warning:   return "warning";
+  case severity_level::notice:    return "notice";
+  case severity_level::info:      return "info";
+  case severity_level::debug:     return "debug";
+  }
+  return "unknown";
+}
+
+// Write str as the body of a JSON string
+static void
+write_json_string(std::ostream& ostr, const char* str)
+{
+  for (auto c = str; *c; ++c) {
+    switch (*c) {
+    case '"':  ostr << "\\\""; break;
+    case '\\': ostr << "\\\\"; break;
+    case '\n': ostr << "\\n";  break;
+    case '\r': ostr << "\\r";  break;
+    case '\t': ostr << "\\t";  break;
+    default:
+      if (static_cast<unsigned char>(*c) < 0x20) {
+        char buf[8] = {0};
+        std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned int>(*c));
+        ostr << buf;
+      }
+      else
+        ostr << *c;
+    }
+  }
+}
+
+// One JSON object per message, used by console and file dispatch
+static void
+write_json(std::ostream& ostr, severity_level l, const char* tag, const char* msg,
+           time_point time, std::thread::id tid)
+{
+  ostr << "{\"time\":\"" << xrt_core::timestamp_iso8601(time)
+       << "\",\"level\":\"" << severity_name(l)
+       << "\",\"tag\":\"";
+  write_json_string(ostr, tag);
+  ostr << "\",\"pid\":" << xrt_core::utils::get_pid()
+       << ",\"tid\":\"" << tid
+       << "\",\"msg\":\"";
+  write_json_string(ostr, msg);
+  ostr << "\"}\n";
+}
+
+// Build and process information as one JSON object
+static void
+write_json_header(std::ostream& ostr)
+{
+  ostr << "{\"time\":\"" << xrt_core::timestamp_iso8601(std::chrono::system_clock::now())
+       << "\",\"level\":\"info\",\"tag\":\"XRT\""
+       << ",\"pid\":" << xrt_core::utils::get_pid()
+       << ",\"uid\":" << get_userid()
+       << ",\"host\":\"";
+  write_json_string(ostr, xrt_core::utils::get_hostname().c_str());
+  ostr << "\",\"exe\":\"";
+  write_json_string(ostr, get_exe_path().c_str());
+  ostr << "\",\"build_version\":\"" << xrt_build_version
+       << "\",\"build_hash\":\"" << xrt_build_version_hash
+       << "\",\"build_date\":\"" << xrt_build_version_date
+       << "\",\"git_branch\":\"" << xrt_build_version_branch
+       << "\"}" << std::endl;
+}
 
 //--
 class message_dispatch
@@ -74,7 +158,19 @@ public:
   virtual ~message_dispatch() {}
   static message_dispatch* make_dispatcher(const std::string& choice);
 public:
-  virtual void send(severity_level l, const char* tag, const char* msg) = 0;
+  // Message is sent at time from thread tid
+  virtual void send(severity_level l, const char* tag, const char* msg,
+                    time_point time, std::thread::id tid) = 0;
+
+  // Flush messages written since last flush
+  virtual void flush() {}
+
+  // When batched, the dispatcher does not flush each message but
+  // relies on the caller to flush
+  void set_batched(bool batched) { m_batched = batched; }
+
+protected:
+  std::atomic<bool> m_batched {false};
 };
 
 //--
@@ -83,17 +179,22 @@ class null_dispatch : public message_dispatch
 public:
   null_dispatch() {}
   virtual ~null_dispatch() {}
-  virtual void send(severity_level, const char*, const char*) {};
+  virtual void send(severity_level, const char*, const char*, time_point, std::thread::id) {};
 };
 
 //--
 class console_dispatch : public message_dispatch
 {
 public:
-  console_dispatch();
+  explicit
+  console_dispatch(bool json);
   virtual ~console_dispatch() {}
-  virtual void send(severity_level l, const char* tag, const char* msg) override;
+  virtual void send(severity_level l, const char* tag, const char* msg,
+                    time_point time, std::thread::id tid) override;
+  virtual void flush() override;
 private:
+  bool m_json;
+  std::mutex m_mutex;
   std::map<severity_level, const char*> severityMap = {
     { severity_level::emergency, "EMERGENCY: "},
     { severity_level::alert,     "ALERT: "},
@@ -117,7 +218,8 @@ public:
   virtual ~syslog_dispatch()
   { closelog(); }
 
-  virtual void send(severity_level l, const char* tag, const char* msg) override
+  virtual void send(severity_level l, const char*, const char* msg,
+                    time_point, std::thread::id) override
   { syslog(severityMap[l], "%s", msg); }
 
 private:
@@ -138,11 +240,14 @@ private:
 class file_dispatch : public message_dispatch
 {
 public:
-  explicit
-  file_dispatch(const std::string& file);
+  file_dispatch(const std::string& file, bool json);
   virtual ~file_dispatch();
-  virtual void send(severity_level l, const char* tag, const char* msg) override;
+  virtual void send(severity_level l, const char* tag, const char* msg,
+                    time_point time, std::thread::id tid) override;
+  virtual void flush() override;
 private:
+  bool m_json;
+  std::mutex m_mutex;
   std::ofstream handle;
   std::map<severity_level, const char*> severityMap = {
     { severity_level::emergency, "EMERGENCY: "},
@@ -156,18 +261,103 @@ private:
   };
 };
 
+//--
+// Messages are recorded by the sending thread into a buffer owned by
+// that thread and written by a background thread.  Each buffer has one
+// producer and one consumer and requires no lock.  Messages sent to a
+// full buffer are dropped and counted, the count is logged by the
+// background thread.
+class async_dispatch : public message_dispatch
+{
+public:
+  async_dispatch(message_dispatch* sink, size_t capacity);
+  virtual ~async_dispatch();
+  virtual void send(severity_level l, const char* tag, const char* msg,
+                    time_point time, std::thread::id tid) override;
+
+  // Write remaining messages and stop the background thread,
+  // messages sent after stop are written synchronously
+  void stop();
+
+private:
+  struct record
+  {
+    severity_level level;
+    std::string tag;
+    std::string msg;
+    time_point time;
+    std::thread::id tid;
+  };
+
+  // Single producer single consumer ring of records.  Records are
+  // reused such that string capacity is retained.
+  struct ring
+  {
+    std::vector<record> slots;
+    std::atomic<size_t> head {0};       // written by producer
+    std::atomic<size_t> tail {0};       // written by consumer
+    std::atomic<bool> orphaned {false}; // producer thread has exited
+
+    explicit
+    ring(size_t capacity) : slots(capacity) {}
+  };
+
+  // Ring of calling thread, marked orphaned on thread exit.  The
+  // trivially destructible flag records that the holder of the thread
+  // is destroyed, messages the thread sends after that, e.g. from
+  // static destructors of the main thread, are written synchronously.
+  struct ring_holder
+  {
+    inline static thread_local bool destroyed = false;
+    std::shared_ptr<ring> buffer;
+    ~ring_holder()
+    {
+      if (buffer)
+        buffer->orphaned = true;
+      destroyed = true;
+    }
+  };
+
+  // Ring of calling thread, nullptr if the holder of the thread is
+  // destroyed
+  ring*
+  thread_ring();
+
+  // Write all recorded messages in time order
+  void
+  write_batch();
+
+  void
+  run();
+
+  message_dispatch* m_sink;
+  size_t m_capacity;
+  std::mutex m_rings_mutex;                  // registration of rings
+  std::vector<std::shared_ptr<ring>> m_rings;
+  std::atomic<uint64_t> m_dropped {0};
+  uint64_t m_dropped_reported = 0;
+  std::atomic<bool> m_stop {false};
+  std::atomic<unsigned int> m_senders {0};   // threads recording a message
+  std::mutex m_wait_mutex;
+  std::condition_variable m_wait;
+  bool m_wake = false;                       // write batch now, guarded by m_wait_mutex
+  std::thread m_thread;
+};
+
 //-------
 message_dispatch*
 message_dispatch::
 make_dispatcher(const std::string& choice)
 {
+  bool json = (xrt_core::config::get_logging_format() == "json");
+  message_dispatch* dispatcher = nullptr;
   if( (choice == "null") || (choice == ""))
     return new null_dispatch;
   else if(choice == "console")
-    return new console_dispatch;
+    dispatcher = new console_dispatch(json);
   else if(choice == "syslog") {
 #ifndef _WIN32
-    return new syslog_dispatch;
+    dispatcher = new syslog_dispatch;
 #else
     throw std::runtime_error("syslog not supported on windows");
 #endif
@@ -177,18 +367,35 @@ make_dispatcher(const std::string& choice)
       std::string file = choice;
       file.erase(0, 1);
       file.erase(file.size()-1);
-      return new file_dispatch(file);
+      dispatcher = new file_dispatch(file, json);
     }
     else
-      return new file_dispatch(choice);
+      dispatcher = new file_dispatch(choice, json);
   }
+
+  if (!xrt_core::config::get_logging_async())
+    return dispatcher;
+
+  // Remaining messages are written at exit, the dispatcher is not
+  // deleted such that messages sent during static destruction are
+  // still written
+  static async_dispatch* async = nullptr;
+  async = new async_dispatch(dispatcher, xrt_core::config::get_logging_async_buffer());
+  std::atexit([] { async->stop(); });
+  return async;
 }
 
 //file ops
 file_dispatch::
-file_dispatch(const std::string &file)
+file_dispatch(const std::string &file, bool json)
+  : m_json(json)
 {
   handle.open(file.c_str());
+  if (m_json) {
+    write_json_header(handle);
+    return;
+  }
+
   handle << "XRT build version: " << xrt_build_version << "\n";
   handle << "Build hash: " << xrt_build_version_hash << "\n";
   handle << "Build date: " << xrt_build_version_date << "\n";
@@ -206,19 +413,38 @@ file_dispatch::~file_dispatch() {
 
 void
 file_dispatch::
-send(severity_level l, const char* tag, const char* msg)
+send(severity_level l, const char* tag, const char* msg, time_point time, std::thread::id tid)
 {
-  static std::mutex mutex;
-  std::lock_guard<std::mutex> lk(mutex);
-  handle << "[" << xrt_core::timestamp() <<"] [" << tag << "] Tid: "
-         << std::this_thread::get_id() << ", " << " " << severityMap[l]
-         << msg << std::endl;
+  std::lock_guard<std::mutex> lk(m_mutex);
+  if (m_json)
+    write_json(handle, l, tag, msg, time, tid);
+  else
+    handle << "[" << xrt_core::timestamp(time) <<"] [" << tag << "] Tid: "
+           << tid << ", " << " " << severityMap[l]
+           << msg << "\n";
+
+  if (!m_batched)
+    handle.flush();
+}
+
+void
+file_dispatch::
+flush()
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  handle.flush();
 }
 
 //console ops
 console_dispatch::
-console_dispatch()
+console_dispatch(bool json)
+  : m_json(json)
 {
+  if (m_json) {
+    write_json_header(std::cerr);
+    return;
+  }
+
   std::cerr << "XRT build version: " << xrt_build_version << "\n";
   std::cerr << "Build hash: " << xrt_build_version_hash << "\n";
   std::cerr << "Build date: " << xrt_build_version_date << "\n";
@@ -232,12 +458,186 @@ console_dispatch()
 
 void
 console_dispatch::
-send(severity_level l, const char* tag, const char* msg)
+send(severity_level l, const char* tag, const char* msg, time_point time, std::thread::id tid)
 {
-  static std::mutex mutex;
-  std::lock_guard<std::mutex> lk(mutex);
-  std::cerr << "[" << tag << "] " << severityMap[l]
-            << msg << std::endl;
+  std::lock_guard<std::mutex> lk(m_mutex);
+  if (m_json)
+    write_json(std::cerr, l, tag, msg, time, tid);
+  else
+    std::cerr << "[" << tag << "] " << severityMap[l]
+              << msg << "\n";
+
+  if (!m_batched)
+    std::cerr.flush();
+}
+
+void
+console_dispatch::
+flush()
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  std::cerr.flush();
+}
+
+//async ops
+async_dispatch::
+async_dispatch(message_dispatch* sink, size_t capacity)
+  : m_sink(sink)
+  , m_capacity(std::max<size_t>(capacity, 1))
+{
+  m_sink->set_batched(true);
+  m_thread = std::thread([this] { run(); });
+}
+
+async_dispatch::
+~async_dispatch()
+{
+  stop();
+}
+
+async_dispatch::ring*
+async_dispatch::
+thread_ring()
+{
+  if (ring_holder::destroyed)
+    return nullptr;
+
+  static thread_local ring_holder holder;
+  if (!holder.buffer) {
+    holder.buffer = std::make_shared<ring>(m_capacity);
+    std::lock_guard<std::mutex> lk(m_rings_mutex);
+    m_rings.push_back(holder.buffer);
+  }
+  return holder.buffer.get();
+}
+
+void
+async_dispatch::
+send(severity_level l, const char* tag, const char* msg, time_point time, std::thread::id tid)
+{
+  // stop() waits for senders that did not see m_stop before it writes
+  // the last batch
+  ++m_senders;
+  auto buffer = m_stop ? nullptr : thread_ring();
+  if (!buffer) {
+    --m_senders;
+    m_sink->send(l, tag, msg, time, tid);
+    m_sink->flush();
+    return;
+  }
+
+  auto head = buffer->head.load(std::memory_order_relaxed);
+  if (head - buffer->tail.load(std::memory_order_acquire) == buffer->slots.size()) {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+    --m_senders;
+    return;
+  }
+
+  auto& slot = buffer->slots[head % buffer->slots.size()];
+  slot.level = l;
+  slot.tag.assign(tag);
+  slot.msg.assign(msg);
+  slot.time = time;
+  slot.tid = tid;
+  buffer->head.store(head + 1, std::memory_order_release);
+  --m_senders;
+
+  // Severe messages are written without waiting for the next batch
+  if (l <= severity_level::error) {
+    {
+      std::lock_guard<std::mutex> lk(m_wait_mutex);
+      m_wake = true;
+    }
+    m_wait.notify_one();
+  }
+}
+
+void
+async_dispatch::
+write_batch()
+{
+  std::vector<std::shared_ptr<ring>> rings;
+  {
+    std::lock_guard<std::mutex> lk(m_rings_mutex);
+    rings = m_rings;
+  }
+
+  // Records of all rings in time order, records of one thread stay in
+  // send order
+  std::vector<const record*> records;
+  std::vector<size_t> heads(rings.size());
+  for (size_t idx = 0; idx < rings.size(); ++idx) {
+    auto& buffer = *rings[idx];
+    heads[idx] = buffer.head.load(std::memory_order_acquire);
+    for (auto tail = buffer.tail.load(std::memory_order_relaxed); tail != heads[idx]; ++tail)
+      records.push_back(&buffer.slots[tail % buffer.slots.size()]);
+  }
+  std::stable_sort(records.begin(), records.end(),
+                   [](const record* a, const record* b) { return a->time < b->time; });
+
+  for (auto rec : records)
+    m_sink->send(rec->level, rec->tag.c_str(), rec->msg.c_str(), rec->time, rec->tid);
+
+  auto dropped = m_dropped.load(std::memory_order_relaxed);
+  if (dropped != m_dropped_reported) {
+    auto msg = std::to_string(dropped - m_dropped_reported)
+      + " message(s) dropped, increase Runtime.runtime_log_async_buffer";
+    m_sink->send(severity_level::warning, "XRT", msg.c_str(),
+                 std::chrono::system_clock::now(), std::this_thread::get_id());
+    m_dropped_reported = dropped;
+  }
+
+  if (!records.empty() || dropped)
+    m_sink->flush();
+
+  for (size_t idx = 0; idx < rings.size(); ++idx)
+    rings[idx]->tail.store(heads[idx], std::memory_order_release);
+
+  // Release rings of exited threads once written
+  std::lock_guard<std::mutex> lk(m_rings_mutex);
+  m_rings.erase(std::remove_if(m_rings.begin(), m_rings.end(),
+                               [](const std::shared_ptr<ring>& buffer) {
+                                 return buffer->orphaned
+                                   && buffer->tail.load() == buffer->head.load();
+                               }),
+                m_rings.end());
+}
+
+void
+async_dispatch::
+run()
+{
+  constexpr std::chrono::milliseconds batch_interval{10};
+  while (!m_stop) {
+    {
+      std::unique_lock<std::mutex> lk(m_wait_mutex);
+      m_wait.wait_for(lk, batch_interval, [this] { return m_stop || m_wake; });
+      m_wake = false;
+    }
+    write_batch();
+  }
+}
+
+void
+async_dispatch::
+stop()
+{
+  {
+    std::lock_guard<std::mutex> lk(m_wait_mutex);
+    if (m_stop)
+      return;
+    m_stop = true;
+  }
+  m_wait.notify_one();
+  if (m_thread.joinable())
+    m_thread.join();
+
+  // Messages recorded after the last batch, including those of senders
+  // that did not see m_stop
+  while (m_senders)
+    std::this_thread::yield();
+  write_batch();
+  m_sink->set_batched(false);
 }
 
 } //end unnamed namespace
@@ -253,7 +653,7 @@ send(severity_level l, const char* tag, const char* msg)
 
   if(ver >= lev) {
     static message_dispatch* dispatcher = message_dispatch::make_dispatcher(logger);
-    dispatcher->send(l, tag, msg);
+    dispatcher->send(l, tag, msg, std::chrono::system_clock::now(), std::this_thread::get_id());
   }
 }
 
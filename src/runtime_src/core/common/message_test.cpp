@@ -0,0 +1,160 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+/*
+ * Asynchronous JSON lines message logging.
+ *
+ * The test runs itself as a child process that logs through
+ * xrt_core::message with runtime_log_async and runtime_log_format=json
+ * into a file, using a small buffer such that messages are dropped.
+ * The log is checked once the child has exited:
+ *  - messages of each thread are in send order
+ *  - written and dropped messages add up to the messages sent
+ *  - strings are escaped
+ *  - a message sent from a static destructor is written
+ *
+ * % message_test
+ */
+#include "core/common/message.h"
+#include "core/common/test_util.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using severity_level = xrt_core::message::severity_level;
+
+constexpr int threads = 4;
+constexpr int messages = 2000;
+
+// Message with every kind of character that is escaped
+constexpr const char* escape_msg = "quote \" backslash \\ newline \n tab \t ctl \x01 end";
+constexpr const char* escape_json = "\"tag\":\"tag \\\"x\\\"\",";
+constexpr const char* escape_msg_json = "\"msg\":\"quote \\\" backslash \\\\ newline \\n tab \\t ctl \\u0001 end\"}";
+
+// Sends a message after thread local storage of the main thread is
+// destroyed.  Constructed after the first message such that it is
+// destroyed before the asynchronous logger is stopped at exit.
+struct late_sender
+{
+  ~late_sender()
+  {
+    xrt_core::message::send(severity_level::info, "late", "static destructor");
+  }
+};
+
+void
+child()
+{
+  std::vector<std::thread> senders;
+  for (int thread = 0; thread < threads; ++thread) {
+    senders.emplace_back([thread] {
+      for (int seq = 0; seq < messages; ++seq) {
+        auto msg = "t" + std::to_string(thread) + " " + std::to_string(seq);
+        xrt_core::message::send(severity_level::info, "test", msg);
+      }
+    });
+  }
+  for (auto& sender : senders)
+    sender.join();
+
+  xrt_core::message::send(severity_level::error, "tag \"x\"", escape_msg);
+  static late_sender late;
+}
+
+// Value of string field key in a JSON line
+std::string
+field(const std::string& line, const std::string& key)
+{
+  auto start = line.find("\"" + key + "\":\"");
+  if (start == std::string::npos)
+    throw std::runtime_error("no " + key + " in: " + line);
+  start += key.size() + 4;
+  return line.substr(start, line.find('"', start) - start);
+}
+
+void
+check_log(const std::string& log_file)
+{
+  std::ifstream in(log_file);
+  std::string line;
+  if (!std::getline(in, line) || line.find("\"build_version\"") == std::string::npos)
+    throw std::runtime_error("missing header");
+
+  std::map<int, int> next;  // next sequence number per thread
+  int written = 0;
+  int dropped = 0;
+  bool escaped = false;
+  bool late = false;
+  while (std::getline(in, line)) {
+    if (line.front() != '{' || line.back() != '}')
+      throw std::runtime_error("not a JSON object: " + line);
+
+    auto msg = field(line, "msg");
+    if (field(line, "tag") == "test") {
+      // t<thread> <seq>
+      auto thread = std::stoi(msg.substr(1));
+      auto seq = std::stoi(msg.substr(msg.find(' ') + 1));
+      if (seq < next[thread])
+        throw std::runtime_error("out of order: " + line);
+      next[thread] = seq + 1;
+      ++written;
+    }
+    else if (field(line, "tag") == "late")
+      late = true;
+    else if (msg.find("message(s) dropped") != std::string::npos)
+      dropped += std::stoi(msg);
+    else if (line.find(escape_json) != std::string::npos && line.find(escape_msg_json) != std::string::npos)
+      escaped = true;
+    else
+      throw std::runtime_error("unexpected message: " + line);
+  }
+
+  std::cout << written << " written, " << dropped << " dropped\n";
+  if (written + dropped != threads * messages)
+    throw std::runtime_error("written and dropped messages do not add up to "
+                             + std::to_string(threads * messages));
+  if (!escaped)
+    throw std::runtime_error("escaped message not found");
+  if (!late)
+    throw std::runtime_error("message from static destructor not found");
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  if (argc > 1) {
+    child();
+    return 0;
+  }
+
+  return xrt_core::test_util::run_main([argv] {
+    // The child inherits XRT_INI_PATH
+    auto log_file = xrt_core::test_util::temp_path("message_test.log").string();
+    xrt_core::test_util::ini_file ini("message_test",
+      "[Runtime]\n"
+      "verbosity=7\n"
+      "runtime_log=" + log_file + "\n"
+      "runtime_log_format=json\n"
+      "runtime_log_async=true\n"
+      "runtime_log_async_buffer=16\n");
+
+    auto cmd = std::string(argv[0]) + " child"; // NOLINT
+    if (std::system(cmd.c_str()) != 0)
+      throw std::runtime_error(cmd + " failed");
+
+    check_log(log_file);
+    std::remove(log_file.c_str());
+    return 0;
+  });
+}
@@ -197,4 +197,28 @@ to_ert_status(const result_type& strs)
   return ert_status;
 }
 
+xrt_core::query::sensor_snapshot::data_type
+xrt_core::query::sensor_snapshot::
+to_data(const std::any& value)
+{
+  data_type data;
+  if (auto v = std::any_cast<uint64_t>(&value))
+    data.value = *v;
+  else if (auto v = std::any_cast<uint32_t>(&value))
+    data.value = *v;
+  else if (auto v = std::any_cast<uint16_t>(&value))
+    data.value = *v;
+  else if (auto v = std::any_cast<uint8_t>(&value))
+    data.value = *v;
+  else if (auto v = std::any_cast<int64_t>(&value))
+    data.value = static_cast<uint64_t>(*v);
+  else if (auto v = std::any_cast<int32_t>(&value))
+    data.value = static_cast<uint64_t>(*v);
+  else if (auto v = std::any_cast<bool>(&value))
+    data.value = *v ? 1 : 0;
+  else
+    data.error = "query result is not a scalar sensor value";
+  return data;
+}
+
 }} // query, xrt_core
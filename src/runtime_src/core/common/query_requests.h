@@ -12,6 +12,8 @@
 #include "core/common/shim/hwctx_handle.h"
 #include "core/include/xclerr_int.h"
 
+#include <any>
+#include <chrono>
 #include <cstdint>
 #include <iomanip>
 #include <map>
@@ -329,6 +331,7 @@ enum class key_type
   kernel_max_bandwidth_mbps,
   sub_device_path,
   read_trace_data,
+  sensor_snapshot,
   noop
 };
 
@@ -4018,6 +4021,44 @@ struct read_trace_data : request
   virtual std::any
   get(const device*, const std::any&) const override = 0;
 };
+
+/**
+ * sensor_snapshot - Read a declared set of scalar sensors in one call
+ *
+ * The argument lists the keys of the sensor queries to read.  The
+ * result has one entry per key in the same order.  A sensor that
+ * cannot be read has a non empty error and a value of 0.
+ *
+ * Values read less than max_age ago may be returned from a cache
+ * maintained by the backend, 0 forces a read of every sensor.
+ *
+ * Backends that keep sensor files open implement this request
+ * directly, otherwise use xrt_core::sensor::read_snapshot which falls
+ * back on one query per key.
+ */
+struct sensor_snapshot : request
+{
+  struct args {
+    std::vector<key_type> keys;
+    std::chrono::milliseconds max_age {0};
+  };
+
+  struct data_type {
+    uint64_t value = 0;
+    std::string error;
+  };
+
+  using result_type = std::vector<data_type>;
+  static const key_type key = key_type::sensor_snapshot;
+
+  virtual std::any
+  get(const device*, const std::any&) const override = 0;
+
+  // Convert result of a scalar query request to a snapshot value
+  XRT_CORE_COMMON_EXPORT
+  static data_type
+  to_data(const std::any& value);
+};
 } // query
 
 } // xrt_core
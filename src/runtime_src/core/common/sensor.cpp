@@ -21,8 +21,10 @@
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/algorithm/string.hpp>
 
-#include <sstream>
 #include <iomanip>
+#include <optional>
+#include <sstream>
+#include <vector>
 
 // Too much typing
 using ptree_type = boost::property_tree::ptree;
@@ -30,16 +32,19 @@ namespace xq = xrt_core::query;
 
 
 namespace {
+
+using sensor_data = xq::sensor_snapshot::data_type;
+
 // Saves voltage-current pair of a sensor into a boost::property_tree
 // Converts mV and mA into V and A before adding to the tree
 //
-// @tparam QRVoltage voltage query for a sensor; query::noop if query DNE
-// @tparam QRCurrent current query for the same sensor; query::noop if query DNE
+// @param voltage snapshot of voltage sensor; nullptr if sensor DNE
+// @param current snapshot of current sensor; nullptr if sensor DNE
 // @param loc_id human readable sensor identifier
 // @desc description about the sensor
-template <typename QRVoltage, typename QRCurrent>
 static ptree_type
-populate_sensor(const xrt_core::device * device,
+populate_sensor(const sensor_data* voltage,
+                const sensor_data* current,
                 const std::string& loc_id,
                 const std::string& desc)
 {
@@ -47,50 +52,34 @@ populate_sensor(const xrt_core::device * device,
   pt.put("id", loc_id);
   pt.put("description", desc);
 
-  uint64_t voltage = 0;
-  uint64_t current = 0;
-  try {
-    if (!std::is_same<QRVoltage, xq::noop>::value)
-      voltage = xrt_core::device_query<QRVoltage>(device);
-  }
-  catch (const std::exception& ex) {
-    pt.put("voltage.error_msg", ex.what());
-  }
-  pt.put("voltage.volts", xrt_core::utils::format_base10_shiftdown3(voltage));
-  pt.put("voltage.is_present", voltage != 0 ? "true" : "false");
+  uint64_t volts = voltage ? voltage->value : 0;
+  if (voltage && !voltage->error.empty())
+    pt.put("voltage.error_msg", voltage->error);
+  pt.put("voltage.volts", xrt_core::utils::format_base10_shiftdown3(volts));
+  pt.put("voltage.is_present", volts != 0 ? "true" : "false");
 
-  try {
-    if (!std::is_same<QRCurrent, xq::noop>::value)
-      current = xrt_core::device_query<QRCurrent>(device);
-  }
-  catch (const std::exception& ex) {
-    pt.put("current.error_msg", ex.what());
-  }
-  pt.put("current.amps", xrt_core::utils::format_base10_shiftdown3(current));
-  pt.put("current.is_present", current != 0 ? "true" : "false");
+  uint64_t amps = current ? current->value : 0;
+  if (current && !current->error.empty())
+    pt.put("current.error_msg", current->error);
+  pt.put("current.amps", xrt_core::utils::format_base10_shiftdown3(amps));
+  pt.put("current.is_present", amps != 0 ? "true" : "false");
 
   return pt;
 }
 
-template <typename QueryRequestType>
 static ptree_type
-populate_temp(const xrt_core::device * device,
+populate_temp(const sensor_data& temp,
               const std::string& loc_id,
               const std::string& desc)
 {
   ptree_type pt;
-  uint64_t temp_C = 0;
-  try {
-    temp_C = xrt_core::device_query<QueryRequestType>(device);
-  }
-  catch (const std::exception& ex) {
-    pt.put("error_msg", ex.what());
-  }
+  if (!temp.error.empty())
+    pt.put("error_msg", temp.error);
 
   pt.put("location_id", loc_id);
   pt.put("description", desc);
-  pt.put("temp_C", temp_C);
-  pt.put("is_present", temp_C != 0 ? "true" : "false");
+  pt.put("temp_C", temp.value);
+  pt.put("is_present", temp.value != 0 ? "true" : "false");
 
   return pt;
 }
@@ -111,31 +100,62 @@ lvl_to_power_watts(uint64_t lvl)
 
 static ptree_type
 populate_fan(const xrt_core::device * device,
+             const sensor_data& temp,
+             const sensor_data& rpm,
              const std::string& loc_id,
              const std::string& desc)
 {
   ptree_type pt;
-  uint64_t temp_C = 0;
-  uint64_t rpm = 0;
+  std::string error = temp.error.empty() ? rpm.error : temp.error;
   std::string is_present;
   try {
-    temp_C = xrt_core::device_query<xq::fan_trigger_critical_temp>(device);
-    rpm = xrt_core::device_query<xq::fan_speed_rpm>(device);
     is_present = xrt_core::device_query<xq::fan_fan_presence>(device);
   }
   catch (const std::exception& ex) {
-    pt.put("error_msg", ex.what());
+    if (error.empty())
+      error = ex.what();
   }
 
+  if (!error.empty())
+    pt.put("error_msg", error);
   pt.put("location_id", loc_id);
   pt.put("description", desc);
-  pt.put("critical_trigger_temp_C", temp_C);
-  pt.put("speed_rpm", rpm);
+  pt.put("critical_trigger_temp_C", temp.value);
+  pt.put("speed_rpm", rpm.value);
   pt.put("is_present", xq::fan_fan_presence::to_string(is_present));
 
   return pt;
 }
 
+// Reads the sensors of a legacy report in one snapshot.  No data is
+// returned for a key of query::noop.
+static std::vector<std::optional<sensor_data>>
+read_legacy_snapshot(const xrt_core::device * device, const std::vector<xq::key_type>& keys)
+{
+  xq::sensor_snapshot::args args;
+  for (auto key : keys)
+    if (key != xq::key_type::noop)
+      args.keys.push_back(key);
+
+  xq::sensor_snapshot::result_type data;
+  try {
+    data = xrt_core::sensor::read_snapshot(device, args);
+  }
+  catch (const std::exception& ex) {
+    data.assign(args.keys.size(), {0, ex.what()});
+  }
+
+  std::vector<std::optional<sensor_data>> result;
+  auto itr = data.begin();
+  for (auto key : keys) {
+    if (key == xq::key_type::noop)
+      result.emplace_back(std::nullopt);
+    else
+      result.emplace_back(std::move(*itr++));
+  }
+  return result;
+}
+
 /*
  * _data_driven_*(): Sensor data driven model APIs
  *   without it's name and it is not static.
@@ -288,62 +308,115 @@ read_legacy_mechanical(const xrt_core::device * device)
   ptree_type root;
   ptree_type fan_array;
 
-  fan_array.push_back({"", populate_fan(device, "fpga_fan_1", "FPGA Fan 1")});
+  auto data = read_legacy_snapshot(device, {xq::fan_trigger_critical_temp::key, xq::fan_speed_rpm::key});
+  fan_array.push_back({"", populate_fan(device, *data[0], *data[1], "fpga_fan_1", "FPGA Fan 1")});
 
   root.add_child("fans", fan_array);
   return root;
 }
 
-static ptree_type
-read_legacy_thermals(const xrt_core::device * device)
+struct legacy_temp
 {
-  ptree_type thermal_array;
-  ptree_type root;
+  xq::key_type key;
+  const char* loc_id;
+  const char* desc;
+};
 
+static const std::vector<legacy_temp> legacy_temps = {
   //--- pcb ----------
-  thermal_array.push_back({"",
-	populate_temp<xq::temp_card_top_front>(device, "pcb_top_front", "PCB Top Front")});
-  thermal_array.push_back({"",
-	populate_temp<xq::temp_card_top_rear>(device, "pcb_top_rear", "PCB Top Rear")});
-  thermal_array.push_back({"",
-	populate_temp<xq::temp_card_bottom_front>(device, "pcb_bottom_front", "PCB Bottom Front")});
+  { xq::temp_card_top_front::key,    "pcb_top_front",    "PCB Top Front" },
+  { xq::temp_card_top_rear::key,     "pcb_top_rear",     "PCB Top Rear" },
+  { xq::temp_card_bottom_front::key, "pcb_bottom_front", "PCB Bottom Front" },
 
   //--- cage ----------
-  thermal_array.push_back({"",
-	populate_temp<xq::cage_temp_0>(device, "cage_temp_0", "Cage0")});
-  thermal_array.push_back({"",
-	populate_temp<xq::cage_temp_1>(device, "cage_temp_1", "Cage1")});
-  thermal_array.push_back({"",
-	populate_temp<xq::cage_temp_2>(device, "cage_temp_2", "Cage2")});
-  thermal_array.push_back({"",
-	populate_temp<xq::cage_temp_3>(device, "cage_temp_3", "Cage3")});
+  { xq::cage_temp_0::key,            "cage_temp_0",      "Cage0" },
+  { xq::cage_temp_1::key,            "cage_temp_1",      "Cage1" },
+  { xq::cage_temp_2::key,            "cage_temp_2",      "Cage2" },
+  { xq::cage_temp_3::key,            "cage_temp_3",      "Cage3" },
 
   // --- fpga, vccint, hbm -------------
-  thermal_array.push_back({"",
-	populate_temp<xq::temp_fpga>(device, "fpga0", "FPGA")});
-  thermal_array.push_back({"",
-	populate_temp<xq::int_vcc_temp>(device, "int_vcc", "Int Vcc")});
-  thermal_array.push_back({"",
-	populate_temp<xq::hbm_temp>(device, "fpga_hbm", "FPGA HBM")});
+  { xq::temp_fpga::key,              "fpga0",            "FPGA" },
+  { xq::int_vcc_temp::key,           "int_vcc",          "Int Vcc" },
+  { xq::hbm_temp::key,               "fpga_hbm",         "FPGA HBM" },
+};
+
+static ptree_type
+read_legacy_thermals(const xrt_core::device * device)
+{
+  ptree_type thermal_array;
+  ptree_type root;
+
+  std::vector<xq::key_type> keys;
+  for (auto& temp : legacy_temps)
+    keys.push_back(temp.key);
+
+  auto data = read_legacy_snapshot(device, keys);
+  for (size_t idx = 0; idx < legacy_temps.size(); ++idx)
+    thermal_array.push_back({"",
+      populate_temp(*data[idx], legacy_temps[idx].loc_id, legacy_temps[idx].desc)});
 
   root.add_child("thermals", thermal_array);
   return root;
 }
 
+// Voltage-current pair of a power rail; query::noop if query DNE
+struct legacy_rail
+{
+  xq::key_type voltage;
+  xq::key_type current;
+  const char* loc_id;
+  const char* desc;
+};
+
+static const std::vector<legacy_rail> legacy_rails = {
+  { xq::v12v_aux_millivolts::key,         xq::v12v_aux_milliamps::key,      "12v_aux",        "12 Volts Auxillary" },
+  { xq::v12v_pex_millivolts::key,         xq::v12v_pex_milliamps::key,      "12v_pex",        "12 Volts PCI Express" },
+  { xq::v3v3_pex_millivolts::key,         xq::v3v3_pex_milliamps::key,      "3v3_pex",        "3.3 Volts PCI Express" },
+  { xq::v3v3_aux_millivolts::key,         xq::v3v3_aux_milliamps::key,      "3v3_aux",        "3.3 Volts Auxillary" },
+  { xq::int_vcc_millivolts::key,          xq::int_vcc_milliamps::key,       "vccint",         "Internal FPGA Vcc" },
+  { xq::int_vcc_io_millivolts::key,       xq::int_vcc_io_milliamps::key,    "vccint_io",      "Internal FPGA Vcc IO" },
+  { xq::ddr_vpp_bottom_millivolts::key,   xq::noop::key,                    "ddr_vpp_btm",    "DDR Vpp Bottom" },
+  { xq::ddr_vpp_top_millivolts::key,      xq::noop::key,                    "ddr_vpp_top",    "DDR Vpp Top" },
+  { xq::v5v5_system_millivolts::key,      xq::noop::key,                    "5v5_system",     "5.5 Volts System" },
+  { xq::v1v2_vcc_top_millivolts::key,     xq::noop::key,                    "1v2_top",        "Vcc 1.2 Volts Top" },
+  { xq::v1v2_vcc_bottom_millivolts::key,  xq::noop::key,                    "vcc_1v2_btm",    "Vcc 1.2 Volts Bottom" },
+  { xq::v1v8_millivolts::key,             xq::noop::key,                    "1v8_top",        "1.8 Volts Top" },
+  { xq::v0v9_vcc_millivolts::key,         xq::noop::key,                    "0v9_vcc",        "0.9 Volts Vcc" },
+  { xq::v12v_sw_millivolts::key,          xq::noop::key,                    "12v_sw",         "12 Volts SW" },
+  { xq::mgt_vtt_millivolts::key,          xq::noop::key,                    "mgt_vtt",        "Mgt Vtt" },
+  { xq::v3v3_vcc_millivolts::key,         xq::noop::key,                    "3v3_vcc",        "3.3 Volts Vcc" },
+  { xq::hbm_1v2_millivolts::key,          xq::noop::key,                    "hbm_1v2",        "1.2 Volts HBM" },
+  { xq::v2v5_vpp_millivolts::key,         xq::noop::key,                    "vpp2v5",         "Vpp 2.5 Volts" },
+  { xq::v12_aux1_millivolts::key,         xq::noop::key,                    "12v_aux1",       "12 Volts Aux1" },
+  { xq::noop::key,                        xq::vcc1v2_i_milliamps::key,      "vcc1v2_i",       "Vcc 1.2 Volts i" },
+  { xq::noop::key,                        xq::v12_in_i_milliamps::key,      "v12_in_i",       "V12 in i" },
+  { xq::noop::key,                        xq::v12_in_aux0_i_milliamps::key, "v12_in_aux0_i",  "V12 in Aux0 i" },
+  { xq::noop::key,                        xq::v12_in_aux1_i_milliamps::key, "v12_in_aux1_i",  "V12 in Aux1 i" },
+  { xq::vcc_aux_millivolts::key,          xq::noop::key,                    "vcc_aux",        "Vcc Auxillary" },
+  { xq::vcc_aux_pmc_millivolts::key,      xq::noop::key,                    "vcc_aux_pmc",    "Vcc Auxillary Pmc" },
+  { xq::vcc_ram_millivolts::key,          xq::noop::key,                    "vcc_ram",        "Vcc Ram" },
+  { xq::v0v9_int_vcc_vcu_millivolts::key, xq::noop::key,                    "0v9_vccint_vcu", "0.9 Volts Vcc Vcu" },
+};
+
 static ptree_type
 read_legacy_electrical(const xrt_core::device * device)
 {
   ptree_type sensor_array;
-  ptree_type pt;
 
-  sensor_array.push_back({"",
-    populate_sensor<xq::v12v_aux_millivolts, xq::v12v_aux_milliamps>(device, "12v_aux", "12 Volts Auxillary")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v12v_pex_millivolts, xq::v12v_pex_milliamps>(device, "12v_pex", "12 Volts PCI Express")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v3v3_pex_millivolts, xq::v3v3_pex_milliamps>(device, "3v3_pex", "3.3 Volts PCI Express")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v3v3_aux_millivolts, xq::v3v3_aux_milliamps>(device, "3v3_aux", "3.3 Volts Auxillary")});
+  std::vector<xq::key_type> keys;
+  for (auto& rail : legacy_rails) {
+    keys.push_back(rail.voltage);
+    keys.push_back(rail.current);
+  }
+
+  auto data = read_legacy_snapshot(device, keys);
+  for (size_t idx = 0; idx < legacy_rails.size(); ++idx) {
+    auto& voltage = data[2 * idx];
+    auto& current = data[2 * idx + 1];
+    sensor_array.push_back({"",
+      populate_sensor(voltage ? &*voltage : nullptr, current ? &*current : nullptr,
+                      legacy_rails[idx].loc_id, legacy_rails[idx].desc)});
+  }
 
   /* Board power measurement uses cached values of above sensors.*/
   std::string power_watts;
@@ -361,53 +434,6 @@ read_legacy_electrical(const xrt_core::device * device)
     max_power_watts = "N/A";
   }
 
-  sensor_array.push_back({"",
-    populate_sensor<xq::int_vcc_millivolts, xq::int_vcc_milliamps>(device, "vccint", "Internal FPGA Vcc")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::int_vcc_io_millivolts, xq::int_vcc_io_milliamps>(device, "vccint_io", "Internal FPGA Vcc IO")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::ddr_vpp_bottom_millivolts, xq::noop>(device, "ddr_vpp_btm", "DDR Vpp Bottom")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::ddr_vpp_top_millivolts, xq::noop>(device, "ddr_vpp_top", "DDR Vpp Top")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v5v5_system_millivolts, xq::noop>(device, "5v5_system", "5.5 Volts System")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v1v2_vcc_top_millivolts, xq::noop>(device, "1v2_top", "Vcc 1.2 Volts Top")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v1v2_vcc_bottom_millivolts, xq::noop>(device, "vcc_1v2_btm", "Vcc 1.2 Volts Bottom")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v1v8_millivolts, xq::noop>(device, "1v8_top", "1.8 Volts Top")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v0v9_vcc_millivolts, xq::noop>(device, "0v9_vcc", "0.9 Volts Vcc")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v12v_sw_millivolts, xq::noop>(device, "12v_sw", "12 Volts SW")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::mgt_vtt_millivolts, xq::noop>(device, "mgt_vtt", "Mgt Vtt")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v3v3_vcc_millivolts, xq::noop>(device, "3v3_vcc", "3.3 Volts Vcc")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::hbm_1v2_millivolts, xq::noop>(device, "hbm_1v2", "1.2 Volts HBM")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v2v5_vpp_millivolts, xq::noop>(device, "vpp2v5", "Vpp 2.5 Volts")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v12_aux1_millivolts, xq::noop>(device, "12v_aux1", "12 Volts Aux1")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::noop, xq::vcc1v2_i_milliamps>(device, "vcc1v2_i", "Vcc 1.2 Volts i")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::noop, xq::v12_in_i_milliamps>(device, "v12_in_i", "V12 in i")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::noop, xq::v12_in_aux0_i_milliamps>(device, "v12_in_aux0_i", "V12 in Aux0 i")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::noop, xq::v12_in_aux1_i_milliamps>(device, "v12_in_aux1_i", "V12 in Aux1 i")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::vcc_aux_millivolts, xq::noop>(device, "vcc_aux", "Vcc Auxillary")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::vcc_aux_pmc_millivolts, xq::noop>(device, "vcc_aux_pmc", "Vcc Auxillary Pmc")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::vcc_ram_millivolts, xq::noop>(device, "vcc_ram", "Vcc Ram")});
-  sensor_array.push_back({"",
-    populate_sensor<xq::v0v9_int_vcc_vcu_millivolts, xq::noop>(device, "0v9_vccint_vcu", "0.9 Volts Vcc Vcu")});
-
   ptree_type root;
   root.add_child("power_rails", sensor_array);
   root.put("power_consumption_max_watts", max_power_watts);
@@ -421,6 +447,29 @@ read_legacy_electrical(const xrt_core::device * device)
 
 namespace xrt_core { namespace sensor {
 
+xq::sensor_snapshot::result_type
+read_snapshot(const xrt_core::device * device, const xq::sensor_snapshot::args& args)
+{
+  try {
+    return xrt_core::device_query<xq::sensor_snapshot>(device, args);
+  }
+  catch (const xq::no_such_key&) {
+    // device does not read sensors in batch
+  }
+
+  xq::sensor_snapshot::result_type data;
+  data.reserve(args.keys.size());
+  for (auto key : args.keys) {
+    try {
+      data.push_back(xq::sensor_snapshot::to_data(device->query(key)));
+    }
+    catch (const std::exception& ex) {
+      data.push_back({0, ex.what()});
+    }
+  }
+  return data;
+}
+
 /*
  * read_<>() functions are top level functions are being called from tools/common driver.
  * Job is to get all the requested sensor information stored into boost::property_tree.
@@ -17,6 +17,7 @@
 #define COMMON_SENSOR_H
 #include "config.h"
 #include "device.h"
+#include "query_requests.h"
 
 #include <boost/lexical_cast.hpp>
 #include <iostream>
@@ -39,6 +40,12 @@ XRT_CORE_COMMON_EXPORT
 boost::property_tree::ptree
 read_mechanical(const xrt_core::device * device);
 
+// Read a set of scalar sensors in one call.  Uses the sensor_snapshot
+// query if implemented by the device, otherwise queries each sensor.
+XRT_CORE_COMMON_EXPORT
+query::sensor_snapshot::result_type
+read_snapshot(const xrt_core::device * device, const query::sensor_snapshot::args& args);
+
 }} // sensor, xrt_core
 
 
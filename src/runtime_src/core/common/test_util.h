@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrt_core_common_test_util_h_
+#define xrt_core_common_test_util_h_
+
+// Scaffolding shared by unit tests and tests/xrt test cases.  Header
+// only and without XRT dependencies such that test cases built
+// against an installed XRT can use it.
+
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+#ifdef _WIN32
+# include <process.h>
+#else
+# include <unistd.h>
+#endif
+
+namespace xrt_core::test_util {
+
+// Path of name in the temporary directory, unique to the process such
+// that concurrent test runs do not share files
+inline std::filesystem::path
+temp_path(const std::string& name)
+{
+#ifdef _WIN32
+  auto pid = _getpid();
+#else
+  auto pid = ::getpid();
+#endif
+  return std::filesystem::temp_directory_path() / (name + "." + std::to_string(pid));
+}
+
+inline void
+set_env(const char* key, const std::string& value)
+{
+#ifdef _WIN32
+  _putenv_s(key, value.c_str());
+#else
+  setenv(key, value.c_str(), 1);
+#endif
+}
+
+// class ini_file - xrt.ini in a unique temporary path
+//
+// XRT_INI_PATH points at the file, which is removed when the object
+// is destroyed.  Must be created before the first XRT API call.
+// Child processes inherit XRT_INI_PATH.
+class ini_file
+{
+  std::filesystem::path m_path;
+
+public:
+  ini_file(const std::string& name, const std::string& content)
+    : m_path(temp_path(name + ".ini"))
+  {
+    std::ofstream(m_path) << content;
+    set_env("XRT_INI_PATH", m_path.string());
+  }
+
+  ~ini_file()
+  {
+    std::error_code ec;
+    std::filesystem::remove(m_path, ec);
+  }
+
+  ini_file(const ini_file&) = delete;
+  ini_file& operator=(const ini_file&) = delete;
+
+  const std::filesystem::path&
+  path() const
+  {
+    return m_path;
+  }
+};
+
+// run_main() - Run a test and report the result
+//
+// @fcn: test function returning non zero to exit without result
+// Return: exit status of the test
+template <typename Function>
+int
+run_main(Function&& fcn)
+{
+  try {
+    if (auto ret = fcn())
+      return ret;
+
+    std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
+
+} // xrt_core::test_util
+
+#endif
@@ -18,6 +18,7 @@
 #include "time.h"
 
 #include <chrono>
+#include <cstdio>
 #include <cstring>
 #include <ctime>
 
@@ -57,13 +58,37 @@ time_ns()
 std::string
 timestamp()
 {
-  auto time = std::chrono::system_clock::now();
+  return timestamp(std::chrono::system_clock::now());
+}
+
+/**
+ * @return formatted timestamp of time point
+ */
+std::string
+timestamp(std::chrono::system_clock::time_point time)
+{
   auto tm = get_gmtime(std::chrono::system_clock::to_time_t(time));
   char buf[64] = {0};
   return std::strftime(buf, sizeof(buf), "%c GMT", tm)
     ? buf : "Time conversion failed";
 }
 
+/**
+ * @return ISO 8601 UTC timestamp of time point with milliseconds
+ */
+std::string
+timestamp_iso8601(std::chrono::system_clock::time_point time)
+{
+  auto tm = get_gmtime(std::chrono::system_clock::to_time_t(time));
+  auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+  char buf[64] = {0};
+  auto len = std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", tm);
+  if (!len)
+    return "Time conversion failed";
+  std::snprintf(buf + len, sizeof(buf) - len, ".%03dZ", static_cast<int>(ms));
+  return buf;
+}
+
 /**
  * @return formatted timestamp for epoch
  */
@@ -18,6 +18,7 @@
 #define xrtcore_util_time_h_
 
 #include "core/common/config.h"
+#include <chrono>
 #include <cstdint>
 #include <string>
 
@@ -38,6 +39,20 @@ XRT_CORE_COMMON_EXPORT
 std::string
 timestamp();
 
+/**
+ * @return formatted timestamp of time point
+ */
+XRT_CORE_COMMON_EXPORT
+std::string
+timestamp(std::chrono::system_clock::time_point time);
+
+/**
+ * @return ISO 8601 UTC timestamp of time point with milliseconds
+ */
+XRT_CORE_COMMON_EXPORT
+std::string
+timestamp_iso8601(std::chrono::system_clock::time_point time);
+
 /**
  * @return timestamp for epoch
  */
@@ -14,55 +14,10 @@
  * under the License.
  */
 
-#ifndef _HWEM_MEMORY_MANAGER_H_
-#define _HWEM_MEMORY_MANAGER_H_
+#ifndef _EDGE_EM_MEMORY_MANAGER_H_
+#define _EDGE_EM_MEMORY_MANAGER_H_
 
-#include <mutex>
-#include <list>
-#include <cassert>
-#include <algorithm>
-
-#include "em_defines.h"
-#include "xclhal2.h"
-
-namespace xclemulation
-{
-    class MemoryManager 
-    {
-        std::mutex mMemManagerMutex;
-        std::list<std::pair<uint64_t, uint64_t> > mFreeBufferList;
-        std::list<std::pair<uint64_t, uint64_t> > mBusyBufferList;
-        uint64_t mSize;
-        uint64_t mStart;
-        uint64_t mAlignment;
-        const unsigned mCoalesceThreshold;
-        uint64_t mFreeSize;
-
-        typedef std::list<std::pair<uint64_t, uint64_t> > PairList;
-
-    public:
-        static const uint64_t mNull = 0xffffffffffffffffull;
-
-    public:
-        MemoryManager(uint64_t size, uint64_t start, unsigned alignment);
-        ~MemoryManager();
-        uint64_t alloc(size_t& size,unsigned int paddingFactor = 0);
-        void free(uint64_t buf);
-        void reset();
-
-        uint64_t size()     { return mSize; }
-        uint64_t start()    { return mStart; }
-        uint64_t freeSize() { return mFreeSize; }
-        static bool isNullAlloc(const std::pair<uint64_t, uint64_t>& buf) { return ((buf.first == mNull) || (buf.second == mNull)); }
-
-        std::pair<uint64_t, uint64_t>lookup(uint64_t buf);
-
-    private:
-        void coalesce();
-        PairList::iterator find(uint64_t buf);
-    };
-}
+// The allocator of emulated device memory is shared with PCIe emulation
+#include "core/pcie/emulation/common_em/memorymanager.h"
 
 #endif
-
-
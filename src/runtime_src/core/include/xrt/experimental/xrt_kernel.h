@@ -12,6 +12,11 @@
 # include "xrt/detail/pimpl.h"
 # include <chrono>
 # include <condition_variable>
+# include <cstdint>
+# include <cstring>
+# include <type_traits>
+# include <utility>
+# include <vector>
 #endif
 
 #ifdef __cplusplus
@@ -243,6 +248,158 @@ public:
   reset();
 };
 
+/// @cond
+namespace detail {
+
+// Binding of typed kernel arguments to the command payload of a run
+// object.  The binding is validated against the kernel meta data once
+// when constructed.  Arguments that can be written directly to the
+// command payload have a payload location, other arguments are set
+// through the binding.
+class typed_binding_impl;
+class typed_binding : public detail::pimpl<typed_binding_impl>
+{
+public:
+  enum class arg_kind : uint8_t { scalar, global };
+
+  // Signature entry per argument, kind and size of host type
+  struct arg_type
+  {
+    arg_kind kind;
+    size_t size;
+  };
+
+  typed_binding() = default;
+
+  XRT_API_EXPORT
+  typed_binding(const xrt::run& run, const std::vector<arg_type>& signature);
+
+  // Payload location per argument, nullptr if argument cannot be
+  // written directly to the command payload
+  XRT_API_EXPORT
+  uint8_t* const*
+  get_payload_locations() const;
+
+  XRT_API_EXPORT
+  void
+  set_global(size_t index, const xrt::bo& bo);
+
+  XRT_API_EXPORT
+  void
+  set_scalar(size_t index, const void* value, size_t bytes);
+};
+
+} // detail
+/// @endcond
+
+/**
+ * @class typed_kernel
+ *
+ * @brief
+ * Kernel with compile time argument signature
+ *
+ * @details
+ * A typed kernel binds kernel arguments to the command payload of a
+ * run object once when constructed.  The signature is validated
+ * against the kernel meta data and the payload location of each
+ * argument is precomputed, such that starting the kernel with new
+ * argument values is a sequence of stores to the command payload.
+ *
+ * Arguments of type xrt::bo, or a class derived from xrt::bo such
+ * as xrt::ext::bo, are global arguments, all other
+ * arguments must be trivially copyable scalars of the same size as
+ * the corresponding kernel argument.
+ *
+ * A typed kernel manages a single run object, which must complete
+ * before the typed kernel is started again.
+ *
+ * @code
+ *  xrt::typed_kernel<xrt::bo, xrt::bo, int> simple{kernel};
+ *  for (int i = 0; i < iterations; ++i)
+ *    simple(bo0, bo1, i).wait();
+ * @endcode
+ */
+template <typename... Args>
+class typed_kernel
+{
+  using binding = detail::typed_binding;
+
+  xrt::run m_run;
+  binding m_binding;
+  uint8_t* const* m_payload = nullptr;
+
+  template <typename ArgType>
+  static constexpr bool
+  is_global()
+  {
+    return std::is_base_of_v<xrt::bo, std::decay_t<ArgType>>;
+  }
+
+  template <size_t index, typename ArgType>
+  void
+  set_arg(const ArgType& arg)
+  {
+    if constexpr (is_global<ArgType>()) {
+      m_binding.set_global(index, arg);
+    }
+    else {
+      static_assert(std::is_trivially_copyable_v<ArgType>, "typed_kernel scalar argument must be trivially copyable");
+      if (auto dst = m_payload[index])
+        std::memcpy(dst, &arg, sizeof(ArgType));
+      else
+        m_binding.set_scalar(index, &arg, sizeof(ArgType));
+    }
+  }
+
+  template <size_t... index>
+  void
+  set_args(std::index_sequence<index...>, const Args&... args)
+  {
+    (set_arg<index>(args), ...);
+  }
+
+public:
+  /**
+   * typed_kernel() - Construct from kernel
+   *
+   * @param kernel
+   *  Kernel to bind typed arguments to
+   *
+   * Throws if the signature does not match the kernel arguments.
+   */
+  explicit
+  typed_kernel(const xrt::kernel& kernel)
+    : m_run(kernel)
+    , m_binding(m_run, {binding::arg_type{is_global<Args>() ? binding::arg_kind::global : binding::arg_kind::scalar, sizeof(Args)}...})
+    , m_payload(m_binding.get_payload_locations())
+  {}
+
+  /**
+   * operator() - Set all kernel arguments and start the run
+   *
+   * @param args
+   *  Kernel arguments
+   * @return
+   *  Run object that was started
+   */
+  xrt::run&
+  operator() (const Args&... args)
+  {
+    set_args(std::index_sequence_for<Args...>{}, args...);
+    m_run.start();
+    return m_run;
+  }
+
+  /**
+   * get_run() - Run object managed by this typed kernel
+   */
+  xrt::run&
+  get_run()
+  {
+    return m_run;
+  }
+};
+
 } // namespace xrt
 
 #endif // __cplusplus
@@ -8,8 +8,10 @@
 
 #ifdef __cplusplus
 # include <algorithm>
+# include <chrono>
 # include <future>
 # include <memory>
+# include <utility>
 #endif
 
 #ifdef __cplusplus
@@ -21,13 +23,17 @@ namespace xrt {
  *
  * Used for sequencing operations in order of enqueuing.
  *
- * A queue has exactly one consumer which is a separate thread created
- * when the queue is constructed.
+ * A queue has one or more consumers which are separate threads
+ * created when the queue is constructed.  With one consumer, tasks
+ * are executed and completed in order of enqueuing.  With more
+ * consumers, tasks are started in order of enqueuing but may execute
+ * concurrently.
  *
  * When an opeation is enqueued on the queue an event is returned to
  * the caller.  This event can be enqueued in a different queue, which
  * will then wait for the former to complete the operaiton associated
- * with the event.
+ * with the event.  A task waiting for an event does not occupy a
+ * consumer thread.
  */
 class queue_impl;
 class queue
@@ -39,6 +45,9 @@ class queue
   // A task wraps a caller's typed operation such that it
   // can be inserted into a queue.
   //
+  // The layout of a task is part of the ABI, tasks are passed by
+  // value to add_task() in the library.
+  //
   // Tasks should be synchronous operations.
   class task
   {
@@ -115,6 +124,7 @@ public:
     {
       virtual ~event_iholder() {};
       virtual void wait() const = 0;
+      virtual bool ready() const = 0;
     };
 
     // Wrap typed future
@@ -132,6 +142,13 @@ public:
       {
         m_held.wait();
       }
+
+      // A deferred future is ready in the sense that waiting for it
+      // does not block on other work, wait() runs the deferred function
+      bool ready() const override
+      {
+        return m_held.wait_for(std::chrono::seconds(0)) != std::future_status::timeout;
+      }
     };
 
     std::shared_ptr<event_iholder> m_content;
@@ -163,6 +180,15 @@ public:
       if (m_content)
         m_content->wait();
     }
+
+    // ready() - check if event has completed without waiting
+    //
+    // An empty event is always ready
+    bool
+    ready() const
+    {
+      return !m_content || m_content->ready();
+    }
   };
 
 private:
@@ -171,6 +197,21 @@ private:
   void
   add_task(task&& ev);
 
+  // Add task to queue, task is not started before event is ready
+  XRT_API_EXPORT
+  void
+  add_task(event&& ev, task&& t);
+
+  template <typename Callable>
+  static auto
+  make_task(Callable&& c)
+  {
+    using return_type = decltype(c());
+    std::packaged_task<return_type()> task{std::forward<Callable>(c)};
+    std::shared_future f{task.get_future()};
+    return std::make_pair(std::move(task), std::move(f));
+  }
+
 public:
   /**
    * queue() - Constructor for queue object
@@ -180,6 +221,20 @@ public:
   XRT_API_EXPORT
   queue();
 
+  /**
+   * queue() - Constructor for queue object with multiple consumers
+   *
+   * @param workers
+   *   Number of consumer threads, must be at least one
+   *
+   * With more than one consumer, enqueued operations are started in
+   * order of enqueuing, but may execute concurrently and complete
+   * out of order.  Use enqueue_after() to order operations.
+   */
+  XRT_API_EXPORT
+  explicit
+  queue(unsigned int workers);
+
   /**
    * enqueue() - Enqueue a callable
    *
@@ -199,13 +254,36 @@ public:
   auto
   enqueue(Callable&& c)
   {
-    using return_type = decltype(c());
-    std::packaged_task<return_type()> task{[cc = std::move(c)] { return cc(); }};
-    std::shared_future f{task.get_future()};
+    auto [task, f] = make_task(std::forward<Callable>(c));
     add_task(std::move(task));
     return f;
   }
 
+  /**
+   * enqueue_after() - Enqueue a callable that depends on an event
+   *
+   * @param ev
+   *   Event that must complete before the callable is executed
+   * @param c
+   *   Callable function, typically a lambda
+   * @return
+   *   Future result of the function (std::future)
+   *
+   * The callable is executed once the event has completed.  The
+   * event is typically the result of an operation enqueued in a
+   * different queue.  No consumer thread is blocked while waiting
+   * for the event.  With one consumer, operations enqueued after
+   * this one are not started before this one.
+   */
+  template <typename Callable>
+  auto
+  enqueue_after(xrt::queue::event ev, Callable&& c)
+  {
+    auto [task, f] = make_task(std::forward<Callable>(c));
+    add_task(std::move(ev), std::move(task));
+    return f;
+  }
+
   /**
    * enqueue() - Enqueue the future of an enqueued operation
    *
@@ -224,7 +302,7 @@ public:
   auto
   enqueue(std::shared_future<ValueType> sf)
   {
-    return enqueue([evc = xrt::queue::event{std::move(sf)}] { evc.wait(); });
+    return enqueue_after(xrt::queue::event{std::move(sf)}, [] {});
   }
 
   /**
@@ -244,7 +322,7 @@ public:
   auto
   enqueue(xrt::queue::event ev)
   {
-    return enqueue([evc = std::move(ev)] { evc.wait(); });
+    return enqueue_after(std::move(ev), [] {});
   }
 
 public:
@@ -17,33 +17,47 @@
 #ifndef _HWEM_MEMORY_MANAGER_H_
 #define _HWEM_MEMORY_MANAGER_H_
 
-#include <mutex>
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
 #include <list>
 #include <map>
-#include <cassert>
-#include <algorithm>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
 
-#include "em_defines.h"
 #include "xclhal2.h"
 
 namespace xclemulation
 {
 static std::map<uint64_t,uint64_t> DEFAULT_MAP;
 static std::string DEFAULT_TAG("");
+    /*
+     * MemoryManager - allocator of emulated device memory.
+     *
+     * Free blocks are indexed both by address and by size, busy blocks
+     * by address, such that alloc, free and lookup are O(log n).  Alloc
+     * returns the lowest addressed of the smallest free blocks that fit
+     * (best fit).  A freed block is merged with its free neighbours.
+     *
+     * Shared by the PCIe and edge emulation shims.
+     */
     class MemoryManager 
     {
         std::mutex mMemManagerMutex;
-        std::list<std::pair<uint64_t, uint64_t> > mFreeBufferList;
-        std::list<std::pair<uint64_t, uint64_t> > mBusyBufferList;
+        // address -> size
+        std::map<uint64_t, uint64_t> mFreeByAddr;
+        // (size, address)
+        std::set<std::pair<uint64_t, uint64_t> > mFreeBySize;
+        // address -> size
+        std::map<uint64_t, uint64_t> mBusyBuffers;
         uint64_t mSize;
         uint64_t mStart;
         uint64_t mAlignment;
 	std::string mTag;
-        const unsigned mCoalesceThreshold;
         uint64_t mFreeSize;
 
-        typedef std::list<std::pair<uint64_t, uint64_t> > PairList;
-
     public:
 	static const uint64_t mNull = 0xffffffffffffffffull;
 	std::list<MemoryManager*> mChildMemories;
@@ -64,8 +78,8 @@ static std::string DEFAULT_TAG("");
         std::pair<uint64_t, uint64_t>lookup(uint64_t buf);
 
     private:
-        void coalesce();
-        PairList::iterator find(uint64_t buf);
+        void insertFree(uint64_t addr, uint64_t size);
+        void eraseFree(std::map<uint64_t, uint64_t>::iterator it);
     };
 }
 
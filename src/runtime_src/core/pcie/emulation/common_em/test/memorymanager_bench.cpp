@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Advanced Micro Devices, Inc. All rights reserved.
+
+// Alloc/free stress of the emulation device memory allocator.  Keeps
+// a working set of live buffers of random size, freeing and allocating
+// in random order, and checks alignment, overlap, lookup and free size
+// accounting.  Once all buffers are freed the whole memory must be
+// allocatable again.
+//
+// % memorymanager_bench [live buffers] [operations]
+
+#include "memorymanager.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t alignment = 4096;
+constexpr uint64_t mem_start = 0x400000000;
+constexpr uint64_t mem_size = uint64_t(16) << 30;
+
+void
+check(bool cond, const char* msg)
+{
+  if (!cond)
+    throw std::runtime_error(msg);
+}
+
+void
+run(size_t live, size_t ops)
+{
+  xclemulation::MemoryManager mm(mem_size, mem_start, alignment);
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<size_t> size_dist(1, 64 * 1024);
+
+  std::vector<uint64_t> bufs;
+  std::map<uint64_t, uint64_t> shadow;
+  uint64_t used = 0;
+
+  auto alloc = [&] {
+    size_t size = size_dist(rng);
+    size_t req = size;
+    uint64_t addr = mm.alloc(req);
+    check(addr != xclemulation::MemoryManager::mNull, "out of memory");
+    check(addr % alignment == 0 && req % alignment == 0 && req >= size, "bad alignment");
+    auto next = shadow.lower_bound(addr);
+    check(next == shadow.end() || addr + req <= next->first, "overlap with next buffer");
+    check(next == shadow.begin() || std::prev(next)->first + std::prev(next)->second <= addr,
+          "overlap with previous buffer");
+    shadow.emplace(addr, req);
+    bufs.push_back(addr);
+    used += req;
+  };
+
+  auto release = [&] {
+    std::uniform_int_distribution<size_t> idx_dist(0, bufs.size() - 1);
+    auto idx = idx_dist(rng);
+    uint64_t addr = bufs[idx];
+    bufs[idx] = bufs.back();
+    bufs.pop_back();
+    check(mm.lookup(addr).second == shadow[addr], "lookup mismatch");
+    used -= shadow[addr];
+    shadow.erase(addr);
+    mm.free(addr);
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < live; ++i)
+    alloc();
+  for (size_t i = 0; i < ops; ++i) {
+    release();
+    alloc();
+  }
+  check(mm.freeSize() == mem_size - used, "free size mismatch");
+  while (!bufs.empty())
+    release();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  check(mm.freeSize() == mem_size, "free size mismatch after free");
+  check(xclemulation::MemoryManager::isNullAlloc(mm.lookup(mem_start)), "lookup of freed buffer");
+  size_t whole = mem_size;
+  check(mm.alloc(whole) == mem_start, "free blocks not coalesced");
+
+  auto total = 2 * (live + ops);
+  std::cout << live << " live buffers, " << total << " alloc/free in " << elapsed.count()
+            << " s, " << elapsed.count() * 1e9 / total << " ns/op\n";
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  size_t live = argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 50000;
+  size_t ops = argc > 2 ? std::strtoull(argv[2], nullptr, 0) : 200000;
+  try {
+    run(live, ops);
+    std::cout << "PASSED\n";
+    return EXIT_SUCCESS;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "FAILED: " << ex.what() << '\n';
+    return EXIT_FAILURE;
+  }
+}
@@ -16,168 +16,140 @@
 
 #include "mem_model.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
 mem_model::~ mem_model()
 {
-  serialize();
+  for (auto region : mRegions) {
+    if (region)
+      munmap(region, REGIONSIZE);
+  }
+  if (mFd != -1)
+    close(mFd);
 }
 
 mem_model::mem_model(std::string deviceName):
+  mFileSize(0),
+  mFd(-1),
   mDeviceName(deviceName),
   module_name("dr_wrapper_dr_i_sdaccel_generic_pcie_0.sdaccel_generic_pcie_model.ddrx_top_tlm_model_0.axi_app_tlm_model_0")
 {
+  std::string file_name = get_mem_file_name();
+  mFd = open(file_name.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (mFd == -1) {
+    std::cerr << "Unable to open/create mem file " << file_name << std::endl;
+    exit(1);
+  }
+
+  struct stat statBuf;
+  if (fstat(mFd, &statBuf) == 0)
+    mFileSize = statBuf.st_size;
 }
 
   unsigned int mem_model::writeDevMem(uint64_t offset, const void* src, unsigned int size)
   {
 #ifdef DEBUGMSG
-      cout<<endl<<module_name<<" write offset:"<<std::hex<<offset<<endl;
-#endif 
+      std::cout<<std::endl<<module_name<<" write offset:"<<std::hex<<offset<<std::endl;
+#endif
       uint64_t written_bytes = 0;
       uint64_t addr = offset;
       while(written_bytes < size){
-          uint64_t src_offset = written_bytes;
-
-          unsigned char* page_ptr  = get_page(addr);
-          uint64_t       page_addr = addr & ~( ~uint64_t(0) << ADDRBITS);
+          unsigned char* region_ptr = get_region(addr);
+          uint64_t       region_addr = addr & (REGIONSIZE - 1);
+          uint64_t       buf_size = std::min<uint64_t>(size - written_bytes, REGIONSIZE - region_addr);
 
-          unsigned char* dest_buf_ptr = page_ptr + page_addr;
-          unsigned char* src_buf_ptr  = (unsigned char*)(src)      + src_offset;
-
-          uint64_t remaining_bytes_to_write = size - written_bytes;
-          uint64_t unaligned_bytes_in_addr = (addr & ~(~uint64_t(0) << ADDRBITS));
-          uint64_t bytes_upto_next_alignment = (0x1 << ADDRBITS) - unaligned_bytes_in_addr;
-
-          uint64_t buf_size = 0;
-          if(bytes_upto_next_alignment > remaining_bytes_to_write)
-          {
-              buf_size = remaining_bytes_to_write;
-          }else{
-              buf_size = bytes_upto_next_alignment;
-          }
-
-          memcpy(dest_buf_ptr,src_buf_ptr,buf_size);
+          memcpy(region_ptr + region_addr, static_cast<const unsigned char*>(src) + written_bytes, buf_size);
 
           written_bytes += buf_size;
           addr += buf_size;
       }
 #ifdef DEBUGMSG
-      std::cout << endl;
-      std::cout << "Write Operation size : " << size << endl;
-      for(int i = 0; i < size;i++){
-          cout << std::hex << (unsigned int)(((unsigned char*)src)[i]) << " ";
+      std::cout << std::endl;
+      std::cout << "Write Operation size : " << size << std::endl;
+      for(unsigned int i = 0; i < size;i++){
+          std::cout << std::hex << (unsigned int)(((unsigned char*)src)[i]) << " ";
       }
-      std::cout << endl;
-      cout << "Write : " ;
-      cout << "Offset --> " << offset << endl;
-#endif    
+      std::cout << std::endl;
+      std::cout << "Write : " ;
+      std::cout << "Offset --> " << offset << std::endl;
+#endif
 
       return 0;
   }
 
   unsigned int mem_model::readDevMem(uint64_t offset, void* dest, unsigned int size){
 #ifdef DEBUGMSG
-	  cout<<endl<<module_name<<" read offset:"<<std::hex<< (uint64_t)offset<<endl;
-#endif 
-	 
-	  uint64_t read_bytes = 0;
-	  uint64_t addr = offset;
-	  while(read_bytes < size){
-		  uint64_t dest_offset = read_bytes;
-
-		  unsigned char* page_ptr  = get_page(addr);
-		  uint64_t       page_addr = addr & ~(~uint64_t(0) << ADDRBITS);
-
-		  unsigned char* src_buf_ptr = page_ptr + page_addr;
-		  unsigned char* dest_buf_ptr  = (unsigned char*)(dest)      + dest_offset;
-
-		  uint64_t remaining_bytes_to_read = size - read_bytes;
-		  uint64_t unaligned_bytes_in_addr = (addr & ~(~uint64_t(0) << ADDRBITS));
-		  uint64_t bytes_upto_next_alignment = (0x1 << ADDRBITS) - unaligned_bytes_in_addr;
-
-		  uint64_t buf_size = 0;
-		  if(bytes_upto_next_alignment > remaining_bytes_to_read)
-		  {
-			  buf_size = remaining_bytes_to_read;
-		  }else{
-			  buf_size = bytes_upto_next_alignment;
-		  }
-	  memcpy(dest_buf_ptr,src_buf_ptr,buf_size);
-		  read_bytes += buf_size;
-		  addr += buf_size;
-	  }
+      std::cout<<std::endl<<module_name<<" read offset:"<<std::hex<< (uint64_t)offset<<std::endl;
+#endif
+      uint64_t read_bytes = 0;
+      uint64_t addr = offset;
+      while(read_bytes < size){
+          unsigned char* region_ptr = get_region(addr);
+          uint64_t       region_addr = addr & (REGIONSIZE - 1);
+          uint64_t       buf_size = std::min<uint64_t>(size - read_bytes, REGIONSIZE - region_addr);
+
+          memcpy(static_cast<unsigned char*>(dest) + read_bytes, region_ptr + region_addr, buf_size);
+
+          read_bytes += buf_size;
+          addr += buf_size;
+      }
 #ifdef DEBUGMSG
-	  std::cout << endl;
-	  std::cout << "Read Operation size : " << size << endl;
-	  for(unsigned int i = 0; i < size;i++){
-		  cout << std::hex << (unsigned int)(((unsigned char*)dest)[i]) << " ";
-	  }
-	  std::cout << endl;
-	  cout << "Read : " ;
-	  cout << "Offset --> " << offset << endl;
-#endif    
-
-	  return 0;
-  }
-  unsigned char* mem_model::get_page(uint64_t offset) {
-	  uint64_t page_idx = offset >> ADDRBITS;
-	  std::string file_name = get_mem_file_name(page_idx);
-	  if(pageCache.size() > N_1MBARRAYS)
-	  {
-		  std::cerr << "Out of Memory. DDR model does not support this much of memory\n";
-		  exit(1);
-	  } else {
-      FILE* pFile = NULL;
-		  if(pageCache.find(page_idx) != pageCache.end())
-		  {
-			  return pageCache[page_idx];
-		  } else if(((pFile = fopen(file_name.c_str(),"r")) != NULL)) {
-			  int fhandle = fileno(pFile);
-
-			  if (deserialize_msg.ParseFromFileDescriptor(fhandle) == false)
-        {
-          fclose(pFile);
-          exit(1);
-        }
-			  pageCache[page_idx] = new unsigned char[PAGESIZE];
-
-			  memcpy(pageCache[page_idx],deserialize_msg.data().c_str(),PAGESIZE);
-			  fclose(pFile);
-			  return pageCache[page_idx];
-		  } else {
-			  pageCache[page_idx] = new unsigned char[PAGESIZE];
-			  return pageCache[page_idx];
-		  }
-	  }
+      std::cout << std::endl;
+      std::cout << "Read Operation size : " << size << std::endl;
+      for(unsigned int i = 0; i < size;i++){
+          std::cout << std::hex << (unsigned int)(((unsigned char*)dest)[i]) << " ";
+      }
+      std::cout << std::endl;
+      std::cout << "Read : " ;
+      std::cout << "Offset --> " << offset << std::endl;
+#endif
+
+      return 0;
   }
 
+  /*
+   * Return host address of the region containing offset.  The backing
+   * file is extended, sparsely, to cover the region before it is mapped
+   * such that the whole region can be accessed.
+   */
+  unsigned char* mem_model::get_region(uint64_t offset) {
+      uint64_t region_idx = offset >> REGIONBITS;
+      if (region_idx < mRegions.size() && mRegions[region_idx])
+          return mRegions[region_idx];
+
+      uint64_t region_end = (region_idx + 1) << REGIONBITS;
+      if (mFileSize < region_end) {
+          if (ftruncate(mFd, region_end) == -1) {
+              std::cerr << "Out of Memory. DDR model failed to extend mem file\n";
+              exit(1);
+          }
+          mFileSize = region_end;
+      }
 
-  void mem_model::serialize() {
-     FILE *pFile;
-     int fhandle;
-     for (pageCacheItr=pageCache.begin(); pageCacheItr != pageCache.end(); ++pageCacheItr)
-     {
-        std::string file_name = get_mem_file_name(pageCacheItr->first);
-        pFile = fopen(file_name.c_str(),"w+");
-        if(!pFile)
-          continue;
-        fhandle = fileno(pFile);
-        if(fhandle == -1)
-        {
-          fclose(pFile);
+      void* ptr = mmap(nullptr, REGIONSIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE,
+                       mFd, region_idx << REGIONBITS);
+      if (ptr == MAP_FAILED) {
+          std::cerr << "Out of Memory. DDR model failed to map device memory\n";
           exit(1);
-        }
+      }
 
-        serialize_msg.set_data(reinterpret_cast<const char*>(pageCacheItr->second),PAGESIZE);
-        if(serialize_msg.SerializeToFileDescriptor(fhandle) == false)
-        {
-          fclose(pFile);
-          exit(1);
-        }
-        fclose(pFile);
-     }
+      if (region_idx >= mRegions.size())
+          mRegions.resize(region_idx + 1, nullptr);
+      mRegions[region_idx] = static_cast<unsigned char*>(ptr);
+      return mRegions[region_idx];
   }
 
- std::string mem_model::get_mem_file_name(uint64_t pageIdx)
+ std::string mem_model::get_mem_file_name()
  {
    std::string file_name("");
    std::string user("");
@@ -199,11 +171,9 @@ mem_model::mem_model(std::string deviceName):
      int rV = system(mkdirCommand.str().c_str());
      if(rV == -1) {std::cout<<"unable to open/create mem file"<<std::endl;}
    }
-    file_name = file_path + module_name + "_" + std::to_string(pageIdx);
+    file_name = file_path + module_name + ".mem";
 #ifdef DEBUGMSG
-      cout<<"ddr fmodel file_name: "<< file_name<<endl;
+      std::cout<<"ddr fmodel file_name: "<< file_name<<std::endl;
 #endif
     return file_name;
  }
-
-
@@ -23,18 +23,31 @@
 #include <sstream> // memcpy
 #include <stdlib.h> //realloc
 #include <map> //realloc
+#include <string>
+#include <vector>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
-#include "rpc_messages.pb.h"
-
 #define ONE_KB (0x400)
 #define ONE_MB (ONE_KB * ONE_KB)
 #define PAGESIZE (ONE_MB)
 #define ADDRBITS (20)
-#define N_1MBARRAYS 4096
 
+// Device memory is mapped in regions of 4GB
+#define REGIONBITS (32)
+#define REGIONSIZE (uint64_t(1) << REGIONBITS)
+
+/*
+ * mem_model - device memory of the DDR model.
+ *
+ * Device memory is backed by one sparse file in which the file offset
+ * of a byte is its device address.  The file is mapped on demand in
+ * regions of REGIONSIZE, such that finding the host address of a device
+ * address is a table lookup and pointer arithmetic.  Regions that are
+ * never written take no storage, and the content of device memory
+ * persists in the file without serialization.
+ */
 class mem_model{
 public:
 unsigned int writeDevMem(uint64_t offset, const void* src, unsigned int size);
@@ -42,14 +55,12 @@ unsigned int readDevMem(uint64_t offset, void* dest, unsigned int size);
 
 protected:
 private:
-  unsigned char* get_page(uint64_t offset);
-  std::string get_mem_file_name(uint64_t pageIdx);
-  std::map<uint64_t,unsigned char*> pageCache;
-  std::map<uint64_t,unsigned char*>::iterator pageCacheItr;
-
-  ddr_mem_msg serialize_msg;
-  ddr_mem_msg deserialize_msg;
-  void serialize();
+  unsigned char* get_region(uint64_t offset);
+  std::string get_mem_file_name();
+  std::vector<unsigned char*> mRegions;
+  uint64_t mFileSize;
+  int mFd;
+
   std::string mDeviceName;
   std::string module_name;
 public:
@@ -58,5 +69,3 @@ public:
 };
 
 #endif
-
-
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2025 Advanced Micro Devices, Inc. All rights reserved.
+
+// Throughput of the hw_emu DDR model for sequential and random access.
+// Also checks that data written is read back, across region boundaries,
+// and that the content persists in the backing file.
+//
+// % mem_model_bench [MB]
+
+#include "mem_model.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t sequential_block = 64 * ONE_KB;
+constexpr uint64_t random_block = 4 * ONE_KB;
+
+// Device address range spanning a region boundary and a far away region
+constexpr uint64_t base_addr = REGIONSIZE - 8 * ONE_MB;
+constexpr uint64_t far_addr = 0x40'0000'0000;
+
+std::string
+device_name()
+{
+  return "mem_model_bench_" + std::to_string(getpid());
+}
+
+template <typename Function>
+double
+mbps(uint64_t bytes, Function&& f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  return bytes / elapsed.count() / ONE_MB;
+}
+
+void
+check(bool cond, const char* msg)
+{
+  if (!cond)
+    throw std::runtime_error(msg);
+}
+
+void
+run(uint64_t size)
+{
+  auto model = std::make_unique<mem_model>(device_name());
+  std::vector<unsigned char> wbuf(sequential_block);
+  std::vector<unsigned char> rbuf(sequential_block);
+  for (size_t i = 0; i < wbuf.size(); ++i)
+    wbuf[i] = static_cast<unsigned char>(i * 7 + 1);
+
+  auto seq_write = mbps(size, [&] {
+    for (uint64_t off = 0; off < size; off += sequential_block)
+      model->writeDevMem(base_addr + off, wbuf.data(), sequential_block);
+  });
+  auto seq_rewrite = mbps(size, [&] {
+    for (uint64_t off = 0; off < size; off += sequential_block)
+      model->writeDevMem(base_addr + off, wbuf.data(), sequential_block);
+  });
+  auto seq_read = mbps(size, [&] {
+    for (uint64_t off = 0; off < size; off += sequential_block)
+      model->readDevMem(base_addr + off, rbuf.data(), sequential_block);
+  });
+  check(std::memcmp(wbuf.data(), rbuf.data(), sequential_block) == 0, "sequential read back mismatch");
+
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<uint64_t> dist(0, size - random_block);
+  auto ops = size / random_block;
+  std::vector<uint64_t> addrs(ops);
+  for (auto& addr : addrs)
+    addr = base_addr + dist(rng);
+
+  auto rnd_write = mbps(size, [&] {
+    for (auto addr : addrs)
+      model->writeDevMem(addr, wbuf.data(), random_block);
+  });
+  auto rnd_read = mbps(size, [&] {
+    for (auto addr : addrs)
+      model->readDevMem(addr, rbuf.data(), random_block);
+  });
+
+  // Last random write to an address wins, read it back
+  model->readDevMem(addrs.back(), rbuf.data(), random_block);
+  check(std::memcmp(wbuf.data(), rbuf.data(), random_block) == 0, "random read back mismatch");
+
+  // Write across region boundary and far away, then reopen the model
+  model->writeDevMem(REGIONSIZE - 100, wbuf.data(), 200);
+  model->writeDevMem(far_addr, wbuf.data(), 200);
+  model = std::make_unique<mem_model>(device_name());
+  model->readDevMem(REGIONSIZE - 100, rbuf.data(), 200);
+  check(std::memcmp(wbuf.data(), rbuf.data(), 200) == 0, "region boundary mismatch");
+  model->readDevMem(far_addr, rbuf.data(), 200);
+  check(std::memcmp(wbuf.data(), rbuf.data(), 200) == 0, "persisted content mismatch");
+
+  std::cout << "sequential write " << seq_write << " MB/s, rewrite " << seq_rewrite
+            << " MB/s, read " << seq_read << " MB/s\n"
+            << "random " << random_block << "B write " << rnd_write << " MB/s, read " << rnd_read << " MB/s\n";
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  uint64_t size = (argc > 1 ? std::strtoull(argv[1], nullptr, 0) : 256) * ONE_MB;
+  int status = EXIT_SUCCESS;
+  try {
+    run(size);
+    std::cout << "PASSED\n";
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "FAILED: " << ex.what() << '\n';
+    status = EXIT_FAILURE;
+  }
+
+  std::string user = getenv("USER") ? getenv("USER") : "";
+  std::string dir = "/tmp/" + user + "/" + std::to_string(getpid());
+  if (system(("rm -rf " + dir).c_str()) == -1)
+    std::cerr << "Failed to remove " << dir << '\n';
+  return status;
+}
@@ -2075,16 +2075,11 @@ namespace xclswemuhal2
 */
   int SwEmuShim::xclExecWait(int timeoutMilliSec)
   {
-    //unsigned int tSec = 0;
-    //static bool bConfig = true;
-    //tSec = timeoutMilliSec / 1000;
-    //if (bConfig)
-    //{
-    //  tSec = timeoutMilliSec / 1000;
-    //  bConfig = false;
-    //}
-    //sleep(tSec);
-    //PRINTENDFUNC;
+    // Block until the scheduler completes a command, command state is
+    // updated prior to the scheduler signalling completion
+    if (mIsKdsSwEmu && mSWSch)
+      return mSWSch->wait_for_completion(timeoutMilliSec);
+
     return 1;
   }
 
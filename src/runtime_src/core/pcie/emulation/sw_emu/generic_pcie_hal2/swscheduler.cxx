@@ -5,11 +5,16 @@
 
 #include "shim.h"
 #include <algorithm>
+#include <chrono>
 //#define EM_DEBUG_KDS
 #define PRINTSTARTFUNC
 //#define PRINTSTARTFUNC std::cout <<"swscheduler: " <<__func__ << " begin " << std::endl;
 namespace xclswemuhal2 {
 
+  /* Interval at which running commands are polled, the device does not
+   * signal completion */
+  static const std::chrono::microseconds poll_interval(10);
+
   xocl_cmd::xocl_cmd()
   {
     bo = NULL;
@@ -17,6 +22,8 @@ namespace xclswemuhal2 {
     cu_idx = 0;
     slot_idx = 0;
     packet = NULL;
+    next = NULL;
+    cu_next = NULL;
     state = ERT_CMD_STATE_NEW;
   }
 
@@ -27,6 +34,52 @@ namespace xclswemuhal2 {
     cu_idx = 0;
     slot_idx = 0;
     packet = NULL;
+    next = NULL;
+  }
+
+  void cmd_list::push_back(xocl_cmd* xcmd)
+  {
+    xcmd->*link = nullptr;
+    if (tail)
+      tail->*link = xcmd;
+    else
+      head = xcmd;
+    tail = xcmd;
+    ++size;
+  }
+
+  xocl_cmd* cmd_list::pop_front()
+  {
+    xocl_cmd* xcmd = head;
+    if (!xcmd)
+      return nullptr;
+    head = xcmd->*link;
+    if (!head)
+      tail = nullptr;
+    xcmd->*link = nullptr;
+    --size;
+    return xcmd;
+  }
+
+  /* Both lists must use the same link */
+  void cmd_list::splice(cmd_list& other)
+  {
+    if (other.empty())
+      return;
+    if (tail)
+      tail->*link = other.head;
+    else
+      head = other.head;
+    tail = other.tail;
+    size += other.size;
+    other.head = other.tail = nullptr;
+    other.size = 0;
+  }
+
+  static void delete_cmds(cmd_list& cmds)
+  {
+    while (xocl_cmd* xcmd = cmds.pop_front())
+      delete xcmd;
   }
 
   xocl_sched::xocl_sched (SWScheduler* _sch)
@@ -104,6 +157,7 @@ namespace xclswemuhal2 {
   }
 
   xocl_cu::xocl_cu()
+    : ready_queue(&xocl_cmd::cu_next), running_queue(&xocl_cmd::cu_next)
   {
     idx = 0;
     base = 0;
@@ -239,7 +293,7 @@ namespace xclswemuhal2 {
     if (!xcu->done_cnt && xcu->run_cnt)
       cu_poll(xcu);
 
-    return xcu->done_cnt ? (xcu->running_queue).front() : NULL;
+    return xcu->done_cnt ? xcu->running_queue.front() : NULL;
   }
 
   void SWScheduler::cu_pop_done(struct xocl_cu *xcu)
@@ -248,9 +302,7 @@ namespace xclswemuhal2 {
     if (!xcu->done_cnt)
       return;
 
-    //	struct xocl_cmd *xcmd;
-    //xcmd = (xcu->running_queue).front();
-    (xcu->running_queue).pop();
+    xcu->running_queue.pop_front();
     --xcu->done_cnt;
   }
 
@@ -274,21 +326,12 @@ namespace xclswemuhal2 {
   bool SWScheduler::cmd_has_cu(struct xocl_cmd* xcmd, uint32_t f_cu_idx)
   {
     PRINTSTARTFUNC
-    uint32_t mask_idx = 0;
-    uint32_t num_masks = cu_masks(xcmd);
-    for (mask_idx=0; mask_idx<num_masks; ++mask_idx)
-    {
-      uint32_t cmd_mask = xcmd->packet->data[mask_idx]; /* skip header */
-      uint32_t cu_idx = cu_idx_in_mask (f_cu_idx);
-      if(cu_mask_idx(f_cu_idx) < mask_idx)
-        return false;
+    uint32_t mask_idx = cu_mask_idx(f_cu_idx);
+    if (mask_idx >= cu_masks(xcmd))
+      return false;
 
-      if( isKthBitSet(cmd_mask, cu_idx))
-      {
-        return true;
-      }
-    }
-    return false;
+    uint32_t cmd_mask = xcmd->packet->data[mask_idx]; /* skip header */
+    return isKthBitSet(cmd_mask, cu_idx_in_mask(f_cu_idx));
   }
 
   void cu_reset(xocl_cu* xcu, unsigned int idx, uint32_t base, uint32_t addr, uint32_t polladdr)
@@ -311,6 +354,12 @@ namespace xclswemuhal2 {
     mParent = _parent;
     mScheduler = new xocl_sched(this);
     num_pending = 0;
+    cu_exec = nullptr;
+    num_configuring = 0;
+    num_active = 0;
+    num_retired = 0;
+    num_completed = 0;
+    num_completed_seen = 0;
   }
 
   SWScheduler::~SWScheduler()
@@ -445,7 +494,7 @@ namespace xclswemuhal2 {
           //exec_release_slot(exec, xcmd);
           xcmd->cu_idx = cuidx;
           ++xcmd->exec->cu_usage[xcmd->cu_idx];
-          (xcu->running_queue).push(xcmd);
+          xcu->running_queue.push_back(xcmd);
           return true;
         }
       }
@@ -661,10 +710,10 @@ namespace xclswemuhal2 {
       for ( cuidx=0; cuidx<exec->num_cus; cuidx++)
       {
         exec->cu_addr_map[cuidx] = cfg->data[cuidx];
-        xocl_cu* nCu = new xocl_cu();
-        exec->cus[cuidx] =  nCu;
+        if (!exec->cus[cuidx])
+          exec->cus[cuidx] = new xocl_cu();
         uint32_t polladdr = (ert_poll) ? ERT_CQ_BASE_ADDR + (cuidx+1) * cfg->slot_size : 0;
-        cu_reset(nCu, cuidx, exec->base, cfg->data[cuidx], polladdr);
+        cu_reset(exec->cus[cuidx], cuidx, exec->base, cfg->data[cuidx], polladdr);
       }
 
       bool cdmaEnabled = false;
@@ -752,6 +801,7 @@ namespace xclswemuhal2 {
     if (xcmd->exec->polling_mode)
       mScheduler->poll--;
     release_slot_idx(xcmd->exec,xcmd->slot_idx);
+    ++num_retired;
 #ifdef EM_DEBUG_KDS
     std::cout<<"Marking command Complete XCMD: " <<xcmd<<" PACKET: "<<xcmd->packet<< " BO: "<< xcmd->bo << std::endl;
     std::cout<<"Releasing slot " << xcmd->slot_idx << std::endl<<std::endl;
@@ -846,8 +896,22 @@ namespace xclswemuhal2 {
   xocl_cmd* SWScheduler::get_free_xocl_cmd(void)
   {
     PRINTSTARTFUNC
-    xocl_cmd* cmd = new xocl_cmd;
-    return cmd;
+    {
+      std::lock_guard<std::mutex> lk(free_cmds_mutex);
+      if (xocl_cmd* xcmd = free_cmds.pop_front())
+        return xcmd;
+    }
+    return new xocl_cmd;
+  }
+
+  void SWScheduler::complete_to_free(xocl_cmd *xcmd)
+  {
+    PRINTSTARTFUNC
+    if (opcode(xcmd) == ERT_CONFIGURE)
+      --num_configuring;
+    --num_active;
+    std::lock_guard<std::mutex> lk(free_cmds_mutex);
+    free_cmds.push_back(xcmd);
   }
 
   int SWScheduler::convert_execbuf(exec_core *exec, xclemulation::drm_xocl_bo *xobj, xocl_cmd* xcmd)
@@ -917,7 +981,6 @@ namespace xclswemuhal2 {
   int SWScheduler::add_cmd(exec_core *exec, xclemulation::drm_xocl_bo* bo)
   {
     PRINTSTARTFUNC
-    std::lock_guard<std::mutex> lk(pending_cmds_mutex);
     xocl_cmd *xcmd = get_free_xocl_cmd();
     xcmd->packet = (struct ert_packet*)bo->buf;
     xcmd->bo=bo;
@@ -930,131 +993,258 @@ namespace xclswemuhal2 {
 #endif
 
     set_cmd_state(xcmd,ERT_CMD_STATE_NEW);
-    pending_cmds.push_back(xcmd);
-    num_pending++;
-    scheduler_wait_condition();
+    {
+      std::lock_guard<std::mutex> lk(pending_cmds_mutex);
+      pending_cmds.push_back(xcmd);
+      num_pending++;
+    }
+    mScheduler->state_cond.notify_one();
     return ret;
   }
-  
-  int SWScheduler::scheduler_wait_condition()
-  {   
-    PRINTSTARTFUNC
-    bool bSchComeOutOfCond = false;
-    if (mScheduler->stop || mScheduler->error) {
-      bSchComeOutOfCond = true;
-    }
 
-    if (num_pending > 0) {
-      bSchComeOutOfCond = true;
-    }
+  bool SWScheduler::cu_cmd(struct xocl_cmd *xcmd)
+  {
+    return type(xcmd) == ERT_CU
+      && (opcode(xcmd) == ERT_START_CU || opcode(xcmd) == ERT_EXEC_WRITE);
+  }
+
+  /* CU commands are dispatched to per CU ready queues once the exec core
+   * is configured for scheduling by the host (penguin mode).  All other
+   * commands go through the command_queue state machine. */
+  bool SWScheduler::cu_schedulable(struct xocl_cmd *xcmd)
+  {
+    exec_core *exec = xcmd->exec;
+    if (!exec->num_cus || exec->ertfull || exec->ertpoll)
+      return false;
+
+    return cu_cmd(xcmd);
+  }
+
+  /* Least loaded CU of the command's CU mask */
+  xocl_cu* SWScheduler::select_cu(struct xocl_cmd *xcmd)
+  {
+    exec_core *exec = xcmd->exec;
+    xocl_cu *selected = nullptr;
+    unsigned int selected_load = 0;
+    for (unsigned int cuidx = 0; cuidx < exec->num_cus; ++cuidx)
+    {
+      xocl_cu *xcu = exec->cus[cuidx];
+      if (!xcu || !cmd_has_cu(xcmd, cuidx))
+        continue;
 
-    if (mScheduler->intc > 0) {
-      mScheduler->intc = 0;
-      bSchComeOutOfCond = true;
+      unsigned int load = xcu->ready_queue.size + xcu->running_queue.size;
+      if (!selected || load < selected_load)
+      {
+        selected = xcu;
+        selected_load = load;
+      }
     }
+    return selected;
+  }
 
-    if (mScheduler->poll >0 ) {
-      bSchComeOutOfCond = true;
+  /* In penguin mode a CU command is on a CU queue, scheduled by
+   * cu_schedule, and never on command_queue.  There penguin_submit would
+   * start it and cu_schedule could retire it while still queued.  A
+   * command with no CU of its CU mask fails. */
+  void SWScheduler::dispatch_cmd(struct xocl_cmd *xcmd)
+  {
+    bool schedulable = cu_schedulable(xcmd);
+    xocl_cu *xcu = schedulable ? select_cu(xcmd) : nullptr;
+    if (xcu)
+    {
+      cu_exec = xcmd->exec;
+      xcu->ready_queue.push_back(xcmd);
     }
-    if(bSchComeOutOfCond)
+    else if (schedulable)
     {
-      //pthread_cond_signal(&mScheduler->state_cond);
-      mScheduler->state_cond.notify_one();
-      return 0;
+      set_cmd_state(xcmd, ERT_CMD_STATE_ERROR);
+      ++num_retired;
+      notify_host(xcmd);
+      complete_to_free(xcmd);
     }
-    return 1;
+    else
+      mScheduler->command_queue.push_back(xcmd);
+#ifdef EM_DEBUG_KDS
+    std::cout<<xcmd <<" queued to "<< (xcu ? "CU " + std::to_string(xcu->idx) : "command_queue") << std::endl;
+#endif
   }
 
-  void SWScheduler::scheduler_queue_cmds()
+  void SWScheduler::scheduler_queue_cmds(cmd_list& cmds)
   {
     //PRINTSTARTFUNC
-    if(pending_cmds.empty())
-      return;
-
 #ifdef EM_DEBUG_KDS
-    std::cout<<"Iterating on pending commands and adding to Scheduler command_queue  "<< std::endl;
+    if (!cmds.empty())
+      std::cout<<"Queueing "<< cmds.size << " pending commands" << std::endl;
 #endif
-    for(auto it: pending_cmds)
+    /* CU commands held until configured go first, in order */
+    if (!num_configuring)
     {
-      xocl_cmd *xcmd = it;
+      while (!cu_wait_queue.empty() && cu_wait_queue.front()->exec->num_cus)
+        dispatch_cmd(cu_wait_queue.pop_front());
+    }
 
+    while (xocl_cmd *xcmd = cmds.pop_front())
+    {
       /* CU style commands must specify CU type */
       if (opcode(xcmd) == ERT_START_CU || opcode(xcmd) == ERT_EXEC_WRITE)
         xcmd->packet->type = ERT_CU;
 
-      mScheduler->command_queue.push_back(xcmd);
       xcmd->state = ERT_CMD_STATE_QUEUED;
-#ifdef EM_DEBUG_KDS
-    std::cout<<xcmd <<" ADDED to Scheduler command_queue  "<< std::endl;
-#endif
-      num_pending--;
+      ++num_active;
+
+      /* The scheduling mode of a CU command is known only once the
+       * exec core is configured */
+      if (cu_cmd(xcmd)
+          && (num_configuring || !xcmd->exec->num_cus || !cu_wait_queue.empty()))
+      {
+        cu_wait_queue.push_back(xcmd);
+        continue;
+      }
+
+      if (opcode(xcmd) == ERT_CONFIGURE)
+        ++num_configuring;
+      dispatch_cmd(xcmd);
     }
-    pending_cmds.clear();
   }
 
   void SWScheduler::scheduler_iterate_cmds()
   {
     //PRINTSTARTFUNC
-     auto end = mScheduler->command_queue.end();
-#ifdef EM_DEBUG_KDS
-     //if(mScheduler->command_queue.size() > 0)
-     //  std::cout<<" command_queue size is "<<mScheduler->command_queue.size()<< std::endl;
-#endif
-     for (auto itr=mScheduler->command_queue.begin(); itr!=end; )
-     {
-       xocl_cmd *xcmd = *itr;
-       if (xcmd->state == ERT_CMD_STATE_QUEUED)
-       {
+    /* visit each command once, commands not completed are requeued in order */
+    for (unsigned int count = mScheduler->command_queue.size; count; --count)
+    {
+      xocl_cmd *xcmd = mScheduler->command_queue.pop_front();
+      if (xcmd->state == ERT_CMD_STATE_QUEUED)
+      {
 #ifdef EM_DEBUG_KDS
-         std::cout<<xcmd << " is in QUEUED state  "<< std::endl;
+        std::cout<<xcmd << " is in QUEUED state  "<< std::endl;
 #endif
-         queued_to_running(xcmd);
-       }
-       if (xcmd->state == ERT_CMD_STATE_RUNNING)
-       {
-         running_to_complete(xcmd);
-       }
-
-       if (xcmd->state == ERT_CMD_STATE_COMPLETED)
-       {
+        queued_to_running(xcmd);
+      }
+      if (xcmd->state == ERT_CMD_STATE_RUNNING)
+      {
+        running_to_complete(xcmd);
+      }
+
+      if (xcmd->state == ERT_CMD_STATE_COMPLETED)
+      {
 #ifdef EM_DEBUG_KDS
-         std::cout<<xcmd << " is in COMPLETED state  "<< std::endl;
+        std::cout<<xcmd << " is in COMPLETED state  "<< std::endl;
 #endif
-         complete_to_free(xcmd);
-         itr = mScheduler->command_queue.erase(itr);
-         end = mScheduler->command_queue.end();
-       }
-       else {
-         ++itr;
-       }
-     }
+        complete_to_free(xcmd);
+      }
+      else
+        mScheduler->command_queue.push_back(xcmd);
+    }
+  }
+
+  /* Retire done commands of a CU, then start ready commands for as long
+   * as the CU accepts them.  Only a dataflow CU accepts a command while
+   * running. */
+  void SWScheduler::cu_schedule(xocl_cu *xcu)
+  {
+    while (xocl_cmd *xcmd = cu_first_done(xcu))
+    {
+      cu_pop_done(xcu);
+      mark_cmd_complete(xcmd);
+      complete_to_free(xcmd);
+    }
+
+    while (!xcu->ready_queue.empty() && (xcu->dataflow || !xcu->run_cnt) && cu_ready(xcu))
+    {
+      xocl_cmd *xcmd = xcu->ready_queue.front();
+      int l_slot_idx = acquire_slot(xcmd);
+      if (l_slot_idx < 0)
+        return;
 
+      xcu->ready_queue.pop_front();
+      xcmd->slot_idx = l_slot_idx;
+      xcmd->cu_idx = xcu->idx;
+      cu_start(xcu, xcmd);
+      ++xcmd->exec->cu_usage[xcu->idx];
+      xcu->running_queue.push_back(xcmd);
+
+      set_cmd_state(xcmd,ERT_CMD_STATE_RUNNING);
+      if (xcmd->exec->polling_mode)
+        mScheduler->poll++;
+      xcmd->exec->submitted_cmds[xcmd->slot_idx] = xcmd;
+    }
   }
 
-  void scheduler_loop(xocl_sched *xs)
+  void SWScheduler::scheduler_iterate_cus()
+  {
+    //PRINTSTARTFUNC
+    if (!cu_exec)
+      return;
+
+    for (unsigned int cuidx = 0; cuidx < cu_exec->num_cus; ++cuidx)
+    {
+      xocl_cu *xcu = cu_exec->cus[cuidx];
+      if (xcu && (!xcu->ready_queue.empty() || !xcu->running_queue.empty()))
+        cu_schedule(xcu);
+    }
+  }
+
+  void SWScheduler::scheduler_notify_completions()
+  {
+    if (!num_retired)
+      return;
+
+    {
+      std::lock_guard<std::mutex> lk(completion_mutex);
+      num_completed += num_retired;
+    }
+    num_retired = 0;
+    completion_cond.notify_all();
+  }
+
+  int SWScheduler::wait_for_completion(int timeoutMilliSec)
+  {
+    std::unique_lock<std::mutex> lk(completion_mutex);
+    auto completed = [this] { return num_completed != num_completed_seen; };
+    if (!completion_cond.wait_for(lk, std::chrono::milliseconds(std::max(timeoutMilliSec, 0)), completed))
+      return 0;
+
+    num_completed_seen = num_completed;
+    return 1;
+  }
+
+  bool scheduler_loop(xocl_sched *xs)
   {
     //PRINTSTARTFUNC
     SWScheduler* pSch = xs->pSch;
-    std::lock_guard<std::mutex> lk(pSch->pending_cmds_mutex);
+    cmd_list cmds;
+    {
+      std::unique_lock<std::mutex> lk(pSch->pending_cmds_mutex);
+      auto wakeup = [xs, pSch] { return xs->stop || !pSch->pending_cmds.empty(); };
 
-    if (xs->error) { return; }
+      /* sleep until new commands arrive, or poll while commands are active */
+      if (pSch->num_active)
+        xs->state_cond.wait_for(lk, poll_interval, wakeup);
+      else
+        xs->state_cond.wait(lk, wakeup);
 
-    /* queue new pending commands */
-    pSch->scheduler_queue_cmds();
+      if (xs->stop || xs->error)
+        return false;
 
-    /* iterate all commands */
+      /* take all pending commands at once */
+      cmds.splice(pSch->pending_cmds);
+      pSch->num_pending = 0;
+    }
+
+    pSch->scheduler_queue_cmds(cmds);
     pSch->scheduler_iterate_cmds();
+    pSch->scheduler_iterate_cus();
+    pSch->scheduler_notify_completions();
+    return true;
   }
 
   void* scheduler(void* data)
   {
     PRINTSTARTFUNC
     xocl_sched *xs = (xocl_sched *)data;
-    while (!xs->stop && !xs->error)
-    {
-      scheduler_loop(xs);
-      usleep(10);
-    }
+    while (scheduler_loop(xs))
+      ;
     return NULL;
   }
 
@@ -1071,7 +1261,7 @@ namespace xclswemuhal2 {
     //int returnStatus  =  pthread_create(&(mScheduler->scheduler_thread) , NULL, scheduler, (void *)mScheduler);
     int returnStatus = 0;
     mScheduler->scheduler_thread = std::thread(scheduler, (void *)mScheduler);
-   
+
     if (returnStatus != 0)
     {
       std::cout << __func__ <<  " pthread_create failed " << " " << returnStatus<< std::endl;
@@ -1092,19 +1282,37 @@ namespace xclswemuhal2 {
     std::cout<<"SWScheduler Thread ended "<< std::endl;
 #endif
 
-    mScheduler->stop= true;
-    scheduler_wait_condition();
+    {
+      std::lock_guard<std::mutex> lk(pending_cmds_mutex);
+      mScheduler->stop= true;
+    }
+    mScheduler->state_cond.notify_one();
     mScheduler->bThreadCreated = false;
-    
+
     //int retval = pthread_join(mScheduler->scheduler_thread,NULL);
     int retval = 0;
-    
+
     if (mScheduler->scheduler_thread.joinable())
       mScheduler->scheduler_thread.join();
-   
-    pending_cmds.clear();
-    mScheduler->command_queue.clear();
-    free_cmds.clear();
+
+    delete_cmds(pending_cmds);
+    delete_cmds(cu_wait_queue);
+    delete_cmds(mScheduler->command_queue);
+    if (cu_exec)
+    {
+      for (unsigned int cuidx = 0; cuidx < cu_exec->num_cus; ++cuidx)
+      {
+        if (xocl_cu *xcu = cu_exec->cus[cuidx])
+        {
+          delete_cmds(xcu->ready_queue);
+          delete_cmds(xcu->running_queue);
+        }
+      }
+    }
+    delete_cmds(free_cmds);
+    num_pending = 0;
+    num_configuring = 0;
+    num_active = 0;
 
     return retval;
   }
@@ -10,7 +10,6 @@
 #include <mutex>
 #include <cmath>
 #include <cstdint>
-#include <queue>
 #include <thread>
 #include <condition_variable>
 #include "xrt/detail/ert.h"
@@ -34,6 +33,43 @@ namespace xclswemuhal2 {
     std::mutex mLock;
   };
 
+  class xocl_cmd
+  {
+    public:
+      xclemulation::drm_xocl_bo *bo;
+      exec_core *exec;
+      enum ert_cmd_state state;
+      unsigned int cu_idx;
+      int slot_idx;
+      /* The actual cmd object representation */
+      struct ert_packet *packet;
+      /* Link of the scheduler cmd_list the command is on */
+      xocl_cmd *next;
+      /* Link of the CU ready or running queue the command is on */
+      xocl_cmd *cu_next;
+      xocl_cmd();
+      ~xocl_cmd();
+  };
+
+  /* Intrusive FIFO of commands, linked through xocl_cmd::next or, for
+   * CU queues, xocl_cmd::cu_next.  A command is on at most one list of
+   * each link at a time. */
+  class cmd_list
+  {
+    public:
+      xocl_cmd*     head;
+      xocl_cmd*     tail;
+      unsigned int  size;
+      xocl_cmd* xocl_cmd::* link;
+      explicit cmd_list(xocl_cmd* xocl_cmd::* l = &xocl_cmd::next)
+        : head(nullptr), tail(nullptr), size(0), link(l) {}
+      bool empty() const { return head == nullptr; }
+      xocl_cmd* front() const { return head; }
+      void push_back(xocl_cmd* xcmd);
+      xocl_cmd* pop_front();
+      void splice(cmd_list& other);
+  };
+
   class xocl_sched
   {
     public:
@@ -41,8 +77,9 @@ namespace xclswemuhal2 {
       std::thread                 scheduler_thread;
       //pthread_mutex_t             state_lock;
       //pthread_cond_t              state_cond;
-      std::condition_variable_any    state_cond;
-      std::list<xocl_cmd*>        command_queue;
+      std::condition_variable     state_cond;
+      /* Commands not dispatched to a CU ready queue */
+      cmd_list                    command_queue;
       bool                        bThreadCreated;
       unsigned int                error;
       int                         intc;
@@ -64,25 +101,14 @@ namespace xclswemuhal2 {
       uint32_t           ctrlreg;
       unsigned int       done_cnt;
       unsigned int       run_cnt;
-      std::queue<xocl_cmd*>         running_queue;
+      /* Commands assigned to the CU, waiting for the CU to be ready */
+      cmd_list           ready_queue;
+      /* Started commands, in order of start */
+      cmd_list           running_queue;
       xocl_cu();
       ~xocl_cu();
   };
 
-  class xocl_cmd
-  {
-    public:
-      xclemulation::drm_xocl_bo *bo;
-      exec_core *exec;
-      enum ert_cmd_state state;
-      unsigned int cu_idx;
-      int slot_idx;
-      /* The actual cmd object representation */
-      struct ert_packet *packet;
-      xocl_cmd();
-      ~xocl_cmd();
-  };
-
   class exec_core 
   {
     public:
@@ -167,12 +193,18 @@ namespace xclswemuhal2 {
     void mark_mask_complete(exec_core *exec, uint32_t mask, unsigned int mask_idx);
     int queued_to_running(xocl_cmd *xcmd) ;
     void running_to_complete(xocl_cmd *xcmd) ;
-    void complete_to_free(xocl_cmd *xcmd) { }
+    void complete_to_free(xocl_cmd *xcmd) ;
     xocl_cmd* get_free_xocl_cmd(void) ; 
     int add_cmd(exec_core *exec, xclemulation::drm_xocl_bo* bo) ;
-    int scheduler_wait_condition() ;
-    void scheduler_queue_cmds();
+    void scheduler_queue_cmds(cmd_list& cmds);
     void scheduler_iterate_cmds();
+    void scheduler_iterate_cus();
+    void scheduler_notify_completions();
+    bool cu_cmd(struct xocl_cmd *xcmd);
+    bool cu_schedulable(struct xocl_cmd *xcmd);
+    void dispatch_cmd(struct xocl_cmd *xcmd);
+    xocl_cu* select_cu(struct xocl_cmd *xcmd);
+    void cu_schedule(xocl_cu *xcu);
     int get_free_cu(struct xocl_cmd *xcmd);
     void configure_cu(struct xocl_cmd *xcmd, int cu_idx);
     bool cu_done(struct exec_core *exec, unsigned int cu_idx);
@@ -188,27 +220,48 @@ namespace xclswemuhal2 {
     bool cu_ready(xocl_cu *xcu);
     bool cu_start(xocl_cu *xcu, xocl_cmd *xcmd);
 
-    friend void scheduler_loop(xocl_sched *xs);
+    friend bool scheduler_loop(xocl_sched *xs);
     friend void* scheduler(void* data) ;
 
     int init_scheduler_thread(void) ;
     int fini_scheduler_thread(void) ;
     int add_exec_buffer(exec_core *eCore , xclemulation::drm_xocl_bo *buf) ;
     int convert_execbuf(exec_core *exec, xclemulation::drm_xocl_bo *xobj, xocl_cmd* xcmd);
+    /* Wait for completion of any command since the previous call,
+     * returns 0 on timeout */
+    int wait_for_completion(int timeoutMilliSec);
 
     xocl_sched* mScheduler;
     SWScheduler(SwEmuShim* _parent);
     ~SWScheduler();
     SwEmuShim* mParent;
     private:
-    std::list<xocl_cmd*> free_cmds;
+    /* Pool of command objects for reuse */
+    cmd_list free_cmds;
     std::mutex free_cmds_mutex;
 
-    std::list<xocl_cmd*> pending_cmds;
+    cmd_list pending_cmds;
     std::mutex pending_cmds_mutex;
 
     std::mutex m_add_cmd_mutex;
     int num_pending;
+
+    /* Scheduler thread only: exec core of commands on CU ready
+     * queues, commands not yet freed, and commands completed in the
+     * current iteration */
+    exec_core* cu_exec;
+    /* Scheduler thread only: CU commands held while the exec core is
+     * not configured, and configure commands not yet freed */
+    cmd_list cu_wait_queue;
+    unsigned int num_configuring;
+    unsigned int num_active;
+    unsigned int num_retired;
+
+    /* Completed commands, published once per scheduler iteration */
+    std::mutex completion_mutex;
+    std::condition_variable completion_cond;
+    uint64_t num_completed;
+    uint64_t num_completed_seen;
   };
 }
 
@@ -1222,12 +1222,18 @@ struct function4_get : virtual QueryRequestType
 
 static std::map<xrt_core::query::key_type, std::unique_ptr<query::request>> query_tbl;
 
+// Attributes of integer sysfs_get requests, these are read in one
+// snapshot by the sensor_snapshot request
+static std::map<xrt_core::query::key_type, xrt_core::pci::sysfs_snapshot::entry_type> sysfs_tbl;
+
 template <typename QueryRequestType>
 static void
 emplace_sysfs_get(const char* subdev, const char* entry)
 {
   auto x = QueryRequestType::key;
   query_tbl.emplace(x, std::make_unique<sysfs_get<QueryRequestType>>(subdev, entry));
+  if constexpr (std::is_integral_v<typename QueryRequestType::result_type>)
+    sysfs_tbl.emplace(x, xrt_core::pci::sysfs_snapshot::entry_type{subdev, entry});
 }
 
 template <typename QueryRequestType, typename Getter>
@@ -1262,6 +1268,46 @@ emplace_sysfs_getput(const char* subdev, const char* entry)
   query_tbl.emplace(x, std::make_unique<sysfs_getput<QueryRequestType>>(subdev, entry));
 }
 
+// Sysfs backed sensors are read through the persistent attribute
+// files of the pci device, other sensors through their query request
+struct sensor_snapshot
+{
+  using result_type = query::sensor_snapshot::result_type;
+
+  static result_type
+  get(const xrt_core::device* device, key_type, const std::any& param)
+  {
+    auto args = std::any_cast<query::sensor_snapshot::args>(param);
+
+    std::vector<xrt_core::pci::sysfs_snapshot::entry_type> entries;
+    for (auto key : args.keys) {
+      auto itr = sysfs_tbl.find(key);
+      if (itr != sysfs_tbl.end())
+        entries.push_back(itr->second);
+    }
+    auto values = get_pcidev(device)->sysfs_get_snapshot(entries, args.max_age);
+
+    result_type data;
+    data.reserve(args.keys.size());
+    auto value = values.begin();
+    for (auto key : args.keys) {
+      if (sysfs_tbl.count(key)) {
+        data.push_back({value->value, value->error});
+        ++value;
+        continue;
+      }
+
+      try {
+        data.push_back(query::sensor_snapshot::to_data(device->query(key)));
+      }
+      catch (const std::exception& ex) {
+        data.push_back({0, ex.what()});
+      }
+    }
+    return data;
+  }
+};
+
 static void
 initialize_query_table()
 {
@@ -1493,6 +1539,7 @@ initialize_query_table()
   emplace_func4_request<query::host_max_bandwidth_mbps,        host_max_bandwidth_mbps>();
   emplace_func4_request<query::kernel_max_bandwidth_mbps,      kernel_max_bandwidth_mbps>();
   emplace_func4_request<query::read_trace_data,                read_trace_data>();
+  emplace_func4_request<query::sensor_snapshot,                sensor_snapshot>();
 }
 
 struct X { X() { initialize_query_table(); }};
@@ -410,6 +410,14 @@ get_sysfs_path(const std::string& subdev, const std::string& entry)
   return sysfs::get_path(m_sysfs_name, subdev, entry);
 }
 
+std::vector<sysfs_snapshot::value_type>
+dev::
+sysfs_get_snapshot(const std::vector<sysfs_snapshot::entry_type>& entries,
+                   std::chrono::milliseconds max_age)
+{
+  return m_sysfs_snapshot.get(entries, max_age);
+}
+
 std::string
 dev::
 get_subdev_path(const std::string& subdev, uint idx) const
@@ -456,6 +464,9 @@ dev::
 dev(std::shared_ptr<const drv> driver, std::string sysfs)
   : m_sysfs_name(std::move(sysfs))
   , m_driver(std::move(driver))
+  , m_sysfs_snapshot([this](const std::string& subdev, const std::string& entry) {
+      return get_sysfs_path(subdev, entry);
+    })
 {
   std::string err;
 
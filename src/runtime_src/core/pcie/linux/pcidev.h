@@ -5,6 +5,7 @@
 #define _XCL_PCIDEV_H_
 
 #include "device_linux.h"
+#include "sysfs_snapshot.h"
 
 #include <fcntl.h>
 #include <memory>
@@ -131,6 +132,12 @@ public:
   virtual std::string
   get_sysfs_path(const std::string& subdev, const std::string& entry);
 
+  // Read integer attributes, typically sensors, in one call.  The
+  // attribute files are kept open between calls, see sysfs_snapshot.
+  virtual std::vector<sysfs_snapshot::value_type>
+  sysfs_get_snapshot(const std::vector<sysfs_snapshot::entry_type>& entries,
+                     std::chrono::milliseconds max_age);
+
   virtual std::string
   get_subdev_path(const std::string& subdev, uint32_t idx) const;
 
@@ -192,6 +199,7 @@ private:
   mutable char *m_user_bar_map = reinterpret_cast<char *>(MAP_FAILED);
 
   std::shared_ptr<const drv> m_driver;
+  sysfs_snapshot m_sysfs_snapshot;
 };
 
 size_t
@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "sysfs_snapshot.h"
+
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::chrono::seconds retry_interval{1};
+
+// Sensor attributes are a single short line
+constexpr size_t max_value_size = 64;
+
+} // namespace
+
+namespace xrt_core { namespace pci {
+
+sysfs_snapshot::
+sysfs_snapshot(resolver_type resolver)
+  : m_resolver(std::move(resolver))
+{}
+
+sysfs_snapshot::
+~sysfs_snapshot()
+{
+  for (auto& [key, attr] : m_attributes)
+    if (attr.fd >= 0)
+      ::close(attr.fd);
+}
+
+void
+sysfs_snapshot::
+open(attribute& attr, const entry_type& entry, clock::time_point now)
+{
+  attr.open_time = now;
+  if (attr.path.empty())
+    attr.path = m_resolver(entry.subdev, entry.entry);
+
+  if (attr.path.empty()) {
+    std::stringstream ss;
+    ss << "Failed to find subdirectory for " << entry.subdev << std::endl;
+    attr.value = {0, ss.str()};
+    return;
+  }
+
+  attr.fd = ::open(attr.path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (attr.fd < 0) {
+    std::stringstream ss;
+    ss << "Failed to open " << attr.path << " for reading: "
+       << strerror(errno) << std::endl;
+    attr.value = {0, ss.str()};
+  }
+}
+
+void
+sysfs_snapshot::
+read(attribute& attr, const entry_type& entry, clock::time_point now)
+{
+  bool tried = attr.valid;
+  attr.valid = true;
+  attr.read_time = now;
+
+  if (attr.fd < 0) {
+    if (tried && now - attr.open_time < retry_interval)
+      return;
+    open(attr, entry, now);
+    if (attr.fd < 0)
+      return;
+  }
+
+  std::array<char, max_value_size> buf;
+  auto n = ::pread(attr.fd, buf.data(), buf.size() - 1, 0);
+  if (n < 0) {
+    // Attribute may have been recreated, e.g. by driver reload
+    ::close(attr.fd);
+    attr.fd = ::open(attr.path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (attr.fd >= 0)
+      n = ::pread(attr.fd, buf.data(), buf.size() - 1, 0);
+  }
+
+  if (n < 0) {
+    std::stringstream ss;
+    ss << "Failed to read " << attr.path << ": " << strerror(errno) << std::endl;
+    attr.value = {0, ss.str()};
+    if (attr.fd >= 0)
+      ::close(attr.fd);
+    attr.fd = -1;
+    attr.open_time = now;
+    return;
+  }
+
+  std::string s(buf.data(), n);
+  s = s.substr(0, s.find('\n'));
+  if (s.empty()) {
+    std::stringstream ss;
+    ss << "Reading " << attr.path << ", ";
+    ss << "can't convert empty string to integer" << std::endl;
+    attr.value = {0, ss.str()};
+    return;
+  }
+
+  char* end = nullptr;
+  auto value = std::strtoull(s.c_str(), &end, 0);
+  if (*end != '\0') {
+    std::stringstream ss;
+    ss << "Reading " << attr.path << ", ";
+    ss << "failed to convert string to integer: " << s << std::endl;
+    attr.value = {0, ss.str()};
+    return;
+  }
+
+  attr.value = {value, ""};
+}
+
+std::vector<sysfs_snapshot::value_type>
+sysfs_snapshot::
+get(const std::vector<entry_type>& entries, std::chrono::milliseconds max_age)
+{
+  std::vector<value_type> values;
+  values.reserve(entries.size());
+
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto now = clock::now();
+  for (auto& entry : entries) {
+    auto& attr = m_attributes[entry.subdev + "/" + entry.entry];
+    if (!attr.valid || max_age.count() == 0 || now - attr.read_time >= max_age)
+      read(attr, entry, now);
+    values.push_back(attr.value);
+  }
+
+  return values;
+}
+
+}} // pci, xrt_core
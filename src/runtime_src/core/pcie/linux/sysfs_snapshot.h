@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef PCIE_LINUX_SYSFS_SNAPSHOT_H
+#define PCIE_LINUX_SYSFS_SNAPSHOT_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace xrt_core { namespace pci {
+
+// Reader of integer sysfs attributes, typically sensors that are
+// polled periodically by tools.
+//
+// The path of an attribute is resolved once and the attribute file is
+// kept open, a read is a single pread() at offset 0 which makes the
+// driver regenerate the value.  Values are cached and re-read only
+// when older than the max_age of a get() request.  An attribute that
+// cannot be resolved or opened is retried at most once per second.
+class sysfs_snapshot
+{
+public:
+  // Resolve path of entry under subdev, empty string if not found
+  using resolver_type =
+    std::function<std::string(const std::string& subdev, const std::string& entry)>;
+
+  struct entry_type
+  {
+    std::string subdev;
+    std::string entry;
+  };
+
+  struct value_type
+  {
+    uint64_t value = 0;
+    std::string error;  // empty if value is valid
+  };
+
+  explicit
+  sysfs_snapshot(resolver_type resolver);
+
+  ~sysfs_snapshot();
+
+  sysfs_snapshot(const sysfs_snapshot&) = delete;
+  sysfs_snapshot& operator=(const sysfs_snapshot&) = delete;
+
+  // get() - Read a set of attributes
+  //
+  // @entries: attributes to read
+  // @max_age: cached values younger than max_age are not re-read
+  // Return: value of each attribute in order of entries
+  std::vector<value_type>
+  get(const std::vector<entry_type>& entries, std::chrono::milliseconds max_age);
+
+private:
+  using clock = std::chrono::steady_clock;
+
+  struct attribute
+  {
+    std::string path;
+    int fd = -1;
+    value_type value;
+    bool valid = false;              // value has been read
+    clock::time_point read_time;     // time of last read
+    clock::time_point open_time;     // time of last open attempt
+  };
+
+  void
+  open(attribute& attr, const entry_type& entry, clock::time_point now);
+
+  void
+  read(attribute& attr, const entry_type& entry, clock::time_point now);
+
+  resolver_type m_resolver;
+  std::mutex m_mutex;
+  std::map<std::string, attribute> m_attributes;  // subdev/entry
+};
+
+}} // pci, xrt_core
+
+#endif
@@ -0,0 +1,111 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+/*
+ * Exercise the sysfs snapshot with a fake sysfs tree in a temporary
+ * directory.
+ *
+ * The test verifies that values are read and re-read per max_age, that
+ * missing and malformed attributes are reported as errors, and that
+ * each attribute is resolved only once.
+ */
+
+#include "sysfs_snapshot.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+
+#include <unistd.h>
+
+namespace {
+
+namespace sfs = std::filesystem;
+using xrt_core::pci::sysfs_snapshot;
+
+int failures = 0;
+
+void
+check(bool cond, const std::string& what)
+{
+  if (cond)
+    return;
+  std::cout << "FAILED: " << what << std::endl;
+  ++failures;
+}
+
+// Rewrite attribute as the driver would, same inode
+void
+write_attr(const sfs::path& path, const std::string& value)
+{
+  std::ofstream ofs(path, std::ios::out | std::ios::trunc);
+  ofs << value << "\n";
+}
+
+} // namespace
+
+int
+main()
+{
+  auto root = sfs::temp_directory_path() / ("sysfs_snapshot_test." + std::to_string(::getpid()));
+  sfs::create_directories(root / "xmc.u.1");
+  write_attr(root / "xmc.u.1" / "xmc_12v_aux_vol", "12100");
+  write_attr(root / "xmc.u.1" / "xmc_fan_rpm", "0x100");
+  write_attr(root / "xmc.u.1" / "xmc_bad", "hot");
+
+  std::map<std::string, int> resolved;
+  sysfs_snapshot snapshot([&](const std::string& subdev, const std::string& entry) -> std::string {
+    ++resolved[subdev + "/" + entry];
+    if (subdev != "xmc")
+      return "";
+    return (root / "xmc.u.1" / entry).string();
+  });
+
+  std::vector<sysfs_snapshot::entry_type> entries = {
+    {"xmc", "xmc_12v_aux_vol"},
+    {"xmc", "xmc_fan_rpm"},
+    {"xmc", "xmc_bad"},
+    {"xmc", "xmc_missing"},
+    {"icap", "clock_freqs"},
+  };
+
+  auto values = snapshot.get(entries, std::chrono::milliseconds(0));
+  check(values.size() == entries.size(), "one value per entry");
+  check(values[0].error.empty() && values[0].value == 12100, "decimal value");
+  check(values[1].error.empty() && values[1].value == 0x100, "hex value");
+  check(!values[2].error.empty() && values[2].value == 0, "malformed value");
+  check(!values[3].error.empty(), "missing attribute");
+  check(!values[4].error.empty(), "missing subdevice");
+
+  // Value is re-read with max_age of zero, but not within a large max_age
+  write_attr(root / "xmc.u.1" / "xmc_12v_aux_vol", "11900");
+  values = snapshot.get(entries, std::chrono::milliseconds(0));
+  check(values[0].value == 11900, "re-read with zero max_age");
+
+  write_attr(root / "xmc.u.1" / "xmc_12v_aux_vol", "12000");
+  values = snapshot.get(entries, std::chrono::hours(1));
+  check(values[0].value == 11900, "cached within max_age");
+
+  values = snapshot.get(entries, std::chrono::milliseconds(0));
+  check(values[0].value == 12000, "re-read after max_age");
+
+  // Failed attributes are retried at most once per second
+  for (auto& entry : entries) {
+    auto count = resolved[entry.subdev + "/" + entry.entry];
+    check(count == 1, "resolved once: " + entry.subdev + "/" + entry.entry
+          + " " + std::to_string(count));
+  }
+
+  sfs::remove_all(root);
+
+  if (failures) {
+    std::cout << "TEST FAILED" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "TEST PASSED" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -33,6 +33,18 @@ struct xclbin_slots
   }
 };
 
+// Simulated devices are enumerated on bus 0, device number is the index
+struct pcie_bdf
+{
+  using result_type = xrt_core::query::pcie_bdf::result_type;
+
+  static result_type
+  get(const xrt_core::device* device, key_type)
+  {
+    return {0, 0, static_cast<uint16_t>(device->get_device_id()), 0};
+  }
+};
+
 static std::map<xrt_core::query::key_type, std::unique_ptr<xrt_core::query::request>> query_tbl;
 
 template <typename QueryRequestType, typename Getter>
@@ -62,6 +74,7 @@ initialize_query_table()
 {
   emplace_function0_getter<xrt_core::query::kds_cu_info,               kds_cu_info>();
   emplace_function0_getter<xrt_core::query::xclbin_slots,              xclbin_slots>();
+  emplace_function0_getter<xrt_core::query::pcie_bdf,                  pcie_bdf>();
 }
 
 struct X { X() { initialize_query_table(); }};
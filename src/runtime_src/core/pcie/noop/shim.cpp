@@ -24,6 +24,7 @@
 
 #include "core/common/api/hw_context_int.h"
 
+#include <atomic>
 #include <cstdio>
 #include <mutex>
 #include <stdexcept>
@@ -363,6 +364,35 @@ static X x;
 
 } // cmd
 
+// Count buffer syncs and commands, such that the amount of data synced
+// per command can be measured without hardware.  Reported at exit when
+// xrt debug is enabled.  The config reader may be destroyed before the
+// report at exit, so xrt debug is checked when a device is opened.
+namespace stats {
+
+static std::atomic<uint64_t> sync_count {0};
+static std::atomic<uint64_t> sync_bytes {0};
+static std::atomic<uint64_t> cmd_count {0};
+static std::atomic<bool> report {false};
+
+struct X
+{
+  ~X()
+  {
+    if (!report)
+      return;
+
+    std::fprintf(stderr, "noop: %llu commands, %llu syncs, %llu bytes synced, %llu bytes synced per command\n",
+                 static_cast<unsigned long long>(cmd_count), static_cast<unsigned long long>(sync_count),
+                 static_cast<unsigned long long>(sync_bytes),
+                 static_cast<unsigned long long>(cmd_count ? sync_bytes / cmd_count : 0));
+  }
+};
+
+static X x;
+
+} // stats
+
 
 struct shim
 {
@@ -545,6 +575,7 @@ public:
     if (!s_devices[devidx])
       s_devices[devidx] = std::make_shared<pl::device>();
     m_pldev = s_devices[devidx].get();
+    stats::report = xrt_core::config::get_xrt_debug();
   }
 
   // destruct shim object, close the device
@@ -582,8 +613,10 @@ public:
   }
 
   int
-  sync_bo(buffer_handle_type, xclBOSyncDirection, size_t, size_t)
+  sync_bo(buffer_handle_type, xclBOSyncDirection, size_t size, size_t)
   {
+    ++stats::sync_count;
+    stats::sync_bytes += size;
     return 0;
   }
 
@@ -609,6 +642,7 @@ public:
   int
   exec_buf(buffer_handle_type handle)
   {
+    ++stats::cmd_count;
     cmd::add(handle);
     return 0;
   }
@@ -799,7 +833,7 @@ register_xclbin(xclDeviceHandle handle, const xrt::xclbin& xclbin)
 unsigned int
 xclProbe()
 {
-  return 1;
+  return xrt_core::config::get_noop_devices();
 }
 
 xclDeviceHandle
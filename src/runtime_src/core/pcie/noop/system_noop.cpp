@@ -18,6 +18,8 @@
 #include "device_noop.h"
 #include "xrt.h"
 
+#include "core/common/config_reader.h"
+
 #include <memory>
 
 namespace {
@@ -52,7 +54,11 @@ std::pair<device::id_type, device::id_type>
 system::
 get_total_devices(bool is_user) const
 {
-  return {0,0};
+  if (!is_user)
+    return {0,0};
+
+  device::id_type total = xrt_core::config::get_noop_devices();
+  return {total, total};
 }
 
 std::shared_ptr<xrt_core::device>
@@ -29,7 +29,7 @@
 #include <condition_variable>
 #include <queue>
 #include <map>
-#include <atomic>
+#include <set>
 #include <cstdlib>
 #include <cstring>
 #include <functional>
@@ -39,6 +39,7 @@
 #include "pciefunc.h"
 #include "sw_msg.h"
 #include "common.h"
+#include "msgloop.h"
 #include "mpd_plugin.h"
 
 enum Hotplug_state {
@@ -52,10 +53,12 @@ static bool quit = false;
     #define MPD_PLUGIN_PATH "/opt/xilinx/xrt/lib/libmpd_plugin.so"
 #endif
 static const std::string plugin_path(MPD_PLUGIN_PATH);
+// Threads handling msgs of all boards and max msgs of one board handled
+// in a row before moving on to the next board
+static const size_t MPD_HANDLER_THREADS = 4;
+static const size_t MPD_HANDLER_BATCH = 8;
 static struct mpd_plugin_callbacks plugin_cbs;
-static std::map<std::string, std::atomic<bool>> threads_handling;
 static std::map<std::string, enum Hotplug_state> state_machine;
-static std::map<std::string, std::shared_ptr<Msgq<queue_msg>>> threads_msgq;
 static std::map<std::string, std::string>dev_maj_min;
 udev* mpd_hotplug;
 udev_monitor* mpd_hotplug_monitor;
@@ -75,8 +78,8 @@ public:
     void start();
     void run();
     void stop();
-    static void mpd_getMsg(size_t index);
-    static void mpd_handleMsg(size_t index);
+    static bool openEndpoint(size_t index, msgEndpoint& ep);
+    static void logLatency(const std::string& sysfs_name, const msgLatency& l);
     static int localMsgHandler(const pcieFunc& dev,
         std::unique_ptr<sw_msg>& orig,
         std::unique_ptr<sw_msg>& processed);
@@ -85,8 +88,10 @@ public:
         uint16_t port, int id);
     init_fn plugin_init;
     fini_fn plugin_fini;
-    std::map<std::string, std::thread> threads_getMsg;
-    std::map<std::string, std::thread> threads_handleMsg;
+    std::unique_ptr<Msgloop> loop;
+    // boards whose endpoint failed to open or broke, not retried until
+    // the mailbox is re-added
+    std::set<std::string> boards_failed;
 
 private:
     void update_profile_subdev_to_container(const std::string &sysfs_name,
@@ -283,11 +288,14 @@ void Mpd::start()
 void Mpd::run()
 {
     /*
-     * Fire up 2 threads for each board - one is to get msg and the other is to
-     * handle msg. The reason is, in some cases, handle msg may take a relative
-     * long time, eg. downloading a large xclbin, and in this case, one thead
-     * implementation makes the next mailbox msg not read out promptly and ends
-     * up a tx timeout
+     * All boards are served by one msg loop - one I/O thread waits for msgs
+     * on the mailbox and socket fds of all boards and a small pool of threads
+     * handles them. Msgs of one board are handled in order by one handler
+     * thread at a time. The reason for more than one handler thread is, in
+     * some cases, handle msg may take a relative long time, eg. downloading
+     * a large xclbin, and in this case, one thead implementation makes the
+     * next mailbox msg of the other boards not read out promptly and ends up
+     * a tx timeout
      *
      * MPD, running as a daemon, will open mailbox subdevice. As a result, removing
      * the xocl module before mailbox is closed is impossible, this will make
@@ -296,12 +304,16 @@ void Mpd::run()
      * events, which hotplug will produce. For each hotplug, a bunch of events will
      * be produced, here we need to monitor mailbox remove and add events.
      * We maintain a state machine for each fpga. After mpd get started, the state is
-     * initialized as MAILBOX_ADDED, we create pair of threads for each fpga. Whenever
-     * a mailbox remove event is monitored, the state machine changes to MAILBOX_REMOVED,
-     * and the pair of threads will exit and the mailbox will be closed. After a
-     * mailbox add event is monitored, new pair of threads will be created.
+     * initialized as MAILBOX_ADDED, we add an endpoint for each fpga to the msg
+     * loop. Whenever a mailbox remove event is monitored, the state machine changes
+     * to MAILBOX_REMOVED, and the endpoint is removed from the msg loop and the
+     * mailbox will be closed. After a mailbox add event is monitored, a new
+     * endpoint will be added.
      *
      */
+    loop = std::make_unique<Msgloop>(std::min<size_t>(std::max<size_t>(total, 1), MPD_HANDLER_THREADS),
+        MPD_HANDLER_BATCH);
+
     for (size_t i = 0; i < total; i++) {
         std::string sysfs_name = xrt_core::pci::get_dev(i, true)->m_sysfs_name;
 	std::string major_minor;;
@@ -325,23 +337,19 @@ void Mpd::run()
 
             if (state_machine[sysfs_name] != MAILBOX_ADDED)
                 continue;
-            if (threads_getMsg.find(sysfs_name) != threads_getMsg.end() &&
-                threads_handleMsg.find(sysfs_name) != threads_handleMsg.end())
+            if (loop->hasEndpoint(sysfs_name) ||
+                boards_failed.find(sysfs_name) != boards_failed.end())
                 continue;
 
-            threads_handling[sysfs_name] = true;
-
             /*
-             * create the thread pair for it.
+             * add the endpoint for it.
              */
-            syslog(LOG_INFO, "create thread pair for %s", sysfs_name.c_str());
-            std::shared_ptr<Msgq<queue_msg>> msgq = std::make_shared<Msgq<queue_msg>>();
-            threads_msgq[sysfs_name] = msgq;
-            threads_getMsg.insert(std::pair<std::string, std::thread>(sysfs_name,
-                std::move(std::thread(Mpd::mpd_getMsg, i))));
-            threads_handleMsg.insert(std::pair<std::string, std::thread>(sysfs_name,
-                std::move(std::thread(Mpd::mpd_handleMsg, i))));
-            syslog(LOG_INFO, "%ld pairs of threads running...", threads_getMsg.size());
+            syslog(LOG_INFO, "add msg endpoint for %s", sysfs_name.c_str());
+            msgEndpoint ep;
+            if (!openEndpoint(i, ep) || !loop->addEndpoint(sysfs_name, std::move(ep))) {
+                boards_failed.insert(sysfs_name);
+                continue;
+            }
         }
 
 
@@ -375,15 +383,9 @@ void Mpd::run()
             if (action && strcmp(action, "remove") == 0) {
                 if (subdev.find("mailbox.u") != std::string::npos) {
                     state_machine[sysfs_name] = MAILBOX_REMOVED;
-                    threads_handling[sysfs_name] = false;
-                    if (threads_getMsg.find(sysfs_name) != threads_getMsg.end()) {
-                        threads_getMsg[sysfs_name].join();
-                        threads_getMsg.erase(sysfs_name);
-                    }
-                    if (threads_handleMsg.find(sysfs_name) != threads_handleMsg.end()) {
-                        threads_handleMsg[sysfs_name].join();
-                        threads_handleMsg.erase(sysfs_name);
-                    }
+                    logLatency(sysfs_name, loop->getLatency(sysfs_name));
+                    loop->removeEndpoint(sysfs_name);
+                    boards_failed.erase(sysfs_name);
                     syslog(LOG_INFO, "udev: %s %s. Close mailbox", action, devpath);
                 } else {
                     syslog(LOG_INFO, "udev: %s %s of %s", action, subdev.c_str(), devpath);
@@ -407,14 +409,12 @@ void Mpd::run()
 
 void Mpd::stop()
 {
-    // Wait for all threads to finish before quit.
-    for (auto& t : threads_handleMsg) {
-        syslog(LOG_INFO, "%s handleMsg thread exit", t.first.c_str());
-        t.second.join();
-    }
-    for (auto& t : threads_getMsg) {
-        syslog(LOG_INFO, "%s getMsg thread exit", t.first.c_str());
-        t.second.join();
+    // Wait for all msgs in progress to finish before quit.
+    if (loop) {
+        for (auto& s : state_machine)
+            logLatency(s.first, loop->getLatency(s.first));
+        loop->stop();
+        syslog(LOG_INFO, "msg loop exit");
     }
 
     if (mpd_hotplug_monitor)
@@ -668,18 +668,27 @@ int Mpd::localMsgHandler(const pcieFunc& dev, std::unique_ptr<sw_msg>& orig,
     return FOR_LOCAL;
 }
 
-// Client of MPD getting msg. Will quit on any error from either local mailbox or socket fd.
+void Mpd::logLatency(const std::string& sysfs_name, const msgLatency& l)
+{
+    if (l.msgs == 0)
+        return;
+    syslog(LOG_INFO, "%s: %ld msgs in %ld batches, queue latency avg %ldus max %ldus, "
+        "handling avg %ldus max %ldus", sysfs_name.c_str(), l.msgs, l.batches,
+        l.queueUsTotal / l.msgs, l.queueUsMax, l.handleUsTotal / l.msgs, l.handleUsMax);
+}
+
+// Open the msg endpoint of a board served by the msg loop. The endpoint
+// is retired on any error from either local mailbox or socket fd.
 // No retry is ever conducted.
-void Mpd::mpd_getMsg(size_t index)
+bool Mpd::openEndpoint(size_t index, msgEndpoint& ep)
 {
     std::string sysfs_name = xrt_core::pci::get_dev(index, true)->m_sysfs_name;
-    std::shared_ptr<Msgq<queue_msg>> msgq = threads_msgq[sysfs_name];
     int msdfd = -1, mbxfd = -1;
     int ret = 0;
     std::string ip;
     msgHandler cb = nullptr;
 
-    pcieFunc dev(index);
+    auto dev = std::make_shared<pcieFunc>(index);
 
     /*
      * If there is user plugin, then we assume the users either don't want to
@@ -688,44 +697,41 @@ void Mpd::mpd_getMsg(size_t index)
      * mailbox msg and process the msg with the hook function the plugin provides.
      */
     if (plugin_cbs.get_remote_msd_fd) {
-        ret = (*plugin_cbs.get_remote_msd_fd)(dev.getIndex(), &msdfd);
+        ret = (*plugin_cbs.get_remote_msd_fd)(dev->getIndex(), &msdfd);
         if (ret) {
-            dev.log(LOG_ERR, "failed to get remote fd in plugin, mpd_getMsg thread for %s exit!!", sysfs_name.c_str());
-            threads_handling[sysfs_name] = false;
-            return;
+            dev->log(LOG_ERR, "failed to get remote fd in plugin, endpoint for %s not opened", sysfs_name.c_str());
+            return false;
         }
         cb = Mpd::localMsgHandler;
     } else {
-        if (!dev.loadConf()) {
-            dev.log(LOG_ERR, "loadConf() failed, mpd_getMsg thread for %s exit!!", sysfs_name.c_str());
-            threads_handling[sysfs_name] = false;
-            return;
+        if (!dev->loadConf()) {
+            dev->log(LOG_ERR, "loadConf() failed, endpoint for %s not opened", sysfs_name.c_str());
+            return false;
         }
 
-        ip = getIP(dev.getHost());
+        ip = getIP(dev->getHost());
         if (ip.empty()) {
-            dev.log(LOG_ERR, "Can't find out IP from host: %s, mpd_getMsg thread for %s exit!!",
-                    dev.getHost().c_str(), sysfs_name.c_str());
-            threads_handling[sysfs_name] = false;
-            return;
+            dev->log(LOG_ERR, "Can't find out IP from host: %s, endpoint for %s not opened",
+                    dev->getHost().c_str(), sysfs_name.c_str());
+            return false;
         }
 
-        dev.log(LOG_INFO, "peer msd ip=%s, port=%d, id=0x%x",
-            ip.c_str(), dev.getPort(), dev.getId());
+        dev->log(LOG_INFO, "peer msd ip=%s, port=%d, id=0x%x",
+            ip.c_str(), dev->getPort(), dev->getId());
 
-        if ((msdfd = connectMsd(dev, ip, dev.getPort(), dev.getId())) < 0) {
-            dev.log(LOG_ERR, "Unable to connect to msd, mpd_getMsg thread for %s exit!!", sysfs_name.c_str());
-            threads_handling[sysfs_name] = false;
-            return;
+        if ((msdfd = connectMsd(*dev, ip, dev->getPort(), dev->getId())) < 0) {
+            dev->log(LOG_ERR, "Unable to connect to msd, endpoint for %s not opened", sysfs_name.c_str());
+            return false;
         }
     }
 
-    mbxfd = dev.getMailbox();
+    mbxfd = dev->getMailbox();
     if (mbxfd == -1) {
-        dev.log(LOG_ERR, "Unable to get mailbox fd, mpd_getMsg thread for %s exit!!",
+        dev->log(LOG_ERR, "Unable to get mailbox fd, endpoint for %s not opened",
                 sysfs_name.c_str());
-        threads_handling[sysfs_name] = false;
-        return;
+        if (msdfd > 0)
+            close(msdfd);
+        return false;
     }
 
    /*
@@ -742,95 +748,32 @@ void Mpd::mpd_getMsg(size_t index)
     if (plugin_cbs.mb_notify) {
         ret = (*plugin_cbs.mb_notify)(index, mbxfd, true);
         if (ret)
-            dev.log(LOG_ERR, "failed to mark mgmt as online");
+            dev->log(LOG_ERR, "failed to mark mgmt as online");
     }
 
-    struct queue_msg msg = {
-        .localFd = mbxfd,
-        .remoteFd = msdfd,
-        .cb = cb,
-        .data = nullptr,
+    ep.localFd = mbxfd;
+    ep.remoteFd = msdfd;
+    ep.cb = cb;
+    ep.fetch = [dev](int fd) {
+        return getLocalMsg(*dev, fd);
     };
-
-    int retfd[2];
-    for ( ;; ) {
-        retfd[0] = retfd[1] = -100;
-        ret = waitForMsg(dev, mbxfd, msdfd, 3, retfd);
-
-        if (quit)
-            break;
-        if (!threads_handling[sysfs_name])
-            break;
-
-        if (ret < 0) {
-            if (ret == -EAGAIN)
-                continue;
-            else
-                break;
-        }
-
-        bool broken = false;
-        for (int i = 0; i < 2; i++) {
-            if (retfd[i] == mbxfd) {
-                msg.type = LOCAL_MSG;
-                msg.data = std::move(getLocalMsg(dev, mbxfd));
-            } else if (retfd[i] == msdfd) {
-                msg.type = REMOTE_MSG;
-                msg.data = std::move(getRemoteMsg(dev, msdfd));
-            } else
-                continue;
-
-            if (msg.data == nullptr) {
-                broken = true;
-                break;
-            }
-
-            msgq->addMsg(msg);
+    ep.handle = [dev](queue_msg& msg) {
+        return handleMsg(*dev, msg);
+    };
+    ep.close = [dev, index, mbxfd, msdfd, sysfs_name]() {
+        //notify mailbox driver the daemon is offline
+        if (plugin_cbs.mb_notify) {
+            int ret = (*plugin_cbs.mb_notify)(index, mbxfd, false);
+            if (ret)
+                dev->log(LOG_ERR, "failed to mark mgmt as offline");
         }
 
-        if (broken)
-            break;
-    }
-
-    threads_handling[sysfs_name] = false;
-
-    //notify mailbox driver the daemon is offline
-    if (plugin_cbs.mb_notify) {
-        ret = (*plugin_cbs.mb_notify)(index, mbxfd, false);
-        if (ret)
-            dev.log(LOG_ERR, "failed to mark mgmt as offline");
-    }
+        if (msdfd > 0)
+            close(msdfd);
 
-    if (msdfd > 0)
-        close(msdfd);
-
-    dev.log(LOG_INFO, "mpd_getMsg thread for %s exit!!",
-	xrt_core::pci::get_dev(index)->m_sysfs_name.c_str());
-}
-
-// Client of MPD handling msg. Will quit on any error from either local mailbox or socket fd.
-// No retry is ever conducted.
-void Mpd::mpd_handleMsg(size_t index)
-{
-    pcieFunc dev(index);
-    std::string sysfs_name = xrt_core::pci::get_dev(index, true)->m_sysfs_name;
-    std::shared_ptr<Msgq<queue_msg>> msgq = threads_msgq[sysfs_name];
-    for ( ;; ) {
-        struct queue_msg msg;
-        if (quit)
-                break;
-        if (!threads_handling[sysfs_name])
-                break;
-        int ret = msgq->getMsg(3, msg);
-        if (ret) //timeout
-            continue;
-        if (handleMsg(dev, msg) != 0)
-            break;
-    }
-    threads_handling[sysfs_name] = false;
-
-    dev.log(LOG_INFO, "mpd_handleMsg thread for %s exit!!",
-	xrt_core::pci::get_dev(index)->m_sysfs_name.c_str());
+        dev->log(LOG_INFO, "msg endpoint for %s closed", sysfs_name.c_str());
+    };
+    return true;
 }
 
 /*
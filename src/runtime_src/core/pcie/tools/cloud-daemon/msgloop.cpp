@@ -0,0 +1,414 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+
+/*
+ * In this file, we provide the event driven msg loop for all daemons.
+ */
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <syslog.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "msgloop.h"
+
+namespace {
+
+// Largest remote msg accepted, same as getRemoteMsg()
+const size_t maxRemotePayload = 1024 * 1024 * 1024;
+
+// Bytes read from one remote fd per wake up, so that a large msg is read
+// in turns with the fds of other boards
+const size_t remoteReadBudget = 256 * 1024;
+
+uint64_t usSince(std::chrono::steady_clock::time_point t)
+{
+    auto d = std::chrono::steady_clock::now() - t;
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+}
+
+Msgloop::Msgloop(size_t workers, size_t batch) : batch(std::max<size_t>(batch, 1))
+{
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0)
+        throw std::runtime_error("msgloop: can't create epoll fd");
+
+    wakefd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakefd < 0) {
+        ::close(epfd);
+        throw std::runtime_error("msgloop: can't create event fd");
+    }
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = wakefd;
+    if (epoll_ctl(epfd, EPOLL_CTL_ADD, wakefd, &ev) != 0) {
+        ::close(wakefd);
+        ::close(epfd);
+        throw std::runtime_error("msgloop: can't monitor event fd");
+    }
+
+    io = std::thread(&Msgloop::ioThread, this);
+    for (size_t i = 0; i < std::max<size_t>(workers, 1); i++)
+        handlers.emplace_back(&Msgloop::handlerThread, this);
+}
+
+Msgloop::~Msgloop()
+{
+    stop();
+    ::close(wakefd);
+    ::close(epfd);
+}
+
+bool Msgloop::addEndpoint(const std::string& name, msgEndpoint ep)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    if (stopping || boards.find(name) != boards.end())
+        return false;
+
+    auto b = std::make_shared<board>();
+    b->name = name;
+    b->ep = std::move(ep);
+
+    for (int fd : { b->ep.localFd, b->ep.remoteFd }) {
+        if (fd < 0)
+            continue;
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            syslog(LOG_ERR, "msgloop: can't monitor fd %d of %s: %m",
+                fd, name.c_str());
+            retire(b);
+            return false;
+        }
+        fds[fd] = b;
+    }
+
+    boards[name] = b;
+    syslog(LOG_INFO, "msgloop: serving %s, %ld boards", name.c_str(),
+        boards.size());
+    return true;
+}
+
+bool Msgloop::hasEndpoint(const std::string& name)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    return boards.find(name) != boards.end();
+}
+
+bool Msgloop::isAlive(const std::string& name)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    auto it = boards.find(name);
+    return it != boards.end() && !it->second->dead;
+}
+
+void Msgloop::removeEndpoint(const std::string& name)
+{
+    std::function<void()> closeFn;
+    {
+        std::unique_lock<std::mutex> lck(mtx);
+        auto it = boards.find(name);
+        if (it == boards.end())
+            return;
+        auto b = it->second;
+        b->removing = true;
+        retire(b);
+        idleCv.wait(lck, [&b] { return !b->active && !b->reading; });
+        closeFn = takeClose(b, true);
+        boards.erase(name);
+    }
+    if (closeFn)
+        closeFn();
+}
+
+msgLatency Msgloop::getLatency(const std::string& name)
+{
+    std::lock_guard<std::mutex> lck(mtx);
+    auto it = boards.find(name);
+    return it == boards.end() ? msgLatency() : it->second->latency;
+}
+
+void Msgloop::stop()
+{
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        if (stopping)
+            return;
+        stopping = true;
+    }
+
+    uint64_t one = 1;
+    if (write(wakefd, &one, sizeof(one)) != sizeof(one))
+        syslog(LOG_ERR, "msgloop: failed to wake up io thread: %m");
+    readyCv.notify_all();
+
+    io.join();
+    for (auto& t : handlers)
+        t.join();
+
+    std::vector<std::function<void()>> closeFns;
+    {
+        std::lock_guard<std::mutex> lck(mtx);
+        for (auto& b : boards) {
+            retire(b.second);
+            if (auto fn = takeClose(b.second, true))
+                closeFns.push_back(std::move(fn));
+        }
+        boards.clear();
+    }
+    for (auto& fn : closeFns)
+        fn();
+}
+
+// Must be called with mtx held. Stop monitoring fds of a board and drop
+// all msgs not yet handled.
+void Msgloop::retire(const std::shared_ptr<board>& b)
+{
+    if (b->dead)
+        return;
+    b->dead = true;
+    b->q.clear();
+    for (int fd : { b->ep.localFd, b->ep.remoteFd }) {
+        auto it = fds.find(fd);
+        if (fd < 0 || it == fds.end() || it->second != b)
+            continue;
+        epoll_ctl(epfd, EPOLL_CTL_DEL, fd, nullptr);
+        fds.erase(it);
+    }
+    ready.erase(std::remove(ready.begin(), ready.end(), b), ready.end());
+    b->scheduled = false;
+}
+
+// Must be called with mtx held. The close callback is taken at most once
+// and only after the board is retired and idle. A board being removed is
+// closed by removeEndpoint() itself, so that the endpoint is closed when
+// removeEndpoint() returns.
+std::function<void()> Msgloop::takeClose(const std::shared_ptr<board>& b, bool removal)
+{
+    if (!b->dead || b->active || b->reading || b->closed)
+        return nullptr;
+    if (b->removing && !removal)
+        return nullptr;
+    b->closed = true;
+    // Release what the endpoint holds on to, eg. the device owning the
+    // mailbox fd, as soon as the close callback is done.
+    b->ep.fetch = nullptr;
+    b->ep.handle = nullptr;
+    b->rx.reset();
+    return std::move(b->ep.close);
+}
+
+// Called by the io thread only. Read what is available of the remote msg
+// of a board without blocking, returns the msg once it is complete. Sets
+// broken on error or when the peer went away.
+std::unique_ptr<sw_msg> Msgloop::readRemote(board& b, int fd, bool& broken)
+{
+    const size_t hdrSize = sw_msg(0).size();
+    size_t budget = remoteReadBudget;
+
+    broken = false;
+    while (budget) {
+        if (!b.rx) {
+            b.rx = std::make_unique<sw_msg>(0);
+            b.rxDone = 0;
+        }
+
+        size_t want = std::min(b.rx->size() - b.rxDone, budget);
+        ssize_t ret = recv(fd, b.rx->data() + b.rxDone, want, MSG_DONTWAIT);
+        if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return nullptr;
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0) {
+            if (ret == 0)
+                syslog(LOG_ERR, "msgloop: peer of fd %d of %s closed", fd, b.name.c_str());
+            else
+                syslog(LOG_ERR, "msgloop: can't receive from fd %d of %s: %m",
+                    fd, b.name.c_str());
+            broken = true;
+            return nullptr;
+        }
+
+        b.rxDone += ret;
+        budget -= ret;
+        if (b.rxDone < b.rx->size())
+            continue;
+
+        if (b.rx->size() == hdrSize) {
+            // Header is complete, continue with the payload
+            size_t sz = b.rx->payloadSize();
+            if (sz == 0 || sz > maxRemotePayload) {
+                syslog(LOG_ERR, "msgloop: bad msg size %ld on fd %d of %s",
+                    sz, fd, b.name.c_str());
+                broken = true;
+                return nullptr;
+            }
+            auto msg = std::make_unique<sw_msg>(sz);
+            std::memcpy(msg->data(), b.rx->data(), hdrSize);
+            b.rx = std::move(msg);
+            continue;
+        }
+
+        b.rxDone = 0;
+        return std::move(b.rx);
+    }
+    return nullptr;
+}
+
+void Msgloop::ioThread()
+{
+    const int maxEvents = 64;
+    struct epoll_event events[maxEvents];
+
+    for ( ;; ) {
+        int n = epoll_wait(epfd, events, maxEvents, -1);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            syslog(LOG_ERR, "msgloop: epoll_wait failed: %m");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd;
+            std::shared_ptr<board> b;
+            {
+                std::lock_guard<std::mutex> lck(mtx);
+                if (stopping)
+                    return;
+                auto it = fds.find(fd);
+                if (it == fds.end())
+                    continue;
+                b = it->second;
+                b->reading = true;
+            }
+
+            enum MSG_TYPE type = (fd == b->ep.localFd) ? LOCAL_MSG : REMOTE_MSG;
+            std::unique_ptr<sw_msg> data;
+            bool broken = false;
+            if (type == LOCAL_MSG) {
+                data = b->ep.fetch(fd);
+                broken = (data == nullptr);
+            } else {
+                data = readRemote(*b, fd, broken);
+            }
+
+            std::function<void()> closeFn;
+            {
+                std::lock_guard<std::mutex> lck(mtx);
+                b->reading = false;
+                if (b->dead) {
+                    closeFn = takeClose(b);
+                    idleCv.notify_all();
+                } else if (broken) {
+                    syslog(LOG_ERR, "msgloop: failed to read msg from fd %d of %s",
+                        fd, b->name.c_str());
+                    retire(b);
+                    closeFn = takeClose(b);
+                } else if (data != nullptr) {
+                    pendingMsg p;
+                    p.msg.localFd = b->ep.localFd;
+                    p.msg.remoteFd = b->ep.remoteFd;
+                    p.msg.cb = b->ep.cb;
+                    p.msg.data = std::move(data);
+                    p.msg.type = type;
+                    p.arrived = clock::now();
+                    b->q.push_back(std::move(p));
+                    if (!b->scheduled && !b->active) {
+                        b->scheduled = true;
+                        ready.push_back(b);
+                        readyCv.notify_one();
+                    }
+                }
+            }
+            if (closeFn)
+                closeFn();
+        }
+    }
+}
+
+void Msgloop::handlerThread()
+{
+    std::vector<pendingMsg> msgs;
+
+    for ( ;; ) {
+        std::shared_ptr<board> b;
+        {
+            std::unique_lock<std::mutex> lck(mtx);
+            readyCv.wait(lck, [this] { return stopping || !ready.empty(); });
+            if (stopping)
+                return;
+            b = ready.front();
+            ready.pop_front();
+            b->scheduled = false;
+            b->active = true;
+
+            // Take a batch of msgs of this board
+            while (!b->q.empty() && msgs.size() < batch) {
+                msgs.push_back(std::move(b->q.front()));
+                b->q.pop_front();
+            }
+        }
+
+        bool broken = false;
+        uint64_t queueUsTotal = 0, queueUsMax = 0;
+        uint64_t handleUsTotal = 0, handleUsMax = 0;
+        size_t handled = 0;
+        for (auto& p : msgs) {
+            uint64_t queued = usSince(p.arrived);
+            auto start = clock::now();
+            int ret = b->ep.handle(p.msg);
+            uint64_t took = usSince(start);
+
+            queueUsTotal += queued;
+            queueUsMax = std::max(queueUsMax, queued);
+            handleUsTotal += took;
+            handleUsMax = std::max(handleUsMax, took);
+            handled++;
+            if (ret != 0) {
+                broken = true;
+                break;
+            }
+        }
+        msgs.clear();
+
+        std::function<void()> closeFn;
+        {
+            std::lock_guard<std::mutex> lck(mtx);
+            auto& l = b->latency;
+            l.msgs += handled;
+            l.batches++;
+            l.queueUsTotal += queueUsTotal;
+            l.queueUsMax = std::max(l.queueUsMax, queueUsMax);
+            l.handleUsTotal += handleUsTotal;
+            l.handleUsMax = std::max(l.handleUsMax, handleUsMax);
+
+            b->active = false;
+            if (broken) {
+                syslog(LOG_ERR, "msgloop: failed to handle msg of %s",
+                    b->name.c_str());
+                retire(b);
+            }
+            if (b->dead) {
+                closeFn = takeClose(b);
+                idleCv.notify_all();
+            } else if (!b->q.empty()) {
+                // Go to the end of the line, other boards first.
+                b->scheduled = true;
+                ready.push_back(b);
+                readyCv.notify_one();
+            }
+        }
+        if (closeFn)
+            closeFn();
+    }
+}
@@ -0,0 +1,129 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+
+/*
+ * Event driven message loop shared by all boards served by a daemon.
+ *
+ * One I/O thread waits on the mailbox and socket fds of all boards with
+ * epoll and reads incoming sw channel msgs without ever blocking. A mailbox
+ * returns a whole msg per read once readable. A socket msg is read
+ * incrementally as data arrives, so a slow peer or a large msg (eg. an
+ * xclbin download) does not hold up the other boards. Msgs are queued per board and
+ * handled by a small pool of handler threads. A board is only ever handled
+ * by one handler thread at a time, so msgs of one board are handled in the
+ * order they arrived, while slow msgs (eg. downloading a large xclbin) of
+ * one board do not hold up the other boards.
+ *
+ * The loop does not depend on real mailbox devices, the local fd of an
+ * endpoint can be any pollable fd, eg. one end of a socketpair. The remote
+ * fd must be a stream socket.
+ */
+
+#ifndef MSGLOOP_H
+#define MSGLOOP_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+
+// Per board endpoint served by the msg loop.
+struct msgEndpoint {
+    int localFd = -1;
+    int remoteFd = -1;
+    msgHandler cb = nullptr;
+    // Read one msg from the ready local fd, nullptr on error. Must not
+    // block, the local fd returns a whole msg per read once readable.
+    std::function<std::unique_ptr<sw_msg>(int fd)> fetch;
+    // Handle one msg, non-zero on error.
+    std::function<int(queue_msg& msg)> handle;
+    // Called exactly once when the endpoint is retired, either removed
+    // or broken because of an error on one of its fds.
+    std::function<void()> close;
+};
+
+// Per board msg latency counters. Queue latency is the time from a msg
+// being read until a handler thread starts handling it.
+struct msgLatency {
+    uint64_t msgs = 0;
+    uint64_t batches = 0;
+    uint64_t queueUsTotal = 0;
+    uint64_t queueUsMax = 0;
+    uint64_t handleUsTotal = 0;
+    uint64_t handleUsMax = 0;
+};
+
+class Msgloop
+{
+public:
+    // @workers: number of handler threads
+    // @batch: max msgs of one board handled before moving on to next board
+    Msgloop(size_t workers, size_t batch);
+    ~Msgloop();
+
+    // Start serving an endpoint, returns false if name is already served
+    // or the fds can't be monitored.
+    bool addEndpoint(const std::string& name, msgEndpoint ep);
+    // True if name is served or was served and broke, but not yet removed.
+    bool hasEndpoint(const std::string& name);
+    // True if name is served and has not broken.
+    bool isAlive(const std::string& name);
+    // Stop serving an endpoint, waits for the msg in progress if any.
+    void removeEndpoint(const std::string& name);
+    msgLatency getLatency(const std::string& name);
+    // Stop all threads and retire all endpoints.
+    void stop();
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct pendingMsg {
+        queue_msg msg;
+        clock::time_point arrived;
+    };
+
+    struct board {
+        std::string name;
+        msgEndpoint ep;
+        std::deque<pendingMsg> q;
+        bool scheduled = false;  // in ready queue
+        bool active = false;     // being handled by a handler thread
+        bool reading = false;    // msg being read by the io thread
+        bool removing = false;   // removeEndpoint() waiting for board
+        bool dead = false;       // no longer monitored
+        bool closed = false;     // close callback taken
+        std::unique_ptr<sw_msg> rx;  // remote msg being read, header first
+        size_t rxDone = 0;           // bytes of rx read so far
+        msgLatency latency;
+    };
+
+    void ioThread();
+    std::unique_ptr<sw_msg> readRemote(board& b, int fd, bool& broken);
+    void handlerThread();
+    void retire(const std::shared_ptr<board>& b);
+    std::function<void()> takeClose(const std::shared_ptr<board>& b, bool removal = false);
+
+    size_t batch;
+    int epfd = -1;
+    int wakefd = -1;
+    bool stopping = false;
+    std::mutex mtx;
+    std::condition_variable readyCv;
+    std::condition_variable idleCv;
+    std::map<std::string, std::shared_ptr<board>> boards;
+    std::map<int, std::shared_ptr<board>> fds;
+    std::deque<std::shared_ptr<board>> ready;
+    std::thread io;
+    std::vector<std::thread> handlers;
+};
+
+#endif // MSGLOOP_H
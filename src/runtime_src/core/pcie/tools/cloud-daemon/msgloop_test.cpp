@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. - All rights reserved
+
+/*
+ * Exercise the msg loop with socketpairs standing in for the mailbox and
+ * msd socket fds of a number of boards.
+ *
+ * Each board echoes msgs read from its "mailbox" to its "socket". The test
+ * verifies that all msgs are delivered in order per board, that a peer
+ * stalling in the middle of a large msg does not hold up other boards, that
+ * a broken endpoint is closed and that removed endpoints are closed exactly
+ * once.
+ */
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "msgloop.h"
+#include "core/pcie/driver/linux/include/mailbox_proto.h"
+
+namespace {
+
+const size_t boards = 8;
+const size_t msgsPerBoard = 1000;
+
+struct fakeBoard {
+    int mbx[2];   // [0] served by msg loop, [1] driven by test
+    int sock[2];  // [0] served by msg loop, [1] driven by test
+    std::atomic<int> closed { 0 };
+};
+
+bool readAll(int fd, void *buf, size_t len)
+{
+    char *p = static_cast<char *>(buf);
+    while (len) {
+        ssize_t ret = read(fd, p, len);
+        if (ret <= 0)
+            return false;
+        p += ret;
+        len -= ret;
+    }
+    return true;
+}
+
+std::unique_ptr<sw_msg> fetch(int fd)
+{
+    auto msg = std::make_unique<sw_msg>(sizeof(uint64_t));
+    if (!readAll(fd, msg->data(), msg->size()) || !msg->valid())
+        return nullptr;
+    return msg;
+}
+
+// Wait for fd to become readable
+bool readable(int fd, int timeoutMs)
+{
+    struct pollfd pfd = { fd, POLLIN, 0 };
+    return poll(&pfd, 1, timeoutMs) == 1;
+}
+
+bool writeAll(int fd, const void *buf, size_t len)
+{
+    const char *p = static_cast<const char *>(buf);
+    while (len) {
+        ssize_t ret = write(fd, p, len);
+        if (ret <= 0)
+            return false;
+        p += ret;
+        len -= ret;
+    }
+    return true;
+}
+
+bool send(int fd, uint64_t seq)
+{
+    sw_msg msg(&seq, sizeof(seq), seq, 0);
+    return write(fd, msg.data(), msg.size()) == static_cast<ssize_t>(msg.size());
+}
+
+msgEndpoint endpoint(fakeBoard& b)
+{
+    msgEndpoint ep;
+    ep.localFd = b.mbx[0];
+    ep.remoteFd = b.sock[0];
+    ep.fetch = [](int fd) { return fetch(fd); };
+    ep.handle = [](queue_msg& msg) {
+        int fd = (msg.type == LOCAL_MSG) ? msg.remoteFd : msg.localFd;
+        auto& m = msg.data;
+        return write(fd, m->data(), m->size()) == static_cast<ssize_t>(m->size()) ? 0 : -EINVAL;
+    };
+    ep.close = [&b]() { b.closed++; };
+    return ep;
+}
+
+int fail(const std::string& what)
+{
+    std::cout << "FAILED TEST: " << what << std::endl;
+    return 1;
+}
+
+}
+
+int main()
+{
+    std::vector<fakeBoard> fake(boards);
+    for (auto& b : fake) {
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, b.mbx) ||
+            socketpair(AF_UNIX, SOCK_STREAM, 0, b.sock))
+            return fail("socketpair");
+    }
+
+    Msgloop loop(4, 8);
+    for (size_t i = 0; i < boards; i++) {
+        if (!loop.addEndpoint("board" + std::to_string(i), endpoint(fake[i])))
+            return fail("addEndpoint");
+    }
+    if (loop.addEndpoint("board0", endpoint(fake[0])))
+        return fail("duplicate addEndpoint");
+
+    // Interleave msgs of all boards, then check per board ordering. Each
+    // side of the sockets is driven by its own thread, so that no handler
+    // thread is stuck on a full socket while the test waits for another.
+    std::atomic<bool> sent { true };
+    std::vector<char> ordered(boards, 0);
+    std::vector<std::thread> threads;
+    threads.emplace_back([&fake, &sent] {
+        for (uint64_t seq = 0; seq < msgsPerBoard; seq++) {
+            for (auto& b : fake) {
+                if (!send(b.mbx[1], seq))
+                    sent = false;
+            }
+        }
+    });
+    for (size_t i = 0; i < boards; i++) {
+        threads.emplace_back([&fake, &ordered, i] {
+            for (uint64_t seq = 0; seq < msgsPerBoard; seq++) {
+                auto msg = fetch(fake[i].sock[1]);
+                if (!msg || msg->id() != seq)
+                    return;
+            }
+            ordered[i] = 1;
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    if (!sent)
+        return fail("send");
+
+    for (size_t i = 0; i < boards; i++) {
+        if (!ordered[i])
+            return fail("board" + std::to_string(i) + " out of order");
+        auto l = loop.getLatency("board" + std::to_string(i));
+        std::cout << "board" << i << ": " << l.msgs << " msgs, " << l.batches
+                  << " batches, avg queue latency " << (l.msgs ? l.queueUsTotal / l.msgs : 0)
+                  << "us, max " << l.queueUsMax << "us" << std::endl;
+    }
+
+    // Msgs from the remote side go to the mailbox.
+    if (!send(fake[0].sock[1], 42))
+        return fail("send remote");
+    auto msg = fetch(fake[0].mbx[1]);
+    if (!msg || msg->id() != 42)
+        return fail("remote msg");
+
+    // A remote peer stalling halfway through a large msg does not hold up
+    // other boards, the msg is delivered once the rest arrives.
+    std::vector<char> big(1024 * 1024, 'x');
+    sw_msg large(big.data(), big.size(), 7, 0);
+    size_t half = large.size() / 2;
+    if (!writeAll(fake[3].sock[1], large.data(), half))
+        return fail("send large msg");
+    if (!send(fake[0].mbx[1], 43) || !readable(fake[0].sock[1], 5000))
+        return fail("board0 held up by stalled peer of board3");
+    msg = fetch(fake[0].sock[1]);
+    if (!msg || msg->id() != 43)
+        return fail("msg while peer stalled");
+    if (!writeAll(fake[3].sock[1], large.data() + half, large.size() - half))
+        return fail("send rest of large msg");
+    sw_msg got(big.size());
+    if (!readAll(fake[3].mbx[1], got.data(), got.size()) || got.id() != 7 ||
+        std::memcmp(got.payloadData(), big.data(), big.size()) != 0)
+        return fail("large msg");
+
+    // A peer going away breaks the endpoint, which is then closed.
+    close(fake[1].mbx[1]);
+    for (int i = 0; i < 1000 && loop.isAlive("board1"); i++)
+        usleep(1000);
+    if (loop.isAlive("board1") || fake[1].closed != 1)
+        return fail("broken endpoint not closed");
+    if (!loop.hasEndpoint("board1"))
+        return fail("broken endpoint dropped before removal");
+
+    // Removal closes exactly once, also for already broken endpoints.
+    loop.removeEndpoint("board1");
+    loop.removeEndpoint("board2");
+    if (fake[1].closed != 1 || fake[2].closed != 1 || loop.hasEndpoint("board2"))
+        return fail("removeEndpoint");
+
+    loop.stop();
+    for (auto& b : fake) {
+        if (b.closed != 1)
+            return fail("stop did not close all endpoints");
+    }
+
+    std::cout << "PASSED TEST" << std::endl;
+    return 0;
+}
@@ -80,6 +80,47 @@ Report::Report(const std::string & _reportName,
   // Empty
 }
 
+void
+Report::getPropertyTree( const xrt_core::device *pDevice,
+                         SchemaVersion schemaVersion,
+                         boost::property_tree::ptree & pt) const
+{
+  switch (schemaVersion) {
+    case SchemaVersion::json_internal:
+      getPropertyTreeInternal(pDevice, pt);
+      break;
+
+    case SchemaVersion::json_20202:
+      getPropertyTree20202(pDevice, pt);
+      break;
+
+    default:
+      throw std::runtime_error("ERROR: Unknown schema version.");
+      break;
+  }
+}
+
+void
+Report::writeFormattedReport( const xrt_core::device *pDevice,
+                              const boost::property_tree::ptree & pt,
+                              const std::vector<std::string> & elementFilter,
+                              std::ostream & consoleStream) const
+{
+  writeReport(pDevice, pt, elementFilter, consoleStream);
+}
+
+void
+Report::printError(const std::string & error) const
+{
+  std::string reportName = getReportName();
+  if (!reportName.empty()) {
+    reportName[0] = static_cast<char>(std::toupper(reportName[0]));
+    std::cerr << reportName << std::endl;
+  }
+
+  std::cerr << "  ERROR: " << error << std::endl;
+}
+
 void 
 Report::getFormattedReport( const xrt_core::device *pDevice, 
                             SchemaVersion schemaVersion,
@@ -89,29 +130,10 @@ Report::getFormattedReport( const xrt_core::device *pDevice,
 {
   // If an exception occurs while generating a report throw an error in the catch
   try {
-    switch (schemaVersion) {
-      case SchemaVersion::json_internal:
-        getPropertyTreeInternal(pDevice, pt);
-        break;
-
-      case SchemaVersion::json_20202:
-        getPropertyTree20202(pDevice, pt);
-        break;
-
-      default:
-        throw std::runtime_error("ERROR: Unknown schema version.");
-        break;
-    }
-
-    writeReport(pDevice, pt, elementFilter, consoleStream);
+    getPropertyTree(pDevice, schemaVersion, pt);
+    writeFormattedReport(pDevice, pt, elementFilter, consoleStream);
   } catch (const std::exception& e) {
-    std::string reportName = getReportName();
-    if (!reportName.empty()) {
-      reportName[0] = static_cast<char>(std::toupper(reportName[0]));
-      std::cerr << reportName << std::endl;
-    }
-
-    std::cerr << "  ERROR: " << e.what() << std::endl;
+    printError(e.what());
     throw xrt_core::error(std::errc::operation_canceled);
   }
 }
@@ -52,6 +52,12 @@ class Report : public JSONConfigurable {
 
   void getFormattedReport(const xrt_core::device *_pDevice, SchemaVersion _schemaVersion, const std::vector<std::string> & _elementFilter, std::ostream & consoleStream, boost::property_tree::ptree & pt) const;
 
+  // The two steps of getFormattedReport.  Property trees of several
+  // reports can be collected concurrently and written in report order.
+  void getPropertyTree(const xrt_core::device *_pDevice, SchemaVersion _schemaVersion, boost::property_tree::ptree & pt) const;
+  void writeFormattedReport(const xrt_core::device *_pDevice, const boost::property_tree::ptree & pt, const std::vector<std::string> & _elementFilter, std::ostream & consoleStream) const;
+  void printError(const std::string & _error) const;
+
  // Needs a virtual destructor
   virtual ~Report() {};
 
@@ -4,8 +4,10 @@
 
 // ------ I N C L U D E   F I L E S -------------------------------------------
 // Local - Include Files
+#include "core/common/config_reader.h"
 #include "core/common/time.h"
 #include "core/common/query_requests.h"
+#include "core/common/scope_guard.h"
 #include "XBHelpMenusCore.h"
 #include "XBUtilitiesCore.h"
 #include "XBHelpMenus.h"
@@ -20,7 +22,9 @@ namespace po = boost::program_options;
 
 // System - Include Files
 #include <algorithm>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <numeric>
 
 // ------ N A M E S P A C E ---------------------------------------------------
@@ -239,6 +243,79 @@ XBUtilities::collect_and_validate_reports( const ReportCollection &allReportsAva
 }
 
 
+// Property tree of a report collected by a worker thread
+struct collected_report {
+  boost::property_tree::ptree pt;
+  std::exception_ptr error;
+};
+
+// Collect property trees of reports concurrently, device reports are
+// skipped if there is no device.  Workers of reports that timed out
+// are left running when the pool is destroyed.
+static std::vector<std::shared_ptr<collected_report>>
+collect_reports( const std::shared_ptr<xrt_core::device>& device,
+                 const ReportCollection & reportsToProcess,
+                 const Report::SchemaVersion schemaVersion,
+                 std::unique_ptr<XBU::parallel_tasks> & pool)
+{
+  std::vector<std::shared_ptr<collected_report>> collected;
+  std::vector<std::function<void()>> tasks;
+  for (const auto & report : reportsToProcess) {
+    auto result = std::make_shared<collected_report>();
+    collected.push_back(result);
+    if (report->isDeviceRequired() && !device)
+      continue;
+
+    auto pDevice = report->isDeviceRequired() ? device : nullptr;
+    tasks.emplace_back([report, pDevice, schemaVersion, result] {
+      try {
+        report->getPropertyTree(pDevice.get(), schemaVersion, result->pt);
+      } catch (...) {
+        result->error = std::current_exception();
+      }
+    });
+  }
+
+  pool = std::make_unique<XBU::parallel_tasks>(std::move(tasks), xrt_core::config::get_examine_workers(),
+                                               std::chrono::milliseconds(xrt_core::config::get_examine_timeout_ms()));
+  auto status = pool->wait();
+
+  // A report that timed out is still owned by its worker, replace it
+  size_t task = 0;
+  for (size_t idx = 0; idx < reportsToProcess.size(); ++idx) {
+    if (reportsToProcess[idx]->isDeviceRequired() && !device)
+      continue;
+
+    if (status[task]) {
+      collected[idx] = std::make_shared<collected_report>();
+      collected[idx]->error = status[task];
+    }
+    ++task;
+  }
+
+  return collected;
+}
+
+// Write a collected report, returns false if the report failed
+static bool
+write_report( const std::shared_ptr<Report> & report,
+              const xrt_core::device * pDevice,
+              const collected_report & collected,
+              const std::vector<std::string> & elementFilter,
+              std::ostream & consoleStream)
+{
+  try {
+    if (collected.error)
+      std::rethrow_exception(collected.error);
+
+    report->writeFormattedReport(pDevice, collected.pt, elementFilter, consoleStream);
+  } catch (const std::exception& e) {
+    report->printError(e.what());
+    return false;
+  }
+  return true;
+}
+
 void 
 XBUtilities::produce_reports( const std::shared_ptr<xrt_core::device>& device, 
                               const ReportCollection & reportsToProcess, 
@@ -272,18 +349,30 @@ XBUtilities::produce_reports( const std::shared_ptr<xrt_core::device>& device,
 
   bool is_report_output_valid = true;
 
+  // Queries shared by reports run once
+  if (device && xrt_core::config::get_examine_query_cache())
+    device->enable_query_cache(true);
+  auto cache_guard = xrt_core::scope_guard<std::function<void()>>([&device] {
+    if (device)
+      device->enable_query_cache(false);
+  });
+
+  // Property trees are collected concurrently, reports are written in
+  // order below.  The pool is destroyed before the query cache is
+  // disabled, reports that timed out may still use the cache.
+  std::unique_ptr<XBU::parallel_tasks> pool;
+  auto collected = collect_reports(device, reportsToProcess, schemaVersion, pool);
+
   // -- Process the reports that don't require a device
   boost::property_tree::ptree ptSystem;
-  for (const auto & report : reportsToProcess) {
+  for (size_t idx = 0; idx < reportsToProcess.size(); ++idx) {
+    const auto & report = reportsToProcess[idx];
     if (report->isDeviceRequired() == true)
       continue;
 
-    boost::property_tree::ptree ptReport;
-    try {
-      report->getFormattedReport(nullptr, schemaVersion, elementFilter, consoleStream, ptReport);
-    } catch (const std::exception&) {
+    const auto & ptReport = collected[idx]->pt;
+    if (!write_report(report, nullptr, *collected[idx], elementFilter, consoleStream))
       is_report_output_valid = false;
-    }
 
     // Only support 1 node on the root
     if (ptReport.size() > 1)
@@ -371,16 +460,14 @@ XBUtilities::produce_reports( const std::shared_ptr<xrt_core::device>& device,
     if ((is_mfg || !is_ready) && !is_recovery)
       std::cout << "Warning: Device is not ready - Limited functionality available with XRT tools.\n";
 
-    for (auto &report : reportsToProcess) {
+    for (size_t idx = 0; idx < reportsToProcess.size(); ++idx) {
+      const auto & report = reportsToProcess[idx];
       if (!report->isDeviceRequired())
         continue;
 
-      boost::property_tree::ptree ptReport;
-      try {
-        report->getFormattedReport(device.get(), schemaVersion, elementFilter, consoleStream, ptReport);
-      } catch (const std::exception&) {
+      const auto & ptReport = collected[idx]->pt;
+      if (!write_report(report, device.get(), *collected[idx], elementFilter, consoleStream))
         is_report_output_valid = false;
-      }
 
       // Only support 1 node on the root
       if (ptReport.size() > 1)
@@ -7,6 +7,7 @@
 #include "XBUtilitiesCore.h"
 
 // Local - Include Files
+#include "common/config_reader.h"
 #include "common/error.h"
 #include "common/info_vmr.h"
 #include "common/utils.h"
@@ -23,7 +24,9 @@
 // System - Include Files
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <regex>
+#include <thread>
 
 
 #ifdef _WIN32
@@ -82,84 +85,231 @@ XBUtilities::Timer::format_time(std::chrono::duration<double> duration)
   return formatted_time;
 }
 
+// Basic information of a device, collected for each available device
+static boost::property_tree::ptree
+get_device_info(const std::shared_ptr<xrt_core::device>& device)
+{
+  boost::property_tree::ptree pt_dev;
+  pt_dev.put("bdf", xrt_core::query::pcie_bdf::to_string(xrt_core::device_query<xrt_core::query::pcie_bdf>(device)));
+
+  const auto device_class = xrt_core::device_query_default<xrt_core::query::device_class>(device, xrt_core::query::device_class::type::alveo);
+  pt_dev.put("device_class", xrt_core::query::device_class::enum_to_str(device_class));
+
+  //user pf doesn't have mfg node. Also if user pf is loaded, it means that the card is not is mfg mode
+  const auto is_mfg = xrt_core::device_query_default<xrt_core::query::is_mfg>(device, false);
+
+  //if factory mode
+  if (is_mfg) {
+    auto mGoldenVer = xrt_core::device_query<xrt_core::query::mfg_ver>(device);
+    std::string vbnv = "xilinx_" + xrt_core::device_query<xrt_core::query::board_name>(device) + "_GOLDEN_"+ std::to_string(mGoldenVer);
+    pt_dev.put("vbnv", vbnv);
+    pt_dev.put("id", "n/a");
+    pt_dev.put("instance","n/a");
+  }
+  else {
+    switch (device_class) {
+    case xrt_core::query::device_class::type::alveo:
+      pt_dev.put("vbnv", xrt_core::device_query<xrt_core::query::rom_vbnv>(device));
+      break;
+    case xrt_core::query::device_class::type::ryzen:
+      pt_dev.put("name", xrt_core::device_query<xrt_core::query::rom_vbnv>(device));
+      break;
+    }
+    
+    try { //1RP
+      pt_dev.put("id", xrt_core::query::rom_time_since_epoch::to_string(xrt_core::device_query<xrt_core::query::rom_time_since_epoch>(device)));
+    }
+    catch(...) {
+      // The id wasn't added
+    }
+
+    try { //2RP
+      auto logic_uuids = xrt_core::device_query<xrt_core::query::logic_uuids>(device);
+      if (!logic_uuids.empty())
+        pt_dev.put("id", xrt_core::query::interface_uuids::to_uuid_upper_string(logic_uuids[0]));
+    }
+    catch(...) {
+      // The id wasn't added
+    }
+
+    try {
+      const auto fw_ver = xrt_core::device_query_default<xq::firmware_version>(device, {0,0,0,0});
+      std::string version = "N/A";
+      if (fw_ver.major != 0 || fw_ver.minor != 0 || fw_ver.patch != 0 || fw_ver.build != 0) {
+        version = boost::str(boost::format("%u.%u.%u.%u")
+          % fw_ver.major % fw_ver.minor % fw_ver.patch % fw_ver.build);
+      }
+      pt_dev.put("firmware_version", version);
+    }
+    catch(...) {
+      // The firmware wasn't added
+    }
+
+    try {
+      auto instance = xrt_core::device_query<xrt_core::query::instance>(device);
+      std::string pf = device->is_userpf() ? "user" : "mgmt";
+      pt_dev.put("instance",boost::str(boost::format("%s(inst=%d)") % pf % instance));
+    }
+    catch(const xrt_core::query::exception&) {
+        // The instance wasn't added
+    }
+
+  }
+  pt_dev.put("is_ready", xrt_core::device_query_default<xrt_core::query::is_ready>(device, true));
+
+  return pt_dev;
+}
+
 boost::property_tree::ptree
 XBUtilities::get_available_devices(bool inUserDomain)
 {
   xrt_core::device_collection deviceCollection;
   collect_devices(std::set<std::string> {"_all_"}, inUserDomain, deviceCollection);
-  boost::property_tree::ptree pt;
+
+  // Devices are queried concurrently, results are kept in device order
+  std::vector<std::shared_ptr<boost::property_tree::ptree>> devices;
+  std::vector<std::function<void()>> tasks;
   for (const auto & device : deviceCollection) {
-    boost::property_tree::ptree pt_dev;
-    pt_dev.put("bdf", xrt_core::query::pcie_bdf::to_string(xrt_core::device_query<xrt_core::query::pcie_bdf>(device)));
-
-    const auto device_class = xrt_core::device_query_default<xrt_core::query::device_class>(device, xrt_core::query::device_class::type::alveo);
-    pt_dev.put("device_class", xrt_core::query::device_class::enum_to_str(device_class));
-
-    //user pf doesn't have mfg node. Also if user pf is loaded, it means that the card is not is mfg mode
-    const auto is_mfg = xrt_core::device_query_default<xrt_core::query::is_mfg>(device, false);
-
-    //if factory mode
-    if (is_mfg) {
-      auto mGoldenVer = xrt_core::device_query<xrt_core::query::mfg_ver>(device);
-      std::string vbnv = "xilinx_" + xrt_core::device_query<xrt_core::query::board_name>(device) + "_GOLDEN_"+ std::to_string(mGoldenVer);
-      pt_dev.put("vbnv", vbnv);
-      pt_dev.put("id", "n/a");
-      pt_dev.put("instance","n/a");
+    auto pt_dev = std::make_shared<boost::property_tree::ptree>();
+    devices.push_back(pt_dev);
+    tasks.emplace_back([device, pt_dev] { *pt_dev = get_device_info(device); });
+  }
+
+  parallel_tasks pool(std::move(tasks), xrt_core::config::get_examine_workers(),
+                      std::chrono::milliseconds(xrt_core::config::get_examine_timeout_ms()));
+  auto status = pool.wait();
+
+  boost::property_tree::ptree pt;
+  for (size_t idx = 0; idx < devices.size(); ++idx) {
+    if (status[idx])
+      std::rethrow_exception(status[idx]);
+    pt.push_back(std::make_pair("", *devices[idx]));
+  }
+  return pt;
+}
+
+XBUtilities::parallel_tasks::shared_state::
+shared_state(std::vector<std::function<void()>> tasks)
+  : m_tasks(std::move(tasks))
+  , m_state(m_tasks.size(), task_state::queued)
+  , m_start(m_tasks.size())
+  , m_error(m_tasks.size())
+  , m_timed_out(m_tasks.size(), false)
+{}
+
+XBUtilities::parallel_tasks::
+parallel_tasks(std::vector<std::function<void()>> tasks,
+               unsigned int max_workers,
+               std::chrono::milliseconds timeout)
+  : m_shared(std::make_shared<shared_state>(std::move(tasks)))
+  , m_timeout(timeout)
+{
+  if (max_workers <= 1)
+    return;
+
+  auto workers = std::min<size_t>(max_workers, m_shared->m_tasks.size());
+  for (size_t worker = 0; worker < workers; ++worker)
+    m_workers.emplace_back([shared = m_shared] { run_tasks(shared); });
+}
+
+XBUtilities::parallel_tasks::
+~parallel_tasks()
+{
+  bool abandon = false;
+  {
+    std::lock_guard<std::mutex> lk(m_shared->m_mutex);
+    m_shared->m_cancelled = true;
+    abandon = m_shared->m_lost > 0;
+  }
+
+  // Workers held by tasks that timed out may never finish.  Workers
+  // share ownership of the pool state and the tasks share ownership
+  // of the state they update, so they can be left running.
+  for (auto& worker : m_workers) {
+    if (abandon)
+      worker.detach();
+    else
+      worker.join();
+  }
+}
+
+void
+XBUtilities::parallel_tasks::
+run_tasks(const std::shared_ptr<shared_state>& shared)
+{
+  auto& s = *shared;
+  std::unique_lock<std::mutex> lk(s.m_mutex);
+  while (!s.m_cancelled && s.m_next < s.m_tasks.size()) {
+    auto idx = s.m_next++;
+    s.m_state[idx] = task_state::running;
+    s.m_start[idx] = std::chrono::steady_clock::now();
+    s.m_cond.notify_all();
+    lk.unlock();
+
+    std::exception_ptr error;
+    try {
+      s.m_tasks[idx]();
+    }
+    catch (...) {
+      error = std::current_exception();
     }
-    else {
-      switch (device_class) {
-      case xrt_core::query::device_class::type::alveo:
-        pt_dev.put("vbnv", xrt_core::device_query<xrt_core::query::rom_vbnv>(device));
-        break;
-      case xrt_core::query::device_class::type::ryzen:
-        pt_dev.put("name", xrt_core::device_query<xrt_core::query::rom_vbnv>(device));
-        break;
-      }
-      
-      try { //1RP
-        pt_dev.put("id", xrt_core::query::rom_time_since_epoch::to_string(xrt_core::device_query<xrt_core::query::rom_time_since_epoch>(device)));
-      }
-      catch(...) {
-        // The id wasn't added
-      }
 
-      try { //2RP
-        auto logic_uuids = xrt_core::device_query<xrt_core::query::logic_uuids>(device);
-        if (!logic_uuids.empty())
-          pt_dev.put("id", xrt_core::query::interface_uuids::to_uuid_upper_string(logic_uuids[0]));
-      }
-      catch(...) {
-        // The id wasn't added
-      }
+    lk.lock();
+    s.m_error[idx] = error;
+    s.m_state[idx] = task_state::done;
+    if (s.m_timed_out[idx])
+      --s.m_lost;
+    s.m_cond.notify_all();
+  }
+}
 
+std::vector<std::exception_ptr>
+XBUtilities::parallel_tasks::
+wait()
+{
+  auto& s = *m_shared;
+  if (m_workers.empty()) {
+    for (size_t idx = 0; idx < s.m_tasks.size(); ++idx) {
       try {
-        const auto fw_ver = xrt_core::device_query_default<xq::firmware_version>(device, {0,0,0,0});
-        std::string version = "N/A";
-        if (fw_ver.major != 0 || fw_ver.minor != 0 || fw_ver.patch != 0 || fw_ver.build != 0) {
-          version = boost::str(boost::format("%u.%u.%u.%u")
-            % fw_ver.major % fw_ver.minor % fw_ver.patch % fw_ver.build);
-        }
-        pt_dev.put("firmware_version", version);
+        s.m_tasks[idx]();
       }
-      catch(...) {
-        // The firmware wasn't added
+      catch (...) {
+        s.m_error[idx] = std::current_exception();
       }
+    }
+    return s.m_error;
+  }
 
-      try {
-        auto instance = xrt_core::device_query<xrt_core::query::instance>(device);
-        std::string pf = device->is_userpf() ? "user" : "mgmt";
-        pt_dev.put("instance",boost::str(boost::format("%s(inst=%d)") % pf % instance));
-      }
-      catch(const xrt_core::query::exception&) {
-          // The instance wasn't added
-      }
+  std::vector<std::exception_ptr> status(s.m_tasks.size());
+  std::unique_lock<std::mutex> lk(s.m_mutex);
+  for (size_t idx = 0; idx < s.m_tasks.size(); ++idx) {
+    // A task waits for a free worker, workers held by tasks that timed
+    // out may never become free
+    s.m_cond.wait(lk, [this, &s, idx] {
+      return s.m_state[idx] != task_state::queued || s.m_cancelled || s.m_lost == m_workers.size();
+    });
+    if (s.m_state[idx] == task_state::queued) {
+      s.m_cancelled = true;
+      auto msg = boost::str(boost::format("Not started, all workers timed out after %d ms") % m_timeout.count());
+      status[idx] = std::make_exception_ptr(xrt_core::error(std::errc::timed_out, msg));
+      continue;
+    }
 
+    auto done = [&s, idx] { return s.m_state[idx] == task_state::done; };
+    if (m_timeout.count() == 0)
+      s.m_cond.wait(lk, done);
+    else if (!s.m_cond.wait_until(lk, s.m_start[idx] + m_timeout, done)) {
+      s.m_timed_out[idx] = true;
+      ++s.m_lost;
+      auto msg = boost::str(boost::format("Timed out after %d ms") % m_timeout.count());
+      status[idx] = std::make_exception_ptr(xrt_core::error(std::errc::timed_out, msg));
+      continue;
     }
-    pt_dev.put("is_ready", xrt_core::device_query_default<xrt_core::query::is_ready>(device, true));
 
-    pt.push_back(std::make_pair("", pt_dev));
+    status[idx] = s.m_error[idx];
   }
-  return pt;
+
+  return status;
 }
 
 /*
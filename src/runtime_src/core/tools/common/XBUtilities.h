@@ -11,10 +11,15 @@
 #include "core/common/query_requests.h"
 
 #include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include <boost/algorithm/string.hpp>
@@ -60,6 +65,69 @@ namespace XBUtilities {
   boost::property_tree::ptree
   get_available_devices(bool inUserDomain);
 
+  /**
+   * parallel_tasks - Run tasks on a bounded number of threads
+   *
+   * Tasks are started in order as workers become free.  The destructor
+   * cancels tasks not yet started and joins the workers.  If a task
+   * timed out the workers are detached instead, such that a hung task
+   * does not keep the process from exiting.
+   */
+  class parallel_tasks {
+  public:
+    /**
+     * tasks: tasks to run
+     * max_workers: maximum number of threads, 1 runs tasks serially in wait()
+     * timeout: time to wait for a task from when it starts, 0 waits indefinitely
+     */
+    parallel_tasks(std::vector<std::function<void()>> tasks,
+                   unsigned int max_workers,
+                   std::chrono::milliseconds timeout);
+
+    ~parallel_tasks();
+
+    parallel_tasks(const parallel_tasks&) = delete;
+    parallel_tasks& operator=(const parallel_tasks&) = delete;
+
+    /**
+     * wait() - Wait for the tasks, call once
+     *
+     * Return: per task nullptr if the task completed, otherwise the
+     * exception thrown by the task or a timeout error.  A task that
+     * times out is still running, it must share ownership of state it
+     * updates.  Once every worker is held by a task that timed out, the
+     * tasks not yet started fail with a timeout error and are not run.
+     */
+    std::vector<std::exception_ptr>
+    wait();
+
+  private:
+    enum class task_state { queued, running, done };
+
+    // State shared with the workers, detached workers outlive the pool
+    struct shared_state {
+      explicit shared_state(std::vector<std::function<void()>> tasks);
+
+      std::vector<std::function<void()>> m_tasks;
+      std::mutex m_mutex;
+      std::condition_variable m_cond;
+      std::vector<task_state> m_state;
+      std::vector<std::chrono::steady_clock::time_point> m_start;
+      std::vector<std::exception_ptr> m_error;
+      std::vector<bool> m_timed_out;
+      size_t m_next = 0;             // next task to start
+      size_t m_lost = 0;             // workers held by tasks that timed out
+      bool m_cancelled = false;
+    };
+
+    static void
+    run_tasks(const std::shared_ptr<shared_state>& shared);
+
+    std::shared_ptr<shared_state> m_shared;
+    std::chrono::milliseconds m_timeout;
+    std::vector<std::thread> m_workers;
+  };
+
   std::string
   str_available_devs(bool _inUserDomain);
 
@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "flash_delta.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+int FdFlashDevice::read(uint64_t addr, unsigned char *buf, size_t len)
+{
+#ifdef __linux__
+    while (len) {
+        ssize_t ret = pread(mFd, buf, len, static_cast<off_t>(addr));
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret < 0)
+            return -errno;
+        if (ret == 0)
+            return -EIO;
+        buf += ret;
+        addr += ret;
+        len -= ret;
+    }
+    return 0;
+#else
+    return -ENOSYS;
+#endif
+}
+
+int FdFlashDevice::write(uint64_t addr, const unsigned char *buf, size_t len)
+{
+#ifdef __linux__
+    while (len) {
+        ssize_t ret = pwrite(mFd, buf, len, static_cast<off_t>(addr));
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret < 0)
+            return -errno;
+        if (ret == 0)
+            return -EIO;
+        buf += ret;
+        addr += ret;
+        len -= ret;
+    }
+    return 0;
+#else
+    return -ENOSYS;
+#endif
+}
+
+SimFlashDevice::SimFlashDevice(const std::string& path, size_t size,
+    size_t sectorSize, const SimFlashTiming& timing)
+    : mSize(size), mSectorSize(sectorSize), mTiming(timing)
+{
+    // Erased flash reads back as all 1s
+    size_t cur = std::filesystem::exists(path) ? std::filesystem::file_size(path) : 0;
+    if (cur < size) {
+        std::ofstream f(path, std::ios::binary | std::ios::app);
+        std::vector<char> erased(size - cur, static_cast<char>(0xff));
+        f.write(erased.data(), erased.size());
+        if (!f)
+            throw std::runtime_error("Failed to create flash file " + path);
+    }
+    mFile.open(path, std::ios::binary | std::ios::in | std::ios::out);
+    if (!mFile.is_open())
+        throw std::runtime_error("Failed to open flash file " + path);
+}
+
+SimFlashDevice::~SimFlashDevice()
+{
+}
+
+int SimFlashDevice::read(uint64_t addr, unsigned char *buf, size_t len)
+{
+    std::lock_guard<std::mutex> lk(mMutex);
+    if (addr + len > mSize)
+        return -EINVAL;
+
+    mFile.seekg(addr);
+    mFile.read(reinterpret_cast<char *>(buf), len);
+    if (!mFile) {
+        mFile.clear();
+        return -EIO;
+    }
+
+    mCounters.bytesRead += len;
+    mCounters.busy += std::chrono::microseconds(len * mTiming.readNsPerByte / 1000);
+    return 0;
+}
+
+// Each sector touched by the write is erased and the written range is
+// programmed. The rest of a partially written sector is preserved like
+// the flash driver does.
+int SimFlashDevice::write(uint64_t addr, const unsigned char *buf, size_t len)
+{
+    std::lock_guard<std::mutex> lk(mMutex);
+    if (addr + len > mSize)
+        return -EINVAL;
+    if (len == 0)
+        return 0;
+
+    mFile.seekp(addr);
+    mFile.write(reinterpret_cast<const char *>(buf), len);
+    mFile.flush();
+    if (!mFile) {
+        mFile.clear();
+        return -EIO;
+    }
+
+    uint64_t first = addr / mSectorSize;
+    uint64_t last = (addr + len - 1) / mSectorSize;
+    mCounters.sectorsErased += last - first + 1;
+    mCounters.bytesProgrammed += len;
+    mCounters.busy += std::chrono::microseconds((last - first + 1) * mTiming.eraseUsPerSector);
+    mCounters.busy += std::chrono::microseconds(len * mTiming.programNsPerByte / 1000);
+    return 0;
+}
+
+SimFlashDevice::Counters SimFlashDevice::getCounters()
+{
+    std::lock_guard<std::mutex> lk(mMutex);
+    return mCounters;
+}
+
+void SimFlashDevice::resetCounters()
+{
+    std::lock_guard<std::mutex> lk(mMutex);
+    mCounters = Counters();
+}
+
+int writeFlashDelta(FlashDevice& dev, uint64_t addr, const unsigned char *buf,
+    size_t len, FlashDeltaStats *stats, size_t sectorSize, size_t batchSectors)
+{
+    FlashDeltaStats st;
+    const uint64_t end = addr + len;
+    const uint64_t batchSize = sectorSize * std::max<size_t>(batchSectors, 1);
+    // Batches are aligned to sectors, the first and last sector of the
+    // image may be partial.
+    const uint64_t alignedStart = addr - (addr % sectorSize);
+
+    struct Batch {
+        uint64_t start = 0;
+        uint64_t end = 0;
+        std::vector<unsigned char> data;
+    };
+    auto readBatch = [&dev, addr, end, alignedStart, batchSize](uint64_t index, Batch *b) {
+        b->start = std::max(addr, alignedStart + index * batchSize);
+        b->end = std::min(end, alignedStart + (index + 1) * batchSize);
+        b->data.resize(b->end - b->start);
+        return dev.read(b->start, b->data.data(), b->data.size());
+    };
+
+    if (len == 0) {
+        if (stats)
+            *stats = st;
+        return 0;
+    }
+
+    const uint64_t batches = (end - alignedStart + batchSize - 1) / batchSize;
+    Batch cur, next;
+    int ret = readBatch(0, &cur);
+
+    for (uint64_t i = 0; ret == 0 && i < batches; i++) {
+        // Read back the next batch while the current one is written
+        std::future<int> pending;
+        if (i + 1 < batches)
+            pending = std::async(std::launch::async, readBatch, i + 1, &next);
+
+        // Coalesce adjacent changed sectors into one write
+        uint64_t runStart = 0, runEnd = 0;
+        for (uint64_t s = cur.start; s < cur.end; ) {
+            uint64_t e = std::min(cur.end, s - (s % sectorSize) + sectorSize);
+            st.sectors++;
+            bool same = std::memcmp(cur.data.data() + (s - cur.start),
+                buf + (s - addr), e - s) == 0;
+            if (!same) {
+                st.sectorsChanged++;
+                if (runEnd != s)
+                    runStart = s;
+                runEnd = e;
+            }
+            bool flush = runEnd > runStart && (same || e == cur.end);
+            if (flush) {
+                ret = dev.write(runStart, buf + (runStart - addr), runEnd - runStart);
+                st.bytesWritten += runEnd - runStart;
+                runStart = runEnd = 0;
+                if (ret)
+                    break;
+            }
+            s = e;
+        }
+
+        if (pending.valid()) {
+            int r = pending.get();
+            if (ret == 0)
+                ret = r;
+        }
+        std::swap(cur, next);
+    }
+
+    if (stats)
+        *stats = st;
+    return ret;
+}
@@ -0,0 +1,104 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef _FLASH_DELTA_H_
+#define _FLASH_DELTA_H_
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+/*
+ * Delta flash programming.
+ *
+ * Reflashing an image that mostly matches what is already on flash only
+ * needs to erase and program the sectors that differ. The flash is read
+ * back in large batches and compared sector by sector with the new image.
+ * The next batch is read while the changed sectors of the current batch
+ * are written.
+ */
+
+// Erase sector size of the flash parts used on our cards
+const size_t flashSectorSize = 64 * 1024ul;
+// Sectors read back from flash per batch
+const size_t flashDeltaBatchSectors = 16;
+
+// Flash as seen through the flash driver. Flash is byte addressable,
+// sectors are erased as needed when written. Returns 0 or -errno.
+class FlashDevice
+{
+public:
+    virtual ~FlashDevice() {}
+    virtual int read(uint64_t addr, unsigned char *buf, size_t len) = 0;
+    virtual int write(uint64_t addr, const unsigned char *buf, size_t len) = 0;
+};
+
+// Flash driver node, or any file, opened by caller
+class FdFlashDevice : public FlashDevice
+{
+public:
+    explicit FdFlashDevice(int fd) : mFd(fd) {}
+    int read(uint64_t addr, unsigned char *buf, size_t len) override;
+    int write(uint64_t addr, const unsigned char *buf, size_t len) override;
+
+private:
+    int mFd;
+};
+
+// Timing model of the flash simulator
+struct SimFlashTiming {
+    uint64_t readNsPerByte = 20;        // ~50MB/s quad spi read
+    uint64_t eraseUsPerSector = 150000; // 64KB sector erase
+    uint64_t programNsPerByte = 1000;   // ~1MB/s page program
+};
+
+// File backed flash simulator. Models a NOR flash which has to erase a
+// sector before programming it. Device time is not spent but accumulated
+// from the timing model, so that flashing strategies can be compared
+// without hardware.
+class SimFlashDevice : public FlashDevice
+{
+public:
+    struct Counters {
+        uint64_t bytesRead = 0;
+        uint64_t bytesProgrammed = 0;
+        uint64_t sectorsErased = 0;
+        std::chrono::microseconds busy { 0 };
+    };
+
+    // Create or open the backing file, a new flash is erased (all 0xff).
+    SimFlashDevice(const std::string& path, size_t size,
+        size_t sectorSize = flashSectorSize, const SimFlashTiming& timing = SimFlashTiming());
+    ~SimFlashDevice();
+
+    int read(uint64_t addr, unsigned char *buf, size_t len) override;
+    int write(uint64_t addr, const unsigned char *buf, size_t len) override;
+
+    Counters getCounters();
+    void resetCounters();
+
+private:
+    std::fstream mFile;
+    size_t mSize;
+    size_t mSectorSize;
+    SimFlashTiming mTiming;
+    std::mutex mMutex;
+    Counters mCounters;
+};
+
+struct FlashDeltaStats {
+    size_t sectors = 0;         // sectors covered by image
+    size_t sectorsChanged = 0;  // sectors written
+    size_t bytesWritten = 0;
+};
+
+// Write len bytes of buf to flash at addr, skipping sectors that already
+// hold the same data. Returns 0 or -errno.
+int writeFlashDelta(FlashDevice& dev, uint64_t addr, const unsigned char *buf,
+    size_t len, FlashDeltaStats *stats = nullptr,
+    size_t sectorSize = flashSectorSize,
+    size_t batchSectors = flashDeltaBatchSectors);
+
+#endif
@@ -0,0 +1,93 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Exercise delta flash programming against the file backed flash
+// simulator.  A full image is flashed, then an image that differs in a
+// few sectors is flashed in delta mode and compared with a full write of
+// the same image.
+#include "../flash_delta.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const size_t flashSize = 32 * 1024 * 1024ul;
+const size_t imageSize = 16 * 1024 * 1024ul + 1234;  // not sector aligned
+const uint64_t imageAddr = 0x1000;                   // not sector aligned
+
+int fail(const std::string& what)
+{
+    std::cout << "TEST FAILED: " << what << std::endl;
+    return 1;
+}
+
+bool flashMatches(SimFlashDevice& dev, uint64_t addr, const std::vector<unsigned char>& image)
+{
+    std::vector<unsigned char> data(image.size());
+    return dev.read(addr, data.data(), data.size()) == 0 && data == image;
+}
+
+}
+
+int main()
+{
+    std::string path = "flash_delta_test.bin";
+    std::remove(path.c_str());
+
+    std::mt19937 gen(42);
+    std::vector<unsigned char> image(imageSize);
+    for (auto& b : image)
+        b = static_cast<unsigned char>(gen());
+
+    SimFlashDevice dev(path, flashSize);
+
+    // Blank flash, every sector is written
+    FlashDeltaStats st;
+    if (writeFlashDelta(dev, imageAddr, image.data(), image.size(), &st))
+        return fail("delta write to blank flash");
+    if (st.sectorsChanged != st.sectors || !flashMatches(dev, imageAddr, image))
+        return fail("blank flash not fully written");
+
+    // Same image again, nothing is written
+    dev.resetCounters();
+    if (writeFlashDelta(dev, imageAddr, image.data(), image.size(), &st))
+        return fail("delta write of same image");
+    if (st.sectorsChanged != 0 || dev.getCounters().sectorsErased != 0)
+        return fail("unchanged image was written");
+
+    // Change the first and last byte and two adjacent sectors in between
+    auto changed = image;
+    changed.front() ^= 0xff;
+    changed.back() ^= 0xff;
+    changed[5 * flashSectorSize] ^= 0xff;
+    changed[6 * flashSectorSize] ^= 0xff;
+
+    dev.resetCounters();
+    if (writeFlashDelta(dev, imageAddr, changed.data(), changed.size(), &st))
+        return fail("delta write of changed image");
+    auto delta = dev.getCounters();
+    if (st.sectorsChanged != 4 || delta.sectorsErased != 4 || !flashMatches(dev, imageAddr, changed))
+        return fail("changed sectors not written, " + std::to_string(st.sectorsChanged) + " sectors written");
+
+    // Full write of the same image for comparison
+    dev.resetCounters();
+    if (dev.write(imageAddr, changed.data(), changed.size()))
+        return fail("full write");
+    auto full = dev.getCounters();
+
+    std::cout << "delta: " << delta.sectorsErased << " sectors erased, "
+              << delta.busy.count() / 1000 << "ms" << std::endl;
+    std::cout << "full:  " << full.sectorsErased << " sectors erased, "
+              << full.busy.count() / 1000 << "ms" << std::endl;
+    if (delta.busy * 5 > full.busy)
+        return fail("delta write not faster than full write");
+
+    std::remove(path.c_str());
+    std::cout << "PASSED TEST" << std::endl;
+    return 0;
+}
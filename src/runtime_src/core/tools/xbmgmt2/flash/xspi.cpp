@@ -15,6 +15,8 @@
  * under the License.
  */
 #include "xspi.h"
+#include "flash_delta.h"
+#include "core/common/config_reader.h"
 #include "core/common/system.h"
 #include "core/common/device.h"
 #include "core/common/query_requests.h"
@@ -2139,12 +2141,35 @@ static int mcsStreamToBin(std::istream& mcsStream, unsigned int& currentAddr,
     return 0;
 }
 
+// Only write the sectors that differ from what is on flash already.
+// Enabled with Runtime.flash_delta in xrt.ini.
+static int writeBitstreamDelta(std::FILE *flashDev, int index, unsigned int addr,
+    std::vector<unsigned char>& buf)
+{
+#ifdef __linux__
+    // Positional I/O on the underlying fd, nothing may be left buffered
+    std::fflush(flashDev);
+    FdFlashDevice dev(fileno(flashDev));
+    FlashDeltaStats stats;
+    int ret = writeFlashDelta(dev, toAddr(index, addr), buf.data(), buf.size(), &stats);
+    if (ret == 0)
+        std::cout << "Wrote " << stats.sectorsChanged << " of " << stats.sectors
+            << " sectors, skipped unchanged sectors" << std::endl;
+    return ret;
+#else
+    return -ENOSYS;
+#endif
+}
+
 static int writeBitstream(std::FILE *flashDev, int index, unsigned int addr,
     std::vector<unsigned char>& buf)
 {
     int ret = 0;
     size_t len = 0;
 
+    if (xrt_core::config::get_flash_delta())
+        return writeBitstreamDelta(flashDev, index, addr, buf);
+
     // Write to flash page by page and print '.' for each write
     // as progress indicator
     for (size_t i = 0; ret == 0 && i < buf.size(); i += len) {
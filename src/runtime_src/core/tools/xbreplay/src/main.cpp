@@ -13,10 +13,11 @@ namespace xbr = xrt_core::tools::xbreplay;
 /*
  * This function is used to parse the command line arguments
  */
-static std::tuple<bool, std::string, std::string> parse_command_line_arguments(std::vector<std::string>& cmd_params)
+static std::tuple<bool, std::string, std::string, xbr::replay_options> parse_command_line_arguments(std::vector<std::string>& cmd_params)
 {
   std::string trace_file;
   std::string mem_file;
+  xbr::replay_options replay_opts;
   std::vector<std::string>& args = cmd_params;
   xbr::utils::cmd_args_opt opt;
   bool doexit = false;
@@ -25,12 +26,13 @@ static std::tuple<bool, std::string, std::string> parse_command_line_arguments(s
     {'h', false, "", "To provide usage information"},
     {'t', true, "", "To provide path to the trace file as input"},
     {'d', true, "", "To provide path to the memory dump file"},
-    {'l', true, "", "To set the log level (DEBUG=0, INFO=1, WARN=2, ERROR=3)"}
+    {'l', true, "", "To set the log level (DEBUG=0, INFO=1, WARN=2, ERROR=3)"},
+    {'p', false, "", "To replay with the recorded inter-call timing"}
   };
 
   xbr::utils::cmd_args cargs(std::move(options));
 
-  while (-1 != cargs.parse(args, opt, "t:d:l:h"))
+  while (-1 != cargs.parse(args, opt, "t:d:l:hp"))
   {
     switch (opt.type)
     {
@@ -50,18 +52,23 @@ static std::tuple<bool, std::string, std::string> parse_command_line_arguments(s
         l.set_loglevel(opt.value);
         XBREPLAY_INFO("Received log level: ", opt.value);
         break;
+      case 'p':
+        replay_opts.paced = true;
+        XBREPLAY_INFO("Replay with recorded timing");
+        break;
       default:
         throw std::runtime_error("Unknown option or missing argument. ABORT !!");
         break;
     }
   }
-  return std::make_tuple(doexit, trace_file, mem_file);
+  return std::make_tuple(doexit, trace_file, mem_file, replay_opts);
 }
 
 /*
  * This function is used to start the replay
  */
-static void start_replay(const std::string& trace_file, const std::string& mem_file)
+static void start_replay(const std::string& trace_file, const std::string& mem_file,
+                         const xbr::replay_options& replay_opts)
 {
   xbr::seq_reconstructor_factory seq_factory = {};
 
@@ -69,9 +76,9 @@ static void start_replay(const std::string& trace_file, const std::string& mem_f
     * main
     *   -> Sequence Reconstructor thread
     *      -> Replay Master Thread.
-    *         -> Replay Worker Thread.
+    *         -> Replay Worker Thread per recorded thread.
     */
-  if (auto pseq_recon = seq_factory.create_seq_recon(trace_file, mem_file))
+  if (auto pseq_recon = seq_factory.create_seq_recon(trace_file, mem_file, replay_opts))
      pseq_recon->threads_join();
   else
       throw std::runtime_error("Failed to create sequence reconstructor");
@@ -90,8 +97,9 @@ int main(int argc, const char* argv[])
     /* doexit - Flag to indicate if the program should exit
      * trace_file & mem_file - Input Trace file path & memory dump file path
      * which is generated by xbtracer.
+     * replay_opts - Replay options.
      */
-    auto [doexit, trace_file, mem_file] = parse_command_line_arguments(args);
+    auto [doexit, trace_file, mem_file, replay_opts] = parse_command_line_arguments(args);
 
     /* The user has executed the 'xbreplay' command with the '-h' option.
      * The help message has been displayed on the screen. The program will now terminate.
@@ -99,7 +107,7 @@ int main(int argc, const char* argv[])
     if (doexit)
       return 0;
 
-    start_replay(trace_file, mem_file);
+    start_replay(trace_file, mem_file, replay_opts);
   }
   catch (const std::exception& e)
   {
@@ -0,0 +1,148 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+/*
+ * Replay of a synthetic binary trace against the noop shim.
+ *
+ * A binary trace of two threads, each opening and closing a device, is
+ * written with the binary logger of xbtracer.  The trace is read back
+ * with the binary trace reader, then replayed with xbreplay with
+ * XCL_EMULATION_MODE=noop.
+ *
+ * % noop_replay_test <path to xbreplay>
+ */
+#include "binary_logger.h"
+#include "trace_reader.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+namespace xtx = xrt::tools::xbtracer;
+
+constexpr uint32_t trace_entry = 0;
+constexpr uint32_t trace_exit = 1;
+constexpr const char* device_ctor = "xrt::device::device(unsigned int)";
+constexpr const char* device_dtor = "xrt::device::~device()";
+
+void
+write_trace(const std::string& path)
+{
+  xtx::binary_logger logger(path, 1, std::chrono::system_clock::now(),
+                            "|HEADER|pid:1|xrt_version:test|\n|START|test|\n");
+
+  // Distinct device handles per thread, the calls are interleaved
+  // across threads in the trace.
+  std::vector<std::thread> threads;
+  for (uintptr_t idx = 1; idx <= 2; ++idx) {
+    threads.emplace_back([&logger, idx] {
+      auto handle = reinterpret_cast<const void*>(idx * 0x1000); // NOLINT
+      logger.log(trace_entry, handle, device_ctor, "(0)");
+      logger.log(trace_exit, handle, device_ctor, "|");
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      logger.log(trace_entry, handle, device_dtor, "()");
+      logger.log(trace_exit, handle, device_dtor, "|");
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+
+  logger.close("|END|test|\n");
+}
+
+void
+check_trace(const std::string& path)
+{
+  std::ifstream in(path, std::ios::binary);
+  xtx::bin::reader reader(in);
+
+  std::vector<std::string> lines;
+  uint64_t previous = 0;
+  reader.read([&](const xtx::bin::reader::line& line) {
+    // |ENTRY|<seconds>.<nanoseconds>|...
+    auto start = line.text.find('|', 1) + 1;
+    auto dot = line.text.find('.', start);
+    auto ts = std::stoull(line.text.substr(start, dot - start)) * 1000000000ULL
+      + std::stoull(line.text.substr(dot + 1, 9));
+    if (ts < previous)
+      throw std::runtime_error("records out of order: " + line.text);
+    previous = ts;
+    lines.push_back(line.text);
+  });
+
+  if (reader.truncated())
+    throw std::runtime_error("trace is truncated");
+  if (lines.size() != 8)
+    throw std::runtime_error("expected 8 records, got " + std::to_string(lines.size()));
+  if (reader.header().find("|START|") == std::string::npos || reader.end() != "|END|test|\n")
+    throw std::runtime_error("header or end line missing");
+}
+
+std::string
+replay(const std::string& xbreplay, const std::string& path)
+{
+  std::string cmd = xbreplay + " -l 0 -t " + path + " 2>&1";
+  std::string output;
+
+  auto pipe = popen(cmd.c_str(), "r");
+  if (!pipe)
+    throw std::runtime_error("failed to run " + cmd);
+
+  std::vector<char> buf(4096);
+  while (auto len = std::fread(buf.data(), 1, buf.size(), pipe))
+    output.append(buf.data(), len);
+
+  if (pclose(pipe) != 0)
+    throw std::runtime_error(cmd + " failed:\n" + output);
+  return output;
+}
+
+size_t
+count(const std::string& output, const std::string& str)
+{
+  size_t cnt = 0;
+  for (auto pos = output.find(str); pos != std::string::npos; pos = output.find(str, pos + 1))
+    ++cnt;
+  return cnt;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  if (argc != 2) {
+    std::cerr << "usage: noop_replay_test <path to xbreplay>\n";
+    return 1;
+  }
+
+  try {
+    const std::string path = "trace.xbt";
+    write_trace(path);
+    check_trace(path);
+
+    setenv("XCL_EMULATION_MODE", "noop", 1);
+    auto output = replay(argv[1], path); // NOLINT
+
+    if (count(output, "XBREPLAY_ERROR") || count(output, "No API MAPPED"))
+      throw std::runtime_error("replay failed:\n" + output);
+    if (count(output, std::string("|func_id |") + device_ctor + "|") != 2 ||
+        count(output, std::string("|func_id |") + device_dtor + "|") != 2)
+      throw std::runtime_error("replay did not invoke every call:\n" + output);
+
+    std::cout << "PASSED" << std::endl;
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "FAILED: " << ex.what() << std::endl;
+  }
+  return 1;
+}
@@ -5,19 +5,74 @@
 
 namespace xrt_core::tools::xbreplay {
 
+void replay_sequencer::dispatch(const utils::message& msg)
+{
+  std::lock_guard lock(m_mutex);
+  if (!m_started)
+  {
+    m_started = true;
+    m_first_entry = msg.m_entry_ts;
+    m_start = clock::now();
+  }
+  m_inflight.insert(exit_ts(msg));
+}
+
+bool replay_sequencer::wait(const utils::message& msg)
+{
+  std::unique_lock lock(m_mutex);
+  m_cv.wait(lock, [this, &msg] {
+    return m_abort || *m_inflight.begin() >= msg.m_entry_ts;
+  });
+
+  if (m_paced && !m_abort && msg.m_entry_ts > m_first_entry)
+  {
+    auto at = m_start + std::chrono::nanoseconds(msg.m_entry_ts - m_first_entry);
+    m_cv.wait_until(lock, at, [this] { return m_abort; });
+  }
+  return !m_abort;
+}
+
+void replay_sequencer::complete(const utils::message& msg)
+{
+  {
+    std::lock_guard lock(m_mutex);
+    auto it = m_inflight.find(exit_ts(msg));
+    if (it != m_inflight.end())
+      m_inflight.erase(it);
+  }
+  m_cv.notify_all();
+}
+
+void replay_sequencer::abort()
+{
+  {
+    std::lock_guard lock(m_mutex);
+    m_abort = true;
+  }
+  m_cv.notify_all();
+}
+
+replay_worker& replay_master::get_worker(uint64_t tid)
+{
+  auto& worker = m_workers[tid];
+  if (!worker)
+  {
+    XBREPLAY_INFO("Start Replay Worker for TID:", tid);
+    worker = std::make_unique<replay_worker>(m_api, m_seq);
+    worker->start();
+  }
+  return *worker;
+}
 
 /**
  * This is replay master thread function, receives
  * command from seq reconstructor and forwards to
- * Replay worker thread.
+ * the Replay worker thread of the recorded TID.
  */
 void replay_master::replay_master_main()
 {
   XBREPLAY_INFO("Replay Master started");
 
-  /* start replay worker thread */
-  m_replay_worker.start();
-
   bool loop = true;
   while (loop)
   {
@@ -27,15 +82,22 @@ void replay_master::replay_master_main()
       if (!msg_skip(msg))
       {
         /* send to worker thread */
-        m_out_msgq.send(msg);
+        m_seq.dispatch(*msg);
+        get_worker(msg->m_tid).send(msg);
       }
     }
     else
     {
-      m_out_msgq.send(msg);
+      for (auto& [tid, worker] : m_workers)
+        worker->send(msg);
       break;
     }
   }
+
+  for (auto& [tid, worker] : m_workers)
+    worker->th_join();
+
+  m_api.clear_map();
   XBREPLAY_INFO("Replay Master Exited");
 }
 
@@ -43,6 +105,7 @@ void replay_master::replay_master_main()
  * This is replay worker thread function.
  * Receives instructions from Replay master thread to
  * Performs XRT API invocation along with its parameters.
+ * On failure the replay is aborted in all worker threads.
  */
 void replay_worker::replay_worker_main()
 {
@@ -52,6 +115,9 @@ void replay_worker::replay_worker_main()
     auto msg = m_in_msgq.receive();
     if (msg->get_msgtype() != utils::message_type::stop_replay)
     {
+      if (!m_seq.wait(*msg))
+        break;
+
       try
       {
         m_api.invoke(msg);
@@ -59,20 +125,22 @@ void replay_worker::replay_worker_main()
       catch (const std::exception& e)
       {
         XBREPLAY_ERROR("Exception occurred during API invocation: {}", e.what());
+        m_seq.abort();
         break;
       }
       catch (...)
       {
         XBREPLAY_ERROR("An unknown error occurred");
+        m_seq.abort();
         break;
       }
+      m_seq.complete(*msg);
     }
     else
     {
       break;
     }
   }
-  m_api.clear_map();
   XBREPLAY_INFO("Replay Worker Exited");
 }
 
@@ -6,24 +6,88 @@
 #include "replay_xrt.hpp"
 #include "utils/message_queue.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace xrt_core::tools::xbreplay {
 
+/**
+ * Replay options
+ *  paced - Start each call at its recorded offset from the first call
+ */
+struct replay_options
+{
+  bool paced = false;
+};
+
+/**
+ * Replay sequencer class
+ *
+ * Orders the calls dispatched to the replay workers as recorded.  A call
+ * is started once every dispatched call that returned before it was
+ * entered in the trace has completed, calls that overlapped in the trace
+ * may run concurrently.  Calls must be dispatched in Entry order.
+ */
+class replay_sequencer
+{
+  using clock = std::chrono::steady_clock;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+
+  /* Exit time stamps of dispatched calls not yet completed */
+  std::multiset<uint64_t> m_inflight;
+  bool m_paced;
+  bool m_abort = false;
+  bool m_started = false;
+  uint64_t m_first_entry = 0;
+  clock::time_point m_start;
+
+  static uint64_t exit_ts(const utils::message& msg)
+  {
+    return std::max(msg.m_entry_ts, msg.m_exit_ts);
+  }
+
+  public:
+  explicit replay_sequencer(bool paced)
+  : m_paced(paced)
+  {}
+
+  void dispatch(const utils::message& msg);
+
+  /*
+   * Block until the call may start, returns false if replay is aborted
+   */
+  bool wait(const utils::message& msg);
+
+  void complete(const utils::message& msg);
+  void abort();
+};
+
 /**
  * Replay worker class
+ *
+ * A replay worker is created for every thread of the trace and invokes
+ * the calls of that thread in order.
  */
 class replay_worker
 {
-  utils::message_queue& m_in_msgq;
+  utils::message_queue m_in_msgq;
   std::thread m_replay_thrd;
-  replay_xrt m_api;
+  replay_xrt& m_api;
+  replay_sequencer& m_seq;
 
   public:
-  replay_worker(utils::message_queue& mqueues)
-  :m_in_msgq(mqueues)
+  replay_worker(replay_xrt& api, replay_sequencer& seq)
+  : m_api(api)
+  , m_seq(seq)
   {}
 
   void replay_worker_main();
@@ -35,6 +99,11 @@ class replay_worker
     });
   }
 
+  void send(std::shared_ptr<utils::message> msg)
+  {
+    m_in_msgq.send(std::move(msg));
+  }
+
   void th_join()
   {
     m_replay_thrd.join();
@@ -59,13 +128,18 @@ class replay_master
   std::vector<std::pair<std::string, std::string>> m_api_skip;
 
   utils::message_queue& m_in_msgq;
-  utils::message_queue m_out_msgq;
   std::thread m_replay_thrd;
   uint64_t m_api_skip_flag_cnt;
 
   /* vector<pair<API_ID ,TID>>  */
   std::vector<std::pair<std::string, uint64_t>>m_api_skip_list;
-  replay_worker m_replay_worker;
+  replay_xrt m_api;
+  replay_sequencer m_seq;
+
+  /* Replay worker per recorded TID */
+  std::map<uint64_t, std::unique_ptr<replay_worker>> m_workers;
+
+  replay_worker& get_worker(uint64_t tid);
 
   void init_api_skip_list()
   {
@@ -82,9 +156,9 @@ class replay_master
   }
 
   public:
-  replay_master(utils::message_queue& msg_q)
+  replay_master(utils::message_queue& msg_q, const replay_options& options)
   : m_in_msgq(msg_q)
-  , m_replay_worker(m_out_msgq)
+  , m_seq(options.paced)
   {
     m_api_skip_flag_cnt = 0;
     init_api_skip_list();
@@ -154,7 +228,6 @@ class replay_master
   void th_join()
   {
     m_replay_thrd.join();
-    m_replay_worker.th_join();
   }
 };
 }// end of namespace
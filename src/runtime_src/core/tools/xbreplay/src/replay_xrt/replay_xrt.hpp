@@ -16,13 +16,49 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <filesystem>
 
 namespace xrt_core::tools::xbreplay {
 
+/**
+ * Handle map shared by the replay worker threads.
+ *
+ * Lookup and insertion are serialized, references to values remain
+ * valid until the entry is erased.  Accesses to the same entry are
+ * ordered by the replay sequencer.
+ */
+template <typename Key, typename Value>
+class handle_map
+{
+  std::unordered_map<Key, Value> m_map;
+  std::mutex m_mutex;
+
+  public:
+  Value& operator[](const Key& key)
+  {
+    std::lock_guard lock(m_mutex);
+    return m_map[key];
+  }
+
+  void erase(const Key& key)
+  {
+    std::lock_guard lock(m_mutex);
+    m_map.erase(key);
+  }
+
+  void clear()
+  {
+    std::lock_guard lock(m_mutex);
+    m_map.clear();
+  }
+};
+
 /**
  * Replay XRT class.
  * This class performs following.
@@ -35,45 +71,45 @@ class replay_xrt
 {
   private:
   /*Map between handle from tracelog and device */
-  std::unordered_map<uint64_t, std::shared_ptr<xrt::device>> m_device_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<xrt::device>> m_device_hndle_map;
 
   /*Map between handle from tracelog and kernel */
-  std::unordered_map<uint64_t, std::shared_ptr<xrt::kernel>> m_kernel_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<xrt::kernel>> m_kernel_hndle_map;
 
   /*Map between handle from tracelog and xcldevice handle */
-  std::unordered_map<uint64_t, std::shared_ptr<xclDeviceHandle>> m_xcldev_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<xclDeviceHandle>> m_xcldev_hndle_map;
 
   /*Map between handle from tracelog and xcldevice handle */
-  std::unordered_map<uint64_t, std::shared_ptr<xclBufferExportHandle>> m_xclBufExp_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<xclBufferExportHandle>> m_xclBufExp_hndle_map;
 
   /*Map between handle from tracelog and xcldevice handle */
-  std::unordered_map<uint64_t, std::shared_ptr<axlf>> m_axlf_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<axlf>> m_axlf_hndle_map;
 
   /*Map between handle from  tracelog and xcldevice handle */
-  std::unordered_map<uint64_t, std::shared_ptr<xrt::hw_context>> m_hwctx_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<xrt::hw_context>> m_hwctx_hndle_map;
 
   /*Map between handle from log and run */
-  std::unordered_map<uint64_t, std::shared_ptr<xrt::run>> m_run_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<xrt::run>> m_run_hndle_map;
 
   /*Map between handle from log and bo */
-  std::unordered_map<uint64_t, std::shared_ptr<xrt::bo>> m_bo_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<xrt::bo>> m_bo_hndle_map;
 
   /*Map between handle from log and bo */
-  std::unordered_map<uint64_t, std::shared_ptr<xrt::xclbin>> m_xclbin_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<xrt::xclbin>> m_xclbin_hndle_map;
 
   /*Map between group id */
-  std::unordered_map<uint64_t, xrt::memory_group> m_kernel_grp_id;
+  handle_map<uint64_t, xrt::memory_group> m_kernel_grp_id;
 
   /* Map betgween uuid & device handle */
-  std::unordered_map<std::shared_ptr<xrt::device>, xrt::uuid> m_uuid_device_map;
+  handle_map<std::shared_ptr<xrt::device>, xrt::uuid> m_uuid_device_map;
 
   std::map <std::string, std::function < void (std::shared_ptr<utils::message>)>> m_api_map;
 
   /*Map between handle from log and xrt::module */
-  std::unordered_map<uint64_t, std::shared_ptr<xrt::module>> m_module_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<xrt::module>> m_module_hndle_map;
 
   /*Map between handle from log and xrt::elf */
-  std::unordered_map<uint64_t, std::shared_ptr<xrt::elf>> m_elf_hndle_map;
+  handle_map<uint64_t, std::shared_ptr<xrt::elf>> m_elf_hndle_map;
 
   /* Registers device class API's */
   void register_device_class_func();
@@ -144,10 +180,11 @@ class replay_xrt
    */
   void invoke (std::shared_ptr<utils::message> msg)
   {
-    if (m_api_map.find (msg->m_api_id) != m_api_map.end ())
+    auto it = m_api_map.find (msg->m_api_id);
+    if (it != m_api_map.end ())
     {
       msg->print_args();
-      m_api_map[msg->m_api_id] (msg);
+      it->second (msg);
     }
     else
     {
@@ -179,7 +216,7 @@ class replay_xrt
   std::string save_buf_to_file(std::shared_ptr<utils::message> msg, std::string file_ext)
   {
     /* To create unique file name */
-    static uint64_t i = 0;
+    static std::atomic<uint64_t> i = 0;
 
     // Define the file path
     std::filesystem::path currentpath = std::filesystem::current_path();
@@ -2,26 +2,17 @@
 // Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
 
 #include "seq_reconstructor.hpp"
+#include "trace_reader.h"
 
+#include <array>
 #include <tuple>
 
 namespace xrt_core::tools::xbreplay {
 
-/**
- * This function is used to find the line attributes such as
- *  TID, PID, API_ID etc. of entry/exit marker lines.
- */
-std::string
-find_attribute(const std::string& line, uint8_t offset, const std::string& pattern)
-{
-  std::regex Regex(pattern);
-  std::smatch match;
+namespace bin = xrt::tools::xbtracer::bin;
 
-  if (std::regex_search(line, match, Regex))
-    return match[offset].str();
-
-  return "";
-}
+/* Records of the binary trace are merged by time stamp within this window */
+constexpr uint64_t merge_window_ns = 1000000000UL;
 
 /**
  * This function is used to retrive Entry/Exit Marker line attributes which
@@ -29,18 +20,22 @@ find_attribute(const std::string& line, uint8_t offset, const std::string& patte
  * It Retrives TID, Object Handle, API_ID(Func Signature)
  *
  */
-std::tuple<std::string, std::string, std::string>
-get_line_attributes(const std::string& line, const std::string& regex_pattern)
+call_matcher::call_id
+get_line_attributes(const std::string& line, const std::regex& regex)
 {
   /* TID, handle, API ID */
-  std::tuple<std::string, std::string, std::string> entry_id = {};
+  call_matcher::call_id entry_id = {};
+  std::smatch match;
+
+  if (!std::regex_search(line, match, regex))
+    return entry_id;
 
   /* update TID */
-  std::get<0>(entry_id) = find_attribute(line, utils::match_idx_tid, regex_pattern);
+  std::get<0>(entry_id) = match[utils::match_idx_tid].str();
 
   /* Update handle */
-  std::get<1>(entry_id) = find_attribute(line, utils::match_idx_handle, regex_pattern);
-  std::string api = find_attribute(line, utils::match_idx_api, regex_pattern);
+  std::get<1>(entry_id) = match[utils::match_idx_handle].str();
+  std::string api = match[utils::match_idx_api].str();
   std::string api_id;
 
   size_t pos = api.find(")");
@@ -55,6 +50,119 @@ get_line_attributes(const std::string& line, const std::string& regex_pattern)
   return entry_id;
 }
 
+void call_matcher::add_entry(call_id id, std::string line)
+{
+  m_open[std::move(id)].push_back(m_released + m_calls.size());
+  m_calls.emplace_back(std::move(line), "");
+}
+
+void call_matcher::add_exit(const call_id& id, std::string line)
+{
+  auto it = m_open.find(id);
+  if (it == m_open.end())
+    return;
+
+  auto idx = it->second.back();
+  it->second.pop_back();
+  if (it->second.empty())
+    m_open.erase(it);
+
+  m_calls[idx - m_released].second = std::move(line);
+}
+
+bool call_matcher::next(trace_pair& trace, bool flush)
+{
+  if (m_calls.empty() || (!flush && m_calls.front().second.empty()))
+    return false;
+
+  trace = std::move(m_calls.front());
+  m_calls.pop_front();
+  ++m_released;
+  return true;
+}
+
+bool xrt_seq_reconstructor::is_binary_trace()
+{
+  std::array<char, bin::magic.size()> magic = {0};
+  m_trace_file.read(magic.data(), magic.size());
+  bool binary = m_trace_file && (magic == bin::magic);
+  m_trace_file.clear();
+  m_trace_file.seekg(0);
+  return binary;
+}
+
+/*
+ * Send the matched Entry and Exit marker lines to replay master
+ */
+void xrt_seq_reconstructor::send_matched(bool flush)
+{
+  call_matcher::trace_pair trace;
+  while (m_matcher.next(trace, flush))
+  {
+    if (trace.second.empty())
+      XBREPLAY_ERROR("Cannot find exit line for entry:", trace.first);
+
+    auto msg = std::make_shared<utils::message>(trace, m_mem_file_path,
+                  m_is_mem_file_available);
+
+    if (msg->is_success())
+      m_msgq.send(msg);
+    else
+      throw std::runtime_error("Failed to send message: Invalid line\n" +
+                  trace.first + "\n" + trace.second);
+  }
+}
+
+/*
+ * Read text trace line by line and match Entry and Exit marker lines
+ */
+void xrt_seq_reconstructor::read_text_trace()
+{
+  static const std::regex entry_regex(utils::regex_entry_pattern);
+  static const std::regex exit_regex(utils::regex_exit_pattern);
+  std::string line;
+
+  while (std::getline(m_trace_file, line))
+  {
+    if (line.rfind("|ENTRY|", 0) == 0)
+    {
+      auto id = get_line_attributes(line, entry_regex);
+      m_matcher.add_entry(std::move(id), std::move(line));
+    }
+    else if (line.rfind("|EXIT|", 0) == 0)
+    {
+      auto id = get_line_attributes(line, exit_regex);
+      m_matcher.add_exit(id, std::move(line));
+      send_matched(false);
+    }
+  }
+}
+
+/*
+ * Read binary trace, records are merged by time stamp across threads
+ * within the merge window.
+ */
+void xrt_seq_reconstructor::read_binary_trace()
+{
+  m_trace_file.seekg(0);
+  bin::reader reader(m_trace_file);
+
+  reader.read([this](const bin::reader::line& line) {
+    call_matcher::call_id id = {line.tid, line.handle,
+                                line.api.substr(0, line.api.find(')') + 1)};
+    if (line.exit)
+    {
+      m_matcher.add_exit(id, line.text);
+      send_matched(false);
+    }
+    else
+      m_matcher.add_entry(std::move(id), line.text);
+  }, merge_window_ns);
+
+  if (reader.truncated())
+    XBREPLAY_WARN("Binary trace is truncated");
+}
+
 /*
  * This is seq Reconstructor thread, this thread
  * will find Entry and corresponding Exit marker lines and
@@ -64,58 +172,16 @@ get_line_attributes(const std::string& line, const std::string& regex_pattern)
 void xrt_seq_reconstructor::start_reconstruction()
 {
   XBREPLAY_INFO("th:Seq Reconstruction start");
-  std::string line;
   m_replay_master.start();
 
   try
   {
-    while (std::getline(m_trace_file, line))
-    {
-      std::pair<std::string, std::string> trace = {};
-
-      /* Save current position */
-      std::streampos cur_pos = m_trace_file.tellg();
-
-      if (line.find("ENTRY") != std::string::npos)
-      {
-        /* store the Entry marker*/
-        trace.first = line;
-        auto entry_id = get_line_attributes(line, utils::regex_entry_pattern);
-        bool exit_found = false;
-        while (std::getline(m_trace_file, line))
-        {
-          if (line.find("EXIT") != std::string::npos)
-          {
-            auto exit_id = get_line_attributes(line, utils::regex_exit_pattern);
-            if (exit_id == entry_id)
-            {
-               /* found match, send to replay master */
-               trace.second = line;
-               exit_found = true;
-               break;
-            }
-          }
-          else
-            continue;
-        }
-        if (!exit_found)
-          XBREPLAY_ERROR("Cannot find exit line for entry:", trace.first);
-
-        auto msg = std::make_shared<utils::message>(trace, m_mem_file_path,
-                      m_is_mem_file_available);
-
-        if (msg->is_success())
-          m_msgq.send(msg);
-        else
-          throw std::runtime_error("Failed to send message: Invalid line\n" +
-                      trace.first + "\n" + trace.second);
-      }
-
-      /* While searching entry and corresponding exit the file seek postion has
-       * moved, we need to set it back to the right starting point.
-       */
-      m_trace_file.seekg(cur_pos);
-    } /* end of  while loop */
+    if (m_binary)
+      read_binary_trace();
+    else
+      read_text_trace();
+
+    send_matched(true);
   }
   catch (const std::runtime_error& e)
   {
@@ -6,10 +6,13 @@
 #include "replay.hpp"
 #include "utils/message_queue.hpp"
 
+#include <deque>
 #include <fstream>
+#include <map>
 #include <memory>
 #include <string>
 #include <thread>
+#include <tuple>
 #include <vector>
 
 namespace xrt_core::tools::xbreplay {
@@ -30,17 +33,58 @@ class seq_reconstructor
   virtual void threads_join() = 0;
 };
 
+/**
+ * Matches Entry and Exit marker lines of a trace in one pass.
+ *
+ * Entry lines are queued in trace order.  An Exit line is paired with
+ * the most recent unmatched Entry line of the same TID, handle and API
+ * ID.  Pairs are released in Entry order as soon as all preceding Entry
+ * lines are matched.
+ */
+class call_matcher
+{
+  public:
+  /* TID, handle, API ID */
+  using call_id = std::tuple<std::string, std::string, std::string>;
+  using trace_pair = std::pair<std::string, std::string>;
+
+  void add_entry(call_id id, std::string line);
+  void add_exit(const call_id& id, std::string line);
+
+  /*
+   * Release next matched pair in Entry order, or any pair if flush is
+   * set, returns false if there is none.
+   */
+  bool next(trace_pair& trace, bool flush = false);
+
+  private:
+  std::deque<trace_pair> m_calls;
+  uint64_t m_released = 0;
+  std::map<call_id, std::vector<uint64_t>> m_open;
+};
+
 /**
  * Sequence Reconstructor class
+ *
+ * Reads either the text trace or the binary trace (trace.xbt) written
+ * by xbtracer, the format is detected from the file content.  Records
+ * of the binary trace are merged by time stamp across threads and
+ * formatted as text marker lines.
  */
 class xrt_seq_reconstructor : public seq_reconstructor
 {
   private:
   utils::message_queue m_msgq;
   replay_master m_replay_master;
+  call_matcher m_matcher;
+  bool m_binary = false;
+
+  void read_text_trace();
+  void read_binary_trace();
+  void send_matched(bool flush);
 
   public:
-  bool m_is_mem_file_available;
+  bool m_is_mem_file_available = false;
   std::string m_mem_file_path;
 
   void start_reconstruction() override;
@@ -53,17 +97,20 @@ class xrt_seq_reconstructor : public seq_reconstructor
 
   /* constructor */
   xrt_seq_reconstructor(const std::string &trace_file_path,
-                        const std::string &mem_dmp_file_path)
-      : m_replay_master(m_msgq)
+                        const std::string &mem_dmp_file_path,
+                        const replay_options& options)
+      : m_replay_master(m_msgq, options)
   {
-    m_trace_file.open(trace_file_path.c_str());
+    m_trace_file.open(trace_file_path.c_str(), std::ios::binary);
 
     if (!m_trace_file.is_open())
       throw std::runtime_error("Failed to open input file: " + trace_file_path);
 
+    m_binary = is_binary_trace();
+
     if (!mem_dmp_file_path.empty())
     {
-      m_mem_dmp_file.open(trace_file_path.c_str(), std::ios::binary);
+      m_mem_dmp_file.open(mem_dmp_file_path.c_str(), std::ios::binary);
       if (!m_mem_dmp_file.is_open())
       {
         XBREPLAY_WARN("Failed to open memory dump file:", mem_dmp_file_path);
@@ -83,6 +130,11 @@ class xrt_seq_reconstructor : public seq_reconstructor
 
   ~xrt_seq_reconstructor() {}
 
+  /*
+   * Check for the binary trace magic, the read position is restored
+   */
+  bool is_binary_trace();
+
   void threads_join() override
   {
     m_seq_recon_thread.join();
@@ -100,9 +152,10 @@ class seq_reconstructor_factory
   public:
   std::shared_ptr<seq_reconstructor>
   create_seq_recon(const std::string &tracer_file,
-                   const std::string &dump_file)
+                   const std::string &dump_file,
+                   const replay_options& options)
   {
-    return std::make_shared<xrt_seq_reconstructor>(tracer_file, dump_file);
+    return std::make_shared<xrt_seq_reconstructor>(tracer_file, dump_file, options);
   }
 };
 
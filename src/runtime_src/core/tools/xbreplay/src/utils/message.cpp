@@ -4,6 +4,25 @@
 
 namespace xrt_core::tools::xbreplay::utils {
 
+/*
+ * This function is used to convert trace time stamp of format
+ * <seconds>.<nanoseconds> to nanoseconds.
+ */
+uint64_t parse_timestamp(const std::string& ts)
+{
+  constexpr uint64_t giga = 1000000000UL;
+  constexpr size_t ns_digits = 9;
+
+  size_t pos = ts.find('.');
+  uint64_t sec = std::stoull(ts.substr(0, pos));
+  if (pos == std::string::npos)
+    return sec * giga;
+
+  std::string frac = ts.substr(pos + 1, ns_digits);
+  frac.append(ns_digits - frac.size(), '0');
+  return sec * giga + std::stoull(frac);
+}
+
 void trim_spaces(std::string& entry)
 {
   entry.erase(entry.begin(), std::find_if(entry.begin(), entry.end(), [](int ch) {
@@ -59,7 +78,7 @@ replay_status message::update_args(const std::pair <std::string&, std::string&>
 void message::rmv_return_type(std::string& str)
 {
   /* Regular expression to match function signature (excluding return type)*/
-  std::regex pattern(regex_func_pattern);
+  static const std::regex pattern(regex_func_pattern);
 
   /* Check if the input string contains a function signature */
   std::smatch match;
@@ -96,7 +115,7 @@ replay_status message::decode_args(const std::string& line)
 
   if (line.find("...") != std::string::npos)
   {
-    std::regex pattern(regex_decode_args_pattern);
+    static const std::regex pattern(regex_decode_args_pattern);
     std::smatch matches;
     if (std::regex_search(line, matches, pattern))
     {
@@ -134,8 +153,8 @@ replay_status message::decode_args(const std::string& line)
       *        update the values.
       *
       */
-    std::regex regexFirst(regex_args_type_pattern);
-    std::regex regexSecond(regex_args_value_pattern);
+    static const std::regex regexFirst(regex_args_type_pattern);
+    static const std::regex regexSecond(regex_args_value_pattern);
 
     std::smatch match_firstline, match_secondline;
 
@@ -170,9 +189,12 @@ replay_status message::decode_entry_line(const std::string& line)
    * Entry trace marker is of below format and correspondigly update regex
    * ENTRY <number> <number> <number> <hex-value> ClassName::MethodName(arguments).
    **/
-  std::regex pattern(regex_entry_pattern);
+  static const std::regex pattern(regex_entry_pattern);
   if (std::regex_search(line, match, pattern))
   {
+    /* get time stamp */
+    m_entry_ts = parse_timestamp(match[match_idx_timestamp]);
+
     /* get thread ID */
     m_tid = std::stoul(match[match_idx_tid], nullptr, base_hex);
 
@@ -227,7 +249,7 @@ void message::get_user_data(const std::string& tag, std::vector<char>* user_data
     }
 
     std::string offset_str = tag.substr(start_pos, end_pos - start_pos);
-    m_mem_offset = std::stoul(offset_str, nullptr, base_hex);
+    m_mem_offset = std::stoull(offset_str, nullptr, base_hex);
     load_user_data(m_mem_offset, user_data);
   }
   else
@@ -236,10 +258,51 @@ void message::get_user_data(const std::string& tag, std::vector<char>* user_data
   }
 }
 
+/*
+ * This function is used to read the data of a mem record from memory
+ * dump file at current position and append it to target.  The size
+ * of an "m64" record is 64 bit, of an old "mem" record 32 bit.
+ */
+void message::read_mem_record(std::ifstream& file, std::vector<char>& target,
+                              uint32_t tag_value)
+{
+  uint64_t mem_size = 0;
+
+  if (tag_value == mem64_tag_value)
+    file.read(reinterpret_cast<char*>(&mem_size), sizeof(mem_size));
+  else
+  {
+    uint32_t mem_size32 = 0;
+    file.read(reinterpret_cast<char*>(&mem_size32), sizeof(mem_size32));
+    mem_size = mem_size32;
+  }
+  if (!file)
+    throw std::runtime_error("Error: Could not read memory size");
+
+  size_t base = target.size();
+  target.resize(base + mem_size, 0);
+
+  /* Read in  4k blocks */
+  uint64_t bytes_read = 0;
+  while (bytes_read < mem_size)
+  {
+    uint64_t bytes_to_read = std::min<uint64_t>(read_block_size, mem_size - bytes_read);
+    file.read(&target[base + bytes_read], static_cast<std::streamsize>(bytes_to_read));
+
+    if (!file)
+       throw std::runtime_error("Error reading from file " + m_mem_file_path);
+
+    bytes_read += bytes_to_read;
+  }
+}
+
 /*
  * This function is used to load user data from memory dump file.
+ *
+ * The data is either a mem record, or a ref record which lists the
+ * offsets of the mem records of the chunks of the data.
  */
-void message::load_user_data(const uint32_t offset, std::vector<char>* user_data)
+void message::load_user_data(const uint64_t offset, std::vector<char>* user_data)
 {
   std::ifstream file(m_mem_file_path, std::ios::binary);
 
@@ -251,7 +314,7 @@ void message::load_user_data(const uint32_t offset, std::vector<char>* user_data
   file.seekg(seek_pos);
 
   if (!file)
-    throw std::runtime_error("Failed to seek to position " + std::to_string(seek_pos));
+    throw std::runtime_error("Failed to seek to position " + std::to_string(offset));
 
   // Read the first 4 bytes
   uint32_t tag_value = 0;
@@ -263,46 +326,39 @@ void message::load_user_data(const uint32_t offset, std::vector<char>* user_data
 
   memcpy(&tag_value, buf_tag_val.data(), tag_read_len);
 
+  /* While reading Param data from memdump, update in user provided pointer
+   * else update in the member variable
+   */
+  std::vector<char>& target = user_data ? *user_data : m_buf;
+  target.clear();
+
   /* check if the TAG value matches */
-  if (tag_value == mem_tag_value)
+  if (tag_value == mem_tag_value || tag_value == mem64_tag_value)
+    read_mem_record(file, target, tag_value);
+  else if (tag_value == ref_tag_value)
   {
-    // Read the next 4 bytes
-    uint32_t mem_size = 0;
-    std::array<char, tag_read_len> buf = {0};
-
-    file.read(buf.data(), tag_read_len);
+    uint64_t mem_size = 0;
+    uint64_t count = 0;
+    file.read(reinterpret_cast<char*>(&mem_size), sizeof(mem_size));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    std::vector<uint64_t> chunks(count);
+    file.read(reinterpret_cast<char*>(chunks.data()), count * sizeof(uint64_t));
     if (!file)
-      throw std::runtime_error("Error: Could not read memory size");
+      throw std::runtime_error("Error: Could not read chunk list");
 
-    memcpy(&mem_size, buf.data(), tag_read_len);
-
-    /* While reading Param data from memdump, update in user provided pointer
-    * else update in the member variable
-    */
-    std::vector<char>& target = user_data ? *user_data : m_buf;
-    target.resize(mem_size, 0);
-
-    if (mem_size < read_block_size)
+    target.reserve(mem_size);
+    for (auto chunk : chunks)
     {
-      file.read(target.data(), mem_size);
-      if (!file)
-        throw std::runtime_error("Error: Could not read buffer");
+      file.seekg(static_cast<std::streamoff>(chunk));
+      file.read(buf_tag_val.data(), tag_read_len);
+      memcpy(&tag_value, buf_tag_val.data(), tag_read_len);
+      if (!file || tag_value != mem64_tag_value)
+        throw std::runtime_error("Invalid chunk at position " + std::to_string(chunk));
+      read_mem_record(file, target, tag_value);
     }
-    else
-    {
-      /* Read in  4k blocks */
-      uint32_t bytes_read = 0;
-      while (bytes_read < mem_size)
-      {
-        uint32_t bytes_to_read = std::min(static_cast<uint32_t>(read_block_size), mem_size - bytes_read);
-        file.read(&target[bytes_read], bytes_to_read);
-
-        if (!file)
-           throw std::runtime_error("Error reading from file " + m_mem_file_path);
 
-        bytes_read += bytes_to_read;
-      }
-    }
+    if (target.size() != mem_size)
+      throw std::runtime_error("Chunk sizes do not add up to " + std::to_string(mem_size));
   }
   else
     throw std::runtime_error("Tag value does not match: " + std::to_string(tag_value));
@@ -314,15 +370,16 @@ void message::load_user_data(const uint32_t offset, std::vector<char>* user_data
  */
 replay_status message::decode_exit_line(const std::string& line)
 {
-  std::regex pattern(regex_exit_pattern);
+  static const std::regex pattern(regex_exit_pattern);
   std::smatch match;
   replay_status estatus = replay_status::success;
 
   if (std::regex_search(line, match, pattern))
   {
     std::string mem_tag = match[match_idx_memtag].str();
+    m_exit_ts = parse_timestamp(match[match_idx_timestamp]);
 
-    std::regex return_val_pattern(regex_ret_val_pattern);
+    static const std::regex return_val_pattern(regex_ret_val_pattern);
     std::smatch ret_match;
     const std::string& api = match[match_idx_api].str();
     const std::string substr = ")=";
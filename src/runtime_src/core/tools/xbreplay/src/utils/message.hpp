@@ -29,7 +29,10 @@ constexpr const char* regex_func_pattern =
               (R"((?:\b\w+\s*::\s*)?\w+\s*::\s*\w+\s*\([^)]*\))");
 constexpr const char* regex_ret_val_pattern = (R"(=(\d+))");
 
-constexpr uint32_t mem_tag_value = 0x6d656du;
+constexpr uint32_t mem_tag_value = 0x6d656du;   // "mem", 32 bit size
+constexpr uint32_t mem64_tag_value = 0x34366du; // "m64", 64 bit size
+constexpr uint32_t ref_tag_value = 0x666572u;
+constexpr uint32_t match_idx_timestamp = 1u;
 constexpr uint32_t match_idx_arg_type = 1u;
 constexpr uint32_t match_idx_arg_value = 2u;
 constexpr uint32_t match_idx_tid = 3u;
@@ -61,6 +64,8 @@ class message
   uint64_t  m_ret_val;
   uint64_t  m_handle;
   uint64_t  m_tid;
+  uint64_t  m_entry_ts = 0;
+  uint64_t  m_exit_ts = 0;
   std::vector<char>m_buf;
   bool m_is_mem_file_available;
   std::vector<std::pair<std::string, std::string>> m_args;
@@ -122,7 +127,7 @@ class message
   private:
   std::string m_mem_file_path;
   replay_status m_status;
-  uint32_t  m_mem_offset;
+  uint64_t  m_mem_offset;
   message_type m_type;
 
   /*
@@ -159,9 +164,17 @@ class message
   /*
    * This function is used to retrive store data from memory dump file.
    */
-  void load_user_data(const uint32_t offset,
+  void load_user_data(const uint64_t offset,
                             std::vector<char>* user_data = nullptr);
 
+  /*
+   * This function is used to read the data of a mem record from memory
+   * dump file at current position and append it to target.  The size
+   * of an "m64" record is 64 bit, of an old "mem" record 32 bit.
+   */
+  void read_mem_record(std::ifstream& file, std::vector<char>& target,
+                       uint32_t tag_value);
+
   /*
    * This function is used decode parameters such as TID, return handle etc.,
    * from the function exit marker line.
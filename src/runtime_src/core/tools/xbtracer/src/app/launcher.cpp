@@ -1,6 +1,8 @@
 // SPDX-License-Identifier: Apache-2.0
 // Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
 
+#include "trace_reader.h"
+
 #include <array>
 #include <chrono>
 #include <filesystem>
@@ -66,6 +68,8 @@ class launcher
   // Public members
   bool m_debug = false;
   bool m_inst_debug = false;
+  bool m_binary = false;
+  std::string m_convert;
   std::string m_name;
   std::string m_lib_path;
   std::string m_extra_lib;
@@ -282,10 +286,10 @@ int parse_cmdline(launcher& app, int argc, char* argv[])
   std::lock_guard lock(mutex);
 
 #ifdef _WIN32
-  while ((option = getopt(argc, argv, "vVL:")) != -1)
+  while ((option = getopt(argc, argv, "vVbc:L:")) != -1)
 #else
   // NOLINTNEXTLINE(concurrency-mt-unsafe) - getopt is protected by a mutex
-  while ((option = getopt(argc, argv, "vV")) != -1)
+  while ((option = getopt(argc, argv, "vVbc:")) != -1)
 #endif /* #ifdef _WIN32 */
   {
     switch (option)
@@ -298,6 +302,14 @@ int parse_cmdline(launcher& app, int argc, char* argv[])
         app.m_debug = true;
         app.m_inst_debug = true;
         break;
+
+      case 'b':
+        app.m_binary = true;
+        break;
+
+      case 'c':
+        app.m_convert = optarg;
+        break;
 #ifdef _WIN32
       case 'L':
         if (std::filesystem::exists(optarg))
@@ -310,6 +322,10 @@ int parse_cmdline(launcher& app, int argc, char* argv[])
     }
   }
 
+  // Conversion of a binary trace doesn't launch an application
+  if (!app.m_convert.empty())
+    return 0;
+
   if (optind == argc)
     log_f("There should be alleast 1 argument without option switch");
 
@@ -360,6 +376,60 @@ void print_trace_location(launcher& app)
   std::cout << "\nTraces can be found at: " << trace_dir.string() << "\n\n";
 }
 
+/*
+ * Convert binary trace captured with -b to the text trace format.  The
+ * text trace is written next to the binary trace such that xbreplay can
+ * use it together with the memory dump file.
+ */
+void convert_trace(const std::string& path)
+{
+  namespace bin = xrt::tools::xbtracer::bin;
+  namespace fs = std::filesystem;
+
+  fs::path in_path(path);
+  if (fs::is_directory(in_path))
+    in_path /= bin::filename;
+
+  std::ifstream in(in_path, std::ios::binary);
+  if (!in)
+    log_f("Failed to open ", in_path.string());
+
+  // Lines are written after the header, which is known once read
+  std::string body;
+  size_t count = 0;
+  std::string header;
+  std::string end;
+  try
+  {
+    bin::reader reader(in);
+    reader.read([&body, &count](const bin::reader::line& line) {
+      body.append(line.text).append("\n");
+      ++count;
+    });
+
+    if (reader.truncated())
+      log_e("Binary trace ", in_path.string(), " is truncated");
+
+    header = reader.header();
+    end = reader.end();
+  }
+  catch (const std::exception& ex)
+  {
+    log_f(in_path.string(), ": ", ex.what());
+  }
+
+  auto out_path = in_path.parent_path() / "trace.txt";
+  std::ofstream out(out_path);
+  if (!out)
+    log_f("Failed to open ", out_path.string());
+
+  out << header << body << end;
+
+  log_d("Converted ", count, " records from ", in_path.string(),
+        " to ", out_path.string());
+  std::cout << "\nText trace written to: " << out_path.string() << "\n\n";
+}
+
 int set_envs(launcher& app)
 {
   if (app.m_inst_debug)
@@ -370,6 +440,14 @@ int set_envs(launcher& app)
       log_f("Failed to set environment variable: INST_DEBUG");
   }
 
+  if (app.m_binary)
+  {
+    if (set_env("TRACE_BINARY", "TRUE"))
+      log_d("Environment variable set successfully: TRACE_BINARY = TRUE");
+    else
+      log_f("Failed to set environment variable: TRACE_BINARY");
+  }
+
   if (set_env("TRACE_APP_NAME", app.m_cmdline.c_str()))
     log_d("Environment variable set successfully: TRACE_APP_NAME = ",
         app.m_cmdline);
@@ -644,6 +722,12 @@ int win_launcher(int& argc, char* argv[])
   */
   parse_cmdline(app, argc, argv);
 
+  if (!app.m_convert.empty())
+  {
+    convert_trace(app.m_convert);
+    return 0;
+  }
+
   /*
     Find and Check capture lib
   */
@@ -729,6 +813,12 @@ int posix_launcher(int& argc, char* argv[])
   */
   parse_cmdline(app, argc, argv);
 
+  if (!app.m_convert.empty())
+  {
+    convert_trace(app.m_convert);
+    return 0;
+  }
+
   /* Find instrumentation library */
   app.m_lib_path = find_library_path(inst_lib_name);
 
@@ -0,0 +1,279 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "binary_logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+namespace xrt::tools::xbtracer {
+
+// NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+constexpr std::chrono::milliseconds writer_interval {10};
+
+/*
+ * Per thread state, the api cache maps the address of string literals
+ * to api ids such that an api is interned once per thread.
+ */
+struct binary_logger::thread_state
+{
+  binary_logger* owner = nullptr;
+  thread_buffer* buffer = nullptr;
+  uint32_t thread = 0;
+  std::unordered_map<const char*, uint32_t> apis;
+};
+
+binary_logger::binary_logger(const std::string& path, uint32_t pid,
+                             time_point start, const std::string& header)
+: m_start_time(start)
+{
+  m_fp.open(path, std::ios::out | std::ios::binary);
+  if (!m_fp)
+    std::cerr << "Failed to open binary trace file: " << path << std::endl;
+
+  m_fp.write(bin::magic.data(), bin::magic.size());
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  m_fp.write(reinterpret_cast<const char*>(&bin::version), sizeof(bin::version));
+  write_chunk_header(bin::chunk::header, sizeof(pid) + header.size());
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  m_fp.write(reinterpret_cast<const char*>(&pid), sizeof(pid));
+  m_fp.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+  m_writer = std::thread(&binary_logger::writer, this);
+}
+
+binary_logger::~binary_logger()
+{
+  if (!m_closed)
+    close("");
+}
+
+binary_logger::thread_state&
+binary_logger::get_thread_state()
+{
+  static thread_local thread_state state;
+  if (state.owner == this)
+    return state;
+
+  auto buf = std::make_unique<thread_buffer>();
+  state.buffer = buf.get();
+  state.apis.clear();
+  {
+    std::lock_guard lock(m_mutex);
+    m_buffers.push_back(std::move(buf));
+  }
+  state.thread = intern_thread(std::this_thread::get_id());
+  state.owner = this;
+  return state;
+}
+
+uint32_t
+binary_logger::intern_api(const std::string& api)
+{
+  std::lock_guard lock(m_mutex);
+  auto [itr, inserted] = m_apis.emplace(api, static_cast<uint32_t>(m_apis.size()));
+  if (inserted)
+    m_definitions.emplace_back(bin::chunk::api, itr->second, api);
+  return itr->second;
+}
+
+uint32_t
+binary_logger::intern_thread(std::thread::id tid)
+{
+  std::lock_guard lock(m_mutex);
+  auto [itr, inserted] = m_threads.emplace(tid, static_cast<uint32_t>(m_threads.size()));
+  if (inserted) {
+    std::ostringstream oss;
+    oss << tid;
+    m_definitions.emplace_back(bin::chunk::thread, itr->second, oss.str());
+  }
+  return itr->second;
+}
+
+/*
+ * Append record and argument text to ring buffers of calling thread.
+ * Argument text larger than the blob ring buffer is truncated.
+ */
+void
+binary_logger::push(thread_buffer* buf, uint32_t type, const void* handle,
+                    uint32_t api, uint32_t thread, std::string_view args)
+{
+  auto now = std::chrono::system_clock::now();
+  auto size = std::min(args.size(), blob_capacity);
+  auto tail = buf->tail.load(std::memory_order_relaxed);
+
+  while (tail - buf->head.load(std::memory_order_acquire) >= record_capacity ||
+         buf->blob_tail + size - buf->blob_head.load(std::memory_order_acquire) > blob_capacity)
+  {
+    if (m_closed.load(std::memory_order_relaxed))
+      return;
+    m_work.notify_one();
+    std::this_thread::yield();
+  }
+
+  auto offset = buf->blob_tail % blob_capacity;
+  auto first = std::min(size, blob_capacity - offset);
+  std::memcpy(buf->blob.data() + offset, args.data(), first);
+  std::memcpy(buf->blob.data(), args.data() + first, size - first);
+  buf->blob_tail += size;
+
+  auto& rec = buf->records[tail % record_capacity];
+  rec.timestamp = static_cast<uint64_t>(
+    std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start_time).count());
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  rec.handle = reinterpret_cast<uint64_t>(handle);
+  rec.api = api;
+  rec.thread = thread;
+  rec.blob_offset = static_cast<uint32_t>(offset);
+  rec.blob_size = static_cast<uint32_t>(size);
+  rec.type = type;
+  rec.reserved = 0;
+
+  buf->tail.store(tail + 1, std::memory_order_release);
+}
+
+void
+binary_logger::log(uint32_t type, const void* handle, const char* api,
+                   std::string_view args)
+{
+  if (m_closed.load(std::memory_order_relaxed))
+    return;
+
+  auto& state = get_thread_state();
+  auto [itr, inserted] = state.apis.emplace(api, 0);
+  if (inserted)
+    itr->second = intern_api(api);
+
+  push(state.buffer, type, handle, itr->second, state.thread, args);
+}
+
+void
+binary_logger::log(uint32_t type, const void* handle, const std::string& api,
+                   std::string_view args, std::thread::id tid)
+{
+  if (m_closed.load(std::memory_order_relaxed))
+    return;
+
+  auto& state = get_thread_state();
+  push(state.buffer, type, handle, intern_api(api), intern_thread(tid), args);
+}
+
+void
+binary_logger::write_chunk_header(bin::chunk tag, size_t size)
+{
+  auto fixed_sz = static_cast<uint32_t>(size);
+  m_fp.put(static_cast<char>(tag));
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  m_fp.write(reinterpret_cast<const char*>(&fixed_sz), sizeof(fixed_sz));
+}
+
+void
+binary_logger::write_definition(bin::chunk tag, uint32_t id,
+                                const std::string& str)
+{
+  write_chunk_header(tag, sizeof(id) + str.size());
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  m_fp.write(reinterpret_cast<const char*>(&id), sizeof(id));
+  m_fp.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+/*
+ * Write the records published by all threads.  The tails are loaded
+ * before the pending definitions are taken, such that definitions
+ * interned before a record was published are written before the
+ * record.
+ */
+void
+binary_logger::drain()
+{
+  std::vector<thread_buffer*> buffers;
+  {
+    std::lock_guard lock(m_mutex);
+    for (auto& buf : m_buffers)
+      buffers.push_back(buf.get());
+  }
+
+  std::vector<uint64_t> tails;
+  for (auto buf : buffers)
+    tails.push_back(buf->tail.load(std::memory_order_acquire));
+
+  decltype(m_definitions) definitions;
+  {
+    std::lock_guard lock(m_mutex);
+    definitions.swap(m_definitions);
+  }
+  for (auto& [tag, id, str] : definitions)
+    write_definition(tag, id, str);
+
+  for (size_t idx = 0; idx < buffers.size(); ++idx) {
+    auto buf = buffers[idx];
+    auto head = buf->head.load(std::memory_order_relaxed);
+    auto tail = tails[idx];
+    if (head == tail)
+      continue;
+
+    m_batch.clear();
+    m_batch_blob.clear();
+    for (auto pos = head; pos != tail; ++pos) {
+      auto rec = buf->records[pos % record_capacity];
+      auto first = std::min<size_t>(rec.blob_size, blob_capacity - rec.blob_offset);
+      auto data = buf->blob.data();
+      auto batch_offset = m_batch_blob.size();
+      m_batch_blob.insert(m_batch_blob.end(), data + rec.blob_offset, data + rec.blob_offset + first);
+      m_batch_blob.insert(m_batch_blob.end(), data, data + (rec.blob_size - first));
+      rec.blob_offset = static_cast<uint32_t>(batch_offset);
+      m_batch.push_back(rec);
+    }
+
+    buf->blob_head.store(buf->blob_head.load(std::memory_order_relaxed) + m_batch_blob.size(),
+                         std::memory_order_release);
+    buf->head.store(tail, std::memory_order_release);
+
+    auto count = static_cast<uint32_t>(m_batch.size());
+    write_chunk_header(bin::chunk::records, sizeof(count) + m_batch.size() * sizeof(bin::record)
+                       + m_batch_blob.size());
+    // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+    m_fp.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    m_fp.write(reinterpret_cast<const char*>(m_batch.data()),
+               static_cast<std::streamsize>(m_batch.size() * sizeof(bin::record)));
+    // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+    m_fp.write(m_batch_blob.data(), static_cast<std::streamsize>(m_batch_blob.size()));
+  }
+}
+
+void
+binary_logger::writer()
+{
+  bool stop = false;
+  while (!stop) {
+    {
+      std::unique_lock lock(m_mutex);
+      m_work.wait_for(lock, writer_interval, [this] { return m_stop; });
+      stop = m_stop;
+    }
+    drain();
+  }
+}
+
+void
+binary_logger::close(const std::string& end)
+{
+  {
+    std::lock_guard lock(m_mutex);
+    m_stop = true;
+  }
+  m_work.notify_one();
+  if (m_writer.joinable())
+    m_writer.join();
+
+  m_closed = true;
+  drain();
+
+  write_chunk_header(bin::chunk::end, end.size());
+  m_fp.write(end.data(), static_cast<std::streamsize>(end.size()));
+  m_fp.close();
+}
+
+} // namespace xrt::tools::xbtracer
@@ -0,0 +1,144 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#pragma once
+
+#include "trace_format.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace xrt::tools::xbtracer {
+
+/*
+ * binary_logger - capture of entry and exit traces as binary records.
+ *
+ * Each thread appends fixed size records and the argument text of the
+ * records to ring buffers of its own, no lock is taken and nothing is
+ * formatted on the traced thread.  A writer thread drains the ring
+ * buffers into the trace file, see trace_format.h for the layout.  A
+ * thread blocks only when its ring buffers are full.
+ *
+ * Function signatures and thread ids are written once to the file and
+ * referenced by id from the records.
+ */
+class binary_logger
+{
+  public:
+  using time_point = std::chrono::time_point<std::chrono::system_clock>;
+
+  /*
+   * Open trace file and start writer thread, header is the text of the
+   * header lines of the text trace.
+   */
+  binary_logger(const std::string& path, uint32_t pid, time_point start,
+                const std::string& header);
+
+  /*
+   * Stop writer thread after draining all ring buffers.
+   */
+  ~binary_logger();
+
+  binary_logger(const binary_logger&) = delete;
+  binary_logger& operator=(const binary_logger&) = delete;
+  binary_logger(binary_logger&&) = delete;
+  binary_logger& operator=(binary_logger&&) = delete;
+
+  /*
+   * Log a trace of calling thread, api must be a string literal as it
+   * is identified by address.
+   */
+  void log(uint32_t type, const void* handle, const char* api,
+           std::string_view args);
+
+  /*
+   * Log a trace on behalf of thread tid.
+   */
+  void log(uint32_t type, const void* handle, const std::string& api,
+           std::string_view args, std::thread::id tid);
+
+  /*
+   * Drain all ring buffers and write the end chunk with the text of the
+   * end line of the text trace.  No trace can be logged after.
+   */
+  void close(const std::string& end);
+
+  private:
+  static constexpr size_t record_capacity = 4096;
+  static constexpr size_t blob_capacity = 1024 * 1024;
+
+  /*
+   * Single producer, single consumer ring buffers of a thread.  Record
+   * blob offsets are offsets in the blob ring buffer.
+   */
+  struct thread_buffer
+  {
+    std::vector<bin::record> records = std::vector<bin::record>(record_capacity);
+    std::vector<char> blob = std::vector<char>(blob_capacity);
+    uint64_t blob_tail = 0; // owned by producer
+    alignas(64) std::atomic<uint64_t> tail {0};
+    alignas(64) std::atomic<uint64_t> head {0};
+    std::atomic<uint64_t> blob_head {0};
+  };
+
+  struct thread_state;
+
+  thread_state&
+  get_thread_state();
+
+  uint32_t
+  intern_api(const std::string& api);
+
+  uint32_t
+  intern_thread(std::thread::id tid);
+
+  void
+  push(thread_buffer* buf, uint32_t type, const void* handle, uint32_t api,
+       uint32_t thread, std::string_view args);
+
+  void
+  write_chunk_header(bin::chunk tag, size_t size);
+
+  void
+  write_definition(bin::chunk tag, uint32_t id, const std::string& str);
+
+  void
+  drain();
+
+  void
+  writer();
+
+  std::ofstream m_fp;
+  time_point m_start_time;
+
+  // Guards interning, buffer registration, and pending definitions
+  std::mutex m_mutex;
+  std::unordered_map<std::string, uint32_t> m_apis;
+  std::map<std::thread::id, uint32_t> m_threads;
+  std::vector<std::unique_ptr<thread_buffer>> m_buffers;
+  std::vector<std::tuple<bin::chunk, uint32_t, std::string>> m_definitions;
+
+  // Writer thread, m_stop is guarded by m_mutex
+  std::condition_variable m_work;
+  bool m_stop = false;
+  std::atomic<bool> m_closed {false};
+  std::thread m_writer;
+
+  // Writer scratch
+  std::vector<bin::record> m_batch;
+  std::vector<char> m_batch_blob;
+};
+
+} // namespace xrt::tools::xbtracer
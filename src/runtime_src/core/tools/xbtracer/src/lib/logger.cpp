@@ -84,6 +84,9 @@ logger::logger()
     m_inst_debug = true;
   }
 
+  //NOLINTNEXTLINE(concurrency-mt-unsafe) - protected by env_mutex
+  bool binary = (get_env("TRACE_BINARY") == std::string("TRUE"));
+
   //NOLINTNEXTLINE(concurrency-mt-unsafe) - protected by env_mutex
   m_program_name = get_env("TRACE_APP_NAME");
 
@@ -112,12 +115,28 @@ logger::logger()
     if (!fs::create_directory(time_fmt_str))
       std::cerr << "Failed to create directory: " << time_fmt_str << std::endl;
 
+  std::ostringstream header;
+  header << "|HEADER|pname:\"" << m_program_name <<  "\"|m_pid:" << m_pid << "|xrt_ver:"
+     << XRT_DRIVER_VERSION << "|os:" << os_name_ver() << "|time:"
+     << time_fmt_str << "." << std::setfill('0') << std::setw(fw_9)
+     << ns.count() % giga << "|\n";
+
+  header << "|START|"<< time_fmt_str << "." << std::setfill('0') << std::setw(fw_9)\
+     << ns.count() % giga << "|\n";
+
   // Construct full path and open files for logging.
   std::ostringstream oss_full_path;
   oss_full_path << "." <<path_separator << time_fmt_str << path_separator
-                << xrt_trace_filename;
+                << (binary ? bin::filename : xrt_trace_filename);
 
-  m_fp.open(oss_full_path.str(), std::ios::out);
+  if (binary)
+    m_bin = std::make_unique<binary_logger>(oss_full_path.str(),
+              static_cast<uint32_t>(m_pid), m_start_time, header.str());
+  else
+  {
+    m_fp.open(oss_full_path.str(), std::ios::out);
+    m_fp << header.str();
+  }
 
   oss_full_path.str("");
   oss_full_path.clear();
@@ -125,15 +144,7 @@ logger::logger()
   oss_full_path << "." << path_separator << time_fmt_str << path_separator
                 << xrt_trace_bin_filename;
 
-  m_fp_bin.open(oss_full_path.str(), std::ios::out | std::ios::binary);
-
-  m_fp << "|HEADER|pname:\"" << m_program_name <<  "\"|m_pid:" << m_pid << "|xrt_ver:"
-     << XRT_DRIVER_VERSION << "|os:" << os_name_ver() << "|time:"
-     << time_fmt_str << "." << std::setfill('0') << std::setw(fw_9)
-     << ns.count() % giga << "|\n";
-
-  m_fp << "|START|"<< time_fmt_str << "." << std::setfill('0') << std::setw(fw_9)\
-     << ns.count() % giga << "|\n";
+  m_mem_dump.open(oss_full_path.str());
 }
 
 /*
@@ -155,11 +166,24 @@ logger::~logger()
                     now.time_since_epoch());
   std::string time_fmt_str = tp_to_date_time_fmt(now);
 
-  m_fp << "|END|" << time_fmt_str << "." << std::setfill('0') << std::setw(fw_9)
+  std::ostringstream end;
+  end << "|END|" << time_fmt_str << "." << std::setfill('0') << std::setw(fw_9)
      << ns.count() % giga << "|\n";
 
-  m_fp_bin.close();
-  m_fp.close();
+  if (m_bin)
+    m_bin->close(end.str());
+  else
+  {
+    m_fp << end.str();
+    m_fp.close();
+  }
+
+  m_mem_dump.close();
+
+  if (m_inst_debug)
+    std::cout << "Memory dump: " << m_mem_dump.get_bytes_in()
+              << " bytes traced, " << m_mem_dump.get_bytes_out()
+              << " bytes written" << std::endl;
 }
 
 void logger::synth_dtor_trace_fn()
@@ -168,6 +192,7 @@ void logger::synth_dtor_trace_fn()
 
   while (run)
   {
+    std::unique_lock<std::mutex> lock(m_tracker_mutex);
     run = false;
     run |= check_ref_count(m_dev_ref_tracker);
     run |= check_ref_count(m_run_ref_tracker);
@@ -178,6 +203,8 @@ void logger::synth_dtor_trace_fn()
     run |= check_ref_count(m_elf_ref_tracker);
 
 
+    lock.unlock();
+
     if (m_is_destructing == false)
 	run = true;
     // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
@@ -189,17 +216,33 @@ void logger::synth_dtor_trace_fn()
 /*
  * API to capture Entry and Exit Trace.
  * */
-void logger::log(trace_type type, std::string str)
+void logger::log(trace_type type, const void* handle, const char* func,
+                 const std::string& args)
 {
-  std::thread::id tid = std::this_thread::get_id();
-
-  log(type, str, tid);
+  if (m_bin)
+    m_bin->log(static_cast<uint32_t>(type), handle, func, args);
+  else
+    log_text(type, stringify_args(handle, "|", func) + args + "|\n",
+             std::this_thread::get_id());
 }
 
 /*
  * API to capture Entry and Exit Trace with given thread-id.
  * */
-void logger::log(trace_type type, std::string str, std::thread::id tid)
+void logger::log(trace_type type, const void* handle, const std::string& func,
+                 const std::string& args, std::thread::id tid)
+{
+  if (m_bin)
+    m_bin->log(static_cast<uint32_t>(type), handle, func, args, tid);
+  else
+    log_text(type, stringify_args(handle, "|", func) + args + "|\n", tid);
+}
+
+/*
+ * Write Entry and Exit Trace line to the text trace.
+ * */
+void logger::log_text(trace_type type, const std::string& str,
+                      std::thread::id tid)
 {
   auto time_now = std::chrono::system_clock::now();
 
@@ -208,11 +251,12 @@ void logger::log(trace_type type, std::string str, std::thread::id tid)
      << timediff(time_now, m_start_time) << "|" << m_pid << "|" << tid << "|"
      << str;
 
+  std::lock_guard<std::mutex> lock(m_fp_mutex);
   m_fp << ss.str();
 
   if (m_inst_debug)
     m_fp << std::flush;
-};
+}
 
 // Function to read OS name and version
 std::string logger::os_name_ver()
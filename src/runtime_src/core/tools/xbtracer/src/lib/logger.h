@@ -8,6 +8,7 @@
 #include <ctime>
 #include <fstream>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <thread>
 #include <tuple>
@@ -15,6 +16,9 @@
 #include <vector>
 #include <filesystem>
 
+#include "binary_logger.h"
+#include "mem_dump.h"
+
 #include "xrt/xrt_hw_context.h"
 #include "xrt/experimental/xrt_xclbin.h"
 #include "xrt/experimental/xrt_module.h"
@@ -66,21 +70,22 @@ class membuf
     m_sz = sz;
   }
 
+  const unsigned char* data() const
+  {
+    return m_ptr;
+  }
+
+  size_t size() const
+  {
+    return m_sz;
+  }
+
   friend std::ostream& operator<<(std::ostream& os, const membuf& mb)
   {
     for (unsigned int i = 0; i < mb.m_sz; i++)
       os << std::to_string(*(mb.m_ptr + i)) << " ";
     return os;
   }
-
-  friend std::ofstream& operator<<(std::ofstream& ofs, const membuf& mb)
-  {
-    ofs.write("mem\0", 4);
-    uint32_t fixed_sz = static_cast<uint32_t>(mb.m_sz);
-    ofs.write(reinterpret_cast<const char*>(&fixed_sz), sizeof(fixed_sz));
-    ofs.write((const char*)mb.m_ptr, mb.m_sz);
-    return ofs;
-  }
 };
 
 template <typename... Args>
@@ -90,7 +95,9 @@ class logger
 {
   private:
   std::ofstream m_fp;
-  std::ofstream m_fp_bin;
+  std::mutex m_fp_mutex;
+  mem_dump m_mem_dump;
+  std::unique_ptr<binary_logger> m_bin;
   std::string m_program_name;
   bool m_inst_debug;
   bool m_is_destructing = false;
@@ -101,6 +108,7 @@ class logger
 #endif /* #ifdef _WIN32 */
   std::chrono::time_point<std::chrono::system_clock> m_start_time{};
   std::thread synth_dtor_trace_thread;
+  std::mutex m_tracker_mutex;
   std::vector<std::tuple<std::shared_ptr<xrt_core::device>, std::thread::id,
                          std::string>> m_dev_ref_tracker;
   std::vector<std::tuple<std::shared_ptr<kernel_impl>, std::thread::id,
@@ -137,11 +145,11 @@ class logger
       }
       else
       {
-        logger::get_instance().log(trace_type::entry, stringify_args(pimpl)
-                                   + "|" + dtor_name + "()|\n", tid);
-        logger::get_instance().log(trace_type::exit, stringify_args(pimpl)
-                                   + "|" + dtor_name + "||\n", tid);
-        tuples.erase(it);
+        logger::get_instance().log(trace_type::entry, pimpl.get(), dtor_name,
+                                   "()", tid);
+        logger::get_instance().log(trace_type::exit, pimpl.get(), dtor_name,
+                                   "|", tid);
+        it = tuples.erase(it);
       }
     }
 
@@ -150,6 +158,11 @@ class logger
 
   void synth_dtor_trace_fn();
 
+  /*
+   * Write a text trace line, str is the line following the thread-id.
+   * */
+  void log_text(trace_type type, const std::string& str, std::thread::id tid);
+
   /*
    * constructor
    * */
@@ -170,42 +183,49 @@ class logger
 
   void set_pimpl(std::shared_ptr<xrt_core::device> hpimpl)
   {
+    std::lock_guard<std::mutex> lock(m_tracker_mutex);
     m_dev_ref_tracker.emplace_back(std::make_tuple(hpimpl,
           std::this_thread::get_id(), "xrt::device::~device()"));
   }
 
   void set_pimpl(std::shared_ptr<kernel_impl> hpimpl)
   {
+    std::lock_guard<std::mutex> lock(m_tracker_mutex);
     m_krnl_ref_tracker.emplace_back(std::make_tuple(hpimpl,
           std::this_thread::get_id(), "xrt::kernel::~kernel()"));
   }
 
   void set_pimpl(std::shared_ptr<run_impl> hpimpl)
   {
+    std::lock_guard<std::mutex> lock(m_tracker_mutex);
     m_run_ref_tracker.emplace_back(std::make_tuple(hpimpl,
           std::this_thread::get_id(), "xrt::run::~run()"));
   }
 
   void set_pimpl(std::shared_ptr<hw_context_impl> hpimpl)
   {
+    std::lock_guard<std::mutex> lock(m_tracker_mutex);
     m_hw_cnxt_ref_tracker.emplace_back(std::make_tuple(hpimpl,
           std::this_thread::get_id(), "xrt::hw_context::~hw_context()"));
   }
 
   void set_pimpl(std::shared_ptr<bo_impl> hpimpl)
   {
+    std::lock_guard<std::mutex> lock(m_tracker_mutex);
     m_bo_ref_tracker.emplace_back(std::make_tuple(hpimpl,
           std::this_thread::get_id(), "xrt::bo::~bo()"));
   }
 
   void set_pimpl(std::shared_ptr<module_impl> hpimpl)
   {
+    std::lock_guard<std::mutex> lock(m_tracker_mutex);
     m_mod_ref_tracker.emplace_back(std::make_tuple(hpimpl,
           std::this_thread::get_id(), "xrt::module::~module()"));
   }
 
   void set_pimpl(std::shared_ptr<elf_impl> hpimpl)
   {
+    std::lock_guard<std::mutex> lock(m_tracker_mutex);
     m_elf_ref_tracker.emplace_back(std::make_tuple(hpimpl,
           std::this_thread::get_id(), "xrt::elf::~elf()"));
   }
@@ -226,9 +246,9 @@ class logger
     return ptr;
   }
 
-  std::ofstream& get_bin_fd()
+  mem_dump& get_mem_dump()
   {
-    return m_fp_bin;
+    return m_mem_dump;
   }
 
   /*
@@ -237,10 +257,17 @@ class logger
   ~logger();
 
   /*
-   * API to capture Entry and Exit Trace.
+   * API to capture Entry and Exit Trace.  func must be a string literal,
+   * args is the text following func in the trace line.
+   * */
+  void log(trace_type type, const void* handle, const char* func,
+           const std::string& args);
+
+  /*
+   * API to capture Entry and Exit Trace on behalf of thread tid.
    * */
-  void log(trace_type type, std::string str);
-  void log(trace_type type, std::string str, std::thread::id tid);
+  void log(trace_type type, const void* handle, const std::string& func,
+           const std::string& args, std::thread::id tid);
 };
 
 template <typename... Args>
@@ -251,18 +278,24 @@ std::string stringify_args(const Args&... args)
   return oss.str();
 }
 
-template <typename T>
-inline std::string mb_stringify(T a1)
+inline std::string mb_stringify(const membuf& a1)
 {
-  std::ofstream& fd = logger::get_instance().get_bin_fd();
+  auto pos = logger::get_instance().get_mem_dump().write(a1.data(), a1.size());
   std::stringstream ss;
-  std::streampos pos = fd.tellp();
   ss << "mem@0x" << std::hex << pos << "[filename:" << xrt_trace_bin_filename
      << "]";
-  fd << a1;
   return ss.str();
 }
 
+template <typename T>
+inline std::string arg_stringify(const T& arg)
+{
+  if constexpr (std::is_same_v<membuf, std::decay_t<T>>)
+    return mb_stringify(arg);
+  else
+    return stringify_args(arg);
+}
+
 template <typename... Args>
 std::string concat_args(const Args&... args)
 {
@@ -270,11 +303,7 @@ std::string concat_args(const Args&... args)
   bool first = true;
 
   // Folding expression with type check for membuf
-  ((oss << (first ? "" : ", ")
-    << (std::is_same_v<membuf, std::decay_t<Args>>
-    ? mb_stringify(args)
-    : stringify_args(args)),
-    first = false), ...);
+  ((oss << (first ? "" : ", ") << arg_stringify(args), first = false), ...);
 
   return oss.str();
 }
@@ -283,10 +312,7 @@ std::string concat_args(const Args&... args)
 template <typename Arg, typename Val>
 std::string concat_arg_nv(const Arg& arg, const Val& val)
 {
-  if (!std::strcmp(typeid(membuf).name(), typeid(val).name()))
-    return stringify_args(arg) + "=" + mb_stringify(val);
-  else
-    return stringify_args(arg) + "=" + stringify_args(val);
+  return stringify_args(arg) + "=" + arg_stringify(val);
 }
 
 // Base case for recursive function to concatenate args and vals
@@ -377,9 +403,8 @@ namespace xtx = xrt::tools::xbtracer;
       break;                                                                   \
     }                                                                          \
     auto __handle = this->get_handle();                                        \
-    xtx::logger::get_instance().log(xtx::trace_type::entry,                    \
-        xtx::stringify_args(__handle.get(), "|", f) +                          \
-        "(" + xtx::concat_args(__VA_ARGS__) + ")|\n");                         \
+    xtx::logger::get_instance().log(xtx::trace_type::entry, __handle.get(), f, \
+        "(" + xtx::concat_args(__VA_ARGS__) + ")");                            \
   }                                                                            \
   while (0)                                                                    \
 
@@ -396,9 +421,8 @@ namespace xtx = xrt::tools::xbtracer;
       break;                                                                   \
     }                                                                          \
     auto __handle = this->get_handle();                                        \
-    xtx::logger::get_instance().log(xtx::trace_type::exit,                     \
-        xtx::stringify_args(__handle.get(), "|", f) +                          \
-        "|" + xtx::concat_args_nv(__VA_ARGS__) + "|\n");                       \
+    xtx::logger::get_instance().log(xtx::trace_type::exit, __handle.get(), f,  \
+        "|" + xtx::concat_args_nv(__VA_ARGS__));                               \
   }                                                                            \
   while (0)
 
@@ -415,9 +439,7 @@ namespace xtx = xrt::tools::xbtracer;
       break;                                                                   \
     }                                                                          \
     auto __handle = this->get_handle();                                        \
-    xtx::logger::get_instance().log(xtx::trace_type::exit,                     \
-        xtx::stringify_args(__handle.get(), "|", f) +                          \
-        "=" + xtx::stringify_args(r) + "|" + xtx::concat_args_nv(__VA_ARGS__)  \
-        + "|\n");                                                              \
+    xtx::logger::get_instance().log(xtx::trace_type::exit, __handle.get(), f,  \
+        "=" + xtx::stringify_args(r) + "|" + xtx::concat_args_nv(__VA_ARGS__)); \
   }                                                                            \
   while (0)
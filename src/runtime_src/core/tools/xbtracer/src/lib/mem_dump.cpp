@@ -0,0 +1,211 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "mem_dump.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+// NOLINTBEGIN(cppcoreguidelines-avoid-magic-numbers)
+
+/*
+ * XXH64 hash, used to identify chunks.  Hashing is done on the traced
+ * thread prior to taking the dump lock.
+ */
+constexpr uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t prime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t
+rotl(uint64_t x, int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t
+read64(const unsigned char* p)
+{
+  uint64_t v = 0;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint32_t
+read32(const unsigned char* p)
+{
+  uint32_t v = 0;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint64_t
+round(uint64_t acc, uint64_t input)
+{
+  acc += input * prime2;
+  return rotl(acc, 31) * prime1;
+}
+
+inline uint64_t
+merge(uint64_t acc, uint64_t val)
+{
+  acc ^= round(0, val);
+  return acc * prime1 + prime4;
+}
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+uint64_t
+xxh64(const unsigned char* p, size_t len, uint64_t seed = 0)
+{
+  const unsigned char* end = p + len;
+  uint64_t h = 0;
+
+  if (len >= 32) {
+    uint64_t v1 = seed + prime1 + prime2;
+    uint64_t v2 = seed + prime2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - prime1;
+    const unsigned char* limit = end - 32;
+    do {
+      v1 = round(v1, read64(p));
+      v2 = round(v2, read64(p + 8));
+      v3 = round(v3, read64(p + 16));
+      v4 = round(v4, read64(p + 24));
+      p += 32;
+    } while (p <= limit);
+
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    h = merge(h, v1);
+    h = merge(h, v2);
+    h = merge(h, v3);
+    h = merge(h, v4);
+  }
+  else
+    h = seed + prime5;
+
+  h += len;
+
+  for (; p + 8 <= end; p += 8) {
+    h ^= round(0, read64(p));
+    h = rotl(h, 27) * prime1 + prime4;
+  }
+
+  if (p + 4 <= end) {
+    h ^= read32(p) * prime1;
+    h = rotl(h, 23) * prime2 + prime3;
+    p += 4;
+  }
+
+  for (; p < end; ++p) {
+    h ^= (*p) * prime5;
+    h = rotl(h, 11) * prime1;
+  }
+
+  h ^= h >> 33;
+  h *= prime2;
+  h ^= h >> 29;
+  h *= prime3;
+  h ^= h >> 32;
+  return h;
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+// NOLINTEND(cppcoreguidelines-avoid-magic-numbers)
+
+constexpr const char* mem_tag = "m64";
+constexpr const char* ref_tag = "ref";
+constexpr size_t tag_len = 4;
+
+} // namespace
+
+namespace xrt::tools::xbtracer {
+
+void mem_dump::open(const std::string& path)
+{
+  m_fp.open(path, std::ios::out | std::ios::binary);
+  if (!m_fp)
+    std::cerr << "Failed to open memory dump file: " << path << std::endl;
+}
+
+void mem_dump::close()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_fp.close();
+}
+
+/*
+ * Write record of tag, 64 bit size, and payload at end of file.  Must
+ * be called with m_mutex locked.
+ */
+uint64_t mem_dump::write_record(const char* tag, const void* data,
+                                size_t size, const void* ids, uint64_t count)
+{
+  uint64_t offset = m_pos;
+  auto fixed_sz = static_cast<uint64_t>(size);
+
+  m_fp.write(tag, tag_len);
+  // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+  m_fp.write(reinterpret_cast<const char*>(&fixed_sz), sizeof(fixed_sz));
+  m_pos += tag_len + sizeof(fixed_sz);
+
+  if (ids)
+  {
+    m_fp.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    m_fp.write(reinterpret_cast<const char*>(ids), count * sizeof(uint64_t));
+    m_pos += sizeof(count) + count * sizeof(uint64_t);
+  }
+  else
+  {
+    m_fp.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+    m_pos += size;
+  }
+  // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+
+  return offset;
+}
+
+uint64_t mem_dump::write(const unsigned char* data, size_t size)
+{
+  size_t count = std::max<size_t>(1, (size + chunk_size - 1) / chunk_size);
+
+  std::vector<key> keys(count);
+  for (size_t idx = 0; idx < count; ++idx)
+  {
+    size_t offset = idx * chunk_size;
+    size_t len = std::min(chunk_size, size - offset);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    keys[idx] = {xxh64(data + offset, len), len};
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_bytes_in += size;
+
+  std::vector<uint64_t> ids(count);
+  for (size_t idx = 0; idx < count; ++idx)
+  {
+    auto [itr, inserted] = m_chunks.emplace(keys[idx], 0);
+    if (inserted)
+      // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      itr->second = write_record(mem_tag, data + idx * chunk_size,
+                                 keys[idx].size, nullptr, 0);
+    ids[idx] = itr->second;
+  }
+
+  if (count == 1)
+    return ids.front();
+
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  key ref_key {xxh64(reinterpret_cast<const unsigned char*>(ids.data()),
+                     ids.size() * sizeof(uint64_t)), size};
+  auto [itr, inserted] = m_refs.emplace(ref_key, 0);
+  if (inserted)
+    itr->second = write_record(ref_tag, nullptr, size, ids.data(), count);
+  return itr->second;
+}
+
+} // namespace xrt::tools::xbtracer
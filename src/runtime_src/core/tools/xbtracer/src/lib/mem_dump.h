@@ -0,0 +1,85 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace xrt::tools::xbtracer {
+
+/*
+ * mem_dump - content addressed store of traced buffers.
+ *
+ * Buffers are split in fixed size chunks and each chunk is hashed with
+ * a fast non-cryptographic hash.  A chunk is written to the dump file
+ * once, as an "m64" record, and the file offset of the record is the
+ * id of the chunk.  A buffer of more than one chunk is written as a
+ * "ref" record listing the ids of its chunks, identical buffers share
+ * the ref record.
+ *
+ *   m64 : "m64\0", 64 bit size, data
+ *   ref : "ref\0", 64 bit size, 64 bit chunk count, 64 bit chunk ids
+ *
+ * Dumps of earlier versions hold "mem" records with a 32 bit size,
+ * "mem\0", 32 bit size, data, which readers still accept.
+ *
+ * A buffer that fits in one chunk is referenced by the id of its chunk
+ * such that single chunk buffers are read as before.  Chunks are
+ * identified by hash and size, a hash collision is not detected.
+ */
+class mem_dump
+{
+  public:
+  static constexpr size_t chunk_size = 64 * 1024;
+
+  void open(const std::string& path);
+  void close();
+
+  /*
+   * Store buffer and return the offset of its mem or ref record
+   */
+  uint64_t write(const unsigned char* data, size_t size);
+
+  /*
+   * Total size of buffers stored and bytes written to the dump file
+   */
+  uint64_t get_bytes_in() const { return m_bytes_in; }
+  uint64_t get_bytes_out() const { return m_pos; }
+
+  private:
+  struct key
+  {
+    uint64_t hash;
+    uint64_t size;
+
+    bool operator==(const key& rhs) const
+    {
+      return hash == rhs.hash && size == rhs.size;
+    }
+  };
+
+  struct key_hash
+  {
+    size_t operator()(const key& k) const
+    {
+      return static_cast<size_t>(k.hash);
+    }
+  };
+
+  uint64_t write_record(const char* tag, const void* data, size_t size,
+                        const void* ids, uint64_t count);
+
+  std::mutex m_mutex;
+  std::ofstream m_fp;
+  uint64_t m_pos = 0;
+  uint64_t m_bytes_in = 0;
+  std::unordered_map<key, uint64_t, key_hash> m_chunks;
+  std::unordered_map<key, uint64_t, key_hash> m_refs;
+};
+
+} // namespace xrt::tools::xbtracer
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+/*
+ * Synthetic benchmark of the memory dump.
+ *
+ * Models an inference loop that syncs a large weight buffer, which
+ * never changes, and a small activation buffer, which changes on every
+ * iteration.  The loop is dumped once the way buffers were dumped
+ * before mem_dump, by appending every buffer in full, and once through
+ * mem_dump.  Size of both dumps and the time spent writing them is
+ * reported, and every buffer is read back from the mem_dump file.
+ *
+ * % mem_dump_bench [iterations] [weight MiB] [activation KiB]
+ *
+ * Defaults are 50 iterations of a 64 MiB weight buffer and a 1 MiB
+ * activation buffer.
+ */
+#include "mem_dump.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono;
+using buffer = std::vector<unsigned char>;
+
+constexpr const char* old_file = "mem_dump_bench_old.bin";
+constexpr const char* new_file = "mem_dump_bench_new.bin";
+
+template <typename T>
+T
+read_value(std::ifstream& fp)
+{
+  T value {};
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+  fp.read(reinterpret_cast<char*>(&value), sizeof(value));
+  if (!fp)
+    throw std::runtime_error("short read");
+  return value;
+}
+
+// Read a mem or ref record at offset, see the format in mem_dump.h
+buffer
+read_record(std::ifstream& fp, uint64_t offset)
+{
+  std::string tag(4, '\0');
+  fp.seekg(static_cast<std::streamoff>(offset));
+  fp.read(tag.data(), static_cast<std::streamsize>(tag.size()));
+  auto size = read_value<uint64_t>(fp);
+
+  if (tag == std::string("m64\0", 4)) {
+    buffer data(size);
+    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+    fp.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size));
+    if (!fp)
+      throw std::runtime_error("short read");
+    return data;
+  }
+
+  if (tag != std::string("ref\0", 4))
+    throw std::runtime_error("bad tag at " + std::to_string(offset));
+
+  std::vector<uint64_t> ids(read_value<uint64_t>(fp));
+  for (auto& id : ids)
+    id = read_value<uint64_t>(fp);
+
+  buffer data;
+  data.reserve(size);
+  for (auto id : ids) {
+    auto chunk = read_record(fp, id);
+    data.insert(data.end(), chunk.begin(), chunk.end());
+  }
+  if (data.size() != size)
+    throw std::runtime_error("chunks do not add up at " + std::to_string(offset));
+  return data;
+}
+
+uint64_t
+file_size(const char* path)
+{
+  std::ifstream fp(path, std::ios::binary | std::ios::ate);
+  return static_cast<uint64_t>(fp.tellg());
+}
+
+unsigned long
+arg(int argc, char* argv[], int idx, unsigned long def)
+{
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  return idx < argc ? std::stoul(argv[idx]) : def;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    auto iterations = arg(argc, argv, 1, 50);
+    buffer weights(arg(argc, argv, 2, 64) << 20);
+    buffer activation(arg(argc, argv, 3, 1024) << 10);
+
+    std::mt19937_64 rng(1);
+    for (auto& b : weights)
+      b = static_cast<unsigned char>(rng());
+
+    auto step = [&](unsigned long iter) {
+      for (auto& b : activation)
+        b = static_cast<unsigned char>(rng() + iter);
+    };
+
+    // Before: every buffer appended in full
+    std::ofstream old_fp(old_file, std::ios::binary);
+    auto start = steady_clock::now();
+    for (unsigned long iter = 0; iter < iterations; ++iter) {
+      step(iter);
+      for (auto* buf : {&weights, &activation}) {
+        uint64_t size = buf->size();
+        old_fp.write("mem\0", 4);
+        // NOLINTBEGIN(cppcoreguidelines-pro-type-reinterpret-cast)
+        old_fp.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        old_fp.write(reinterpret_cast<const char*>(buf->data()), static_cast<std::streamsize>(size));
+        // NOLINTEND(cppcoreguidelines-pro-type-reinterpret-cast)
+      }
+    }
+    old_fp.close();
+    auto old_ms = duration_cast<milliseconds>(steady_clock::now() - start).count();
+
+    // After: through mem_dump, keep a copy of each activation to verify
+    rng.seed(1);
+    for (auto& b : weights)
+      b = static_cast<unsigned char>(rng());
+
+    std::vector<buffer> activations;
+    std::vector<uint64_t> offsets;
+    xrt::tools::xbtracer::mem_dump dump;
+    dump.open(new_file);
+    milliseconds new_time {0};
+    for (unsigned long iter = 0; iter < iterations; ++iter) {
+      step(iter);
+      activations.push_back(activation);
+      start = steady_clock::now();
+      offsets.push_back(dump.write(weights.data(), weights.size()));
+      offsets.push_back(dump.write(activation.data(), activation.size()));
+      new_time += duration_cast<milliseconds>(steady_clock::now() - start);
+    }
+    dump.close();
+
+    std::cout << "iterations: " << iterations
+              << ", weights: " << weights.size()
+              << " bytes, activation: " << activation.size() << " bytes\n"
+              << "before: " << file_size(old_file) << " bytes, " << old_ms << " ms\n"
+              << "after:  " << file_size(new_file) << " bytes, " << new_time.count() << " ms\n";
+
+    std::ifstream fp(new_file, std::ios::binary);
+    for (unsigned long iter = 0; iter < iterations; ++iter) {
+      if (read_record(fp, offsets[2 * iter]) != weights)
+        throw std::runtime_error("weights mismatch in iteration " + std::to_string(iter));
+      if (read_record(fp, offsets[2 * iter + 1]) != activations[iter])
+        throw std::runtime_error("activation mismatch in iteration " + std::to_string(iter));
+    }
+    fp.close();
+
+    std::remove(old_file);
+    std::remove(new_file);
+    std::cout << "PASSED" << std::endl;
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "FAILED: " << ex.what() << std::endl;
+  }
+  return 1;
+}
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/*
+ * Layout of the binary trace file written in binary capture mode.
+ *
+ * The file starts with the magic and the version followed by a
+ * sequence of chunks, each chunk is a one byte tag, a 32 bit payload
+ * size and the payload.  All integers are in host byte order.
+ *
+ *   header  : 32 bit process id followed by the text of the HEADER and
+ *             START lines of the text trace
+ *   api     : 32 bit api id followed by the function signature
+ *   thread  : 32 bit thread id followed by the printed std::thread::id
+ *   records : 32 bit record count, the records and the argument blob
+ *   end     : text of the END line of the text trace
+ *
+ * An api or thread chunk always precedes the first records chunk that
+ * references its id.  Records of one thread are in program order, the
+ * records chunks of different threads are interleaved in the order
+ * they were drained and must be merged by timestamp.
+ *
+ * A record's argument text is the text that follows the function
+ * signature in the text trace, up to but excluding the terminating
+ * "|\n".  For entry records the text is enclosed in parentheses.
+ */
+namespace xrt::tools::xbtracer::bin {
+
+constexpr const char* filename = "trace.xbt";
+constexpr std::array<char, 4> magic = {'X', 'B', 'T', 'B'};
+constexpr uint32_t version = 1;
+
+enum class chunk : uint8_t {
+  header = 'H',
+  api = 'A',
+  thread = 'T',
+  records = 'R',
+  end = 'E'
+};
+
+struct record
+{
+  uint64_t timestamp;     // nanoseconds since start of trace
+  uint64_t handle;        // object handle
+  uint32_t api;           // id from api chunk
+  uint32_t thread;        // id from thread chunk
+  uint32_t blob_offset;   // argument text offset in records chunk blob
+  uint32_t blob_size;     // argument text size
+  uint32_t type;          // trace_type
+  uint32_t reserved;
+};
+
+static_assert(sizeof(record) == 40, "binary trace record layout changed");
+
+} // namespace xrt::tools::xbtracer::bin
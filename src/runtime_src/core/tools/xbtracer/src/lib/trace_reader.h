@@ -0,0 +1,228 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#pragma once
+
+#include "trace_format.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <istream>
+#include <limits>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace xrt::tools::xbtracer::bin {
+
+/*
+ * reader - reads a binary trace and formats its records as the marker
+ * lines of the text trace.
+ *
+ * Records chunks of different threads are interleaved in the file, so
+ * records are held back until no record within the merge window can
+ * precede them.  Lines are produced in time stamp order, records with
+ * equal time stamps in file order.  The default window holds back all
+ * records until the end of the file.
+ *
+ * Used by xbtracer to convert a binary trace and by xbreplay to replay
+ * it.  Errors are reported by throwing std::runtime_error.
+ */
+class reader
+{
+  public:
+  static constexpr uint64_t whole_file = std::numeric_limits<uint64_t>::max();
+
+  struct line
+  {
+    bool exit;            // exit or entry marker line
+    std::string tid;      // printed std::thread::id
+    std::string handle;   // printed object handle
+    std::string api;      // function signature
+    std::string text;     // marker line without the terminating newline
+  };
+
+  /*
+   * Check magic and version of the trace, the stream must be at the
+   * start of the trace.
+   */
+  explicit reader(std::istream& in)
+    : m_in(in)
+  {
+    std::array<char, magic.size()> buf {};
+    uint32_t ver = 0;
+    m_in.read(buf.data(), buf.size());
+    m_in.read(reinterpret_cast<char*>(&ver), sizeof(ver)); // NOLINT
+    if (!m_in || buf != magic)
+      throw std::runtime_error("Not a binary trace");
+    if (ver != version)
+      throw std::runtime_error("Unsupported binary trace version " + std::to_string(ver));
+  }
+
+  /*
+   * Read trace to the end and call callback(const line&) for every
+   * record.  Reading stops at a truncated chunk, see truncated().
+   */
+  template <typename Callback>
+  void
+  read(Callback&& callback, uint64_t merge_window = whole_file)
+  {
+    auto later = [](const pending& a, const pending& b) {
+      return std::tie(a.rec.timestamp, a.seq) > std::tie(b.rec.timestamp, b.seq);
+    };
+    std::priority_queue<pending, std::vector<pending>, decltype(later)> heap(later);
+
+    uint64_t seq = 0;
+    uint64_t max_ts = 0;
+    std::string data;
+    char tag = 0;
+
+    while (m_in.get(tag))
+    {
+      uint32_t size = 0;
+      m_in.read(reinterpret_cast<char*>(&size), sizeof(size)); // NOLINT
+      data.resize(size);
+      if (!m_in || !m_in.read(data.data(), size))
+      {
+        m_truncated = true;
+        break;
+      }
+
+      switch (static_cast<chunk>(tag))
+      {
+        case chunk::header:
+          m_pid = get<uint32_t>(data, 0);
+          m_header = data.substr(sizeof(m_pid));
+          break;
+
+        case chunk::api:
+        case chunk::thread:
+        {
+          auto& names = (static_cast<chunk>(tag) == chunk::api) ? m_apis : m_threads;
+          auto id = get<uint32_t>(data, 0);
+          if (names.size() <= id)
+            names.resize(static_cast<size_t>(id) + 1);
+          names[id] = data.substr(sizeof(id));
+          break;
+        }
+
+        case chunk::records:
+        {
+          auto count = get<uint32_t>(data, 0);
+          size_t blob = sizeof(count) + static_cast<size_t>(count) * sizeof(record);
+          if (blob > data.size())
+            throw std::runtime_error("Invalid records chunk in binary trace");
+
+          for (size_t idx = 0; idx < count; ++idx)
+          {
+            pending p {get<record>(data, sizeof(count) + idx * sizeof(record)), seq++, {}};
+            if (p.rec.api >= m_apis.size() || p.rec.thread >= m_threads.size() ||
+                static_cast<size_t>(p.rec.blob_offset) + p.rec.blob_size > data.size() - blob)
+              throw std::runtime_error("Invalid record in binary trace");
+
+            p.args = data.substr(blob + p.rec.blob_offset, p.rec.blob_size);
+            max_ts = std::max(max_ts, p.rec.timestamp);
+            heap.push(std::move(p));
+          }
+
+          while (!heap.empty() && max_ts - heap.top().rec.timestamp > merge_window)
+          {
+            callback(format(heap.top()));
+            heap.pop();
+          }
+          break;
+        }
+
+        case chunk::end:
+          m_end = data;
+          break;
+
+        default:
+          break;
+      }
+    }
+
+    while (!heap.empty())
+    {
+      callback(format(heap.top()));
+      heap.pop();
+    }
+  }
+
+  /*
+   * Text of the HEADER and START lines, and of the END line
+   */
+  const std::string&
+  header() const
+  {
+    return m_header;
+  }
+
+  const std::string&
+  end() const
+  {
+    return m_end;
+  }
+
+  bool
+  truncated() const
+  {
+    return m_truncated;
+  }
+
+  private:
+  struct pending
+  {
+    record rec;
+    uint64_t seq;
+    std::string args;
+  };
+
+  template <typename T>
+  static T
+  get(const std::string& data, size_t offset)
+  {
+    T value {};
+    if (offset + sizeof(T) > data.size())
+      throw std::runtime_error("Truncated chunk in binary trace");
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+  }
+
+  line
+  format(const pending& p) const
+  {
+    constexpr uint64_t giga = 1000000000UL;
+    constexpr int ns_digits = 9;
+
+    line l {p.rec.type != 0, m_threads[p.rec.thread], {}, m_apis[p.rec.api], {}};
+
+    std::ostringstream handle;
+    handle << reinterpret_cast<const void*>(p.rec.handle); // NOLINT
+    l.handle = handle.str();
+
+    std::ostringstream oss;
+    oss << (l.exit ? "|EXIT|" : "|ENTRY|") << (p.rec.timestamp / giga)
+        << "." << std::setfill('0') << std::setw(ns_digits)
+        << (p.rec.timestamp % giga) << "|" << m_pid << "|" << l.tid << "|"
+        << l.handle << "|" << l.api << p.args << "|";
+    l.text = oss.str();
+    return l;
+  }
+
+  std::istream& m_in;
+  uint32_t m_pid = 0;
+  std::string m_header;
+  std::string m_end;
+  std::vector<std::string> m_apis;
+  std::vector<std::string> m_threads;
+  bool m_truncated = false;
+};
+
+} // namespace xrt::tools::xbtracer::bin
@@ -158,7 +158,7 @@ bo::bo(xclDeviceHandle dhdl, xcl_buffer_handle xhdl)
   XRT_TOOLS_XBT_CALL_CTOR(dtbl.bo.ctor_xcl_bh, this, dhdl, xhdl);
   /* As pimpl will be updated only after ctor call*/
   XRT_TOOLS_XBT_FUNC_ENTRY(func, &dhdl, &xhdl);
-  XRT_TOOLS_XBT_FUNC_EXIT(dtbl.bo.ctor_xcl_bh);
+  XRT_TOOLS_XBT_FUNC_EXIT(func);
 }
 
 size_t bo::size() const
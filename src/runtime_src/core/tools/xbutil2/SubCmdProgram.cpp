@@ -19,11 +19,118 @@ namespace XBU = XBUtilities;
 #include <boost/program_options.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/property_tree/json_parser.hpp>
 namespace po = boost::program_options;
 
 // System - Include Files
+#include <filesystem>
 #include <iostream>
 #include <fstream>
+#include <thread>
+
+// ----- H E L P E R   M E T H O D S ------------------------------------------
+
+namespace {
+
+struct program_result
+{
+  std::string bdf;
+  std::string status;   // programmed, skipped, failed
+  std::string error;
+  std::chrono::duration<double> elapsed {0};
+};
+
+static std::string
+get_bdf(const std::shared_ptr<xrt_core::device>& device)
+{
+  try {
+    return xrt_core::query::pcie_bdf::to_string(xrt_core::device_query<xrt_core::query::pcie_bdf>(device));
+  }
+  catch (const std::exception&) {
+    return std::to_string(device->get_device_id());
+  }
+}
+
+// Program one device.  With skip_loaded the device is not programmed
+// if the xclbin is already loaded.  The xclbin object is shared by all
+// devices, it is read and validated only once.
+static void
+program_device(const std::shared_ptr<xrt_core::device>& device, const xrt::xclbin& xclbin,
+               bool skip_loaded, program_result& result)
+{
+  XBU::Timer timer;
+  try {
+    xrt::uuid loaded;
+    try {
+      if (skip_loaded)
+        loaded = device->get_xclbin_uuid();
+    }
+    catch (const std::exception&) {
+      // Nothing known to be loaded, program the device
+    }
+
+    if (loaded && loaded == xclbin.get_uuid()) {
+      result.status = "skipped";
+    }
+    else {
+      device->load_xclbin(xclbin);
+      result.status = "programmed";
+    }
+  }
+  catch (const std::exception& e) {
+    result.status = "failed";
+    result.error = e.what();
+  }
+  result.elapsed = timer.get_elapsed_time();
+}
+
+// Program all devices concurrently, one thread per device.
+static std::vector<program_result>
+program_devices(const xrt_core::device_collection& devices, const xrt::xclbin& xclbin, bool skip_loaded)
+{
+  std::vector<program_result> results(devices.size());
+  for (size_t i = 0; i < devices.size(); ++i)
+    results[i].bdf = get_bdf(devices[i]);
+
+  if (devices.size() == 1) {
+    program_device(devices[0], xclbin, skip_loaded, results[0]);
+    return results;
+  }
+
+  std::vector<std::thread> threads;
+  threads.reserve(devices.size());
+  for (size_t i = 0; i < devices.size(); ++i)
+    threads.emplace_back(program_device, std::cref(devices[i]), std::cref(xclbin), skip_loaded, std::ref(results[i]));
+  for (auto& t : threads)
+    t.join();
+
+  return results;
+}
+
+static boost::property_tree::ptree
+results_to_ptree(const std::string& path, const xrt::xclbin& xclbin,
+                 const std::vector<program_result>& results, std::chrono::duration<double> elapsed)
+{
+  boost::property_tree::ptree pt_devices;
+  for (const auto& result : results) {
+    boost::property_tree::ptree pt_device;
+    pt_device.put("bdf", result.bdf);
+    pt_device.put("status", result.status);
+    pt_device.put("time_ms", static_cast<uint64_t>(result.elapsed.count() * 1000));
+    if (!result.error.empty())
+      pt_device.put("error", result.error);
+    pt_devices.push_back(std::make_pair("", pt_device));
+  }
+
+  boost::property_tree::ptree pt;
+  pt.put("xclbin", path);
+  pt.put("uuid", xclbin.get_uuid().to_string());
+  pt.put("time_ms", static_cast<uint64_t>(elapsed.count() * 1000));
+  pt.add_child("devices", pt_devices);
+  return pt;
+}
+
+} // namespace
 
 // ----- C L A S S   M E T H O D S -------------------------------------------
 
@@ -32,18 +139,20 @@ SubCmdProgram::SubCmdProgram(bool _isHidden, bool _isDepricated, bool _isPrelimi
              "Download the acceleration program to a given device")
     , m_device("")
     , m_xclbin("")
+    , m_output("")
     , m_help(false)
 {
   const std::string longDescription = "Programs the given acceleration image into the device's shell.";
   setLongDescription(longDescription);
-  setExampleSyntax("");
+  setExampleSyntax("  --device all --user <xclbin>  Program all devices concurrently");
   setIsHidden(_isHidden);
   setIsDeprecated(_isDepricated);
   setIsPreliminary(_isPreliminary);
 
   m_commonOptions.add_options()
-    ("device,d", boost::program_options::value<decltype(m_device)>(&m_device), "The Bus:Device.Function (e.g., 0000:d8:00.0) device of interest.")
+    ("device,d", boost::program_options::value<decltype(m_device)>(&m_device), "The Bus:Device.Function (e.g., 0000:d8:00.0) device of interest, or 'all' to program all devices concurrently.  With 'all', devices that already have the xclbin loaded are skipped unless --force is given.")
     ("user,u", boost::program_options::value<std::string>(&m_xclbin), "The name (and path) of the xclbin to be loaded")
+    ("output,o", boost::program_options::value<decltype(m_output)>(&m_output), "Write a json report of the programmed devices to the given file")
     ("help", boost::program_options::bool_switch(&m_help), "Help to use this sub-command")
   ;
 }
@@ -67,10 +176,22 @@ SubCmdProgram::execute(const SubCmdOptions& _options) const
   XBU::verbose(boost::str(boost::format("  XclBin: %s") % m_xclbin));
 
   // -- process "device" option -----------------------------------------------
-  // Find device of interest
-  std::shared_ptr<xrt_core::device> device;
+  // Find devices of interest
+  xrt_core::device_collection devices;
+  bool all_devices = false;
   try {
-    device = XBU::get_device(boost::algorithm::to_lower_copy(m_device), true /*inUserDomain*/);
+    if (!m_output.empty() && std::filesystem::exists(m_output) && !XBU::getForce())
+      throw std::runtime_error((boost::format("The output file '%s' already exists.  Please either remove it or execute this command again with the '--force' option to overwrite it.") % m_output).str());
+
+    const auto device_str = boost::algorithm::to_lower_copy(m_device);
+    if (device_str == "all") {
+      all_devices = true;
+      XBU::collect_devices(std::set<std::string>{"_all_"}, true /*inUserDomain*/, devices);
+      if (devices.empty())
+        throw std::runtime_error("No devices found");
+    }
+    else
+      devices.push_back(XBU::get_device(device_str, true /*inUserDomain*/));
   } catch (const std::runtime_error& e) {
     // Catch only the exceptions that we have generated earlier
     std::cerr << boost::format("ERROR: %s\n") % e.what();
@@ -79,16 +200,46 @@ SubCmdProgram::execute(const SubCmdOptions& _options) const
 
   // -- process "program" option -----------------------------------------------
   if (!m_xclbin.empty()) {
-    auto bdf = xrt_core::query::pcie_bdf::to_string(xrt_core::device_query<xrt_core::query::pcie_bdf>(device));
-    auto xclbin_obj = xrt::xclbin{m_xclbin};
+    // Read and validate the xclbin once for all devices
+    xrt::xclbin xclbin_obj;
     try {
-      device->load_xclbin(xclbin_obj);
+      xclbin_obj = xrt::xclbin{m_xclbin};
     }
     catch (const std::exception& e) {
-      XBUtilities::throw_cancel(boost::format("Could not program device %s : %s") % bdf % e.what());
+      XBUtilities::throw_cancel(boost::format("Could not read xclbin %s : %s") % m_xclbin % e.what());
+    }
+
+    // Devices that already have the xclbin loaded are skipped when
+    // programming all devices, unless reprogramming is forced.  A
+    // single device is always programmed.
+    XBU::Timer timer;
+    auto results = program_devices(devices, xclbin_obj, all_devices && !XBU::getForce());
+    auto elapsed = timer.get_elapsed_time();
+
+    bool failed = false;
+    for (const auto& result : results) {
+      if (result.status == "failed") {
+        failed = true;
+        std::cerr << boost::format("ERROR: Could not program device %s : %s\n") % result.bdf % result.error;
+        continue;
+      }
+      std::cout << boost::format("INFO: xrt-smi program %s on %s (%.3fs)\n")
+        % (result.status == "skipped" ? "skipped, xclbin already loaded," : "succeeded")
+        % result.bdf % result.elapsed.count();
+    }
+    if (results.size() > 1)
+      std::cout << boost::format("INFO: Programmed %d device(s) in %.3fs\n") % results.size() % elapsed.count();
+
+    if (!m_output.empty()) {
+      std::ofstream fOutput(m_output, std::ios::out | std::ios::binary);
+      if (!fOutput.is_open())
+        XBUtilities::throw_cancel(boost::format("Unable to open the file '%s' for writing.") % m_output);
+      boost::property_tree::json_parser::write_json(fOutput, results_to_ptree(m_xclbin, xclbin_obj, results, elapsed));
+      std::cout << boost::format("Successfully wrote the json file: %s\n") % m_output;
     }
 
-    std::cout << "INFO: xrt-smi program succeeded on " << bdf << std::endl;
+    if (failed)
+      throw xrt_core::error(std::errc::operation_canceled);
     return;
   }
 
@@ -29,6 +29,7 @@ class SubCmdProgram : public SubCmd {
  private:
   std::string m_device;
   std::string m_xclbin;
+  std::string m_output;
   bool        m_help;
 };
 
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+/*
+ * Concurrent report collection of xrt-smi examine against the noop shim.
+ *
+ * Runs 'xrt-smi examine -r all' on two noop devices with serial
+ * collection (Runtime.examine_workers=1), with the default number of
+ * workers, and with the default number of workers and the query cache
+ * off (Runtime.examine_query_cache=false).  Console output, errors,
+ * exit status and JSON output except the creation date must be the
+ * same.
+ *
+ * % examine_workers_test <path to xrt-smi>
+ */
+#include "core/common/test_util.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <sys/wait.h>
+#include <vector>
+
+namespace {
+
+struct examine_result
+{
+  int status;
+  std::string console;
+  std::string errors;
+  std::string json;
+};
+
+std::string
+read_file(const std::string& path, bool skip_creation_date = false)
+{
+  std::ifstream in(path);
+  std::string text;
+  for (std::string line; std::getline(in, line);) {
+    if (skip_creation_date && line.find("\"creation_date\"") != std::string::npos)
+      continue;
+    text += line + '\n';
+  }
+  return text;
+}
+
+examine_result
+examine(const std::string& xrtsmi, const std::string& name, const std::string& ini)
+{
+  using xrt_core::test_util::temp_path;
+  xrt_core::test_util::ini_file ini_file(name, "[Runtime]\nnoop_devices=2\n" + ini);
+
+  auto json_path = temp_path(name + ".json").string();
+  auto err_path = temp_path(name + ".err").string();
+  std::string cmd = xrtsmi + " examine -d 0000:00:00.0 -r all --format JSON --output "
+    + json_path + " --force 2>" + err_path;
+
+  auto pipe = popen(cmd.c_str(), "r");
+  if (!pipe)
+    throw std::runtime_error("failed to run " + cmd);
+
+  examine_result result;
+  std::vector<char> buf(4096);
+  while (auto len = std::fread(buf.data(), 1, buf.size(), pipe))
+    result.console.append(buf.data(), len);
+
+  auto status = pclose(pipe);
+  if (!WIFEXITED(status))
+    throw std::runtime_error(cmd + " did not exit:\n" + result.console);
+
+  result.status = WEXITSTATUS(status);
+  result.errors = read_file(err_path);
+  result.json = read_file(json_path, true);
+
+  for (const auto& path : {json_path, err_path})
+    std::remove(path.c_str());
+  return result;
+}
+
+void
+compare(const std::string& what, const std::string& serial, const std::string& name, const std::string& other)
+{
+  if (serial == other)
+    return;
+
+  std::ostringstream oss;
+  oss << what << " differs\n--- examine_workers=1\n" << serial
+      << "--- " << name << "\n" << other;
+  throw std::runtime_error(oss.str());
+}
+
+void
+compare(const examine_result& serial, const std::string& name, const examine_result& other)
+{
+  compare("exit status", std::to_string(serial.status) + '\n', name, std::to_string(other.status) + '\n');
+  compare("console output", serial.console, name, other.console);
+  compare("error output", serial.errors, name, other.errors);
+  compare("JSON output", serial.json, name, other.json);
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  if (argc != 2) {
+    std::cerr << "usage: examine_workers_test <path to xrt-smi>\n";
+    return 1;
+  }
+
+  return xrt_core::test_util::run_main([argv] {
+    xrt_core::test_util::set_env("XCL_EMULATION_MODE", "noop");
+    auto serial = examine(argv[1], "examine_serial", "examine_workers=1\n"); // NOLINT
+    auto parallel = examine(argv[1], "examine_parallel", ""); // NOLINT
+    auto uncached = examine(argv[1], "examine_uncached", "examine_query_cache=false\n"); // NOLINT
+
+    if (serial.console.empty() || serial.json.empty())
+      throw std::runtime_error("no report produced:\n" + serial.console + serial.errors);
+
+    compare(serial, "default", parallel);
+    compare(serial, "examine_query_cache=false", uncached);
+    return 0;
+  });
+}
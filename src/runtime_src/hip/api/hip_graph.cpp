@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "hip/core/common.h"
+#include "hip/core/event.h"
+#include "hip/core/graph.h"
+#include "hip/core/stream.h"
+
+namespace xrt::core::hip {
+
+// Graphs are created by stream capture, explicit construction of
+// graph nodes is not supported.
+static graph_handle
+hip_graph_create(unsigned int flags)
+{
+  throw_invalid_value_if(flags != 0, "flags should be 0");
+  return insert_in_map(graph_cache, std::make_shared<graph>());
+}
+
+static void
+hip_graph_destroy(hipGraph_t graph)
+{
+  throw_invalid_value_if(!graph, "graph is nullptr");
+  throw_invalid_value_if(!graph_cache.count(graph), "graph is invalid");
+  graph_cache.remove(graph);
+}
+
+static graph_exec_handle
+hip_graph_instantiate(hipGraph_t graph)
+{
+  throw_invalid_value_if(!graph, "graph is nullptr");
+  auto hip_graph = graph_cache.get(graph);
+  throw_invalid_value_if(!hip_graph, "graph is invalid");
+
+  return insert_in_map(graph_exec_cache, std::make_shared<graph_exec>(*hip_graph));
+}
+
+static void
+hip_graph_launch(hipGraphExec_t graph_exec, hipStream_t stream)
+{
+  throw_invalid_value_if(!graph_exec, "graph exec is nullptr");
+  auto hip_graph_exec = graph_exec_cache.get(graph_exec);
+  throw_invalid_value_if(!hip_graph_exec, "graph exec is invalid");
+
+  auto hip_stream = get_stream(stream);
+  throw_invalid_handle_if(!hip_stream, "stream is invalid");
+
+  auto s_hdl = hip_stream.get();
+  auto cmd_hdl = insert_in_map(command_cache,
+                               std::make_shared<graph_launch>(hip_stream, hip_graph_exec));
+  s_hdl->enqueue(command_cache.get(cmd_hdl));
+}
+
+static void
+hip_graph_exec_destroy(hipGraphExec_t graph_exec)
+{
+  throw_invalid_value_if(!graph_exec, "graph exec is nullptr");
+  throw_invalid_value_if(!graph_exec_cache.count(graph_exec), "graph exec is invalid");
+  graph_exec_cache.remove(graph_exec);
+}
+} // xrt::core::hip
+
+// =========================================================================
+// Graph related apis implementation
+hipError_t
+hipGraphCreate(hipGraph_t* pGraph, unsigned int flags)
+{
+  try {
+    throw_invalid_value_if(!pGraph, "graph passed is nullptr");
+
+    auto handle = xrt::core::hip::hip_graph_create(flags);
+    *pGraph = reinterpret_cast<hipGraph_t>(handle);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipGraphDestroy(hipGraph_t graph)
+{
+  try {
+    xrt::core::hip::hip_graph_destroy(graph);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipGraphInstantiate(hipGraphExec_t* pGraphExec, hipGraph_t graph, hipGraphNode_t* pErrorNode,
+                    char* /*pLogBuffer*/, size_t /*bufferSize*/)
+{
+  try {
+    throw_invalid_value_if(!pGraphExec, "graph exec passed is nullptr");
+    if (pErrorNode)
+      *pErrorNode = nullptr;
+
+    auto handle = xrt::core::hip::hip_graph_instantiate(graph);
+    *pGraphExec = reinterpret_cast<hipGraphExec_t>(handle);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipGraphInstantiateWithFlags(hipGraphExec_t* pGraphExec, hipGraph_t graph, unsigned long long flags)
+{
+  try {
+    throw_invalid_value_if(!pGraphExec, "graph exec passed is nullptr");
+    throw_invalid_value_if(flags != 0, "flags should be 0");
+
+    auto handle = xrt::core::hip::hip_graph_instantiate(graph);
+    *pGraphExec = reinterpret_cast<hipGraphExec_t>(handle);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipGraphLaunch(hipGraphExec_t graphExec, hipStream_t stream)
+{
+  try {
+    xrt::core::hip::hip_graph_launch(graphExec, stream);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipGraphExecDestroy(hipGraphExec_t graphExec)
+{
+  try {
+    xrt::core::hip::hip_graph_exec_destroy(graphExec);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
@@ -141,6 +141,7 @@ namespace xrt::core::hip
   {
     // TODO src and dst can be hip memories. Handle that case too
     memcpy(dst, src, size);
+    memory_database::instance().mark_dirty(dst, size);
   }
 
   static void
@@ -154,6 +155,7 @@ namespace xrt::core::hip
 
     // src is device address. Get device address
     hip_mem_dev->read(dst, size, 0, offset);
+    memory_database::instance().mark_dirty(dst, size);
   }
 
   static void
@@ -366,7 +368,15 @@ namespace xrt::core::hip
     auto s_hdl = hip_stream.get();
     auto cmd_hdl = insert_in_map(command_cache,
       std::make_shared<memory_pool_command>(hip_stream, memory_pool_command::memory_pool_command_type::alloc, curr_mem_pool, *dev_ptr, size));
-    s_hdl->enqueue(command_cache.get(cmd_hdl));
+    try {
+      s_hdl->enqueue(command_cache.get(cmd_hdl));
+    }
+    catch (...) {
+      // e.g. stream is capturing, the allocation never happens
+      memory_database::instance().remove(h);
+      *dev_ptr = nullptr;
+      throw;
+    }
   }
 
   static void
@@ -381,9 +391,11 @@ namespace xrt::core::hip
     throw_invalid_value_if(!mem_pool, "Invalid memory pool.");
 
     // ptr to a xrt::core::hip::command object could be shared between global command_cache and stream::m_top_event::m_chain_of_commands of a stream object
+    // memory is reusable by other streams once commands enqueued prior to the free complete
     auto s_hdl = hip_stream.get();
     auto cmd_hdl = insert_in_map(command_cache,
-      std::make_shared<memory_pool_command>(hip_stream, memory_pool_command::memory_pool_command_type::free, mem_pool, dev_ptr, 0));
+      std::make_shared<memory_pool_command>(hip_stream, memory_pool_command::memory_pool_command_type::free, mem_pool, dev_ptr, 0,
+                                            hip_stream->get_pending_commands()));
     s_hdl->enqueue(command_cache.get(cmd_hdl));
   }
 
@@ -433,7 +445,15 @@ namespace xrt::core::hip
     auto s_hdl = hip_stream.get();
     auto cmd_hdl = insert_in_map(command_cache,
       std::make_shared<memory_pool_command>(hip_stream, memory_pool_command::memory_pool_command_type::alloc, pool, *dev_ptr, size));
-    s_hdl->enqueue(command_cache.get(cmd_hdl));
+    try {
+      s_hdl->enqueue(command_cache.get(cmd_hdl));
+    }
+    catch (...) {
+      // e.g. stream is capturing, the allocation never happens
+      memory_database::instance().remove(h);
+      *dev_ptr = nullptr;
+      throw;
+    }
   }
 } // xrt::core::hip
 
@@ -3,6 +3,7 @@
 
 #include "hip/core/common.h"
 #include "hip/core/event.h"
+#include "hip/core/graph.h"
 #include "hip/core/stream.h"
 
 namespace xrt::core::hip {
@@ -86,6 +87,7 @@ hip_stream_wait_event(hipStream_t stream, hipEvent_t ev, unsigned int flags)
 
   auto hip_wait_stream = get_stream(stream);
   throw_invalid_resource_if(!hip_wait_stream, "stream is invalid");
+  throw_if(hip_wait_stream->is_capturing(), hipErrorStreamCaptureUnsupported, "event wait cannot be captured");
 
   throw_invalid_handle_if(!ev, "event is nullptr");
   auto hip_event_cmd = std::dynamic_pointer_cast<event>(command_cache.get(ev));
@@ -112,6 +114,30 @@ hip_stream_wait_event(hipStream_t stream, hipEvent_t ev, unsigned int flags)
     wait_stream->record_top_event(dummy_event_hdl);
   }
 }
+
+static void
+hip_stream_begin_capture(hipStream_t stream, hipStreamCaptureMode mode)
+{
+  auto hip_stream = get_stream(stream);
+  throw_invalid_handle_if(!hip_stream, "stream is invalid");
+  hip_stream->begin_capture(mode);
+}
+
+static graph_handle
+hip_stream_end_capture(hipStream_t stream)
+{
+  auto hip_stream = get_stream(stream);
+  throw_invalid_handle_if(!hip_stream, "stream is invalid");
+  return insert_in_map(graph_cache, hip_stream->end_capture());
+}
+
+static hipStreamCaptureStatus
+hip_stream_is_capturing(hipStream_t stream)
+{
+  auto hip_stream = get_stream(stream);
+  throw_invalid_handle_if(!hip_stream, "stream is invalid");
+  return hip_stream->get_capture_status();
+}
 } // // xrt::core::hip
 
 // =========================================================================
@@ -187,3 +213,58 @@ hipStreamWaitEvent(hipStream_t stream, hipEvent_t event, unsigned int flags)
   return hipErrorUnknown;
 }
 
+hipError_t
+hipStreamBeginCapture(hipStream_t stream, hipStreamCaptureMode mode)
+{
+  try {
+    xrt::core::hip::hip_stream_begin_capture(stream, mode);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipStreamEndCapture(hipStream_t stream, hipGraph_t* pGraph)
+{
+  try {
+    throw_invalid_value_if(!pGraph, "graph passed is nullptr");
+
+    auto handle = xrt::core::hip::hip_stream_end_capture(stream);
+    *pGraph = reinterpret_cast<hipGraph_t>(handle);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
+
+hipError_t
+hipStreamIsCapturing(hipStream_t stream, hipStreamCaptureStatus* pCaptureStatus)
+{
+  try {
+    throw_invalid_value_if(!pCaptureStatus, "capture status passed is nullptr");
+
+    *pCaptureStatus = xrt::core::hip::hip_stream_is_capturing(stream);
+    return hipSuccess;
+  }
+  catch (const xrt_core::system_error& ex) {
+    xrt_core::send_exception_message(std::string(__func__) +  " - " + ex.what());
+    return static_cast<hipError_t>(ex.value());
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+  return hipErrorUnknown;
+}
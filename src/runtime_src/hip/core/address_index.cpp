@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "address_index.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace {
+
+// RAII announcement of a reader in the reader count of an epoch
+class read_guard
+{
+  std::atomic<uint32_t>& m_count;
+
+public:
+  explicit read_guard(std::atomic<uint32_t>& count)
+    : m_count(count)
+  {
+    m_count.fetch_add(1, std::memory_order_seq_cst);
+  }
+
+  ~read_guard()
+  {
+    m_count.fetch_sub(1, std::memory_order_release);
+  }
+
+  read_guard(const read_guard&) = delete;
+  read_guard(read_guard&&) = delete;
+  read_guard& operator=(const read_guard&) = delete;
+  read_guard& operator=(read_guard&&) = delete;
+};
+
+} // namespace
+
+namespace xrt::core::hip {
+
+address_index::
+address_index()
+  : m_table(new table)
+{}
+
+address_index::
+~address_index()
+{
+  delete m_table.load();
+}
+
+size_t
+address_index::
+get_stripe()
+{
+  static thread_local size_t stripe =
+    std::hash<std::thread::id>{}(std::this_thread::get_id()) % reader_stripes;
+  return stripe;
+}
+
+void
+address_index::
+publish(std::unique_ptr<table> tbl)
+{
+  // The seq_cst store of the table and loads of the reader counts
+  // pair with the seq_cst increment of a reader count and load of
+  // the table by a reader.  A reader that loaded the previous table
+  // incremented the count of either epoch before the table was
+  // published, so waiting for both epochs to drain after publishing
+  // covers all such readers.  The epoch is flipped before each wait
+  // such that new readers do not hold up the drain.
+  std::unique_ptr<const table> prev {m_table.exchange(tbl.release(), std::memory_order_seq_cst)};
+  for (int phase = 0; phase < 2; ++phase) {
+    auto epoch = m_epoch.load(std::memory_order_relaxed);
+    m_epoch.store(epoch ^ 1, std::memory_order_seq_cst);
+    for (auto& reader : m_readers)
+      while (reader.count[epoch].load(std::memory_order_seq_cst))
+        std::this_thread::yield();
+  }
+}
+
+bool
+address_index::
+insert(uint64_t addr, size_t size, std::shared_ptr<memory> mem)
+{
+  std::lock_guard lk(m_mutex);
+  auto curr = m_table.load(std::memory_order_relaxed);
+  auto itr = std::lower_bound(curr->begin(), curr->end(), addr,
+                              [](const range& r, uint64_t a) { return r.address < a; });
+
+  // Reject overlap with previous or next range
+  if (itr != curr->begin() && std::prev(itr)->address + std::prev(itr)->size > addr)
+    return false;
+  if (itr != curr->end() && itr->address < addr + size)
+    return false;
+
+  auto [owned, inserted] = m_owned.emplace(addr, std::move(mem));
+  if (!inserted)
+    return false;
+
+  auto pos = std::distance(curr->begin(), itr);
+  auto tbl = std::make_unique<table>();
+  tbl->reserve(curr->size() + 1);
+  tbl->insert(tbl->end(), curr->begin(), curr->begin() + pos);
+  tbl->push_back({addr, size, &owned->second});
+  tbl->insert(tbl->end(), curr->begin() + pos, curr->end());
+  publish(std::move(tbl));
+  return true;
+}
+
+void
+address_index::
+remove(uint64_t addr)
+{
+  std::lock_guard lk(m_mutex);
+  auto curr = m_table.load(std::memory_order_relaxed);
+  auto itr = std::upper_bound(curr->begin(), curr->end(), addr,
+                              [](uint64_t a, const range& r) { return a < r.address; });
+  if (itr == curr->begin())
+    return;
+
+  --itr;
+  if (addr - itr->address >= itr->size)
+    return;
+
+  auto base = itr->address;
+  auto tbl = std::make_unique<table>();
+  tbl->reserve(curr->size() - 1);
+  tbl->insert(tbl->end(), curr->begin(), itr);
+  tbl->insert(tbl->end(), std::next(itr), curr->end());
+  publish(std::move(tbl));
+
+  // No reader references the memory object once published
+  m_owned.erase(base);
+}
+
+void
+address_index::
+clear()
+{
+  std::lock_guard lk(m_mutex);
+  publish(std::make_unique<table>());
+  m_owned.clear();
+}
+
+std::pair<std::shared_ptr<memory>, size_t>
+address_index::
+find(uint64_t addr) const
+{
+  read_guard guard(m_readers[get_stripe()].count[m_epoch.load(std::memory_order_relaxed)]);
+  auto curr = m_table.load(std::memory_order_seq_cst);
+  auto itr = std::upper_bound(curr->begin(), curr->end(), addr,
+                              [](uint64_t a, const range& r) { return a < r.address; });
+  if (itr == curr->begin())
+    return {nullptr, 0};
+
+  --itr;
+  auto offset = addr - itr->address;
+  if (offset >= itr->size)
+    return {nullptr, 0};
+
+  return {*itr->mem, offset};
+}
+
+} // xrt::core::hip
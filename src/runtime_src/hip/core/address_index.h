@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrthip_address_index_h
+#define xrthip_address_index_h
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace xrt::core::hip {
+
+class memory;
+
+// address_index - concurrent lookup of memory containing an address
+//
+// Lookups are done for every pointer argument of kernel launches and
+// copies and take no lock.  The index is an immutable array of
+// address ranges sorted by address and published through an atomic
+// pointer.  Writers are serialized, they publish a modified copy of
+// the array and free the previous array when no reader can still be
+// referencing it.
+//
+// Readers announce themselves in one of a set of cache line aligned
+// counters selected by thread and by the current reader epoch.  After
+// publishing, a writer flips the epoch and waits for the counters of
+// the previous epoch to drain, twice, at which point any reader that
+// could have loaded the previous array has completed.  New readers
+// count against the other epoch, so a writer is not starved by a
+// continuous stream of lookups.
+class address_index
+{
+public:
+  address_index();
+  ~address_index();
+
+  address_index(const address_index&) = delete;
+  address_index(address_index&&) = delete;
+  address_index& operator=(const address_index&) = delete;
+  address_index& operator=(address_index&&) = delete;
+
+  // Insert memory for range [addr, addr+size[, returns false without
+  // inserting if the range overlaps an existing range
+  bool
+  insert(uint64_t addr, size_t size, std::shared_ptr<memory> mem);
+
+  // Remove range containing addr if any
+  void
+  remove(uint64_t addr);
+
+  // Remove all ranges
+  void
+  clear();
+
+  // Get memory containing addr and offset of addr within the memory,
+  // returns {nullptr, 0} if no memory contains addr
+  std::pair<std::shared_ptr<memory>, size_t>
+  find(uint64_t addr) const;
+
+private:
+  struct range
+  {
+    uint64_t address;
+    size_t size;
+    const std::shared_ptr<memory>* mem; // owned by m_owned
+  };
+  using table = std::vector<range>;
+
+  struct alignas(64) reader_count
+  {
+    std::atomic<uint32_t> count[2] = {0, 0}; // per epoch
+  };
+  static constexpr size_t reader_stripes = 64;
+
+  static size_t
+  get_stripe();
+
+  // Publish table and free the previous table once no reader
+  // references it.  Must be called with m_mutex locked.
+  void
+  publish(std::unique_ptr<table> tbl);
+
+  std::atomic<const table*> m_table;
+  std::atomic<unsigned int> m_epoch {0};
+  mutable std::array<reader_count, reader_stripes> m_readers;
+
+  // Serializes writers, owns the memory objects of the current table
+  std::mutex m_mutex;
+  std::map<uint64_t, std::shared_ptr<memory>> m_owned;
+};
+
+} // xrt::core::hip
+
+#endif
@@ -0,0 +1,197 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "copy_engine.h"
+#include "common.h"
+#include "memory.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Copies up to this size are batched with other small copies queued
+// on the same lane
+constexpr size_t small_copy_size = 64 * 1024;
+
+// Max number of copies in one batch
+constexpr size_t max_batch_size = 64;
+
+} // namespace
+
+namespace xrt::core::hip {
+
+copy_engine::
+copy_engine(unsigned int workers)
+{
+  for (unsigned int i = 0; i < workers; ++i)
+    m_workers.emplace_back(&copy_engine::worker, this);
+}
+
+copy_engine::
+~copy_engine()
+{
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_stop = true;
+  }
+  m_work.notify_all();
+  for (auto& t : m_workers)
+    t.join();
+}
+
+std::future<void>
+copy_engine::
+enqueue(const void* lane_key, void* dst, const void* src, size_t size, hipMemcpyKind kind)
+{
+  auto j = std::make_unique<job>(job{dst, src, size, kind, {}});
+  auto done = j->done.get_future();
+
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    auto& ln = m_lanes[lane_key];
+    ln.jobs.push_back(std::move(j));
+
+    // lane is made ready when first job is added, a busy lane
+    // is made ready again by the worker when batch completes
+    if (ln.jobs.size() > 1 || ln.busy)
+      return done;
+
+    m_ready.push_back(lane_key);
+  }
+
+  m_work.notify_one();
+  return done;
+}
+
+// Take next job of lane, followed by any small copies queued behind it
+// if the job itself is a small copy.
+std::vector<std::unique_ptr<copy_engine::job>>
+copy_engine::
+take_batch(lane& ln)
+{
+  std::vector<std::unique_ptr<job>> batch;
+  batch.push_back(std::move(ln.jobs.front()));
+  ln.jobs.pop_front();
+
+  if (batch.front()->size > small_copy_size)
+    return batch;
+
+  while (!ln.jobs.empty() && batch.size() < max_batch_size && ln.jobs.front()->size <= small_copy_size) {
+    batch.push_back(std::move(ln.jobs.front()));
+    ln.jobs.pop_front();
+  }
+
+  return batch;
+}
+
+// Execute batch of copies in order.  Consecutive host to device and
+// device to host copies of same memory object are grouped such that
+// the buffer is synced once for the range covered by the group.
+void
+copy_engine::
+execute(std::vector<std::unique_ptr<job>>& batch)
+{
+  // device side memory of host to device and device to host copies
+  std::vector<std::pair<std::shared_ptr<memory>, size_t>> dev_mems;
+  dev_mems.reserve(batch.size());
+  for (const auto& j : batch) {
+    if (j->kind == hipMemcpyHostToDevice)
+      dev_mems.push_back(memory_database::instance().get_hip_mem_from_addr(j->dst));
+    else if (j->kind == hipMemcpyDeviceToHost)
+      dev_mems.push_back(memory_database::instance().get_hip_mem_from_addr(j->src));
+    else
+      dev_mems.push_back({nullptr, 0});
+  }
+
+  size_t idx = 0;
+  while (idx < batch.size()) {
+    auto& mem = dev_mems[idx].first;
+    auto kind = batch[idx]->kind;
+    auto end = idx + 1;
+    if (mem) {
+      while (end < batch.size() && batch[end]->kind == kind && dev_mems[end].first == mem)
+        ++end;
+    }
+
+    try {
+      if (!mem) {
+        // copies not involving host/device memory object pairs, or
+        // invalid addresses which hipMemcpy reports
+        auto& j = batch[idx];
+        auto err = hipMemcpy(j->dst, j->src, j->size, j->kind);
+        throw_if(err != hipSuccess, err, "asynchronous copy failed");
+      }
+      else {
+        size_t begin = std::numeric_limits<size_t>::max();
+        size_t last = 0;
+        for (auto i = idx; i < end; ++i) {
+          auto offset = dev_mems[i].second;
+          throw_invalid_value_if(offset + batch[i]->size > mem->get_size(), "copy out of bound.");
+          begin = std::min(begin, offset);
+          last = std::max(last, offset + batch[i]->size);
+        }
+
+        if (kind == hipMemcpyHostToDevice) {
+          for (auto i = idx; i < end; ++i)
+            mem->copy_in(batch[i]->src, batch[i]->size, dev_mems[i].second);
+          if (last > begin)
+            mem->sync(XCL_BO_SYNC_BO_TO_DEVICE, last - begin, begin);
+        }
+        else {
+          if (last > begin)
+            mem->sync(XCL_BO_SYNC_BO_FROM_DEVICE, last - begin, begin);
+          for (auto i = idx; i < end; ++i) {
+            mem->copy_out(batch[i]->dst, batch[i]->size, dev_mems[i].second);
+            memory_database::instance().mark_dirty(batch[i]->dst, batch[i]->size);
+          }
+        }
+      }
+
+      for (auto i = idx; i < end; ++i)
+        batch[i]->done.set_value();
+    }
+    catch (...) {
+      for (auto i = idx; i < end; ++i)
+        batch[i]->done.set_exception(std::current_exception());
+    }
+
+    idx = end;
+  }
+}
+
+void
+copy_engine::
+worker()
+{
+  std::unique_lock<std::mutex> lk(m_mutex);
+  while (true) {
+    m_work.wait(lk, [this] { return m_stop || !m_ready.empty(); });
+    if (m_ready.empty())
+      return; // stopped and drained
+
+    auto lane_key = m_ready.front();
+    m_ready.pop_front();
+    auto& ln = m_lanes[lane_key];
+    auto batch = take_batch(ln);
+    ln.busy = true;
+
+    lk.unlock();
+    execute(batch);
+    lk.lock();
+
+    // lanes are erased when drained, a lane with more jobs is made
+    // ready again to preserve FIFO order within the lane
+    auto itr = m_lanes.find(lane_key);
+    itr->second.busy = false;
+    if (itr->second.jobs.empty()) {
+      m_lanes.erase(itr);
+      continue;
+    }
+
+    m_ready.push_back(lane_key);
+    m_work.notify_one();
+  }
+}
+
+} // xrt::core::hip
@@ -0,0 +1,80 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrthip_copy_engine_h
+#define xrthip_copy_engine_h
+
+#include "hip/config.h"
+#include "hip/hip_runtime_api.h"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xrt::core::hip {
+
+// copy_engine - per device worker pool for asynchronous copies
+//
+// Copies are queued on a lane, which is the stream the copy is
+// enqueued on.  Copies within a lane execute in FIFO order, while
+// different lanes are served concurrently by the workers.  A worker
+// takes all small copies queued on a lane as one batch; consecutive
+// host to device or device to host copies of the same memory object
+// in a batch share one buffer sync of the covering range.
+class copy_engine
+{
+  struct job
+  {
+    void* dst;
+    const void* src;
+    size_t size;
+    hipMemcpyKind kind;
+    std::promise<void> done;
+  };
+
+  struct lane
+  {
+    std::deque<std::unique_ptr<job>> jobs;
+    bool busy = false;
+  };
+
+  std::mutex m_mutex;
+  std::condition_variable m_work;
+  std::map<const void*, lane> m_lanes;
+  std::deque<const void*> m_ready;   // lanes with jobs, not busy
+  std::vector<std::thread> m_workers;
+  bool m_stop = false;
+
+  std::vector<std::unique_ptr<job>>
+  take_batch(lane& ln);
+
+  void
+  execute(std::vector<std::unique_ptr<job>>& batch);
+
+  void
+  worker();
+
+public:
+  explicit
+  copy_engine(unsigned int workers);
+
+  ~copy_engine();
+
+  copy_engine(const copy_engine&) = delete;
+  copy_engine(copy_engine&&) = delete;
+  copy_engine& operator=(const copy_engine&) = delete;
+  copy_engine& operator=(copy_engine&&) = delete;
+
+  // Queue a copy on a lane. The returned future is ready when the
+  // copy has completed and rethrows any copy error
+  std::future<void>
+  enqueue(const void* lane_key, void* dst, const void* src, size_t size, hipMemcpyKind kind);
+};
+
+} // xrt::core::hip
+
+#endif
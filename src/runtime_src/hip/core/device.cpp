@@ -2,6 +2,7 @@
 // Copyright (C) 2023-2024 Advanced Micro Devices, Inc. All rights reserved.
 
 #include "device.h"
+#include "copy_engine.h"
 
 namespace xrt::core::hip {
 // Implementation
@@ -14,4 +15,20 @@ device(uint32_t device_id)
   , m_xrt_device{device_id}
   , m_flags{0}
 {}
+
+device::
+~device() = default;
+
+copy_engine&
+device::
+get_copy_engine()
+{
+  // Number of copy workers per device
+  static constexpr unsigned int copy_workers = 2;
+
+  std::call_once(m_copy_engine_flag, [this] {
+    m_copy_engine = std::make_unique<copy_engine>(copy_workers);
+  });
+  return *m_copy_engine;
+}
 }
@@ -11,6 +11,8 @@
 #include "xrt/xrt_device.h"
 
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace xrt::core::hip {
@@ -20,6 +22,7 @@ using device_handle = uint32_t;
 
 // forward declaration
 class context;
+class copy_engine;
 
 class device
 {
@@ -28,12 +31,22 @@ class device
   unsigned int m_flags;
   std::weak_ptr<context> pri_ctx;
 
+  // created on first asynchronous copy
+  std::unique_ptr<copy_engine> m_copy_engine;
+  std::once_flag m_copy_engine_flag;
+
 public:
   device() = default;
 
   explicit
   device(uint32_t device_id);
 
+  ~device();
+
+  // Worker pool for asynchronous copies on this device
+  copy_engine&
+  get_copy_engine();
+
   [[nodiscard]]
   const xrt::device&
   get_xrt_device() const
@@ -0,0 +1,277 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "dirty_tracker.h"
+
+#include "core/common/config_reader.h"
+#include "core/common/error.h"
+#include "core/common/message.h"
+#include "core/common/unistd.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <string>
+
+#ifndef _WIN32
+# include <csignal>
+# include <sys/mman.h>
+#endif
+
+namespace {
+
+#ifndef _WIN32
+// Registry of trackers with write protected pages, searched by fault
+// handler.  Slots are claimed and released with atomic operations
+// only, such that the handler can search without locking.
+constexpr int max_protected_regions = 1024;
+std::atomic<xrt::core::hip::dirty_tracker*> protected_regions[max_protected_regions]; // NOLINT
+
+struct sigaction prev_segv_action; // NOLINT
+
+void
+segv_handler(int sig, siginfo_t* info, void* ucontext)
+{
+  auto addr = reinterpret_cast<uintptr_t>(info->si_addr);
+  for (auto& region : protected_regions) {
+    auto tracker = region.load(std::memory_order_acquire);
+    if (tracker && tracker->on_write_fault(addr))
+      return;
+  }
+
+  // Not a tracked page, forward to previous handler. If default
+  // handling, restore it and return to fault again.
+  if (prev_segv_action.sa_flags & SA_SIGINFO) {
+    prev_segv_action.sa_sigaction(sig, info, ucontext);
+    return;
+  }
+
+  if (prev_segv_action.sa_handler == SIG_DFL || prev_segv_action.sa_handler == SIG_IGN) {
+    sigaction(SIGSEGV, &prev_segv_action, nullptr);
+    return;
+  }
+
+  prev_segv_action.sa_handler(sig);
+}
+
+void
+install_segv_handler()
+{
+  static std::once_flag flag;
+  std::call_once(flag, [] {
+    struct sigaction action {};
+    action.sa_sigaction = segv_handler;
+    action.sa_flags = SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGSEGV, &action, &prev_segv_action))
+      throw xrt_core::system_error(errno, "failed to install hip host memory fault handler");
+  });
+}
+
+int
+register_region(xrt::core::hip::dirty_tracker* tracker)
+{
+  install_segv_handler();
+  for (int slot = 0; slot < max_protected_regions; ++slot) {
+    xrt::core::hip::dirty_tracker* expected = nullptr;
+    if (protected_regions[slot].compare_exchange_strong(expected, tracker, std::memory_order_acq_rel))
+      return slot;
+  }
+  return -1;
+}
+
+void
+unregister_region(int slot)
+{
+  protected_regions[slot].store(nullptr, std::memory_order_release);
+}
+#endif
+
+constexpr size_t bits_per_word = 64;
+
+} // namespace
+
+namespace xrt::core::hip {
+
+dirty_tracker::mode
+dirty_tracker::
+get_mode()
+{
+  static mode value = [] {
+    auto str = xrt_core::config::get_hip_host_mem_tracking();
+    if (str == "explicit")
+      return mode::explicit_ranges;
+    if (str == "mprotect") {
+#ifdef _WIN32
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                              "hip_host_mem_tracking=mprotect is not supported, using explicit");
+      return mode::explicit_ranges;
+#else
+      return mode::page_protect;
+#endif
+    }
+    return mode::none;
+  }();
+  return value;
+}
+
+dirty_tracker::
+dirty_tracker(void* host_addr, size_t size, mode m)
+  : m_host_addr(reinterpret_cast<uintptr_t>(host_addr))
+  , m_size(size)
+  , m_mode(m)
+{
+  if (m_mode != mode::page_protect)
+    return;
+
+  m_page_size = xrt_core::getpagesize();
+  m_page_begin = (m_host_addr + m_page_size - 1) / m_page_size * m_page_size;
+  m_page_end = (m_host_addr + m_size) / m_page_size * m_page_size;
+  if (m_page_end <= m_page_begin) {
+    // no whole pages, all of memory is always dirty
+    m_page_begin = m_page_end = 0;
+    return;
+  }
+
+  auto pages = (m_page_end - m_page_begin) / m_page_size;
+  m_dirty_pages = std::make_unique<std::atomic<uint64_t>[]>((pages + bits_per_word - 1) / bits_per_word);
+
+#ifndef _WIN32
+  m_slot = register_region(this);
+#endif
+  if (m_slot < 0) {
+    // out of slots, fall back to explicitly marked ranges
+    m_mode = mode::explicit_ranges;
+    m_page_begin = m_page_end = 0;
+  }
+}
+
+dirty_tracker::
+~dirty_tracker()
+{
+  if (m_slot < 0)
+    return;
+
+  // lift protection before the region is released
+  try {
+    protect(m_page_begin, m_page_end, true);
+  }
+  catch (const std::exception& ex) {
+    xrt_core::send_exception_message(ex.what());
+  }
+#ifndef _WIN32
+  unregister_region(m_slot);
+#endif
+}
+
+void
+dirty_tracker::
+protect(uintptr_t begin, uintptr_t end, bool writable)
+{
+#ifndef _WIN32
+  if (::mprotect(reinterpret_cast<void*>(begin), end - begin, writable ? (PROT_READ | PROT_WRITE) : PROT_READ))
+    throw xrt_core::system_error(errno, "failed to change protection of hip host memory");
+#endif
+}
+
+void
+dirty_tracker::
+mark_dirty(size_t offset, size_t size)
+{
+  if (!size)
+    return;
+
+  std::lock_guard<std::mutex> lk(m_mutex);
+  m_ranges.emplace_back(offset, size);
+}
+
+bool
+dirty_tracker::
+on_write_fault(uintptr_t addr)
+{
+  if (addr < m_page_begin || addr >= m_page_end)
+    return false;
+
+  // Lift protection before marking the page.  If the page is synced
+  // and protected again in between, the faulting write faults again.
+  // Called in signal context, must not throw.
+  auto page = (addr - m_page_begin) / m_page_size;
+#ifndef _WIN32
+  ::mprotect(reinterpret_cast<void*>(m_page_begin + page * m_page_size), m_page_size, PROT_READ | PROT_WRITE);
+#endif
+  m_dirty_pages[page / bits_per_word].fetch_or(uint64_t(1) << (page % bits_per_word));
+  return true;
+}
+
+std::vector<dirty_tracker::range>
+dirty_tracker::
+take_dirty()
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  auto pages = m_page_size ? (m_page_end - m_page_begin) / m_page_size : 0;
+  auto words = (pages + bits_per_word - 1) / bits_per_word;
+
+  // protection is lifted for all pages until first sync
+  if (m_all_dirty || (m_mode == mode::page_protect && !pages)) {
+    m_all_dirty = false;
+    m_ranges.clear();
+    if (pages) {
+      for (size_t w = 0; w < words; ++w)
+        m_dirty_pages[w].store(0);
+      protect(m_page_begin, m_page_end, false);
+    }
+    return {{0, m_size}};
+  }
+
+  auto dirty = std::move(m_ranges);
+  m_ranges.clear();
+
+  if (pages) {
+    // partial pages at either end
+    if (m_page_begin > m_host_addr)
+      dirty.emplace_back(0, m_page_begin - m_host_addr);
+    if (m_host_addr + m_size > m_page_end)
+      dirty.emplace_back(m_page_end - m_host_addr, m_host_addr + m_size - m_page_end);
+
+    // runs of modified pages are protected again before returned
+    auto add_run = [&](size_t first, size_t last) {
+      auto begin = m_page_begin + first * m_page_size;
+      auto end = m_page_begin + last * m_page_size;
+      protect(begin, end, false);
+      dirty.emplace_back(begin - m_host_addr, end - begin);
+    };
+
+    size_t run_first = 0;
+    size_t run_last = 0;
+    for (size_t w = 0; w < words; ++w) {
+      auto bits = m_dirty_pages[w].exchange(0);
+      for (size_t b = 0; bits; ++b, bits >>= 1) {
+        if (!(bits & 1))
+          continue;
+        auto page = w * bits_per_word + b;
+        if (page != run_last) {
+          if (run_last > run_first)
+            add_run(run_first, run_last);
+          run_first = page;
+        }
+        run_last = page + 1;
+      }
+    }
+    if (run_last > run_first)
+      add_run(run_first, run_last);
+  }
+
+  // sort and merge overlapping or adjacent ranges
+  std::sort(dirty.begin(), dirty.end());
+  std::vector<range> merged;
+  for (const auto& [offset, size] : dirty) {
+    if (!merged.empty() && offset <= merged.back().first + merged.back().second) {
+      auto end = std::max(merged.back().first + merged.back().second, offset + size);
+      merged.back().second = end - merged.back().first;
+      continue;
+    }
+    merged.emplace_back(offset, size);
+  }
+  return merged;
+}
+
+} // xrt::core::hip
@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrthip_dirty_tracker_h
+#define xrthip_dirty_tracker_h
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace xrt::core::hip {
+
+// dirty_tracker - track ranges of host memory modified by host
+//
+// Used for host and registered memory such that only ranges modified
+// since last sync need to be synced to device when the memory is used
+// by a kernel.  Ranges are marked explicitly by the HIP APIs that write
+// the memory.  In page_protect mode pages are write protected when
+// their content is synced, and a write fault marks the page modified
+// before the protection is lifted.  Partial pages at either end of the
+// memory cannot be protected and are always considered modified.
+class dirty_tracker
+{
+public:
+  enum class mode { none, explicit_ranges, page_protect };
+
+  // Tracking mode from Runtime.hip_host_mem_tracking
+  static mode
+  get_mode();
+
+  using range = std::pair<size_t, size_t>; // offset, size
+
+  dirty_tracker(void* host_addr, size_t size, mode m);
+  ~dirty_tracker();
+
+  dirty_tracker(const dirty_tracker&) = delete;
+  dirty_tracker(dirty_tracker&&) = delete;
+  dirty_tracker& operator=(const dirty_tracker&) = delete;
+  dirty_tracker& operator=(dirty_tracker&&) = delete;
+
+  void
+  mark_dirty(size_t offset, size_t size);
+
+  // Return and reset ranges modified since last call.  The returned
+  // ranges are sorted and disjoint.
+  std::vector<range>
+  take_dirty();
+
+  // Called from fault handler for address in the protected range,
+  // returns false if address is not tracked by this object
+  bool
+  on_write_fault(uintptr_t addr);
+
+private:
+  uintptr_t m_host_addr;
+  size_t m_size;
+  mode m_mode;
+
+  // explicitly marked ranges, initially all of memory is dirty
+  std::mutex m_mutex;
+  std::vector<range> m_ranges;
+  bool m_all_dirty = true;
+
+  // page_protect mode: [m_page_begin, m_page_end[ are the whole pages
+  // within the memory, one dirty bit per page.
+  uintptr_t m_page_begin = 0;
+  uintptr_t m_page_end = 0;
+  size_t m_page_size = 0;
+  std::unique_ptr<std::atomic<uint64_t>[]> m_dirty_pages;
+  int m_slot = -1;
+
+  void
+  protect(uintptr_t begin, uintptr_t end, bool writable);
+};
+
+} // xrt::core::hip
+
+#endif
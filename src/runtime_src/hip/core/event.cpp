@@ -2,6 +2,7 @@
 // Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
 
 #include "event.h"
+#include "copy_engine.h"
 #include "memory.h"
 
 namespace xrt::core::hip {
@@ -124,9 +125,9 @@ kernel_start::kernel_start(std::shared_ptr<stream> s, std::shared_ptr<function>
         if (!hip_mem)
           throw std::runtime_error("failed to get memory from arg at index - " + std::to_string(idx));
 
-        // NPU device is not coherent. We need to sync the buffer objects before launching kernel
+        // NPU device is not coherent, buffer is synced in submit
         if (hip_mem->get_type() != memory_type::device)
-          hip_mem->sync(xclBOSyncDirection::XCL_BO_SYNC_BO_TO_DEVICE);
+          host_mems.push_back(hip_mem);
         r.set_arg(arg->index, hip_mem->get_xrt_bo());
         break;
       }
@@ -140,11 +141,18 @@ kernel_start::kernel_start(std::shared_ptr<stream> s, std::shared_ptr<function>
   }
 }
 
+void kernel_start::sync_host_args() const
+{
+  for (const auto& hip_mem : host_mems)
+    hip_mem->sync_dirty_to_device();
+}
+
 bool kernel_start::submit()
 {
   state kernel_start_state = get_state();
   if (kernel_start_state == state::init)
   {
+    sync_host_args();
     r.start();
     set_state(state::running);
     return true;
@@ -170,28 +178,46 @@ bool kernel_start::wait()
   return false;
 }
 
+bool kernel_start::query()
+{
+  state kernel_start_state = get_state();
+  if (kernel_start_state == state::running)
+    return r.state() == ERT_CMD_STATE_COMPLETED;
+
+  return kernel_start_state == state::completed;
+}
+
 bool memcpy_command::submit()
 {
-  m_handle = std::async(std::launch::async, &hipMemcpy, m_dst, m_src, m_size, m_kind);
+  // copies are ordered per stream by the copy engine
+  auto& engine = cstream->get_device()->get_copy_engine();
+  m_handle = engine.enqueue(cstream.get(), m_dst, m_src, m_size, m_kind);
+  set_state(state::running);
   return true;
 }
 
 bool memcpy_command::wait()
 {
-  m_handle.wait();
+  // rethrows copy error, future is invalid once waited
+  if (m_handle.valid())
+    m_handle.get();
   set_state(state::completed);
   return true;
 }
 
 bool memory_pool_command::submit()
 {
+  // pool operations are synchronous and executed once
+  if (get_state() != state::init)
+    return true;
+
   switch (m_type)
   {
   case alloc:
-    m_mem_pool->malloc(m_ptr, m_size);
+    m_mem_pool->malloc(m_ptr, m_size, cstream);
     break;
   case free:
-    m_mem_pool->free(m_ptr);
+    m_mem_pool->free(m_ptr, cstream, std::move(m_fence));
     break;
   
   default:
@@ -199,6 +225,7 @@ bool memory_pool_command::submit()
     break;
   }
   
+  set_state(state::completed);
   return true;
 }
 
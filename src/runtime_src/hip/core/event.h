@@ -41,7 +41,8 @@ public:
     event,
     kernel_start,
     mem_cpy,
-    mem_pool_op
+    mem_pool_op,
+    graph_launch
   };
 
 protected:
@@ -70,6 +71,14 @@ public:
   virtual bool submit() = 0;
   virtual bool wait() = 0;
 
+  // Check if command has completed without waiting, a command that
+  // has completed is not necessarily in completed state until waited
+  virtual bool
+  query()
+  {
+    return get_state() == state::completed;
+  }
+
   [[nodiscard]]
   state
   get_state() const
@@ -111,7 +120,7 @@ public:
   bool submit() override;
   bool wait() override;
   bool synchronize();
-  bool query();
+  bool query() override;
   [[nodiscard]] bool is_recorded() const;
   std::shared_ptr<stream> get_stream();
   void add_to_chain(std::shared_ptr<command> cmd);
@@ -124,13 +133,35 @@ private:
   std::shared_ptr<function> func;
   xrt::run r;
 
+  // non device memory arguments, synced to device before every start
+  std::vector<std::shared_ptr<memory>> host_mems;
+
 public:
   kernel_start(std::shared_ptr<stream> s, std::shared_ptr<function> f, void** args);
   bool submit() override;
   bool wait() override;
+  bool query() override;
+
+  const std::shared_ptr<function>&
+  get_function() const
+  {
+    return func;
+  }
+
+  // run object with all arguments set
+  const xrt::run&
+  get_run() const
+  {
+    return r;
+  }
+
+  // NPU device is not coherent, sync the non device memory arguments
+  // before the kernel is started
+  void
+  sync_host_args() const;
 };
 
-// memcpy command for hipMemcpyAsync
+// memcpy command for hipMemcpyAsync, executed by copy engine of device
 class memcpy_command : public command
 {
 public:
@@ -145,7 +176,7 @@ protected:
   const void* m_src; 
   size_t m_size;
   hipMemcpyKind m_kind;
-  std::future<hipError_t> m_handle;
+  std::future<void> m_handle;
 };
 
 // copy command for copying data from a source only host buffer of type std::vector<uint8|uint16|uint32>
@@ -190,8 +221,11 @@ public:
     free
   };
 
-  memory_pool_command(std::shared_ptr<stream> s, memory_pool_command_type type, std::shared_ptr<memory_pool> pool, void* ptr, size_t size)
+  // fence is the commands enqueued in the stream prior to a free
+  memory_pool_command(std::shared_ptr<stream> s, memory_pool_command_type type, std::shared_ptr<memory_pool> pool, void* ptr, size_t size,
+                      std::vector<std::shared_ptr<command>> fence = {})
     : command(command::type::mem_pool_op, std::move(s)), m_type(type), m_mem_pool(std::move(pool)), m_ptr(ptr), m_size(size)
+    , m_fence(std::move(fence))
   {
   }
 
@@ -203,7 +237,7 @@ private:
   std::shared_ptr<memory_pool> m_mem_pool;
   void* m_ptr;
   size_t m_size;
-  std::future<void> m_handle;
+  std::vector<std::shared_ptr<command>> m_fence;
 };
 
 // Global map of commands
@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+#include "graph.h"
+#include "core/common/api/kernel_int.h"
+
+namespace xrt::core::hip {
+
+graph_exec::
+graph_exec(const graph& g)
+{
+  module_xclbin* segment_module = nullptr;
+  for (auto& node : g.get_nodes()) {
+    auto ks = std::dynamic_pointer_cast<kernel_start>(node);
+    if (!ks) {
+      m_segments.push_back({node, {}, {}});
+      segment_module = nullptr;
+      continue;
+    }
+
+    // runlist is per hw context, start new segment if kernel
+    // is from a different xclbin module
+    auto mod = ks->get_function()->get_module();
+    if (mod != segment_module) {
+      m_segments.push_back({nullptr, xrt::runlist{mod->get_hw_context()}, {}});
+      segment_module = mod;
+    }
+
+    // a run object can be in one runlist only, clone the captured
+    // run object which has all arguments set
+    auto& seg = m_segments.back();
+    seg.runlist.add(xrt_core::kernel_int::clone(ks->get_run()));
+    seg.kernels.push_back(std::move(ks));
+  }
+}
+
+void
+graph_exec::
+launch()
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  if (m_segments.empty())
+    return;
+
+  // runlists of prior launch must be idle before they are executed
+  // again, only the last segment can be running
+  auto& last = m_segments.back();
+  if (!last.cmd)
+    last.runlist.wait();
+
+  for (auto& seg : m_segments) {
+    if (seg.cmd) {
+      seg.cmd->submit();
+      seg.cmd->wait();
+      continue;
+    }
+
+    for (const auto& ks : seg.kernels)
+      ks->sync_host_args();
+
+    seg.runlist.execute();
+    if (&seg != &last)
+      seg.runlist.wait();
+  }
+}
+
+void
+graph_exec::
+wait()
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  if (m_segments.empty())
+    return;
+
+  if (auto& last = m_segments.back(); !last.cmd)
+    last.runlist.wait();
+}
+
+bool
+graph_launch::
+submit()
+{
+  m_exec->launch();
+  set_state(state::running);
+  return true;
+}
+
+bool
+graph_launch::
+wait()
+{
+  if (get_state() == state::running) {
+    m_exec->wait();
+    set_state(state::completed);
+  }
+  return true;
+}
+
+// Global map of graphs
+xrt_core::handle_map<graph_handle, std::shared_ptr<graph>> graph_cache;
+
+// Global map of executable graphs
+xrt_core::handle_map<graph_exec_handle, std::shared_ptr<graph_exec>> graph_exec_cache;
+
+} // xrt::core::hip
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xrthip_graph_h
+#define xrthip_graph_h
+
+#include "common.h"
+#include "event.h"
+#include "module.h"
+#include "stream.h"
+#include "xrt/experimental/xrt_kernel.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace xrt::core::hip {
+
+// graph_handle - opaque graph handle
+using graph_handle = void*;
+
+// graph_exec_handle - opaque executable graph handle
+using graph_exec_handle = void*;
+
+// graph - sequence of commands captured from a stream
+//
+// Captured commands are kept as constructed at time of capture, for
+// kernel_start commands this means the run object is created and all
+// arguments are resolved and set.
+class graph
+{
+  std::vector<std::shared_ptr<command>> m_nodes;
+  mutable std::mutex m_mutex;
+
+public:
+  void
+  add_node(std::shared_ptr<command> cmd)
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_nodes.push_back(std::move(cmd));
+  }
+
+  std::vector<std::shared_ptr<command>>
+  get_nodes() const
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    return m_nodes;
+  }
+};
+
+// graph_exec - executable graph instantiated from a graph
+//
+// Consecutive kernel nodes in same hw context are compiled into one
+// xrt::runlist, such that launching a graph of kernels is one
+// submission.  The run objects of the graph are cloned, so a graph
+// can be instantiated multiple times.  Other nodes are executed in
+// order as commands between the runlists.
+class graph_exec
+{
+  struct segment
+  {
+    std::shared_ptr<command> cmd;                // non kernel node
+    xrt::runlist runlist;                        // consecutive kernel nodes
+    std::vector<std::shared_ptr<kernel_start>> kernels;
+  };
+
+  std::vector<segment> m_segments;
+  std::mutex m_mutex;
+
+public:
+  explicit
+  graph_exec(const graph& g);
+
+  // Execute all segments but wait only for kernels of the last
+  // segment which remain running upon return.  Waits for prior
+  // launch of this graph to complete before executing.
+  void
+  launch();
+
+  // Wait for last launch to complete
+  void
+  wait();
+};
+
+// graph_launch - command for hipGraphLaunch
+class graph_launch : public command
+{
+  std::shared_ptr<graph_exec> m_exec;
+
+public:
+  graph_launch(std::shared_ptr<stream> s, std::shared_ptr<graph_exec> exec)
+    : command(command::type::graph_launch, std::move(s)), m_exec(std::move(exec))
+  {}
+
+  bool submit() override;
+  bool wait() override;
+};
+
+// Global map of graphs
+extern xrt_core::handle_map<graph_handle, std::shared_ptr<graph>> graph_cache;
+
+// Global map of executable graphs
+extern xrt_core::handle_map<graph_exec_handle, std::shared_ptr<graph_exec>> graph_exec_cache;
+
+} // xrt::core::hip
+
+#endif
@@ -37,6 +37,7 @@ namespace xrt::core::hip
     // TODO: useptr is not supported in NPU.
     auto xrt_device = m_device->get_xrt_device();
     m_bo = xrt::ext::bo(xrt_device, host_mem, m_size);
+    init_dirty_tracker();
   }
 
   memory::memory(device* dev, size_t sz, unsigned int flags)
@@ -66,6 +67,7 @@ namespace xrt::core::hip
       default:
         break;
     }
+    init_dirty_tracker();
   }
 
   void*
@@ -102,8 +104,8 @@ namespace xrt::core::hip
     // host memory
     auto src_ptr = reinterpret_cast<const unsigned char*>(src);
     src_ptr += src_offset;
-    m_bo.write(src_ptr, size, offset);
-    m_bo.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+    copy_in(src_ptr, size, offset);
+    sync(XCL_BO_SYNC_BO_TO_DEVICE, size, offset);
   }
 
   void
@@ -117,11 +119,23 @@ namespace xrt::core::hip
     auto dst_ptr = reinterpret_cast<unsigned char *>(dst);
     dst_ptr += dst_offset;
     if (m_bo) {
-      m_bo.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
-      m_bo.read(dst_ptr, size, offset);
+      sync(XCL_BO_SYNC_BO_FROM_DEVICE, size, offset);
+      copy_out(dst_ptr, size, offset);
     }
   }
 
+  void
+  memory::copy_in(const void *src, size_t size, size_t offset)
+  {
+    m_bo.write(src, size, offset);
+  }
+
+  void
+  memory::copy_out(void *dst, size_t size, size_t offset)
+  {
+    m_bo.read(dst, size, offset);
+  }
+
   void
   memory::sync(xclBOSyncDirection direction)
   {
@@ -129,12 +143,39 @@ namespace xrt::core::hip
     m_bo.sync(direction);
   }
 
+  // sync only the range of the buffer that is accessed
+  void
+  memory::sync(xclBOSyncDirection direction, size_t size, size_t offset)
+  {
+    assert(m_bo);
+    m_bo.sync(direction, size, offset);
+  }
+
   void
   memory::copy(const memory& src, size_t sz, size_t src_offset, size_t dst_offset)
   {
     m_bo.copy(src.get_xrt_bo(), sz, src_offset, dst_offset);
   }
 
+  void
+  memory::mark_dirty(size_t offset, size_t size)
+  {
+    if (m_dirty_tracker)
+      m_dirty_tracker->mark_dirty(offset, size);
+  }
+
+  void
+  memory::sync_dirty_to_device()
+  {
+    if (!m_dirty_tracker) {
+      sync(XCL_BO_SYNC_BO_TO_DEVICE);
+      return;
+    }
+
+    for (const auto& [offset, size] : m_dirty_tracker->take_dirty())
+      sync(XCL_BO_SYNC_BO_TO_DEVICE, size, offset);
+  }
+
   void
   memory::init_xrt_bo()
   {
@@ -142,6 +183,16 @@ namespace xrt::core::hip
     m_bo = xrt::ext::bo(xrt_device, m_size);
   }
 
+  void
+  memory::init_dirty_tracker()
+  {
+    auto mode = dirty_tracker::get_mode();
+    if (!m_bo || mode == dirty_tracker::mode::none)
+      return;
+
+    m_dirty_tracker = std::make_unique<dirty_tracker>(m_bo.map(), m_size, mode);
+  }
+
   ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   //we should override clang-tidy warning by adding NOLINT since m_memory_database is non-const parameter
   memory_database* memory_database::m_memory_database = nullptr; //NOLINT
@@ -155,7 +206,7 @@ namespace xrt::core::hip
   }
 
   memory_database::memory_database()
-      : m_addr_map(), m_sub_mem_cache(), m_mutex()
+      : m_addr_index(), m_sub_mem_cache(), m_mutex()
   {
     if (m_memory_database) {
       throw std::runtime_error
@@ -167,23 +218,23 @@ namespace xrt::core::hip
 
   memory_database::~memory_database()
   {
-    m_addr_map.clear();
+    m_addr_index.clear();
   }
 
   void
   memory_database::insert(uint64_t addr, size_t size, std::shared_ptr<xrt::core::hip::memory> hip_mem)
   {
-    std::lock_guard lock(m_mutex);
-    m_addr_map.insert({address_range_key(addr, size), hip_mem});
+    m_addr_index.insert(addr, size, std::move(hip_mem));
   }
 
   void
   memory_database::remove(uint64_t addr)
   {
-    std::lock_guard lock(m_mutex);
-
-    m_sub_mem_cache.erase(addr);
-    m_addr_map.erase(address_range_key(addr, 0));
+    {
+      std::lock_guard lock(m_mutex);
+      m_sub_mem_cache.erase(addr);
+    }
+    m_addr_index.remove(addr);
   }
 
   memory_handle
@@ -218,31 +269,21 @@ namespace xrt::core::hip
   std::pair<std::shared_ptr<xrt::core::hip::memory>, size_t>
   memory_database::get_hip_mem_from_addr(void *addr)
   {
-    std::lock_guard lock(m_mutex);
+    return m_addr_index.find(reinterpret_cast<uint64_t>(addr));
+  }
 
-    auto itr = m_addr_map.find(address_range_key(reinterpret_cast<uint64_t>(addr), 0));
-    if (itr == m_addr_map.end()) {
-      return std::pair(nullptr, 0);
-    }
-    else {
-      auto offset = reinterpret_cast<uint64_t>(addr) - itr->first.address;
-      return {itr->second, offset};
-    }
+  void
+  memory_database::mark_dirty(const void* addr, size_t size)
+  {
+    auto [hip_mem, offset] = get_hip_mem_from_addr(addr);
+    if (hip_mem && (hip_mem->get_type() == memory_type::host || hip_mem->get_type() == memory_type::registered))
+      hip_mem->mark_dirty(offset, size);
   }
 
   std::pair<std::shared_ptr<xrt::core::hip::memory>, size_t>
   memory_database::get_hip_mem_from_addr(const void *addr)
   {
-    std::lock_guard lock(m_mutex);
-
-    auto itr = m_addr_map.find(address_range_key(reinterpret_cast<uint64_t>(addr), 0));
-    if (itr == m_addr_map.end()) {
-      return std::pair(nullptr, 0);
-    }
-    else {
-      auto offset = reinterpret_cast<uint64_t>(addr) - itr->first.address;
-      return {itr->second, offset};
-    }
+    return m_addr_index.find(reinterpret_cast<uint64_t>(addr));
   }
 
 } // namespace xrt::core::hip
@@ -5,7 +5,9 @@
 
 #include "core/common/device.h"
 #include "core/common/unistd.h"
+#include "address_index.h"
 #include "device.h"
+#include "dirty_tracker.h"
 #include "experimental/xrt_bo.h"
 #include "experimental/xrt_ext.h"
 #include "xrt/config.h"
@@ -65,9 +67,29 @@ namespace xrt::core::hip
     void
     read(void *dst, size_t size, size_t dst_offset = 0, size_t offset = 0); 
     
+    // copy to/from host backing of buffer without sync
+    void
+    copy_in(const void *src, size_t size, size_t offset);
+
+    void
+    copy_out(void *dst, size_t size, size_t offset);
+
     void
     sync(xclBOSyncDirection);
 
+    void
+    sync(xclBOSyncDirection, size_t size, size_t offset);
+
+    // Record host write to range of host or registered memory
+    void
+    mark_dirty(size_t offset, size_t size);
+
+    // Sync host or registered memory to device before device use.
+    // Only ranges modified by host since last sync are synced if
+    // host memory tracking is enabled.
+    void
+    sync_dirty_to_device();
+
     void
     copy(const memory& src, size_t sz, size_t src_offset = 0, size_t dst_offset = 0);
 
@@ -103,9 +125,13 @@ namespace xrt::core::hip
     size_t m_size;
     memory_type m_type;
     unsigned int m_flags;
+    std::unique_ptr<dirty_tracker> m_dirty_tracker;
 
     void
     init_xrt_bo();
+
+    void
+    init_dirty_tracker();
   };
 
   // sub_memory
@@ -123,48 +149,32 @@ namespace xrt::core::hip
     init(std::shared_ptr<memory> parent, size_t size, size_t offset)
     {
       m_parent = parent;
+      m_offset = offset;
       m_bo = xrt::bo(parent->get_xrt_bo(), size, offset);
     }
 
-  private:
-    std::shared_ptr<memory> m_parent;
-  };
-
-  // address_range_key is used for look up hip memory objects via an offseted address
-  class address_range_key
-  {
-  public:
-    address_range_key() : address(0), size(0) {}
-    address_range_key(uint64_t addr, size_t sz) : address(addr), size(sz) {}
-
-    uint64_t    address;
-    size_t      size;
-  };
+    const std::shared_ptr<memory>&
+    get_parent() const
+    {
+      return m_parent;
+    }
 
-  struct address_sz_key_compare
-  {
-    bool operator() (const address_range_key& lhs, const address_range_key& rhs) const
+    size_t
+    get_offset() const
     {
-      // The keys a and b are equivalent by definition when neither a < b nor b < a is true
-      if (lhs.address == rhs.address)
-        return false;
-      
-      // Example to explain why "-1" is mandatory in below calculation
-      // if address is 0x4000 and size is 0x100 . If another address is 0x4100
-      // a < b retruns false because 0x4000+0x100 < 0x4100
-      // b < a returns false because 0x4100+0x100 < 0x4000
-      // if we add "-1" then a<b returns true.
-      return (lhs.address + lhs.size < 1) || (lhs.address + lhs.size - 1  < rhs.address);
+      return m_offset;
     }
+
+  private:
+    std::shared_ptr<memory> m_parent;
+    size_t m_offset = 0;
   };
-  
+
   ////////////////////////////////////////////////////////////////////////////////////////////////
-  using addr_map = std::map<address_range_key, std::shared_ptr<memory>, address_sz_key_compare>;
-  
   class memory_database
   {
   private:
-    addr_map m_addr_map; // address lookup for regular xrt::bo
+    address_index m_addr_index; // address lookup for regular xrt::bo
     std::map<memory_handle, std::shared_ptr<sub_memory>> m_sub_mem_cache; // sub_memory lookup via handle
     std::mutex m_mutex;
 
@@ -196,6 +206,10 @@ namespace xrt::core::hip
   
     std::pair<std::shared_ptr<xrt::core::hip::memory>, size_t>
     get_hip_mem_from_addr(const void* addr);
+
+    // Record host write to addr if it is within host or registered memory
+    void
+    mark_dirty(const void* addr, size_t size);
   };
 
   // helper function to get page aligned size;
@@ -6,8 +6,11 @@
 #include "hip/hip_runtime_api.h"
 
 #include "common.h"
+#include "event.h"
 #include "memory_pool.h"
 
+#include <algorithm>
+
 namespace xrt::core::hip
 {
   // Global map of memory_pool associated with device id.
@@ -17,87 +20,25 @@ namespace xrt::core::hip
   // Global map of memory_pool associated with its handle.
   xrt_core::handle_map<mem_pool_handle, std::shared_ptr<memory_pool>> mem_pool_cache;
 
-  static void
-  dlinkedlist_delete(std::shared_ptr<memory_pool_slot>& head, std::shared_ptr<memory_pool_slot>& node)
-  {
-    if (node->m_prev == nullptr) {
-      head = node->m_next;
-      if (node->m_next != nullptr)
-        node->m_next->m_prev = nullptr;
-    } 
-    else {
-      node->m_prev->m_next = node->m_next;
-      if (node->m_next!= nullptr)
-        node->m_next->m_prev = node->m_prev;
-    }
-  }
-
-  static void
-  dlinkedlist_insert(std::shared_ptr<memory_pool_slot>& head, std::shared_ptr<memory_pool_slot>& node)
-  {    
-    node->m_prev = nullptr;
-    node->m_next = head;
-    if (head != nullptr)
-      head->m_prev = node;
-    head = node;
-  }
-
-  memory_pool_slot::memory_pool_slot(size_t start, size_t size)
-      : m_start(start), m_size(size), m_prev(nullptr), m_next(nullptr), m_is_free(true)
+  // power of two size class of size, size must be non zero
+  static size_t
+  size_class(size_t size)
   {
+    size_t cls = 0;
+    while (size >>= 1)
+      ++cls;
+    return cls;
   }
 
   memory_pool_node::memory_pool_node(device* device, size_t size, int id)
-      : m_id(id), m_used(0), m_free_list(nullptr), m_alloc_list(nullptr)
+      : m_id(id), m_used(0)
   {
     m_memory = std::make_shared<memory>(device, size);
-    m_free_list = std::make_shared<memory_pool_slot>(0, size);
-  }
-
-  // merge adjacent free slots as one slot
-  void
-  memory_pool_node::merge_free_slots(std::shared_ptr<memory_pool_slot> new_free_slot)
-  {
-    std::shared_ptr<memory_pool_slot> p0 = new_free_slot;
-    std::shared_ptr<memory_pool_slot> p1 = new_free_slot;
-
-    while (p0 && p0->is_free()) {
-      p1 = p0;
-      if (p0->start() == 0)
-        break;
-      p0 = p0->prev();
-    }
-
-    p0 = p1->next();
-    while (p0 && p0->start() < m_memory->get_size() && p0->is_free()) {
-      dlinkedlist_delete(m_free_list, p0);
-      p1->set_size(p1->get_size() + p0->get_size());
-      p0 = p0->next();
-    }
-  }
-
-  size_t
-  memory_pool_node::free(size_t start)
-  {
-    size_t size_freed = 0;
-    auto used_slot = m_alloc_list;
-    while (used_slot) {
-      if (used_slot->m_start == start ) {
-        size_freed = used_slot->get_size();
-        m_used -= size_freed;
-        dlinkedlist_delete(m_alloc_list, used_slot);
-        dlinkedlist_insert(m_free_list, used_slot);
-        used_slot->m_is_free = true;
-        merge_free_slots(used_slot);
-        break;
-      }
-      used_slot = used_slot->m_next;
-    }
-    return size_freed;
+    m_slots.emplace(0, memory_pool_slot{size});
   }
 
   memory_pool::memory_pool(device* device, size_t max_total_size, size_t pool_size)
-      : m_device(device), m_last_id(0), m_auto_extend(true), m_max_total_size(max_total_size), m_pool_size(pool_size), m_list(), m_mutex(),
+      : m_device(device), m_last_id(0), m_auto_extend(true), m_max_total_size(max_total_size), m_pool_size(pool_size), m_nodes(), m_mutex(),
         m_reuse_follow_event_dependencies(1), m_reuse_allow_opportunistic(1), m_reuse_allow_internal_dependencies(1),
         m_release_threshold(0), m_reserved_mem_current(0), m_reserved_mem_high(0), m_used_mem_current(0), m_used_mem_high(0)
   {
@@ -109,20 +50,19 @@ namespace xrt::core::hip
   {
     std::lock_guard lock(m_mutex);
 
-    m_reserved_mem_current = m_pool_size;
-
     if (m_pool_size > m_max_total_size)
       throw std::runtime_error("mem poolsize is too big.");
     else if (m_pool_size == m_max_total_size)
       m_auto_extend = false;
 
-    m_list.emplace(m_list.end(), std::make_shared<memory_pool_node>(m_device, m_pool_size, m_last_id++));
+    if (m_nodes.empty())
+      add_memory_pool_node(m_pool_size);
   }
 
   void
   memory_pool::get_attribute(hipMemPoolAttr attr, void* value)
   {
-    if (m_list.size() == 0)
+    if (m_nodes.empty())
       init();
 
     switch (attr)
@@ -164,7 +104,7 @@ namespace xrt::core::hip
   void
   memory_pool::set_attribute(hipMemPoolAttr attr, void* value)
   {
-    if (m_list.size() == 0) {
+    if (m_nodes.empty()) {
       init();
     }
 
@@ -204,155 +144,271 @@ namespace xrt::core::hip
     };
   }
 
-  bool
-  memory_pool::extend_memory_list(size_t size)
+  void
+  memory_pool::add_memory_pool_node(size_t size)
   {
-    m_list.insert(m_list.begin(), std::make_shared<memory_pool_node>(m_device, size, m_last_id++));
-    return true;
+    auto id = m_last_id++;
+    m_nodes.emplace(id, std::make_shared<memory_pool_node>(m_device, size, id));
+    insert_free_slot({size, id, 0});
+
+    m_reserved_mem_current += size;
+    m_reserved_mem_high = std::max(m_reserved_mem_high, m_reserved_mem_current);
   }
 
   // add one block to the memory pool
   bool
   memory_pool::extend_memory_pool(size_t aligned_size)
   {
-    if (m_pool_size + aligned_size > m_max_total_size)
+    if (!m_auto_extend || m_reserved_mem_current >= m_max_total_size)
       return false;
 
-    size_t add_mem_sz = m_max_total_size - m_pool_size;
-    add_mem_sz = add_mem_sz >= m_pool_size ? m_pool_size : add_mem_sz;
-
-    // add additional block
-    if (!extend_memory_list(add_mem_sz))
+    size_t add_mem_sz = std::min(m_pool_size, m_max_total_size - m_reserved_mem_current);
+    if (add_mem_sz < aligned_size)
       return false;
 
-    m_reserved_mem_current += add_mem_sz;
-    m_reserved_mem_high = m_reserved_mem_current;
+    add_memory_pool_node(add_mem_sz);
     return true;
   }
 
+  const memory_pool::slot_key*
+  memory_pool::find_free_slot(size_t size) const
+  {
+    // best fit in size class of size, else smallest slot of next
+    // non empty size class
+    auto cls = size_class(size);
+    auto& bin = m_free_bins[cls];
+    auto itr = bin.lower_bound({size, 0, 0});
+    if (itr != bin.end())
+      return &(*itr);
+
+    for (++cls; cls < size_classes; ++cls)
+      if (m_free_bin_mask & (static_cast<uint64_t>(1) << cls))
+        return &(*m_free_bins[cls].begin());
+
+    return nullptr;
+  }
+
+  void
+  memory_pool::insert_free_slot(const slot_key& key)
+  {
+    auto cls = size_class(key.size);
+    m_free_bins[cls].insert(key);
+    m_free_bin_mask |= (static_cast<uint64_t>(1) << cls);
+  }
+
+  void
+  memory_pool::remove_free_slot(const slot_key& key)
+  {
+    auto cls = size_class(key.size);
+    auto& bin = m_free_bins[cls];
+    bin.erase(key);
+    if (bin.empty())
+      m_free_bin_mask &= ~(static_cast<uint64_t>(1) << cls);
+  }
+
+  // merge slot with adjacent free slots as one free slot
+  void
+  memory_pool::release_slot(memory_pool_node* node, std::map<size_t, memory_pool_slot>::iterator itr)
+  {
+    auto& slots = node->m_slots;
+    itr->second.st = memory_pool_slot::state::free;
+    itr->second.owner.reset();
+    itr->second.fence.clear();
+
+    if (itr != slots.begin()) {
+      auto prev = std::prev(itr);
+      if (prev->second.st == memory_pool_slot::state::free) {
+        remove_free_slot({prev->second.size, node->m_id, prev->first});
+        prev->second.size += itr->second.size;
+        slots.erase(itr);
+        itr = prev;
+      }
+    }
+
+    auto next = std::next(itr);
+    if (next != slots.end() && next->second.st == memory_pool_slot::state::free) {
+      remove_free_slot({next->second.size, node->m_id, next->first});
+      itr->second.size += next->second.size;
+      slots.erase(next);
+    }
+
+    insert_free_slot({itr->second.size, node->m_id, itr->first});
+  }
+
+  // caller has removed the slot from the free or pending index
+  void
+  memory_pool::take_slot(memory_pool_node* node, size_t offset, size_t size)
+  {
+    auto itr = node->m_slots.find(offset);
+    auto& slot = itr->second;
+    node->m_used += size;
+
+    if (slot.size > size) {
+      // if the slot is larger than required size, divide it in two.
+      // The remainder of a free slot is released for future use, the
+      // remainder of a pending slot stays pending on the same fence
+      auto rest = node->m_slots.emplace_hint(std::next(itr), offset + size,
+        memory_pool_slot{slot.size - size, slot.st, slot.seq, slot.owner, slot.fence});
+      slot.size = size;
+
+      auto& rslot = rest->second;
+      if (rslot.st == memory_pool_slot::state::pending) {
+        slot_key key {rslot.size, node->m_id, rest->first};
+        auto& pending = m_pending[rslot.owner.get()];
+        pending.order.emplace(rslot.seq, key);
+        pending.by_size.insert(key);
+      }
+      else {
+        release_slot(node, rest);
+      }
+    }
+
+    slot.st = memory_pool_slot::state::used;
+    slot.owner.reset();
+    slot.fence.clear();
+  }
+
+  bool
+  memory_pool::is_fence_complete(memory_pool_slot& slot, bool synchronized, bool opportunistic)
+  {
+    // drop completed commands such that they are checked only once
+    auto& fence = slot.fence;
+    fence.erase(std::remove_if(fence.begin(), fence.end(),
+                               [synchronized, opportunistic](const auto& cmd) {
+                                 return (synchronized && cmd->get_state() == command::state::completed)
+                                   || (opportunistic && cmd->query());
+                               }),
+                fence.end());
+    return fence.empty();
+  }
+
+  void
+  memory_pool::release_pending(bool synchronized, bool opportunistic)
+  {
+    // frees of a stream are released in order of free, the fence of
+    // a later free includes the commands of earlier fences
+    for (auto pitr = m_pending.begin(); pitr != m_pending.end();) {
+      auto& pending = pitr->second;
+      while (!pending.order.empty()) {
+        auto key = pending.order.begin()->second;
+        auto node = m_nodes.at(key.node).get();
+        auto itr = node->m_slots.find(key.offset);
+        if (!is_fence_complete(itr->second, synchronized, opportunistic))
+          break;
+
+        pending.order.erase(pending.order.begin());
+        pending.by_size.erase(key);
+        release_slot(node, itr);
+      }
+
+      if (pending.order.empty())
+        pitr = m_pending.erase(pitr);
+      else
+        ++pitr;
+    }
+  }
+
   // create allocation from a free slot in the memory pool
   void
-  memory_pool::malloc(void* ptr, size_t size)
+  memory_pool::malloc(void* ptr, size_t size, const std::shared_ptr<stream>& s)
   {
-    if (m_list.size() == 0)
+    if (m_nodes.empty())
       init();
 
     assert(ptr);
     auto sub_mem = memory_database::instance().get_sub_mem_from_handle(reinterpret_cast<memory_handle>(ptr));
-    if (!sub_mem) {
+    if (!sub_mem)
       throw std::runtime_error("Invlid sub_memory handle");
-      return;
-    }
 
     // every allocation from pool has page size alignment
     size_t aligned_size = get_page_aligned_size(size);
 
-    std::lock_guard lock(m_mutex);
+    std::unique_lock lock(m_mutex);
 
     if (aligned_size > m_pool_size)
       throw std::runtime_error("requested size is greater than memory pool block size.");
 
-    std::shared_ptr<memory_pool_node> mm;
-
-    uint32_t num_tries = 0;
-    // find first free slot that fits, if none is found, enlarge the pool and try one more time
-    while (num_tries <= 2) {
-      ++ num_tries;
-      auto mp_itr = m_list.begin();
-      while (mp_itr != m_list.end()){
-        mm = *mp_itr;
-        // skip blocks with too liitle memory left to fit the required aligned_size
-        if (m_pool_size - mm->m_used < aligned_size) {
-          mp_itr++;
-          continue;
-        }
+    release_pending(m_reuse_follow_event_dependencies != 0, m_reuse_allow_opportunistic != 0);
+
+    bool waited = false;
+    while (true) {
+      // best fit of free slots and slots pending on a free in this
+      // stream, the latter are reusable in stream order
+      auto free_key = find_free_slot(aligned_size);
+      const slot_key* pending_key = nullptr;
+      auto pitr = m_pending.find(s.get());
+      if (pitr != m_pending.end()) {
+        auto itr = pitr->second.by_size.lower_bound({aligned_size, 0, 0});
+        if (itr != pitr->second.by_size.end())
+          pending_key = &(*itr);
+      }
 
-        auto free_slot = mm->m_free_list;
-        auto alloc_slot = free_slot;
-
-        // find the free slot large enough from the free list (m_free_list), mark it as "not free"
-        // and move it to m_alloc_list
-        while (free_slot != nullptr) {
-          if (free_slot->m_size >= aligned_size) {
-            // found a slot that is large enough
-            if (free_slot->m_size > aligned_size) {
-              // if the slot found is large than require aligned_size, divide it into two slots:
-              // use the first one (alloc_slot) for the current requested allocation
-              // save the other one (free_slot) for future use
-              alloc_slot = free_slot;
-              free_slot = std::make_shared<memory_pool_slot>(alloc_slot->start() + aligned_size, alloc_slot->m_size - aligned_size);
-
-              // update m_free_list,remove alloc_slot from double linked m_free_list
-              if (free_slot->m_prev == nullptr) {
-                mm->m_free_list = free_slot;
-              }
-              else {
-                free_slot->m_prev->m_next = free_slot;
-              }
-              if (free_slot->m_next) {
-                free_slot->m_next->m_prev = free_slot;
-              }
-
-              alloc_slot->m_is_free = false;
-              alloc_slot->m_size = aligned_size;
-            }
-            else {
-              // if the free slot found has exactly the same size as required aligned_size
-              // there is no need to divide the slot, just remove the slot from m_free_list
-              alloc_slot = free_slot;
-              dlinkedlist_delete(mm->m_free_list, alloc_slot);
-              alloc_slot->m_is_free = false;
-            }
-
-            // move the newly found slot to m_alloc_list
-            dlinkedlist_insert(mm->m_alloc_list, alloc_slot);
-
-            // keep track of the total allocated size
-            mm->m_used += alloc_slot->m_size;
-            m_used_mem_current += alloc_slot->m_size;
-            m_used_mem_high = m_used_mem_current;
-
-            // init the sub_mem with bo/offset fro the newly found slot
-            sub_mem->init(mm->m_memory, size, alloc_slot->m_start);
-            memory_database::instance().insert(reinterpret_cast<uint64_t>(ptr),
-                                                            sub_mem->get_size(), sub_mem);
-            return;
+      slot_key key {};
+      if (pending_key && (!free_key || pending_key->size < free_key->size)) {
+        key = *pending_key;
+        auto node = m_nodes.at(key.node).get();
+        pitr->second.order.erase(node->m_slots.at(key.offset).seq);
+        pitr->second.by_size.erase(key);
+        if (pitr->second.order.empty())
+          m_pending.erase(pitr);
+      }
+      else if (free_key) {
+        key = *free_key;
+        remove_free_slot(key);
+      }
+      else if (extend_memory_pool(aligned_size)) {
+        continue;
+      }
+      else if (!waited && m_reuse_allow_internal_dependencies && !m_pending.empty()) {
+        // wait for all pending frees outside the lock, waiting may
+        // submit commands that use the pool
+        std::vector<std::shared_ptr<command>> fences;
+        for (auto& [sptr, pending] : m_pending)
+          for (auto& [seq, pkey] : pending.order) {
+            auto& fence = m_nodes.at(pkey.node)->m_slots.at(pkey.offset).fence;
+            fences.insert(fences.end(), fence.begin(), fence.end());
           }
-          free_slot = free_slot->m_next;
-        }
 
-        mp_itr++;
-        mm = *mp_itr;
+        lock.unlock();
+        for (auto& cmd : fences)
+          cmd->wait();
+        lock.lock();
+
+        release_pending(true, false);
+        waited = true;
+        continue;
       }
-      
-      // we have already tried enlarging the pool and still no free slot is found
-      if (num_tries == 2)
-        break;
-      
-      if (m_auto_extend) {
-        // no free slot has been found, add one additional block to the pool and try one more time
-        if (extend_memory_pool(aligned_size) == false) {
-          // enlarging pool failed
-          break;
-        }
+      else {
+        throw xrt_core::system_error(hipErrorOutOfMemory, "Memory pool allocation failed.");
       }
-    };
 
-    // allocation failed
-    return;
+      auto node = m_nodes.at(key.node);
+      take_slot(node.get(), key.offset, aligned_size);
+
+      // keep track of the total allocated size
+      m_used_mem_current += aligned_size;
+      m_used_mem_high = std::max(m_used_mem_high, m_used_mem_current);
+
+      // init the sub_mem with bo/offset fro the newly found slot
+      sub_mem->init(node->m_memory, size, key.offset);
+      memory_database::instance().insert(reinterpret_cast<uint64_t>(ptr), sub_mem->get_size(), sub_mem);
+      return;
+    }
   }
 
   // lookup the memory pool node from address (ptr)
   std::shared_ptr<memory_pool_node>
   memory_pool::find_memory_pool_node(void* ptr, uint64_t &start)
   {
-    auto mem_info = memory_database::instance().get_hip_mem_from_addr(ptr);
-    auto hip_mem = mem_info.first;
-    size_t offset = mem_info.second;
+    auto hip_mem = memory_database::instance().get_hip_mem_from_addr(ptr).first;
+    if (!hip_mem || hip_mem->get_type() != memory_type::sub)
+      return nullptr;
+
+    auto sub_mem = std::static_pointer_cast<sub_memory>(hip_mem);
 
-    for (auto & node : m_list) {
-      if (hip_mem == node->m_memory) {
-        start = offset;
+    for (auto& [id, node] : m_nodes) {
+      if (sub_mem->get_parent() == node->m_memory) {
+        start = sub_mem->get_offset();
         return node;
       }
     }
@@ -362,20 +418,37 @@ namespace xrt::core::hip
 
   // free a previous allocation
   void
-  memory_pool::free(void* ptr)
+  memory_pool::free(void* ptr, const std::shared_ptr<stream>& s, std::vector<std::shared_ptr<command>> fence)
   {
-    if (!ptr || m_list.size() == 0)
+    if (!ptr || m_nodes.empty())
       return;
 
     std::lock_guard lock(m_mutex);
 
     uint64_t start = 0;
-    auto mm = find_memory_pool_node(reinterpret_cast<void*>(ptr), start);
-    if (mm != nullptr)
-    {
-      // return the slot to free_list and merge it with ajacent free slot
-      auto size_freed = mm->free(start);
-      m_used_mem_current -= size_freed;
+    auto mm = find_memory_pool_node(ptr, start);
+    if (mm) {
+      auto itr = mm->m_slots.find(start);
+      if (itr != mm->m_slots.end() && itr->second.st == memory_pool_slot::state::used) {
+        auto& slot = itr->second;
+        mm->m_used -= slot.size;
+        m_used_mem_current -= slot.size;
+
+        // slot is pending until commands preceding the free complete
+        slot.fence = std::move(fence);
+        if (is_fence_complete(slot, true, false)) {
+          release_slot(mm.get(), itr);
+        }
+        else {
+          slot.st = memory_pool_slot::state::pending;
+          slot.owner = s;
+          slot.seq = m_free_seq++;
+          slot_key key {slot.size, mm->m_id, start};
+          auto& pending = m_pending[s.get()];
+          pending.order.emplace(slot.seq, key);
+          pending.by_size.insert(key);
+        }
+      }
     }
 
     memory_database::instance().remove(reinterpret_cast<uint64_t>(ptr));
@@ -391,29 +464,30 @@ namespace xrt::core::hip
 
     std::lock_guard lock(m_mutex);
 
-    bool node_deleted = false;
-    do {
-      node_deleted = false;
-      auto itr = m_list.begin();
-      while (itr != m_list.end()) {
-        // delete pool block if it is free
-        auto node = *itr;
-        if (node->m_alloc_list == nullptr) {
-          m_reserved_mem_current -= node->get_size();
-          m_list.remove(node);
-          node_deleted = true;
-          break;
-        }
-        ++ itr;
-      };
-    } while (node_deleted && m_reserved_mem_current >= min_bytes_to_hold);
+    auto itr = m_nodes.begin();
+    while (itr != m_nodes.end() && m_reserved_mem_current >= min_bytes_to_hold) {
+      // delete pool block if it is free
+      auto& node = itr->second;
+      if (node->is_unused()) {
+        remove_free_slot({node->get_size(), node->m_id, 0});
+        m_reserved_mem_current -= node->get_size();
+        itr = m_nodes.erase(itr);
+        continue;
+      }
+      ++itr;
+    }
   }
 
+  // release pending frees whose streams have been synchronized, then
   // trim memory pool by releasing unused blocks back to system until
   // either total size < m_release_threshold (set by user) or there is no more blocks to free
   void
   memory_pool::purge()
   {
+    {
+      std::lock_guard lock(m_mutex);
+      release_pending(true, false);
+    }
     trim_to(m_release_threshold);
   }
 
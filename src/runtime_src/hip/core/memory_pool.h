@@ -3,10 +3,14 @@
 #ifndef xrthip_memory_POOL_h
 #define xrthip_memory_POOL_h
 
+#include <array>
 #include <cstdint>
 #include <list>
 #include <map>
 #include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
 
 #include "core/common/device.h"
 #include "experimental/xrt_bo.h"
@@ -27,49 +31,24 @@ namespace xrt::core::hip
   // opaque memory pool handle
   using mem_pool_handle = void*;
 
-  class memory_pool_slot
-  {
-  public:
-    memory_pool_slot(size_t start, size_t size);
-
-    size_t start() { return m_start; }
-    size_t end() { return m_start + m_size; }
-    
-    bool
-    is_free()
-    {
-      return m_is_free;
-    }
-
-    std::shared_ptr<memory_pool_slot>
-    prev()
-    {
-      return m_prev;
-    }
-
-    std::shared_ptr<memory_pool_slot>
-    next()
-    {
-      return m_next;
-    }
+  class command;
+  class stream;
 
-    size_t
-    get_size() const
-    {
-      return m_size;
-    }
-
-    void
-    set_size(size_t size)
-    {
-      m_size = size;
-    }
+  // memory_pool_slot - range of a memory pool block
+  //
+  // A freed slot is pending until the commands that preceded the free
+  // in the freeing stream (the fence) have completed.  A pending slot
+  // can be reused by the freeing stream right away, by other streams
+  // only per the reuse policy of the pool.
+  struct memory_pool_slot
+  {
+    enum class state : uint8_t { free, pending, used };
 
-    size_t m_start;
-    size_t m_size;
-    std::shared_ptr<memory_pool_slot> m_prev;
-    std::shared_ptr<memory_pool_slot> m_next;
-    bool m_is_free;
+    size_t size;
+    state st = state::free;
+    uint64_t seq = 0;                             // pending, order of free
+    std::shared_ptr<stream> owner;                // pending, stream that freed the slot
+    std::vector<std::shared_ptr<command>> fence;  // pending, commands preceding the free
   };
 
   class memory_pool_node
@@ -83,19 +62,34 @@ namespace xrt::core::hip
       return m_memory->get_size();
     }
 
-    size_t
-    free(size_t start);
-
-    void
-    merge_free_slots(std::shared_ptr<memory_pool_slot> new_free_slot);
+    // node has no allocated or pending slots
+    bool
+    is_unused() const
+    {
+      return m_slots.size() == 1 && m_slots.begin()->second.st == memory_pool_slot::state::free;
+    }
 
     int m_id;
-    size_t m_used;    
+    size_t m_used;
     std::shared_ptr<memory> m_memory;
-    std::shared_ptr<memory_pool_slot> m_free_list;
-    std::shared_ptr<memory_pool_slot> m_alloc_list;
+    std::map<size_t, memory_pool_slot> m_slots; // slots by offset, tiling the block
   };
 
+  // memory_pool - stream ordered sub allocation of device memory blocks
+  //
+  // Free slots are binned in power of two size classes, each bin
+  // ordered by size, such that a best fit slot is found in O(log n).
+  // Adjacent free slots are coalesced when a slot becomes free.
+  //
+  // Freed slots stay pending per freeing stream until their fence is
+  // known complete.  Reuse by other streams follows the pool attributes:
+  //  - hipMemPoolReuseFollowEventDependencies: fence commands that are
+  //    synchronized, e.g. through an event the allocating stream waits
+  //    on, release the slot.
+  //  - hipMemPoolReuseAllowOpportunistic: fence commands observed
+  //    complete without synchronization release the slot.
+  //  - hipMemPoolReuseAllowInternalDependencies: when an allocation
+  //    cannot otherwise be satisfied, wait for pending fences.
   class memory_pool
   {
   public:
@@ -112,11 +106,14 @@ namespace xrt::core::hip
     void
     trim_to(size_t min_bytes_to_hold);
 
+    // Allocate size bytes for sub memory handle ptr in stream order of s
     void
-    malloc(void* ptr, size_t size);
-    
+    malloc(void* ptr, size_t size, const std::shared_ptr<stream>& s);
+
+    // Free allocation ptr in stream order of s. The fence is the
+    // commands enqueued in s prior to the free.
     void
-    free(void* ptr);
+    free(void* ptr, const std::shared_ptr<stream>& s, std::vector<std::shared_ptr<command>> fence);
 
     void
     get_attribute(hipMemPoolAttr attr, void* value);
@@ -131,9 +128,32 @@ namespace xrt::core::hip
     }
 
   protected:
-    
-    bool
-    extend_memory_list(size_t size);
+    // free slot index key, ordered by size for best fit
+    struct slot_key
+    {
+      size_t size;
+      int node;
+      size_t offset;
+
+      bool
+      operator<(const slot_key& rhs) const
+      {
+        return std::tie(size, node, offset) < std::tie(rhs.size, rhs.node, rhs.offset);
+      }
+    };
+
+    // slots freed by a stream and not yet released to the pool
+    struct pending_frees
+    {
+      std::map<uint64_t, slot_key> order; // by order of free
+      std::set<slot_key> by_size;         // for best fit reuse by same stream
+    };
+
+    static constexpr size_t size_classes = 64;
+
+    // add one block of size bytes to the memory pool
+    void
+    add_memory_pool_node(size_t size);
 
     // add one block to the memory pool
     bool
@@ -142,12 +162,45 @@ namespace xrt::core::hip
     std::shared_ptr<memory_pool_node>
     find_memory_pool_node(void* ptr, uint64_t &start);
 
+    // best fit free slot of at least size bytes
+    const slot_key*
+    find_free_slot(size_t size) const;
+
+    void
+    insert_free_slot(const slot_key& key);
+
+    void
+    remove_free_slot(const slot_key& key);
+
+    // mark slot free and coalesce with adjacent free slots
+    void
+    release_slot(memory_pool_node* node, std::map<size_t, memory_pool_slot>::iterator itr);
+
+    // allocate size bytes from start of free or pending slot
+    void
+    take_slot(memory_pool_node* node, size_t offset, size_t size);
+
+    // check if fence of pending slot is complete, commands completed
+    // through synchronization are accepted if synchronized is true,
+    // commands completed but not yet synchronized are accepted if
+    // opportunistic is true
+    static bool
+    is_fence_complete(memory_pool_slot& slot, bool synchronized, bool opportunistic);
+
+    // release pending slots of all streams with complete fences
+    void
+    release_pending(bool synchronized, bool opportunistic);
+
     device* m_device;
     int m_last_id;
     bool m_auto_extend;
     size_t m_max_total_size;
     size_t m_pool_size;
-    std::list<std::shared_ptr<memory_pool_node>> m_list;
+    std::map<int, std::shared_ptr<memory_pool_node>> m_nodes;
+    std::array<std::set<slot_key>, size_classes> m_free_bins;
+    uint64_t m_free_bin_mask = 0; // non empty bins
+    std::map<const stream*, pending_frees> m_pending;
+    uint64_t m_free_seq = 0;
     std::mutex m_mutex;
 
     int m_reuse_follow_event_dependencies;
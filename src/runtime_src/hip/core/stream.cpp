@@ -6,6 +6,7 @@
 
 #include "common.h"
 #include "event.h"
+#include "graph.h"
 #include "stream.h"
 
 namespace xrt::core::hip {
@@ -29,6 +30,35 @@ void
 stream::
 enqueue(std::shared_ptr<command> cmd)
 {
+  {
+    std::lock_guard<std::mutex> lock(m_cmd_lock);
+    if (m_capture_status == hipStreamCaptureStatusInvalidated)
+      throw xrt_core::system_error(hipErrorStreamCaptureInvalidated, "stream capture is invalidated");
+
+    if (m_capture_status == hipStreamCaptureStatusActive) {
+      // events cannot be replayed, capture of event dependencies is
+      // not supported
+      if (cmd->get_type() == command::type::event) {
+        m_capture_status = hipStreamCaptureStatusInvalidated;
+        throw xrt_core::system_error(hipErrorStreamCaptureUnsupported, "event operations cannot be captured");
+      }
+
+      // memory pool operations run when submitted, they cannot be
+      // replayed by a graph either
+      if (cmd->get_type() == command::type::mem_pool_op) {
+        m_capture_status = hipStreamCaptureStatusInvalidated;
+        command_cache.remove(cmd.get());
+        throw xrt_core::system_error(hipErrorStreamCaptureUnsupported, "memory pool operations cannot be captured");
+      }
+
+      // captured command is owned by graph, it is never synchronized
+      // so remove it from command cache
+      m_capture_graph->add_node(cmd);
+      command_cache.remove(cmd.get());
+      return;
+    }
+  }
+
   // if there is top event add command chain list of this event
   // else submit the command
   if (m_top_event)
@@ -66,6 +96,18 @@ erase_cmd(std::shared_ptr<command> cmd)
   return false;
 }
 
+std::vector<std::shared_ptr<command>>
+stream::
+get_pending_commands()
+{
+  std::vector<std::shared_ptr<command>> cmds;
+  std::lock_guard<std::mutex> lock(m_cmd_lock);
+  for (const auto& cmd : m_cmd_queue)
+    if (cmd->get_state() != command::state::completed)
+      cmds.push_back(cmd);
+  return cmds;
+}
+
 void
 stream::
 enqueue_event(const std::shared_ptr<event>& ev)
@@ -127,6 +169,8 @@ void
 stream::
 synchronize()
 {
+  throw_if(is_capturing(), hipErrorStreamCaptureUnsupported, "stream is capturing");
+
   // synchronize among streams in this ctx
   synchronize_streams();
 
@@ -150,6 +194,44 @@ record_top_event(event* ev)
   m_top_event = ev;
 }
 
+void
+stream::
+begin_capture(hipStreamCaptureMode mode)
+{
+  throw_if(m_null, hipErrorStreamCaptureUnsupported, "null stream cannot be captured");
+  throw_invalid_value_if(mode != hipStreamCaptureModeGlobal &&
+                         mode != hipStreamCaptureModeThreadLocal &&
+                         mode != hipStreamCaptureModeRelaxed, "invalid stream capture mode");
+
+  std::lock_guard<std::mutex> lk(m_cmd_lock);
+  throw_if(m_capture_status != hipStreamCaptureStatusNone, hipErrorIllegalState, "stream is already capturing");
+  m_capture_graph = std::make_shared<graph>();
+  m_capture_status = hipStreamCaptureStatusActive;
+}
+
+std::shared_ptr<graph>
+stream::
+end_capture()
+{
+  std::lock_guard<std::mutex> lk(m_cmd_lock);
+  throw_if(m_capture_status == hipStreamCaptureStatusNone, hipErrorIllegalState, "stream is not capturing");
+
+  auto status = m_capture_status;
+  auto captured = std::move(m_capture_graph);
+  m_capture_status = hipStreamCaptureStatusNone;
+
+  throw_if(status == hipStreamCaptureStatusInvalidated, hipErrorStreamCaptureInvalidated, "stream capture is invalidated");
+  return captured;
+}
+
+hipStreamCaptureStatus
+stream::
+get_capture_status()
+{
+  std::lock_guard<std::mutex> lk(m_cmd_lock);
+  return m_capture_status;
+}
+
 std::shared_ptr<stream>
 get_stream(hipStream_t stream)
 {
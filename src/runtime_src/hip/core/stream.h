@@ -6,12 +6,14 @@
 #include "context.h"
 
 #include <list>
+#include <vector>
 
 namespace xrt::core::hip {
 
 // forward declarations
 class event;
 class command;
+class graph;
 
 class stream
 {
@@ -23,6 +25,10 @@ class stream
   std::mutex m_cmd_lock;
   event* m_top_event{nullptr};
 
+  // graph commands are captured into while stream is capturing
+  std::shared_ptr<graph> m_capture_graph;
+  hipStreamCaptureStatus m_capture_status{hipStreamCaptureStatusNone};
+
 public:
   stream() = default;
   stream(std::shared_ptr<context> ctx, unsigned int flags, bool is_null = false);
@@ -56,6 +62,10 @@ public:
   bool
   erase_cmd(std::shared_ptr<command> cmd);
 
+  // commands enqueued and not yet completed, in enqueue order
+  std::vector<std::shared_ptr<command>>
+  get_pending_commands();
+
   void
   enqueue_event(const std::shared_ptr<event>& ev);
 
@@ -70,6 +80,24 @@ public:
 
   void
   record_top_event(event* ev);
+
+  // Start capturing commands enqueued to this stream into a graph.
+  // Captured commands are not executed.
+  void
+  begin_capture(hipStreamCaptureMode mode);
+
+  // End capture and return the graph with the captured commands
+  std::shared_ptr<graph>
+  end_capture();
+
+  hipStreamCaptureStatus
+  get_capture_status();
+
+  bool
+  is_capturing()
+  {
+    return get_capture_status() != hipStreamCaptureStatusNone;
+  }
 };
 
 // Global map of streams
@@ -17,10 +17,17 @@
 
 #include <map>
 #include <mutex>
+#include <sstream>
+#include <string>
+
+#include <boost/algorithm/string/trim.hpp>
 
 #define XDP_PLUGIN_SOURCE
 
+#include "core/common/config_reader.h"
+#include "core/common/message.h"
 #include "core/common/time.h"
+#include "core/common/api/native_profile.h"
 #include "xdp/profile/database/dynamic_info/types.h"
 #include "xdp/profile/database/events/native_events.h"
 #include "xdp/profile/plugin/native/native_cb.h"
@@ -196,3 +203,37 @@ void native_sync_end(const char* functionName, unsigned long long int functionID
   else
     db->getStats().logHostRead(0, 0, size, startTimestamp, transferTime, 0, 0);
 }
+
+// Only the categories listed in xrt.ini are subscribed to, so for
+// example tracing just buffer synchronization leaves xrt::run::start
+// untouched.
+extern "C"
+unsigned int native_api_categories()
+{
+  using xdp::native::api_category;
+  static const std::map<std::string, api_category> categories = {
+    { "generic", api_category::generic },
+    { "run",     api_category::run     },
+    { "bo",      api_category::bo      },
+    { "sync",    api_category::sync    }
+  };
+
+  unsigned int mask = 0;
+  std::stringstream ss(xrt_core::config::get_native_xrt_trace_categories());
+  std::string token;
+  while (std::getline(ss, token, ',')) {
+    boost::algorithm::trim(token);
+    if (token.empty())
+      continue;
+    if (token == "all")
+      return ~0U;
+
+    auto itr = categories.find(token);
+    if (itr != categories.end())
+      mask |= static_cast<unsigned int>(itr->second);
+    else
+      xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT",
+                              "Unknown Debug.native_xrt_trace_categories category '" + token + "' ignored");
+  }
+  return mask;
+}
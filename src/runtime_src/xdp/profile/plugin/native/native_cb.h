@@ -38,4 +38,10 @@ extern "C"
 XDP_PLUGIN_EXPORT
 void native_sync_end(const char* functionName, unsigned long long int functionID, unsigned long long int timestamp, bool isWrite, unsigned long long int size);
 
+// Mask of native API categories this plugin subscribes to.  Call sites
+// in categories not subscribed to do not invoke the plugin.
+extern "C"
+XDP_PLUGIN_EXPORT
+unsigned int native_api_categories() ;
+
 #endif
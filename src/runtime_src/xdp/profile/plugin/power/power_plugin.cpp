@@ -26,6 +26,7 @@
 #include "core/common/time.h"
 #include "core/include/xrt/experimental/xrt-next.h"
 #include "core/common/query_requests.h"
+#include "core/common/sensor.h"
 #include "core/include/xrt/xrt_device.h"
 
 #include "xdp/profile/plugin/power/power_plugin.h"
@@ -105,6 +106,37 @@ namespace xdp {
 
   void PowerProfilingPlugin::pollPower()
   {
+    // Sensors in order of the power profile columns, read in one
+    // snapshot per sample
+    xrt_core::query::sensor_snapshot::args sensors;
+    sensors.keys = {
+      xrt_core::query::v12v_aux_milliamps::key,
+      xrt_core::query::v12v_aux_millivolts::key,
+      xrt_core::query::v12v_pex_milliamps::key,
+      xrt_core::query::v12v_pex_millivolts::key,
+      xrt_core::query::int_vcc_milliamps::key,
+      xrt_core::query::int_vcc_millivolts::key,
+      xrt_core::query::v3v3_pex_milliamps::key,
+      xrt_core::query::v3v3_pex_millivolts::key,
+      xrt_core::query::cage_temp_0::key,
+      xrt_core::query::cage_temp_1::key,
+      xrt_core::query::cage_temp_2::key,
+      xrt_core::query::cage_temp_3::key,
+      xrt_core::query::dimm_temp_0::key,
+      xrt_core::query::dimm_temp_1::key,
+      xrt_core::query::dimm_temp_2::key,
+      xrt_core::query::dimm_temp_3::key,
+      xrt_core::query::fan_trigger_critical_temp::key,
+      xrt_core::query::temp_fpga::key,
+      xrt_core::query::hbm_temp::key,
+      xrt_core::query::temp_card_top_front::key,
+      xrt_core::query::temp_card_top_rear::key,
+      xrt_core::query::temp_card_bottom_front::key,
+      xrt_core::query::int_vcc_temp::key,
+      xrt_core::query::fan_speed_rpm::key
+    };
+
+    bool warned = false ;
     while(keepPolling)
     {
       // Get timestamp in milliseconds
@@ -121,59 +153,27 @@ namespace xdp {
           continue;
         }
 
-        try{
-          uint64_t data = 0;
-          data = xrt_core::device_query<xrt_core::query::v12v_aux_milliamps>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::v12v_aux_millivolts>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::v12v_pex_milliamps>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::v12v_pex_millivolts>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::int_vcc_milliamps>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::int_vcc_millivolts>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::v3v3_pex_milliamps>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::v3v3_pex_millivolts>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::cage_temp_0>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::cage_temp_1>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::cage_temp_2>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::cage_temp_3>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::dimm_temp_0>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::dimm_temp_1>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::dimm_temp_2>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::dimm_temp_3>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::fan_trigger_critical_temp>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::temp_fpga>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::hbm_temp>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::temp_card_top_front>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::temp_card_top_rear>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::temp_card_bottom_front>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::int_vcc_temp>(coreDevice);
-          values.push_back(data);
-          data = xrt_core::device_query<xrt_core::query::fan_speed_rpm>(coreDevice); 
-          values.push_back(data);
-        }
-        catch (const xrt_core::query::no_such_key&) {
-          //query is not implemented
+        try {
+          auto data = xrt_core::sensor::read_snapshot(coreDevice.get(), sensors) ;
+
+          // A sensor that cannot be read is recorded as 0, such that
+          // the remaining columns of the sample are preserved
+          size_t errors = 0 ;
+          values.reserve(data.size()) ;
+          for (auto& sensor : data) {
+            values.push_back(sensor.value) ;
+            if (!sensor.error.empty())
+              ++errors ;
+          }
+
+          // No sensors on this device
+          if (errors == data.size())
+            values.clear() ;
+          else if (errors && !warned) {
+            std::string msg = "Error while retrieving data from power files. Using default value.";
+            xrt_core::message::send(xrt_core::message::severity_level::warning, "XRT", msg);
+            warned = true ;
+          }
         }
         catch (const std::exception&) {
           // error retrieving information
@@ -0,0 +1,67 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "xocl/config.h"
+#include "xocl/core/command_buffer.h"
+#include "detail/command_buffer.h"
+#include "plugin/xdp/profile_v2.h"
+
+#include <CL/cl_ext_xilinx.h>
+
+namespace xocl {
+
+static void
+validOrError(cl_command_buffer_khr         command_buffer,
+             cl_command_queue              command_queue,
+             cl_uint                       num_sync_points_in_wait_list,
+             const cl_sync_point_khr*      sync_point_wait_list,
+             cl_sync_point_khr*            sync_point,
+             cl_mutable_command_khr*       mutable_handle)
+{
+  if (!config::api_checks())
+    return;
+
+  detail::command_buffer::validRecordingOrError
+    (command_buffer,command_queue,num_sync_points_in_wait_list,sync_point_wait_list,mutable_handle);
+}
+
+static cl_int
+clCommandBarrierWithWaitListKHR(cl_command_buffer_khr         command_buffer,
+                                cl_command_queue              command_queue,
+                                cl_uint                       num_sync_points_in_wait_list,
+                                const cl_sync_point_khr*      sync_point_wait_list,
+                                cl_sync_point_khr*            sync_point,
+                                cl_mutable_command_khr*       mutable_handle)
+{
+  validOrError(command_buffer,command_queue,num_sync_points_in_wait_list,sync_point_wait_list,sync_point,mutable_handle);
+
+  auto sp = xocl(command_buffer)->record_barrier();
+  if (sync_point)
+    *sync_point = sp;
+  return CL_SUCCESS;
+}
+
+} // xocl
+
+cl_int
+clCommandBarrierWithWaitListKHR(cl_command_buffer_khr         command_buffer,
+                                cl_command_queue              command_queue,
+                                cl_uint                       num_sync_points_in_wait_list,
+                                const cl_sync_point_khr*      sync_point_wait_list,
+                                cl_sync_point_khr*            sync_point,
+                                cl_mutable_command_khr*       mutable_handle)
+{
+  try {
+    PROFILE_LOG_FUNCTION_CALL;
+    LOP_LOG_FUNCTION_CALL;
+    return xocl::clCommandBarrierWithWaitListKHR
+      (command_buffer,command_queue,num_sync_points_in_wait_list,sync_point_wait_list,sync_point,mutable_handle);
+  }
+  catch (const xrt_xocl::error& ex) {
+    xocl::send_exception_message(ex.what());
+    return ex.get_code();
+  }
+  catch (const std::exception& ex) {
+    xocl::send_exception_message(ex.what());
+    return CL_OUT_OF_HOST_MEMORY;
+  }
+}
@@ -0,0 +1,172 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "xocl/config.h"
+#include "xocl/core/command_buffer.h"
+#include "xocl/core/command_queue.h"
+#include "xocl/core/device.h"
+#include "xocl/core/error.h"
+#include "xocl/core/kernel.h"
+#include "detail/command_buffer.h"
+#include "detail/kernel.h"
+#include "plugin/xdp/profile_v2.h"
+
+#include <CL/cl_ext_xilinx.h>
+
+#include <algorithm>
+#include <array>
+
+namespace xocl {
+
+static void
+validOrError(cl_command_buffer_khr                           command_buffer,
+             cl_command_queue                                command_queue,
+             const cl_ndrange_kernel_command_properties_khr* properties,
+             cl_kernel                                       kernel,
+             cl_uint                                         work_dim,
+             const size_t*                                   global_work_offset,
+             const size_t*                                   global_work_size,
+             const size_t*                                   local_work_size,
+             cl_uint                                         num_sync_points_in_wait_list,
+             const cl_sync_point_khr*                        sync_point_wait_list,
+             cl_sync_point_khr*                              sync_point,
+             cl_mutable_command_khr*                         mutable_handle)
+{
+  if (!config::api_checks())
+    return;
+
+  detail::command_buffer::validRecordingOrError
+    (command_buffer,command_queue,num_sync_points_in_wait_list,sync_point_wait_list,mutable_handle);
+
+  // CL_INVALID_VALUE if values specified in properties are not valid.
+  if (properties && *properties)
+    throw error(CL_INVALID_VALUE,"invalid ndrange kernel command property");
+
+  // CL_INVALID_KERNEL if kernel is not a valid kernel object
+  detail::kernel::validOrError(kernel);
+
+  // CL_INVALID_CONTEXT if the context associated with command_buffer
+  // and kernel are not the same.
+  auto xcb = xocl(command_buffer);
+  auto xkernel = xocl(kernel);
+  if (xcb->get_context() != xkernel->get_context())
+    throw error(CL_INVALID_CONTEXT,"command buffer and kernel context mismatch");
+
+  // CL_INVALID_PROGRAM_EXECUTABLE if there is no successfully built
+  // program executable available for device associated with
+  // command_buffer
+  auto xdevice = xcb->get_command_queue()->get_device();
+  if (!xdevice->is_active())
+    throw error(CL_INVALID_PROGRAM_EXECUTABLE,"No program executable for device");
+
+  // CL_INVALID_KERNEL_ARGS if the kernel argument values have not
+  // been specified.
+  detail::kernel::validArgsOrError(kernel);
+
+  // CL_INVALID_OPERATION if the device does not support kernel
+  // printf in command buffers.
+  if (xkernel->has_printf())
+    throw error(CL_INVALID_OPERATION,"printf kernels cannot be recorded in command buffer");
+
+  // CL_INVALID_WORK_DIMENSION if work_dim is not a valid value
+  if (work_dim<1 || work_dim>3)
+    throw error(CL_INVALID_WORK_DIMENSION,"Invalid work dimension '" + std::to_string(work_dim) + "'");
+
+  // CL_INVALID_GLOBAL_WORK_SIZE if global_work_size is NULL, or if
+  // any of the values specified in global_work_size are 0
+  if (!global_work_size)
+    throw error(CL_INVALID_GLOBAL_WORK_SIZE,"global_work_size is nullptr");
+  if (std::any_of(global_work_size,global_work_size+work_dim,[](size_t sz){return sz==0;}))
+    throw error(CL_INVALID_GLOBAL_WORK_SIZE,"global_work_size[?] is zero");
+
+  // CL_INVALID_WORK_GROUP_SIZE if local_work_size is specified and
+  // does not evenly divide the global work size, or does not match
+  // the required work-group size of the kernel.
+  auto compile_wgs_range = xkernel->get_compile_wg_size_range();
+  bool reqd_work_group_size_set =
+    std::any_of(compile_wgs_range.begin(),compile_wgs_range.end(),[](size_t sz) { return sz!=0; });
+  for (cl_uint work_dim_it=0; work_dim_it < work_dim; ++work_dim_it) {
+    if (local_work_size && !local_work_size[work_dim_it])
+      throw error(CL_INVALID_WORK_GROUP_SIZE,"local_work_size[?] is zero");
+    if (local_work_size && (global_work_size[work_dim_it] % local_work_size[work_dim_it]))
+      throw error(CL_INVALID_WORK_GROUP_SIZE,"local_work_size does not divide global_work_size");
+    if (reqd_work_group_size_set &&
+        (!local_work_size || local_work_size[work_dim_it] != compile_wgs_range[work_dim_it]))
+      throw error(CL_INVALID_WORK_GROUP_SIZE,"local_work_size does not match required work group size");
+  }
+}
+
+static cl_int
+clCommandNDRangeKernelKHR(cl_command_buffer_khr                           command_buffer,
+                          cl_command_queue                                command_queue,
+                          const cl_ndrange_kernel_command_properties_khr* properties,
+                          cl_kernel                                       kernel,
+                          cl_uint                                         work_dim,
+                          const size_t*                                   global_work_offset,
+                          const size_t*                                   global_work_size,
+                          const size_t*                                   local_work_size,
+                          cl_uint                                         num_sync_points_in_wait_list,
+                          const cl_sync_point_khr*                        sync_point_wait_list,
+                          cl_sync_point_khr*                              sync_point,
+                          cl_mutable_command_khr*                         mutable_handle)
+{
+  validOrError(command_buffer,command_queue,properties,kernel
+               ,work_dim,global_work_offset,global_work_size,local_work_size
+               ,num_sync_points_in_wait_list,sync_point_wait_list,sync_point,mutable_handle);
+
+  std::array<size_t,3> global_work_offset_3D = {0,0,0};
+  std::array<size_t,3> global_work_size_3D = {1,1,1};
+  std::array<size_t,3> local_work_size_3D = {1,1,1};
+  for (cl_uint work_dim_it=0; work_dim_it < work_dim; ++work_dim_it) {
+    if (global_work_offset)
+      global_work_offset_3D[work_dim_it] = global_work_offset[work_dim_it];
+    global_work_size_3D[work_dim_it] = global_work_size[work_dim_it];
+    if (local_work_size)
+      local_work_size_3D[work_dim_it] = local_work_size[work_dim_it];
+  }
+
+  // Same work group size as clEnqueueNDRangeKernel would pick
+  auto xcb = xocl(command_buffer);
+  if (!local_work_size)
+    local_work_size_3D = detail::kernel::default_local_work_size
+      (xcb->get_command_queue()->get_device(),kernel,work_dim,global_work_size_3D);
+
+  auto sp = xcb->record_ndrange
+    (xocl(kernel),work_dim,global_work_offset_3D.data(),global_work_size_3D.data(),local_work_size_3D.data());
+  if (sync_point)
+    *sync_point = sp;
+  return CL_SUCCESS;
+}
+
+} // xocl
+
+cl_int
+clCommandNDRangeKernelKHR(cl_command_buffer_khr                           command_buffer,
+                          cl_command_queue                                command_queue,
+                          const cl_ndrange_kernel_command_properties_khr* properties,
+                          cl_kernel                                       kernel,
+                          cl_uint                                         work_dim,
+                          const size_t*                                   global_work_offset,
+                          const size_t*                                   global_work_size,
+                          const size_t*                                   local_work_size,
+                          cl_uint                                         num_sync_points_in_wait_list,
+                          const cl_sync_point_khr*                        sync_point_wait_list,
+                          cl_sync_point_khr*                              sync_point,
+                          cl_mutable_command_khr*                         mutable_handle)
+{
+  try {
+    PROFILE_LOG_FUNCTION_CALL;
+    LOP_LOG_FUNCTION_CALL;
+    return xocl::clCommandNDRangeKernelKHR
+      (command_buffer,command_queue,properties,kernel
+       ,work_dim,global_work_offset,global_work_size,local_work_size
+       ,num_sync_points_in_wait_list,sync_point_wait_list,sync_point,mutable_handle);
+  }
+  catch (const xrt_xocl::error& ex) {
+    xocl::send_exception_message(ex.what());
+    return ex.get_code();
+  }
+  catch (const std::exception& ex) {
+    xocl::send_exception_message(ex.what());
+    return CL_OUT_OF_HOST_MEMORY;
+  }
+}
@@ -0,0 +1,90 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "xocl/config.h"
+#include "xocl/core/command_buffer.h"
+#include "xocl/core/command_queue.h"
+#include "xocl/core/error.h"
+#include "detail/command_queue.h"
+#include "plugin/xdp/profile_v2.h"
+
+#include <CL/cl_ext_xilinx.h>
+
+namespace xocl {
+
+static void
+validOrError(cl_uint                                 num_queues,
+             const cl_command_queue*                 queues,
+             const cl_command_buffer_properties_khr* properties,
+             cl_int*                                 errcode_ret)
+{
+  if (!config::api_checks())
+    return;
+
+  // CL_INVALID_VALUE if num_queues is not one, or if queues is NULL
+  if (num_queues != 1 || !queues)
+    throw error(CL_INVALID_VALUE,"exactly one command queue is required");
+
+  // CL_INVALID_COMMAND_QUEUE if any command-queue in queues is not a
+  // valid command-queue.
+  detail::command_queue::validOrError(queues[0]);
+
+  // CL_INCOMPATIBLE_COMMAND_QUEUE_KHR if any command-queue in queues
+  // is an out-of-order command-queue, which is not a capability of
+  // the device.
+  if (xocl(queues[0])->get_properties().test(CL_QUEUE_OUT_OF_ORDER_EXEC_MODE_ENABLE))
+    throw error(CL_INCOMPATIBLE_COMMAND_QUEUE_KHR,"out of order command queue not supported");
+
+  // CL_INVALID_VALUE if values specified in properties are not
+  // valid, or if the same property name is specified more than once.
+  bool flags_seen = false;
+  for (auto p = properties; p && *p; p += 2) {
+    if (p[0] != CL_COMMAND_BUFFER_FLAGS_KHR || flags_seen)
+      throw error(CL_INVALID_VALUE,"invalid command buffer property");
+    if (p[1] & ~static_cast<cl_command_buffer_flags_khr>(CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR))
+      throw error(CL_INVALID_VALUE,"invalid command buffer flags");
+    flags_seen = true;
+  }
+}
+
+static cl_command_buffer_khr
+clCreateCommandBufferKHR(cl_uint                                 num_queues,
+                         const cl_command_queue*                 queues,
+                         const cl_command_buffer_properties_khr* properties,
+                         cl_int*                                 errcode_ret)
+{
+  validOrError(num_queues,queues,properties,errcode_ret);
+
+  cl_command_buffer_flags_khr flags = 0;
+  for (auto p = properties; p && *p; p += 2)
+    if (p[0] == CL_COMMAND_BUFFER_FLAGS_KHR)
+      flags = p[1];
+
+  auto command_buffer = std::make_unique<xocl::command_buffer>(xocl::xocl(queues[0]),flags);
+  xocl::assign(errcode_ret,CL_SUCCESS);
+  return command_buffer.release();
+}
+
+} // xocl
+
+cl_command_buffer_khr
+clCreateCommandBufferKHR(cl_uint                                 num_queues,
+                         const cl_command_queue*                 queues,
+                         const cl_command_buffer_properties_khr* properties,
+                         cl_int*                                 errcode_ret)
+{
+  try {
+    PROFILE_LOG_FUNCTION_CALL;
+    LOP_LOG_FUNCTION_CALL;
+    return xocl::clCreateCommandBufferKHR
+      (num_queues,queues,properties,errcode_ret);
+  }
+  catch (const xrt_xocl::error& ex) {
+    xocl::send_exception_message(ex.what());
+    xocl::assign(errcode_ret,ex.get_code());
+  }
+  catch (const std::exception& ex) {
+    xocl::send_exception_message(ex.what());
+    xocl::assign(errcode_ret,CL_OUT_OF_HOST_MEMORY);
+  }
+  return nullptr;
+}
@@ -0,0 +1,128 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "xocl/config.h"
+#include "xocl/core/command_buffer.h"
+#include "xocl/core/command_queue.h"
+#include "xocl/core/error.h"
+#include "xocl/core/event.h"
+#include "detail/command_buffer.h"
+#include "detail/command_queue.h"
+#include "detail/event.h"
+#include "enqueue.h"
+#include "plugin/xdp/profile_v2.h"
+
+#include <CL/cl_ext_xilinx.h>
+
+namespace xocl {
+
+// Queue to execute command buffer on, default is the recording queue
+static cl_command_queue
+get_queue(cl_uint num_queues, cl_command_queue* queues, cl_command_buffer_khr command_buffer)
+{
+  return (num_queues && queues) ? queues[0] : xocl(command_buffer)->get_command_queue();
+}
+
+static void
+validOrError(cl_uint               num_queues,
+             cl_command_queue*     queues,
+             cl_command_buffer_khr command_buffer,
+             cl_uint               num_events_in_wait_list,
+             const cl_event*       event_wait_list,
+             cl_event*             event)
+{
+  if (!config::api_checks())
+    return;
+
+  // CL_INVALID_COMMAND_BUFFER_KHR if command_buffer is not a valid
+  // command-buffer.
+  detail::command_buffer::validOrError(command_buffer);
+
+  // CL_INVALID_VALUE if queues is NULL and num_queues is > 0, or
+  // queues is not NULL and num_queues is 0, or num_queues is not
+  // the number of queues command_buffer was recorded with.
+  if (!queues != !num_queues)
+    throw error(CL_INVALID_VALUE,"queues and num_queues mismatch");
+  if (num_queues > 1)
+    throw error(CL_INVALID_VALUE,"command buffer was recorded with one queue");
+
+  // CL_INCOMPATIBLE_COMMAND_QUEUE_KHR if the queue is not compatible
+  // with the queue the command buffer was recorded with.
+  auto xcb = xocl(command_buffer);
+  auto queue = get_queue(num_queues,queues,command_buffer);
+  detail::command_queue::validOrError(queue);
+  auto xqueue = xocl(queue);
+  auto xrecq = xcb->get_command_queue();
+  if (xqueue->get_device() != xrecq->get_device()
+      || cl_command_queue_properties(xqueue->get_properties()) != cl_command_queue_properties(xrecq->get_properties()))
+    throw error(CL_INCOMPATIBLE_COMMAND_QUEUE_KHR,"command queue is not compatible with command buffer");
+
+  // CL_INVALID_OPERATION if command_buffer has not been finalized, or
+  // if command_buffer was not created with the
+  // CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR flag and is in the Pending
+  // state.
+  auto state = xcb->get_state();
+  if (state == CL_COMMAND_BUFFER_STATE_RECORDING_KHR)
+    throw error(CL_INVALID_OPERATION,"command buffer is not finalized");
+  if (state == CL_COMMAND_BUFFER_STATE_PENDING_KHR && !xcb->is_simultaneous_use())
+    throw error(CL_INVALID_OPERATION,"command buffer is pending");
+
+  // CL_INVALID_CONTEXT if context associated with queue and events in
+  // event_wait_list are not the same.
+  // CL_INVALID_EVENT_WAIT_LIST if event_wait_list is NULL and
+  // num_events_in_wait_list > 0, or event_wait_list is not NULL and
+  // num_events_in_wait_list is 0, or if event objects in
+  // event_wait_list are not valid events.
+  detail::event::validOrError(queue,num_events_in_wait_list,event_wait_list);
+}
+
+static cl_int
+clEnqueueCommandBufferKHR(cl_uint               num_queues,
+                          cl_command_queue*     queues,
+                          cl_command_buffer_khr command_buffer,
+                          cl_uint               num_events_in_wait_list,
+                          const cl_event*       event_wait_list,
+                          cl_event*             event_parameter)
+{
+  validOrError(num_queues,queues,command_buffer,num_events_in_wait_list,event_wait_list,event_parameter);
+
+  // One event and one submission of the prebuilt runlist regardless
+  // of the number of recorded commands and work groups
+  auto queue = get_queue(num_queues,queues,command_buffer);
+  auto uevent = create_hard_event(queue,CL_COMMAND_COMMAND_BUFFER_KHR,num_events_in_wait_list,event_wait_list);
+  enqueue::set_event_action(uevent.get(),enqueue::action_command_buffer,command_buffer);
+
+  // The command buffer is pending from enqueue until its event
+  // completes or is aborted
+  ptr<xocl::command_buffer> xcb(xocl(command_buffer));
+  xcb->set_pending();
+  uevent->add_callback([xcb](cl_int) { xcb->clear_pending(); });
+  uevent->queue();
+  assign(event_parameter,uevent.get());
+  return CL_SUCCESS;
+}
+
+} // xocl
+
+cl_int
+clEnqueueCommandBufferKHR(cl_uint               num_queues,
+                          cl_command_queue*     queues,
+                          cl_command_buffer_khr command_buffer,
+                          cl_uint               num_events_in_wait_list,
+                          const cl_event*       event_wait_list,
+                          cl_event*             event)
+{
+  try {
+    PROFILE_LOG_FUNCTION_CALL;
+    LOP_LOG_FUNCTION_CALL;
+    return xocl::clEnqueueCommandBufferKHR
+      (num_queues,queues,command_buffer,num_events_in_wait_list,event_wait_list,event);
+  }
+  catch (const xrt_xocl::error& ex) {
+    xocl::send_exception_message(ex.what());
+    return ex.get_code();
+  }
+  catch (const std::exception& ex) {
+    xocl::send_exception_message(ex.what());
+    return CL_OUT_OF_HOST_MEMORY;
+  }
+}
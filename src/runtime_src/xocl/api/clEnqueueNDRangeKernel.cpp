@@ -87,16 +87,6 @@ getDeviceMaxWorkGroupSize(cl_device_id device)
   return size;
 }
 
-static size_t*
-getDeviceMaxWorkItemSizes(cl_device_id device)
-{
-  static size_t sizes[3] = {0,0,0};
-  if (sizes[0])
-    return sizes;
-  xocl::api::clGetDeviceInfo(device,CL_DEVICE_MAX_WORK_ITEM_SIZES,sizeof(size_t)*3,&sizes,nullptr);
-  return sizes;
-}
-
 }
 
 namespace xocl {
@@ -303,39 +293,9 @@ clEnqueueNDRangeKernel(cl_command_queue command_queue,
 
 
   // pick an local work size if the user does not provide one.
-  if (!local_work_size) {
-    size_t max_wg_size = std::numeric_limits<size_t>::max(); // no total work items constraint
-    if(!xcl_max_work_group_size_set)
-      max_wg_size=getDeviceMaxWorkGroupSize(xocl::xocl(command_queue)->get_device());
-    else if (xcl_max_work_group_size_totalworkitemconstraint_set)
-      max_wg_size=max_wgs_range[0];
-
-    size_t best_wg_size = 1;
-    size_t total_size = global_work_size_3D[0] * global_work_size_3D[1] * global_work_size_3D[2];
-    size_t dim_max[3] = {1, 1, 1};
-    for (cl_uint work_dim_it=0; work_dim_it < work_dim; ++work_dim_it) {
-      size_t m = (xcl_max_work_group_size_set && (!xcl_max_work_group_size_totalworkitemconstraint_set))
-        ? max_wgs_range[work_dim_it]
-        : getDeviceMaxWorkItemSizes(xocl::xocl(command_queue)->get_device())[work_dim_it];
-      dim_max[work_dim_it] = (std::min)(m, global_work_size_3D[work_dim_it]);
-    }
-    for (size_t z = 1; z <= dim_max[2]; ++z) {
-      if (global_work_size_3D[2] % z) continue;
-      for (size_t y = 1; y <= dim_max[1]; ++y) {
-        if (global_work_size_3D[1] % y) continue;
-        for (size_t x = 1; x <= dim_max[0]; ++x) {
-          if (global_work_size_3D[0] % x) continue;
-          if ( (x*y*z > best_wg_size) && (x*y*z <= max_wg_size) &&
-               (x*y*z <= total_size) && !(total_size % (x*y*z)) ) {
-            local_work_size_3D[0] = x;
-            local_work_size_3D[1] = y;
-            local_work_size_3D[2] = z;
-            best_wg_size = x*y*z;
-          }
-        }
-      }
-    }
-  }
+  if (!local_work_size)
+    local_work_size_3D = detail::kernel::default_local_work_size
+      (xocl::xocl(command_queue)->get_device(),kernel,work_dim,global_work_size_3D);
   assert(local_work_size_3D[0] && local_work_size_3D[1] && local_work_size_3D[2]);
 
   // More api checks after computing sizes above
@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "xocl/config.h"
+#include "xocl/core/command_buffer.h"
+#include "xocl/core/error.h"
+#include "detail/command_buffer.h"
+#include "plugin/xdp/profile_v2.h"
+
+#include <CL/cl_ext_xilinx.h>
+
+namespace xocl {
+
+static void
+validOrError(cl_command_buffer_khr command_buffer)
+{
+  if (!config::api_checks())
+    return;
+
+  // CL_INVALID_COMMAND_BUFFER_KHR if command_buffer is not a valid
+  // command-buffer.
+  detail::command_buffer::validOrError(command_buffer);
+
+  // CL_INVALID_OPERATION if command_buffer has already been finalized.
+  if (xocl(command_buffer)->get_state() != CL_COMMAND_BUFFER_STATE_RECORDING_KHR)
+    throw error(CL_INVALID_OPERATION,"command buffer is already finalized");
+}
+
+static cl_int
+clFinalizeCommandBufferKHR(cl_command_buffer_khr command_buffer)
+{
+  validOrError(command_buffer);
+  xocl(command_buffer)->finalize();
+  return CL_SUCCESS;
+}
+
+} // xocl
+
+cl_int
+clFinalizeCommandBufferKHR(cl_command_buffer_khr command_buffer)
+{
+  try {
+    PROFILE_LOG_FUNCTION_CALL;
+    LOP_LOG_FUNCTION_CALL;
+    return xocl::clFinalizeCommandBufferKHR(command_buffer);
+  }
+  catch (const xrt_xocl::error& ex) {
+    xocl::send_exception_message(ex.what());
+    return ex.get_code();
+  }
+  catch (const std::exception& ex) {
+    xocl::send_exception_message(ex.what());
+    return CL_OUT_OF_HOST_MEMORY;
+  }
+}
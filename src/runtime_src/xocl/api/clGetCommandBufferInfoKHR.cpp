@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "xocl/config.h"
+#include "xocl/core/command_buffer.h"
+#include "xocl/core/command_queue.h"
+#include "xocl/core/context.h"
+#include "xocl/core/error.h"
+#include "xocl/core/param.h"
+#include "detail/command_buffer.h"
+#include "plugin/xdp/profile_v2.h"
+
+#include <CL/cl_ext_xilinx.h>
+
+#include <vector>
+
+namespace xocl {
+
+static void
+validOrError(cl_command_buffer_khr      command_buffer,
+             cl_command_buffer_info_khr param_name,
+             size_t                     param_value_size,
+             void*                      param_value,
+             size_t*                    param_value_size_ret)
+{
+  if (!config::api_checks())
+    return;
+
+  // CL_INVALID_COMMAND_BUFFER_KHR if command_buffer is not a valid
+  // command-buffer.
+  detail::command_buffer::validOrError(command_buffer);
+}
+
+static cl_int
+clGetCommandBufferInfoKHR(cl_command_buffer_khr      command_buffer,
+                          cl_command_buffer_info_khr param_name,
+                          size_t                     param_value_size,
+                          void*                      param_value,
+                          size_t*                    param_value_size_ret)
+{
+  validOrError(command_buffer,param_name,param_value_size,param_value,param_value_size_ret);
+
+  xocl::param_buffer buffer { param_value, param_value_size, param_value_size_ret };
+
+  auto xcb = xocl(command_buffer);
+  switch (param_name) {
+  case CL_COMMAND_BUFFER_QUEUES_KHR:
+    buffer.as<cl_command_queue>() = xcb->get_command_queue();
+    break;
+  case CL_COMMAND_BUFFER_NUM_QUEUES_KHR:
+    buffer.as<cl_uint>() = 1;
+    break;
+  case CL_COMMAND_BUFFER_REFERENCE_COUNT_KHR:
+    buffer.as<cl_uint>() = xcb->count();
+    break;
+  case CL_COMMAND_BUFFER_STATE_KHR:
+    buffer.as<cl_command_buffer_state_khr>() = xcb->get_state();
+    break;
+  case CL_COMMAND_BUFFER_PROPERTIES_ARRAY_KHR: {
+    std::vector<cl_command_buffer_properties_khr> props;
+    if (auto flags = xcb->get_flags())
+      props = {CL_COMMAND_BUFFER_FLAGS_KHR, flags, 0};
+    buffer.as<cl_command_buffer_properties_khr>() = props;
+    break;
+  }
+  case CL_COMMAND_BUFFER_CONTEXT_KHR:
+    buffer.as<cl_context>() = xcb->get_context();
+    break;
+  default:
+    throw error(CL_INVALID_VALUE,"clGetCommandBufferInfoKHR invalid param_name");
+  }
+
+  return CL_SUCCESS;
+}
+
+} // xocl
+
+cl_int
+clGetCommandBufferInfoKHR(cl_command_buffer_khr      command_buffer,
+                          cl_command_buffer_info_khr param_name,
+                          size_t                     param_value_size,
+                          void*                      param_value,
+                          size_t*                    param_value_size_ret)
+{
+  try {
+    PROFILE_LOG_FUNCTION_CALL;
+    LOP_LOG_FUNCTION_CALL;
+    return xocl::clGetCommandBufferInfoKHR
+      (command_buffer,param_name,param_value_size,param_value,param_value_size_ret);
+  }
+  catch (const xrt_xocl::error& ex) {
+    xocl::send_exception_message(ex.what());
+    return ex.get_code();
+  }
+  catch (const std::exception& ex) {
+    xocl::send_exception_message(ex.what());
+    return CL_OUT_OF_HOST_MEMORY;
+  }
+}
@@ -258,7 +258,7 @@ clGetDeviceInfo(cl_device_id   device,
     buffer.as<char>() = "OpenCL C 1.0";
     break;
   case CL_DEVICE_EXTENSIONS:
-    buffer.as<char>() = "";
+    buffer.as<char>() = CL_KHR_COMMAND_BUFFER_EXTENSION_NAME;
     //12: "cl_khr_global_int32_base_atomics cl_khr_global_int32_extended_atomics cl_khr_local_int32_base_atomics cl_khr_local_int32_extended_atomics cl_khr_byte_addressable_store";
     break;
   case CL_DEVICE_PRINTF_BUFFER_SIZE:
@@ -312,6 +312,12 @@ clGetDeviceInfo(cl_device_id   device,
   case CL_DEVICE_KDMA_COUNT:
     buffer.as<cl_uint>() = static_cast<cl_uint>(xdevice->get_num_cdmas());
     break;
+  case CL_DEVICE_COMMAND_BUFFER_CAPABILITIES_KHR:
+    buffer.as<cl_device_command_buffer_capabilities_khr>() = CL_COMMAND_BUFFER_CAPABILITY_SIMULTANEOUS_USE_KHR;
+    break;
+  case CL_DEVICE_COMMAND_BUFFER_REQUIRED_QUEUE_PROPERTIES_KHR:
+    buffer.as<cl_command_queue_properties>() = 0;
+    break;
   default:
     throw error(CL_INVALID_VALUE,"clGetDeviceInfo: invalid param_name");
     break;
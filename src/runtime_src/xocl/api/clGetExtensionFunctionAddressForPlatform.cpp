@@ -29,6 +29,14 @@ static const std::map<const std::string, void *> extensionFunctionTable = {
   std::pair<const std::string, void *>("xclGetMemObjDeviceAddress", (void *)xclGetMemObjDeviceAddress),
   std::pair<const std::string, void *>("xclGetComputeUnitInfo", (void *)xclGetComputeUnitInfo),
   std::pair<const std::string, void *>("clIcdGetPlatformIDsKHR", (void *)clIcdGetPlatformIDsKHR),
+  std::pair<const std::string, void *>("clCreateCommandBufferKHR", (void *)clCreateCommandBufferKHR),
+  std::pair<const std::string, void *>("clFinalizeCommandBufferKHR", (void *)clFinalizeCommandBufferKHR),
+  std::pair<const std::string, void *>("clRetainCommandBufferKHR", (void *)clRetainCommandBufferKHR),
+  std::pair<const std::string, void *>("clReleaseCommandBufferKHR", (void *)clReleaseCommandBufferKHR),
+  std::pair<const std::string, void *>("clEnqueueCommandBufferKHR", (void *)clEnqueueCommandBufferKHR),
+  std::pair<const std::string, void *>("clCommandBarrierWithWaitListKHR", (void *)clCommandBarrierWithWaitListKHR),
+  std::pair<const std::string, void *>("clCommandNDRangeKernelKHR", (void *)clCommandNDRangeKernelKHR),
+  std::pair<const std::string, void *>("clGetCommandBufferInfoKHR", (void *)clGetCommandBufferInfoKHR),
 };
 
 
@@ -0,0 +1,47 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "xocl/config.h"
+#include "xocl/core/command_buffer.h"
+#include "detail/command_buffer.h"
+#include "plugin/xdp/profile_v2.h"
+
+#include <CL/cl_ext_xilinx.h>
+
+namespace xocl {
+
+static void
+validOrError(cl_command_buffer_khr command_buffer)
+{
+  if (!config::api_checks())
+    return;
+
+  detail::command_buffer::validOrError(command_buffer);
+}
+
+static cl_int
+clRetainCommandBufferKHR(cl_command_buffer_khr command_buffer)
+{
+  validOrError(command_buffer);
+  xocl(command_buffer)->retain();
+  return CL_SUCCESS;
+}
+
+} // xocl
+
+cl_int
+clRetainCommandBufferKHR(cl_command_buffer_khr command_buffer)
+{
+  try {
+    PROFILE_LOG_FUNCTION_CALL;
+    LOP_LOG_FUNCTION_CALL;
+    return xocl::clRetainCommandBufferKHR(command_buffer);
+  }
+  catch (const xrt_xocl::error& ex) {
+    xocl::send_exception_message(ex.what());
+    return ex.get_code();
+  }
+  catch (const std::exception& ex) {
+    xocl::send_exception_message(ex.what());
+    return CL_OUT_OF_HOST_MEMORY;
+  }
+}
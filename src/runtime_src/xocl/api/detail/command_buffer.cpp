@@ -0,0 +1,59 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "command_buffer.h"
+#include "command_queue.h"
+#include "xocl/core/command_buffer.h"
+#include "xocl/core/command_queue.h"
+#include "xocl/core/error.h"
+
+namespace xocl { namespace detail {
+
+namespace command_buffer {
+
+void
+validOrError(const cl_command_buffer_khr command_buffer)
+{
+  if (!command_buffer)
+    throw error(CL_INVALID_COMMAND_BUFFER_KHR,"command buffer is nullptr");
+  command_queue::validOrError(xocl(command_buffer)->get_command_queue());
+}
+
+void
+validRecordingOrError(const cl_command_buffer_khr command_buffer,
+                      const cl_command_queue command_queue,
+                      cl_uint num_sync_points_in_wait_list,
+                      const cl_sync_point_khr* sync_point_wait_list,
+                      const cl_mutable_command_khr* mutable_handle)
+{
+  // CL_INVALID_COMMAND_BUFFER_KHR if command_buffer is not a valid
+  // command-buffer.
+  validOrError(command_buffer);
+
+  // CL_INVALID_COMMAND_QUEUE if command_queue is not NULL.
+  if (command_queue)
+    throw error(CL_INVALID_COMMAND_QUEUE,"command_queue must be nullptr");
+
+  // CL_INVALID_OPERATION if command_buffer has been finalized.
+  auto xcb = xocl(command_buffer);
+  if (xcb->get_state() != CL_COMMAND_BUFFER_STATE_RECORDING_KHR)
+    throw error(CL_INVALID_OPERATION,"command buffer is not recording");
+
+  // CL_INVALID_VALUE if mutable_handle is not NULL.
+  if (mutable_handle)
+    throw error(CL_INVALID_VALUE,"mutable commands are not supported");
+
+  // CL_INVALID_SYNC_POINT_WAIT_LIST_KHR if sync_point_wait_list is
+  // NULL and num_sync_points_in_wait_list is > 0, or
+  // sync_point_wait_list is not NULL and num_sync_points_in_wait_list
+  // is 0, or if synchronization-point objects in sync_point_wait_list
+  // are not valid synchronization-points.
+  if (!sync_point_wait_list != !num_sync_points_in_wait_list)
+    throw error(CL_INVALID_SYNC_POINT_WAIT_LIST_KHR,"sync point wait list mismatch");
+  for (cl_uint idx = 0; idx < num_sync_points_in_wait_list; ++idx)
+    if (!xcb->is_valid_sync_point(sync_point_wait_list[idx]))
+      throw error(CL_INVALID_SYNC_POINT_WAIT_LIST_KHR,"invalid sync point in wait list");
+}
+
+} // command_buffer
+
+}} // detail,xocl
@@ -0,0 +1,29 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xocl_api_detail_command_buffer_h_
+#define xocl_api_detail_command_buffer_h_
+
+#include "xocl/config.h"
+#include "CL/cl_ext_xilinx.h"
+
+namespace xocl { namespace detail {
+
+namespace command_buffer {
+
+void
+validOrError(const cl_command_buffer_khr command_buffer);
+
+// Validate that command buffer is in recording state and that the
+// arguments common to all command recording functions are valid.
+void
+validRecordingOrError(const cl_command_buffer_khr command_buffer,
+                      const cl_command_queue command_queue,
+                      cl_uint num_sync_points_in_wait_list,
+                      const cl_sync_point_khr* sync_point_wait_list,
+                      const cl_mutable_command_khr* mutable_handle);
+
+} // command_buffer
+
+}} // detail,xocl
+
+#endif
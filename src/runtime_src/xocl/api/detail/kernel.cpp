@@ -19,6 +19,10 @@
 #include "xocl/core/device.h"
 #include "xocl/core/program.h"
 #include "xocl/core/error.h"
+#include "xocl/api/api.h"
+
+#include <algorithm>
+#include <limits>
 
 namespace xocl { namespace detail {
 
@@ -50,6 +54,59 @@ validArgsOrError(const cl_kernel kernel)
       throw xocl::error(CL_INVALID_KERNEL_ARGS,"Kernel arg '" + arg->get_name() + "' is not set");
 }
 
+std::array<size_t,3>
+default_local_work_size(const cl_device_id device, const cl_kernel kernel,
+                        cl_uint work_dim, const std::array<size_t,3>& gsize)
+{
+  static size_t device_max_wg_size = 0;
+  static size_t device_max_wi_sizes[3] = {0,0,0};
+  if (!device_max_wg_size)
+    api::clGetDeviceInfo(device,CL_DEVICE_MAX_WORK_GROUP_SIZE,sizeof(size_t),&device_max_wg_size,nullptr);
+  if (!device_max_wi_sizes[0])
+    api::clGetDeviceInfo(device,CL_DEVICE_MAX_WORK_ITEM_SIZES,sizeof(size_t)*3,&device_max_wi_sizes,nullptr);
+
+  auto max_wgs_range = xocl(kernel)->get_max_wg_size_range();
+  bool xcl_max_work_group_size_set =
+    std::any_of(max_wgs_range.begin(),max_wgs_range.end(),[](size_t sz) { return sz!=0; });
+  bool xcl_max_work_group_size_totalworkitemconstraint_set =
+    (max_wgs_range[0]!=0 && max_wgs_range[1]==0 && max_wgs_range[2]==0);
+
+  size_t max_wg_size = std::numeric_limits<size_t>::max(); // no total work items constraint
+  if (!xcl_max_work_group_size_set)
+    max_wg_size = device_max_wg_size;
+  else if (xcl_max_work_group_size_totalworkitemconstraint_set)
+    max_wg_size = max_wgs_range[0];
+
+  std::array<size_t,3> lsize = {1,1,1};
+  size_t best_wg_size = 1;
+  size_t total_size = gsize[0] * gsize[1] * gsize[2];
+  size_t dim_max[3] = {1, 1, 1};
+  for (cl_uint work_dim_it=0; work_dim_it < work_dim; ++work_dim_it) {
+    size_t m = (xcl_max_work_group_size_set && (!xcl_max_work_group_size_totalworkitemconstraint_set))
+      ? max_wgs_range[work_dim_it]
+      : device_max_wi_sizes[work_dim_it];
+    dim_max[work_dim_it] = (std::min)(m, gsize[work_dim_it]);
+  }
+  for (size_t z = 1; z <= dim_max[2]; ++z) {
+    if (gsize[2] % z) continue;
+    for (size_t y = 1; y <= dim_max[1]; ++y) {
+      if (gsize[1] % y) continue;
+      for (size_t x = 1; x <= dim_max[0]; ++x) {
+        if (gsize[0] % x) continue;
+        if ( (x*y*z > best_wg_size) && (x*y*z <= max_wg_size) &&
+             (x*y*z <= total_size) && !(total_size % (x*y*z)) ) {
+          lsize[0] = x;
+          lsize[1] = y;
+          lsize[2] = z;
+          best_wg_size = x*y*z;
+        }
+      }
+    }
+  }
+
+  return lsize;
+}
+
 } // kernel
 
 }} // detail,xocl
@@ -19,6 +19,7 @@
 
 #include "xocl/config.h"
 #include "CL/cl.h"
+#include <array>
 
 namespace xocl { namespace detail {
 
@@ -33,6 +34,14 @@ validArgsOrError(const cl_kernel kernel);
 void
 validOrError(const cl_device_id device, const cl_kernel kernel);
 
+// Local work size used when an NDRange is enqueued or recorded
+// without a local_work_size.  Picks the largest work group that
+// evenly divides the global work size within the limits of the
+// device and the kernel.
+std::array<size_t,3>
+default_local_work_size(const cl_device_id device, const cl_kernel kernel,
+                        cl_uint work_dim, const std::array<size_t,3>& global_work_size);
+
 }
 
 }} // detail,xocl
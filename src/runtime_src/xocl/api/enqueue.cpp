@@ -25,6 +25,7 @@
  */
 
 #include "enqueue.h"
+#include "xocl/core/command_buffer.h"
 #include "xocl/core/event.h"
 #include "xocl/core/command_queue.h"
 #include "xocl/core/device.h"
@@ -258,6 +259,18 @@ write_image(xocl::event* event,xocl::device* device,cl_mem image,
   }
 }
 
+static void
+execute_command_buffer(xocl::event* event,xocl::command_buffer* command_buffer)
+{
+  try {
+    event->set_status(CL_RUNNING);
+    command_buffer->execute();
+    event->set_status(CL_COMPLETE);
+  }
+  catch (const std::exception& ex) {
+    handle_device_exception(event,ex);
+  }
+}
 
 } // namespace
 
@@ -484,5 +497,23 @@ action_ndrange_execute()
   };
 }
 
+xocl::event::action_enqueue_type
+action_command_buffer(cl_command_buffer_khr command_buffer)
+{
+  throw_if_error();
+
+  // The action keeps the command buffer alive until the event
+  // is deleted, the command buffer may be released before it
+  // has executed.
+  xocl::ptr<xocl::command_buffer> cb(xocl::xocl(command_buffer));
+  return [cb = std::move(cb)](xocl::event* ev) {
+    XOCL_DEBUG(std::cout,"launching command buffer event(",ev->get_uid(),")\n");
+    auto command_queue = ev->get_command_queue();
+    auto device = command_queue->get_device();
+    auto xdevice = device->get_xdevice();
+    xdevice->schedule(execute_command_buffer,async_type::misc,ev,cb.get());
+  };
+}
+
 
 }}
@@ -27,6 +27,7 @@
 
 #include "xocl/core/object.h"
 #include "xocl/core/event.h"
+#include <CL/cl_ext_xilinx.h>
 #include <utility>
 
 namespace xocl { namespace enqueue {
@@ -74,6 +75,9 @@ action_migrate_memobjects(size_t num, const cl_mem* memobjs, cl_mem_migration_fl
 xocl::event::action_enqueue_type
 action_ndrange_execute();
 
+xocl::event::action_enqueue_type
+action_command_buffer(cl_command_buffer_khr command_buffer);
+
 template <typename F, typename ...Args>
 inline void
 set_event_action(xocl::event* event, F&& f, Args&&... args)
@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#include "command_buffer.h"
+#include "command_queue.h"
+#include "context.h"
+#include "debug.h"
+#include "device.h"
+#include "error.h"
+#include "execution_context.h"
+#include "kernel.h"
+#include "memory.h"
+
+#include "core/common/api/kernel_int.h"
+
+#include <algorithm>
+
+namespace xocl {
+
+command_buffer::
+command_buffer(command_queue* cq, flags_type flags)
+  : m_queue(cq)
+  , m_device(cq->get_device())
+  , m_flags(flags)
+{
+  static unsigned int count = 0;
+  m_uid = count++;
+
+  XOCL_DEBUGF("command_buffer::command_buffer(%d)\n",m_uid);
+}
+
+command_buffer::
+~command_buffer()
+{
+  XOCL_DEBUGF("command_buffer::~command_buffer(%d)\n",m_uid);
+}
+
+context*
+command_buffer::
+get_context() const
+{
+  return m_queue->get_context();
+}
+
+cl_command_buffer_state_khr
+command_buffer::
+get_state() const
+{
+  if (!m_finalized)
+    return CL_COMMAND_BUFFER_STATE_RECORDING_KHR;
+  if (m_pending)
+    return CL_COMMAND_BUFFER_STATE_PENDING_KHR;
+  return CL_COMMAND_BUFFER_STATE_EXECUTABLE_KHR;
+}
+
+command_buffer::sync_point_type
+command_buffer::
+record_ndrange(kernel* kernel, size_t work_dim,
+               const size_t* global_work_offset,
+               const size_t* global_work_size,
+               const size_t* local_work_size)
+{
+  if (m_finalized)
+    throw error(CL_INVALID_OPERATION,"command buffer is finalized");
+
+  // Argument buffers must exist on the device before the argument
+  // values are captured in the run objects.
+  for (auto& arg : kernel->get_xargument_range()) {
+    auto mem = arg->get_memory_object();
+    if (!mem)
+      continue;
+
+    mem->get_buffer_object(m_device);
+    auto itr = std::find_if(m_migrations.begin(), m_migrations.end(),
+                            [mem](const auto& m) { return m.mem == mem; });
+    if (itr != m_migrations.end())
+      continue;
+
+    bool transfer = !(mem->get_flags() & CL_MEM_WRITE_ONLY) && !mem->no_host_memory();
+    m_migrations.push_back({mem, transfer});
+  }
+
+  execution_context ctx(m_device, kernel, nullptr, work_dim,
+                        global_work_offset, global_work_size, local_work_size);
+  auto runs = ctx.get_workgroup_runs();
+  std::move(runs.begin(), runs.end(), std::back_inserter(m_runs));
+  m_kernels.emplace_back(kernel);
+
+  return ++m_sync_points;
+}
+
+command_buffer::sync_point_type
+command_buffer::
+record_barrier()
+{
+  if (m_finalized)
+    throw error(CL_INVALID_OPERATION,"command buffer is finalized");
+
+  return ++m_sync_points;
+}
+
+void
+command_buffer::
+finalize()
+{
+  if (m_finalized)
+    throw error(CL_INVALID_OPERATION,"command buffer is already finalized");
+
+  if (!m_runs.empty()) {
+    const auto& xkernel = m_kernels.front()->get_xrt_kernel(m_device);
+    m_runlist = xrt::runlist{xrt_core::kernel_int::get_hw_ctx(xkernel)};
+    for (auto& run : m_runs)
+      m_runlist.add(run);
+  }
+
+  m_finalized = true;
+}
+
+void
+command_buffer::
+migrate()
+{
+  for (auto& m : m_migrations) {
+    auto mem = m.mem.get();
+    if (mem->is_resident(m_device))
+      continue;
+
+    if (m.transfer)
+      m_device->migrate_buffer(mem,0);
+    else
+      mem->set_resident(m_device);
+  }
+}
+
+void
+command_buffer::
+set_pending()
+{
+  if (is_simultaneous_use()) {
+    ++m_pending;
+    return;
+  }
+
+  unsigned int idle = 0;
+  if (!m_pending.compare_exchange_strong(idle, 1))
+    throw error(CL_INVALID_OPERATION,"command buffer is pending");
+}
+
+void
+command_buffer::
+clear_pending()
+{
+  --m_pending;
+}
+
+void
+command_buffer::
+execute()
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+  XOCL_DEBUGF("command_buffer(%d) executing %zu runs\n",m_uid,m_runs.size());
+
+  migrate();
+
+  if (m_runs.empty())
+    return;
+
+  m_runlist.execute();
+  m_runlist.wait();
+}
+
+} // xocl
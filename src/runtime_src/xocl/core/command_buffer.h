@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#ifndef xocl_core_command_buffer_h_
+#define xocl_core_command_buffer_h_
+
+#include "xocl/config.h"
+#include "xocl/core/object.h"
+#include "xocl/core/refcount.h"
+
+#include "core/include/xrt/xrt_kernel.h"
+#include "core/include/xrt/experimental/xrt_kernel.h"
+
+#include <CL/cl_ext_xilinx.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace xocl {
+
+/**
+ * Class for cl_khr_command_buffer command buffers
+ *
+ * Kernel commands recorded into a command buffer are turned into run
+ * objects when recorded, one per work group, with all arguments set.
+ * The argument values are captured at time of recording as required
+ * by the extension.
+ *
+ * When the command buffer is finalized the run objects are added to
+ * an xrt::runlist and the memory objects that must be migrated prior
+ * to execution are computed.  Enqueuing a command buffer executes the
+ * runlist as one submission.
+ *
+ * Commands in a command buffer are executed in recording order, which
+ * trivially satisfies any sync point dependencies.
+ */
+class command_buffer : public refcount, public _cl_command_buffer_khr
+{
+public:
+  using sync_point_type = cl_sync_point_khr;
+  using flags_type = cl_command_buffer_flags_khr;
+
+  command_buffer(command_queue* cq, flags_type flags);
+  virtual ~command_buffer();
+
+  unsigned int
+  get_uid() const
+  {
+    return m_uid;
+  }
+
+  command_queue*
+  get_command_queue() const
+  {
+    return m_queue.get();
+  }
+
+  context*
+  get_context() const;
+
+  flags_type
+  get_flags() const
+  {
+    return m_flags;
+  }
+
+  bool
+  is_simultaneous_use() const
+  {
+    return m_flags & CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR;
+  }
+
+  cl_command_buffer_state_khr
+  get_state() const;
+
+  /**
+   * Check if sync point was returned by a command recorded in this
+   * command buffer
+   */
+  bool
+  is_valid_sync_point(sync_point_type sp) const
+  {
+    return sp > 0 && sp <= m_sync_points;
+  }
+
+  /**
+   * Record an NDRange kernel command
+   *
+   * Work sizes are 3 dimensional, the local work size must have been
+   * resolved by caller.
+   *
+   * @return
+   *   Sync point for the recorded command
+   */
+  sync_point_type
+  record_ndrange(kernel* kernel, size_t work_dim,
+                 const size_t* global_work_offset,
+                 const size_t* global_work_size,
+                 const size_t* local_work_size);
+
+  /**
+   * Record a barrier
+   *
+   * Commands are executed in order, so a barrier records nothing but
+   * a sync point.
+   */
+  sync_point_type
+  record_barrier();
+
+  /**
+   * Finalize the command buffer, no more commands can be recorded
+   */
+  void
+  finalize();
+
+  /**
+   * Mark the command buffer pending for one enqueue
+   *
+   * Called when the command buffer is enqueued.  The pending state
+   * lasts until the matching clear_pending(), which is called when
+   * the event of the enqueue completes or is aborted.
+   *
+   * @exception error
+   *   CL_INVALID_OPERATION if the command buffer is already pending
+   *   and was not created for simultaneous use
+   */
+  void
+  set_pending();
+
+  /**
+   * Clear the pending state of one enqueue
+   */
+  void
+  clear_pending();
+
+  /**
+   * Execute the command buffer and wait for completion
+   *
+   * Migrates memory objects not resident on the device and executes
+   * the runlist.  Called from a device worker thread.  Concurrent
+   * executions of a simultaneous use command buffer are serialized.
+   */
+  void
+  execute();
+
+private:
+  // Memory object used by recorded commands.  Migration is skipped
+  // for write only buffers, which are just marked resident.
+  struct migration
+  {
+    ptr<memory> mem;
+    bool transfer;
+  };
+
+  void
+  migrate();
+
+  unsigned int m_uid = 0;
+  ptr<command_queue> m_queue;
+  device* m_device;
+  flags_type m_flags;
+
+  std::vector<ptr<kernel>> m_kernels;
+  std::vector<xrt::run> m_runs;
+  std::vector<migration> m_migrations;
+  xrt::runlist m_runlist;
+
+  sync_point_type m_sync_points = 0;
+  bool m_finalized = false;
+  std::atomic<unsigned int> m_pending {0};
+
+  // Serialize runlist execution
+  std::mutex m_mutex;
+};
+
+} // xocl
+
+#endif
@@ -218,37 +218,49 @@ abort(cl_int status,bool fatal)
   if (status>=0)
     throw xocl::error(CL_INVALID_VALUE,"event::abort() called with non negative value");
 
+  // Callbacks of this event run with the abort status once aborted,
+  // retain such that the event remains alive while they run
+  ptr<xocl::event> retain(this);
+  bool aborted = false;
+
   // This function feels overly complicated
-  std::lock_guard<std::mutex> lk(m_mutex);
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
 
-  // Collect all events in current context
-  std::vector<event*> events;
-  for (auto q : m_context->get_queue_range())
-    range_copy(q->get_event_range(),std::back_inserter(events));
-
-  // Abort the chain of events
-  std::vector<event*> aborts(1,this);
-  while (aborts.size()) {
-    auto abort_ev = aborts.back();
-    aborts.pop_back();
-    XOCL_DEBUG(std::cout,"event(",m_uid,") [",to_string(m_status),"->",to_string(status),"]\n");
-
-    // Only abort queued events unless fatal abort
-    if (abort_ev==this && (fatal || abort_ev->m_status==CL_QUEUED)) {
-      abort_ev->m_status = status;  // abort ev
-      abort_ev->queue_abort(fatal); // remove from queue if any
-      m_event_complete.notify_all();
-    }
-    else if (abort_ev!=this) {
-      // recursively abort event that depends on this
-      abort_ev->abort(status,fatal);
+    // Collect all events in current context
+    std::vector<event*> events;
+    for (auto q : m_context->get_queue_range())
+      range_copy(q->get_event_range(),std::back_inserter(events));
+
+    // Abort the chain of events
+    std::vector<event*> aborts(1,this);
+    while (aborts.size()) {
+      auto abort_ev = aborts.back();
+      aborts.pop_back();
+      XOCL_DEBUG(std::cout,"event(",m_uid,") [",to_string(m_status),"->",to_string(status),"]\n");
+
+      // Only abort queued events unless fatal abort
+      if (abort_ev==this && (fatal || abort_ev->m_status==CL_QUEUED)) {
+        abort_ev->m_status = status;  // abort ev
+        abort_ev->queue_abort(fatal); // remove from queue if any
+        m_event_complete.notify_all();
+        aborted = true;
+      }
+      else if (abort_ev!=this) {
+        // recursively abort event that depends on this
+        abort_ev->abort(status,fatal);
+      }
+
+      for (auto ev : events) {
+        if (ev->waits_on(abort_ev))
+          aborts.push_back(ev);
+      }
     }
+  } // lk
 
-    for (auto ev : events) {
-      if (ev->waits_on(abort_ev))
-        aborts.push_back(ev);
-    }
-  }
+  // Callbacks cannot run while holding the lock
+  if (aborted)
+    run_callbacks(status);
 
   return true;
 }
@@ -380,6 +380,24 @@ execute()
   return m_done;
 }
 
+std::vector<xrt::run>
+execution_context::
+get_workgroup_runs()
+{
+  std::lock_guard<std::mutex> lk(m_mutex);
+
+  std::vector<xrt::run> runs;
+  runs.reserve(get_num_work_groups());
+  while (!m_done) {
+    auto run = xrt_core::kernel_int::clone(m_run);
+    set_rtinfo_args(run);
+    update_work();
+    runs.push_back(std::move(run));
+  }
+
+  return runs;
+}
+
 static void
 run_done(const void* key, ert_cmd_state state, void* data)
 {
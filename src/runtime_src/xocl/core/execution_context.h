@@ -224,6 +224,15 @@ public:
   // soon as an event changes state to CL_SUBMITTED.
   bool
   execute();
+
+  // Create one run object per work group with all arguments set.
+  //
+  // This consumes the work of the context without starting any run
+  // objects.  Used by command buffers to record the NDRange once and
+  // replay the runs any number of times.  The context can be
+  // constructed without an event for this purpose.
+  std::vector<xrt::run>
+  get_workgroup_runs();
 };
 
 // Callback function type for kernel command callbacks
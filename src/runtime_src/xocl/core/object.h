@@ -27,6 +27,7 @@ class sampler;
 class memory;
 class stream;
 class stream_mem;
+class command_buffer;
 
 // Base class for all CL API object types
 template <typename XOCLTYPE, typename CLTYPE>
@@ -156,5 +157,6 @@ struct _cl_kernel :        public xocl::object<xocl::kernel,       _cl_kernel> {
 struct _cl_mem :           public xocl::object<xocl::memory,       _cl_mem> {};
 struct _cl_stream :        public xocl::object<xocl::stream,       _cl_stream> {};
 struct _cl_stream_mem :    public xocl::object<xocl::stream_mem,   _cl_stream_mem> {};
+struct _cl_command_buffer_khr : public xocl::object<xocl::command_buffer, _cl_command_buffer_khr> {};
 
 #endif
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure resolution of pointers to hip memory objects with many live
+// allocations and concurrent lookups from multiple threads.
+//
+// Lookups are done with hipHostGetDevicePointer on interior pointers
+// of host memory allocations:
+//
+//  % addr-lookup [allocations] [lookups per thread]
+
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "hip/hip_runtime_api.h"
+
+#include "common.h"
+
+namespace {
+
+static constexpr size_t allocation_size = 4096;
+static constexpr unsigned int max_threads = 16;
+
+int
+mainworker(size_t allocations, size_t lookups)
+{
+  xrt_hip_test_common::hip_test_device hdevice;
+
+  std::vector<void *> buffers(allocations, nullptr);
+  for (auto &buffer : buffers)
+    xrt_hip_test_common::test_hip_check(hipHostMalloc(&buffer, allocation_size, hipHostMallocMapped));
+
+  for (unsigned int threads = 1; threads <= max_threads; threads *= 2) {
+    std::atomic<size_t> failures {0};
+    std::vector<std::thread> workers;
+    xrt_hip_test_common::hip_test_timer timer;
+    for (unsigned int t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        // stride through allocations at a per thread starting point
+        size_t idx = t * (allocations / threads);
+        for (size_t i = 0; i < lookups; ++i, idx = (idx + 7919) % allocations) {
+          auto ptr = static_cast<char *>(buffers[idx]) + (i % allocation_size);
+          void *device_ptr = nullptr;
+          if (hipHostGetDevicePointer(&device_ptr, ptr, 0) != hipSuccess || !device_ptr)
+            ++failures;
+        }
+      });
+    }
+    for (auto &worker : workers)
+      worker.join();
+    auto delayd = timer.stop();
+
+    if (failures)
+      throw std::runtime_error(std::to_string(failures) + " lookups failed");
+
+    std::cout << "threads: " << threads << ", allocations: " << allocations
+              << ", " << threads * lookups << " lookups in " << delayd << " us ("
+              << static_cast<double>(delayd) * 1000 / (threads * lookups) << " ns per lookup, "
+              << static_cast<double>(threads * lookups) / std::max<uint64_t>(delayd, 1) << " lookups per us)" << std::endl;
+  }
+
+  for (auto buffer : buffers)
+    xrt_hip_test_common::test_hip_check(hipHostFree(buffer));
+
+  return 0;
+}
+}
+
+int
+main(int argc, char *argv[])
+{
+  try {
+    size_t allocations = (argc > 1) ? std::stoul(argv[1]) : 10000;
+    size_t lookups = (argc > 2) ? std::stoul(argv[2]) : 1000000;
+    mainworker(allocations, lookups);
+    std::cout << "PASSED TEST" << std::endl;
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    std::cout << "FAILED TEST" << std::endl;
+    return 1;
+  }
+  return 0;
+}
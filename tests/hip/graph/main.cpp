@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Compare host cost of launching a sequence of kernels eagerly with
+// hipModuleLaunchKernel against replaying the same sequence captured
+// into a graph with hipGraphLaunch.
+//
+// Uses the nop kernel of vadd-stream (nop.co):
+//
+//  % graph [nop.co] [kernels per sequence]
+//
+// Use the noop shim (XCL_EMULATION_MODE=noop) to measure host side
+// overhead only.
+
+#include <array>
+#include <iostream>
+#include <string>
+
+#include "hip/hip_runtime_api.h"
+
+#include "common.h"
+
+namespace {
+
+static constexpr char const *nop_kernel_name = "mynop";
+static constexpr int vector_length = 1024;
+static constexpr int repeat_loop = 1000;
+
+void
+launch_sequence(hipFunction_t function, hipStream_t stream, std::array<void *, 3> &args, int kernels)
+{
+  for (int k = 0; k < kernels; k++)
+    xrt_hip_test_common::test_hip_check(hipModuleLaunchKernel(function, 1, 1, 1, 1, 1, 1,
+                                                              0, stream, args.data(), nullptr), nop_kernel_name);
+}
+
+// Memory pool operations cannot be captured, the capture is invalidated
+void
+capture_mem_pool_op(hipStream_t stream)
+{
+  xrt_hip_test_common::test_hip_check(hipStreamBeginCapture(stream, hipStreamCaptureModeGlobal));
+
+  void *ptr = nullptr;
+  if (hipMallocAsync(&ptr, vector_length * sizeof(float), stream) != hipErrorStreamCaptureUnsupported)
+    throw std::runtime_error("hipMallocAsync succeeded during capture");
+
+  hipStreamCaptureStatus status = hipStreamCaptureStatusNone;
+  xrt_hip_test_common::test_hip_check(hipStreamIsCapturing(stream, &status));
+  if (status != hipStreamCaptureStatusInvalidated)
+    throw std::runtime_error("capture is not invalidated by hipMallocAsync");
+
+  hipGraph_t graph = nullptr;
+  if (hipStreamEndCapture(stream, &graph) != hipErrorStreamCaptureInvalidated)
+    throw std::runtime_error("hipStreamEndCapture succeeded for invalidated capture");
+}
+
+int
+mainworker(const char *kernel_filename, int kernels)
+{
+  xrt_hip_test_common::hip_test_device hdevice;
+  hipFunction_t function = hdevice.get_function(kernel_filename, nop_kernel_name);
+
+  hipStream_t stream = nullptr;
+  xrt_hip_test_common::test_hip_check(hipStreamCreateWithFlags(&stream, hipStreamNonBlocking));
+
+  xrt_hip_test_common::hip_test_device_bo<float> device_a(vector_length);
+  xrt_hip_test_common::hip_test_device_bo<float> device_b(vector_length);
+  xrt_hip_test_common::hip_test_device_bo<float> device_c(vector_length);
+  std::array<void *, 3> args = {&device_a.get(), &device_b.get(), &device_c.get()};
+
+  // Eager launch of kernel sequence
+  xrt_hip_test_common::hip_test_timer timer;
+  for (int i = 0; i < repeat_loop; i++) {
+    launch_sequence(function, stream, args, kernels);
+    xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream));
+  }
+  auto eager = timer.stop();
+
+  // Capture the kernel sequence into a graph
+  hipStreamCaptureStatus status = hipStreamCaptureStatusNone;
+  xrt_hip_test_common::test_hip_check(hipStreamBeginCapture(stream, hipStreamCaptureModeGlobal));
+  xrt_hip_test_common::test_hip_check(hipStreamIsCapturing(stream, &status));
+  if (status != hipStreamCaptureStatusActive)
+    throw std::runtime_error("stream is not capturing");
+
+  launch_sequence(function, stream, args, kernels);
+
+  // Synchronizing a capturing stream is not allowed
+  if (hipStreamSynchronize(stream) != hipErrorStreamCaptureUnsupported)
+    throw std::runtime_error("hipStreamSynchronize succeeded during capture");
+
+  hipGraph_t graph = nullptr;
+  xrt_hip_test_common::test_hip_check(hipStreamEndCapture(stream, &graph));
+  xrt_hip_test_common::test_hip_check(hipStreamIsCapturing(stream, &status));
+  if (status != hipStreamCaptureStatusNone)
+    throw std::runtime_error("stream is still capturing");
+
+  hipGraphExec_t graph_exec = nullptr;
+  xrt_hip_test_common::test_hip_check(hipGraphInstantiate(&graph_exec, graph, nullptr, nullptr, 0));
+
+  // Replay of captured kernel sequence
+  timer.reset();
+  for (int i = 0; i < repeat_loop; i++) {
+    xrt_hip_test_common::test_hip_check(hipGraphLaunch(graph_exec, stream));
+    xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream));
+  }
+  auto replay = timer.stop();
+
+  xrt_hip_test_common::test_hip_check(hipGraphExecDestroy(graph_exec));
+  xrt_hip_test_common::test_hip_check(hipGraphDestroy(graph));
+
+  capture_mem_pool_op(stream);
+  xrt_hip_test_common::test_hip_check(hipStreamDestroy(stream));
+
+  std::cout << '(' << repeat_loop << " loops, " << kernels << " kernels per loop)" << std::endl;
+  std::cout << "hipModuleLaunchKernel: " << eager << " us, "
+            << static_cast<double>(eager)/(repeat_loop * kernels) << " us per kernel" << std::endl;
+  std::cout << "hipGraphLaunch:        " << replay << " us, "
+            << static_cast<double>(replay)/(repeat_loop * kernels) << " us per kernel" << std::endl;
+  return 0;
+}
+}
+
+int
+main(int argc, char *argv[])
+{
+  try {
+    const char *kernel_filename = (argc > 1) ? argv[1] : "nop.co";
+    int kernels = (argc > 2) ? std::stoi(argv[2]) : 16;
+    mainworker(kernel_filename, kernels);
+    std::cout << "PASSED TEST" << std::endl;
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    std::cout << "FAILED TEST" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,109 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure kernel launch cost with large host memory arguments of
+// which a small range is modified between launches.
+//
+// Host memory tracking mode is resolved once per process, so each
+// mode is run as a separate invocation:
+//
+//  % host-mem-sync none [nop.co]
+//  % host-mem-sync explicit [nop.co]
+//  % host-mem-sync mprotect [nop.co]
+//
+// Uses the nop kernel of vadd-stream (nop.co).
+
+#include <array>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "hip/hip_runtime_api.h"
+
+#include "common.h"
+
+namespace {
+
+static constexpr char const *nop_kernel_name = "mynop";
+static constexpr size_t buffer_size = 64 * xrt_hip_test_common::mega_byte;
+static constexpr size_t modified_size = 4096;
+static constexpr int repeat_loop = 100;
+
+// Write an xrt.ini for the requested mode and point XRT at it. This
+// must be done before the first HIP API call.
+void
+configure(const std::string &mode)
+{
+  if (mode != "none" && mode != "explicit" && mode != "mprotect")
+    throw std::runtime_error("Unknown mode: " + mode);
+
+  auto ini = std::filesystem::temp_directory_path() / "host_mem_sync.ini";
+  std::ofstream ostr(ini);
+  ostr << "[Runtime]\n"
+       << "hip_host_mem_tracking=" << mode << "\n";
+
+#ifdef _WIN32
+  _putenv_s("XRT_INI_PATH", ini.string().c_str());
+#else
+  setenv("XRT_INI_PATH", ini.string().c_str(), 1);
+#endif
+}
+
+int
+mainworker(const std::string &mode, const char *kernel_filename)
+{
+  configure(mode);
+
+  xrt_hip_test_common::hip_test_device hdevice;
+  hipFunction_t function = hdevice.get_function(kernel_filename, nop_kernel_name);
+
+  hipStream_t stream = nullptr;
+  xrt_hip_test_common::test_hip_check(hipStreamCreateWithFlags(&stream, hipStreamNonBlocking));
+
+  xrt_hip_test_common::hip_test_host_bo<char> host_a(buffer_size, hipHostMallocDefault);
+  xrt_hip_test_common::hip_test_host_bo<char> host_b(buffer_size, hipHostMallocDefault);
+  xrt_hip_test_common::hip_test_host_bo<char> host_c(buffer_size, hipHostMallocDefault);
+  std::array<void *, 3> args = {&host_a.get(), &host_b.get(), &host_c.get()};
+  std::vector<char> update(modified_size, 'x');
+
+  xrt_hip_test_common::hip_test_timer timer;
+  for (int i = 0; i < repeat_loop; i++) {
+    // modify a small range of the inputs between launches
+    auto offset = (i * modified_size) % buffer_size;
+    xrt_hip_test_common::test_hip_check(hipMemcpy(host_b.get() + offset, update.data(), modified_size, hipMemcpyHostToHost));
+    xrt_hip_test_common::test_hip_check(hipMemcpy(host_c.get() + offset, update.data(), modified_size, hipMemcpyHostToHost));
+
+    xrt_hip_test_common::test_hip_check(hipModuleLaunchKernel(function, 1, 1, 1, 1, 1, 1,
+                                                              0, stream, args.data(), nullptr), nop_kernel_name);
+    xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream));
+  }
+  auto delayd = timer.stop();
+
+  xrt_hip_test_common::test_hip_check(hipStreamDestroy(stream));
+
+  std::cout << "mode(" << mode << "), 3 x " << buffer_size / xrt_hip_test_common::mega_byte << " MB host buffers, "
+            << modified_size << " bytes modified per launch" << std::endl;
+  std::cout << '(' << repeat_loop << " loops, " << delayd << " us, "
+            << static_cast<double>(delayd) / repeat_loop << " us per launch)" << std::endl;
+  return 0;
+}
+}
+
+int
+main(int argc, char *argv[])
+{
+  try {
+    std::string mode = (argc > 1) ? argv[1] : "none";
+    const char *kernel_filename = (argc > 2) ? argv[2] : "nop.co";
+    mainworker(mode, kernel_filename);
+    std::cout << "PASSED TEST" << std::endl;
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    std::cout << "FAILED TEST" << std::endl;
+    return 1;
+  }
+  return 0;
+}
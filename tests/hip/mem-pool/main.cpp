@@ -0,0 +1,188 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure stream ordered memory pool allocation throughput and
+// fragmentation, and check reuse of freed memory across streams that
+// follows event dependencies.  Check that memory pending on a free in
+// one stream is not reused by another stream after the freeing stream
+// reused part of it.
+//
+//  % mem-pool [operations]
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "hip/hip_runtime_api.h"
+
+#include "common.h"
+
+namespace {
+
+static constexpr size_t min_alloc_size = 4 * 1024;
+static constexpr size_t max_alloc_size = 4 * xrt_hip_test_common::mega_byte;
+static constexpr size_t live_allocations = 64;
+
+// large enough that two allocations cannot share a pool block
+static constexpr size_t reuse_alloc_size = 768 * xrt_hip_test_common::mega_byte;
+
+// pool block size, see MEMORY_POOL_BLOCK_SIZE_NPU
+static constexpr size_t pool_block_size = 1024 * xrt_hip_test_common::mega_byte;
+
+uint64_t
+get_pool_attribute(hipMemPool_t pool, hipMemPoolAttr attr)
+{
+  uint64_t value = 0;
+  xrt_hip_test_common::test_hip_check(hipMemPoolGetAttribute(pool, attr, &value));
+  return value;
+}
+
+// Allocate and free in one stream, a random working set is kept live
+void
+alloc_free_throughput(hipMemPool_t pool, hipStream_t stream, size_t operations)
+{
+  std::mt19937_64 rng(42);
+  std::uniform_int_distribution<size_t> size_dist(min_alloc_size, max_alloc_size);
+  std::uniform_int_distribution<size_t> slot_dist(0, live_allocations - 1);
+  std::vector<void *> live(live_allocations, nullptr);
+
+  xrt_hip_test_common::hip_test_timer timer;
+  for (size_t i = 0; i < operations; ++i) {
+    auto &ptr = live[slot_dist(rng)];
+    if (ptr)
+      xrt_hip_test_common::test_hip_check(hipFreeAsync(ptr, stream));
+    xrt_hip_test_common::test_hip_check(hipMallocFromPoolAsync(&ptr, size_dist(rng), pool, stream));
+  }
+  for (auto ptr : live)
+    if (ptr)
+      xrt_hip_test_common::test_hip_check(hipFreeAsync(ptr, stream));
+  auto delayd = timer.stop();
+
+  auto used_high = get_pool_attribute(pool, hipMemPoolAttrUsedMemHigh);
+  auto reserved_high = get_pool_attribute(pool, hipMemPoolAttrReservedMemHigh);
+  xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream));
+
+  std::cout << operations << " alloc/free pairs in " << delayd << " us ("
+            << static_cast<double>(delayd) / operations << " us per pair)" << std::endl;
+  std::cout << "used high: " << used_high / xrt_hip_test_common::mega_byte << " MB, reserved high: "
+            << reserved_high / xrt_hip_test_common::mega_byte << " MB, fragmentation overhead: "
+            << (used_high ? 100.0 * (reserved_high - std::min(reserved_high, used_high)) / used_high : 0.0)
+            << "%" << std::endl;
+}
+
+// Memory freed in one stream is reused by another stream that waits on
+// an event recorded after the free, without growing the pool
+void
+cross_stream_reuse(hipMemPool_t pool, hipStream_t stream_a, hipStream_t stream_b)
+{
+  hipEvent_t freed = nullptr;
+  xrt_hip_test_common::test_hip_check(hipEventCreate(&freed));
+
+  void *ptr_a = nullptr;
+  xrt_hip_test_common::test_hip_check(hipMallocFromPoolAsync(&ptr_a, reuse_alloc_size, pool, stream_a));
+  xrt_hip_test_common::test_hip_check(hipFreeAsync(ptr_a, stream_a));
+  xrt_hip_test_common::test_hip_check(hipEventRecord(freed, stream_a));
+  auto reserved = get_pool_attribute(pool, hipMemPoolAttrReservedMemCurrent);
+
+  void *ptr_b = nullptr;
+  xrt_hip_test_common::test_hip_check(hipStreamWaitEvent(stream_b, freed, 0));
+  xrt_hip_test_common::test_hip_check(hipMallocFromPoolAsync(&ptr_b, reuse_alloc_size, pool, stream_b));
+  xrt_hip_test_common::test_hip_check(hipFreeAsync(ptr_b, stream_b));
+  xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream_b));
+  xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream_a));
+
+  if (get_pool_attribute(pool, hipMemPoolAttrReservedMemCurrent) > reserved)
+    throw std::runtime_error("memory freed in stream order was not reused across streams");
+
+  xrt_hip_test_common::test_hip_check(hipEventDestroy(freed));
+  std::cout << "cross stream reuse: ok" << std::endl;
+}
+
+// A block freed in stream a is pending on the copy preceding the
+// free.  Stream a reuses the head of the block, the tail stays pending
+// such that stream b, which does not synchronize with stream a, gets a
+// new block rather than the tail
+void
+pending_split(hipStream_t stream_a, hipStream_t stream_b)
+{
+  hipMemPool_t pool = nullptr;
+  hipMemPoolProps props {};
+  xrt_hip_test_common::test_hip_check(hipMemPoolCreate(&pool, &props));
+
+  // reuse only through event dependencies, there are none
+  int disable = 0;
+  xrt_hip_test_common::test_hip_check(hipMemPoolSetAttribute(pool, hipMemPoolReuseAllowOpportunistic, &disable));
+  xrt_hip_test_common::test_hip_check(hipMemPoolSetAttribute(pool, hipMemPoolReuseAllowInternalDependencies, &disable));
+
+  // the copy is the fence of the free, it completes when stream a is
+  // synchronized
+  std::vector<char> host(min_alloc_size);
+  void *block = nullptr;
+  xrt_hip_test_common::test_hip_check(hipMallocFromPoolAsync(&block, pool_block_size, pool, stream_a));
+  xrt_hip_test_common::test_hip_check(hipMemcpyAsync(block, host.data(), host.size(), hipMemcpyHostToDevice, stream_a));
+  xrt_hip_test_common::test_hip_check(hipFreeAsync(block, stream_a));
+
+  void *head = nullptr;
+  xrt_hip_test_common::test_hip_check(hipMallocFromPoolAsync(&head, pool_block_size - reuse_alloc_size, pool, stream_a));
+  if (head != block)
+    throw std::runtime_error("pending block was not reused by the freeing stream");
+  auto reserved = get_pool_attribute(pool, hipMemPoolAttrReservedMemCurrent);
+
+  void *tail = nullptr;
+  xrt_hip_test_common::test_hip_check(hipMallocFromPoolAsync(&tail, reuse_alloc_size, pool, stream_b));
+  auto tail_addr = reinterpret_cast<uintptr_t>(tail);
+  auto block_addr = reinterpret_cast<uintptr_t>(block);
+  if ((tail_addr >= block_addr && tail_addr < block_addr + pool_block_size)
+      || get_pool_attribute(pool, hipMemPoolAttrReservedMemCurrent) == reserved)
+    throw std::runtime_error("pending tail of a split slot was reused by another stream");
+
+  xrt_hip_test_common::test_hip_check(hipFreeAsync(tail, stream_b));
+  xrt_hip_test_common::test_hip_check(hipFreeAsync(head, stream_a));
+  xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream_b));
+  xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream_a));
+  xrt_hip_test_common::test_hip_check(hipMemPoolDestroy(pool));
+  std::cout << "pending split: ok" << std::endl;
+}
+
+int
+mainworker(size_t operations)
+{
+  xrt_hip_test_common::hip_test_device hdevice;
+
+  hipMemPool_t pool = nullptr;
+  hipMemPoolProps props {};
+  xrt_hip_test_common::test_hip_check(hipMemPoolCreate(&pool, &props));
+
+  hipStream_t stream_a = nullptr;
+  hipStream_t stream_b = nullptr;
+  xrt_hip_test_common::test_hip_check(hipStreamCreateWithFlags(&stream_a, hipStreamNonBlocking));
+  xrt_hip_test_common::test_hip_check(hipStreamCreateWithFlags(&stream_b, hipStreamNonBlocking));
+
+  alloc_free_throughput(pool, stream_a, operations);
+  cross_stream_reuse(pool, stream_a, stream_b);
+  pending_split(stream_a, stream_b);
+
+  xrt_hip_test_common::test_hip_check(hipStreamDestroy(stream_b));
+  xrt_hip_test_common::test_hip_check(hipStreamDestroy(stream_a));
+  xrt_hip_test_common::test_hip_check(hipMemPoolDestroy(pool));
+  return 0;
+}
+}
+
+int
+main(int argc, char *argv[])
+{
+  try {
+    size_t operations = (argc > 1) ? std::stoul(argv[1]) : 100000;
+    mainworker(operations);
+    std::cout << "PASSED TEST" << std::endl;
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    std::cout << "FAILED TEST" << std::endl;
+    return 1;
+  }
+  return 0;
+}
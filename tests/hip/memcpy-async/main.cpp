@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure throughput and latency of hipMemcpyAsync host to device and
+// device to host copies for sizes from 4 KB to 64 MB.
+//
+//  % memcpy-async [copies per size]
+//
+// Throughput enqueues all copies before synchronizing the stream,
+// latency synchronizes the stream after every copy.
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "hip/hip_runtime_api.h"
+
+#include "common.h"
+
+namespace {
+
+static constexpr size_t min_copy_size = 4 * 1024;
+static constexpr size_t max_copy_size = 64 * xrt_hip_test_common::mega_byte;
+static constexpr size_t max_copy_bytes = 256 * xrt_hip_test_common::mega_byte;
+
+void
+run_copies(const char *what, hipMemcpyKind kind, void *dst, const void *src,
+           size_t size, int copies, hipStream_t stream)
+{
+  const auto msmulti = static_cast<double>(xrt_hip_test_common::hip_test_timer::unit());
+
+  // consecutive copies target consecutive chunks of device buffer
+  auto chunks = max_copy_size / size;
+  auto device_side = [&](int i) { return (i % chunks) * size; };
+
+  xrt_hip_test_common::hip_test_timer timer;
+  for (int i = 0; i < copies; i++) {
+    auto offset = device_side(i);
+    if (kind == hipMemcpyHostToDevice)
+      xrt_hip_test_common::test_hip_check(hipMemcpyAsync(static_cast<char *>(dst) + offset, src, size, kind, stream), what);
+    else
+      xrt_hip_test_common::test_hip_check(hipMemcpyAsync(dst, static_cast<const char *>(src) + offset, size, kind, stream), what);
+  }
+  xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream));
+  auto throughput = timer.stop();
+
+  timer.reset();
+  for (int i = 0; i < copies; i++) {
+    auto offset = device_side(i);
+    if (kind == hipMemcpyHostToDevice)
+      xrt_hip_test_common::test_hip_check(hipMemcpyAsync(static_cast<char *>(dst) + offset, src, size, kind, stream), what);
+    else
+      xrt_hip_test_common::test_hip_check(hipMemcpyAsync(dst, static_cast<const char *>(src) + offset, size, kind, stream), what);
+    xrt_hip_test_common::test_hip_check(hipStreamSynchronize(stream));
+  }
+  auto latency = timer.stop();
+
+  auto bytes = static_cast<double>(size) * copies;
+  std::cout << what << ' ' << size / 1024 << " KB: "
+            << bytes * msmulti / (static_cast<double>(throughput) * xrt_hip_test_common::mega_byte) << " MB/s, "
+            << (copies * msmulti) / static_cast<double>(throughput) << " copies/s, "
+            << static_cast<double>(latency) / copies << " us average latency" << std::endl;
+}
+
+int
+mainworker(int max_copies)
+{
+  xrt_hip_test_common::hip_test_device hdevice;
+  hdevice.show_info(std::cout);
+
+  hipStream_t stream = nullptr;
+  xrt_hip_test_common::test_hip_check(hipStreamCreateWithFlags(&stream, hipStreamNonBlocking));
+
+  xrt_hip_test_common::hip_test_device_bo<char> device_buf(max_copy_size);
+  std::vector<char> host_buf(max_copy_size, 'x');
+
+  for (size_t size = min_copy_size; size <= max_copy_size; size *= 4) {
+    // limit total bytes copied per size
+    auto copies = static_cast<int>(std::min<size_t>(max_copies, std::max<size_t>(1, max_copy_bytes / size)));
+    run_copies("H2D", hipMemcpyHostToDevice, device_buf.get(), host_buf.data(), size, copies, stream);
+    run_copies("D2H", hipMemcpyDeviceToHost, host_buf.data(), device_buf.get(), size, copies, stream);
+  }
+
+  xrt_hip_test_common::test_hip_check(hipStreamDestroy(stream));
+  return 0;
+}
+}
+
+int
+main(int argc, char *argv[])
+{
+  try {
+    int copies = (argc > 1) ? std::stoi(argv[1]) : 1000;
+    mainworker(copies);
+    std::cout << "PASSED TEST" << std::endl;
+  } catch (std::exception &e) {
+    std::cerr << e.what() << std::endl;
+    std::cout << "FAILED TEST" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,121 @@
+#!/usr/bin/python3
+
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Copyright (C) 2024 Advanced Micro Devices, Inc
+#
+# Multi-threaded throughput of pyxrt.  Blocking pyxrt calls release
+# the GIL, so runs and buffer transfers issued from separate Python
+# threads overlap and throughput scales with the number of threads.
+#
+
+import faulthandler
+import os
+import sys
+import re
+import threading
+import time
+
+import numpy
+
+# found in PYTHONPATH
+import pyxrt
+
+# utils_binding.py
+sys.path.append('../')
+from utils_binding import *
+
+ITERATIONS = 2000
+THREADS = [1, 2, 4, 8]
+
+def worker(hello, bo, iterations):
+    run = pyxrt.run(hello)
+    run.set_arg(0, bo)
+    for i in range(iterations):
+        bo.sync(pyxrt.xclBOSyncDirection.XCL_BO_SYNC_BO_TO_DEVICE, bo.size(), 0)
+        run.start()
+        run.wait()
+        bo.sync(pyxrt.xclBOSyncDirection.XCL_BO_SYNC_BO_FROM_DEVICE, bo.size(), 0)
+
+def measure(d, hello, size, nthreads):
+    bos = [pyxrt.bo(d, size, pyxrt.bo.normal, hello.group_id(0)) for i in range(nthreads)]
+    threads = [threading.Thread(target=worker, args=(hello, bo, ITERATIONS)) for bo in bos]
+    start = time.perf_counter()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    elapsed = time.perf_counter() - start
+    return nthreads * ITERATIONS / elapsed
+
+def drop_queue():
+    # Destroying a queue joins its worker, which must be able to take
+    # the GIL to finish a running Python task.  Exit with a traceback
+    # rather than hang if the queue is destroyed with the GIL held.
+    faulthandler.dump_traceback_later(30, exit=True)
+    started = threading.Event()
+    def task():
+        started.set()
+        time.sleep(0.1)
+    q = pyxrt.queue()
+    q.enqueue(task)
+    q.enqueue(task)
+    started.wait()
+    del q
+    faulthandler.cancel_dump_traceback_later()
+
+def runKernel(opt):
+    d = pyxrt.device(opt.index)
+    xbin = pyxrt.xclbin(opt.bitstreamFile)
+    uuid = d.load_xclbin(xbin)
+
+    kernellist = xbin.get_kernels()
+    rule = re.compile("hello*")
+    kernel = list(filter(lambda val: rule.match(val.get_name()), kernellist))[0]
+    hello = pyxrt.kernel(d, uuid, kernel.get_name(), pyxrt.kernel.shared)
+
+    # Zero-copy views of the mapped buffer object
+    bo = pyxrt.bo(d, opt.DATA_SIZE, pyxrt.bo.normal, hello.group_id(0))
+    view = numpy.frombuffer(bo, dtype=numpy.uint8)
+    view[:] = 0
+    assert(view.ctypes.data == numpy.asarray(bo.map()).ctypes.data), "Buffer view is not zero-copy"
+    if hasattr(numpy, "from_dlpack"):
+        dlview = numpy.from_dlpack(bo)
+        assert(dlview.ctypes.data == view.ctypes.data), "DLPack view is not zero-copy"
+
+    drop_queue()
+
+    baseline = None
+    for nthreads in THREADS:
+        rate = measure(d, hello, opt.DATA_SIZE, nthreads)
+        baseline = baseline or rate
+        print("threads: %2d runs/s: %10.1f scaling: %5.2fx" % (nthreads, rate, rate / baseline))
+
+def main(args):
+    opt = Options()
+    b_file = "verify.xclbin"
+    Options.getOptions(opt, args, b_file)
+
+    try:
+        runKernel(opt)
+        print("PASSED TEST")
+        return 0
+
+    except OSError as o:
+        print(o)
+        print("FAILED TEST")
+        return -o.errno
+
+    except AssertionError as a:
+        print(a)
+        print("FAILED TEST")
+        return -1
+    except Exception as e:
+        print(e)
+        print("FAILED TEST")
+        return -1
+
+if __name__ == "__main__":
+    result = main(sys.argv)
+    sys.exit(result)
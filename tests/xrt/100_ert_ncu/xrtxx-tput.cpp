@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+////////////////////////////////////////////////////////////////
+// Command throughput benchmark.  The test keeps a fixed number of
+// commands in flight across the specified CUs and reports the number
+// of commands completed per second.  The kernel does little work such
+// that the measurement is bounded by command scheduling.  Run with
+// XCL_EMULATION_MODE=sw_emu and kds_sw_emu=true in xrt.ini to
+// measure the sw_emu scheduler.
+////////////////////////////////////////////////////////////////
+
+#include "xrt.h"
+#include "xclbin.h"
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#ifdef _WIN32
+# pragma warning ( disable : 4267 )
+#endif
+
+static constexpr size_t ELEMENTS = 16;
+static constexpr size_t ARRAY_SIZE = 8;
+static constexpr size_t MAXCUS = 8;
+
+static size_t compute_units = MAXCUS;
+
+static void
+usage()
+{
+  std::cout << "usage: %s [options] \n\n";
+  std::cout << "  -k <bitstream>\n";
+  std::cout << "  -d <device_index>\n";
+  std::cout << "";
+  std::cout << "  [--jobs <number>]: number of commands in flight (default: 64)\n";
+  std::cout << "  [--cus <number>]: number of cus to use (default: 8) (max: 8)\n";
+  std::cout << "  [--runs <number>]: total number of commands to execute (default: 10000)\n";
+  std::cout << "";
+  std::cout << "* Program keeps specified number of jobs in flight until the total\n";
+  std::cout << "* number of commands have completed.\n";
+  std::cout << "* Summary prints \"jobs cus runs seconds cmds/s\" for use with awk\n";
+}
+
+static std::string
+get_kernel_name(size_t cus)
+{
+  std::string k("addone:{");
+  for (int i=1; i<cus; ++i)
+    k.append("addone_").append(std::to_string(i)).append(",");
+  k.append("addone_").append(std::to_string(cus)).append("}");
+  return k;
+}
+
+// Data for a single job, the run handle is restarted for each command
+struct job_type
+{
+  xrt::bo a;
+  xrt::bo b;
+  xrt::run r;
+
+  job_type(const xrt::device& device, const xrt::kernel& kernel, size_t id)
+  {
+    const size_t data_size = ELEMENTS * ARRAY_SIZE;
+    a = xrt::bo(device, data_size*sizeof(unsigned long), kernel.group_id(0));
+    auto adata = a.map<unsigned long*>();
+    for (unsigned int i=0;i<data_size;++i)
+      adata[i] = i;
+
+    b = xrt::bo(device, data_size*sizeof(unsigned long), kernel.group_id(1));
+    auto bdata = b.map<unsigned long*>();
+    for (unsigned int j=0;j<data_size;++j)
+      bdata[j] = id;
+
+    r = xrt::run(kernel);
+    r.set_arg(0, a);
+    r.set_arg(1, b);
+    r.set_arg(2, ELEMENTS);
+  }
+};
+
+static void
+run(const xrt::device& device, const xrt::kernel& kernel, size_t num_jobs, size_t num_runs)
+{
+  std::vector<job_type> jobs;
+  jobs.reserve(num_jobs);
+  for (size_t i=0; i<num_jobs; ++i)
+    jobs.emplace_back(device, kernel, i);
+
+  auto start = std::chrono::steady_clock::now();
+
+  size_t started = 0;
+  for (auto& job : jobs) {
+    if (started == num_runs)
+      break;
+    job.r.start();
+    ++started;
+  }
+
+  // Wait for jobs in order of start and restart until all
+  // commands have been started
+  size_t completed = 0;
+  for (size_t idx = 0; completed < started; idx = (idx + 1) % num_jobs) {
+    auto& job = jobs[idx];
+    job.r.wait();
+    ++completed;
+
+    if (started < num_runs) {
+      job.r.start();
+      ++started;
+    }
+  }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::cout << "xrtxx-tput: ";
+  std::cout << "jobs cus runs seconds cmds/s = "
+            << num_jobs << " "
+            << compute_units << " "
+            << completed << " "
+            << elapsed.count() << " "
+            << static_cast<size_t>(completed / elapsed.count()) << "\n";
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::vector<std::string> args(argv+1,argv+argc);
+
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  size_t runs = 10000;
+  size_t jobs = 64;
+  size_t cus  = MAXCUS;
+
+  std::string cur;
+  for (auto& arg : args) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "--jobs")
+      jobs = std::stoi(arg);
+    else if (cur == "--runs")
+      runs = std::stoi(arg);
+    else if (cur == "--cus")
+      cus = std::stoi(arg);
+    else
+      throw std::runtime_error("bad argument '" + cur + " " + arg + "'");
+  }
+
+  if (!jobs)
+    throw std::runtime_error("--jobs must be at least 1");
+
+  auto device = xrt::device(device_index);
+  auto uuid = device.load_xclbin(xclbin_fnm);
+
+  compute_units = cus = std::min(cus, compute_units);
+  std::string kname = get_kernel_name(cus);
+  auto kernel = xrt::kernel(device, uuid.get(), kname);
+
+  run(device,kernel,jobs,runs);
+
+  return 0;
+}
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return run(argc,argv);
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << "\n";
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
@@ -0,0 +1,168 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure creation time and buffer object footprint of run instances
+// (module_sram) of an ELF module in one hardware context.
+//
+// Sharing of unpatched control code buffers is resolved once per
+// process, so each mode is run as a separate invocation:
+//
+//  % module_sram -k design.xclbin -e design.elf -m private
+//  % module_sram -k design.xclbin -e design.elf -m shared
+//
+// The footprint is the growth of the buffer object bytes and count
+// allocated on the device, as reported by the memory info query of
+// the device.  Buffers shared by instances are counted once.
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_hw_context.h"
+#include "xrt/experimental/xrt_elf.h"
+#include "xrt/experimental/xrt_module.h"
+#include "xrt/experimental/xrt_xclbin.h"
+
+#include "core/common/test_util.h"
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+# pragma warning( disable : 4996 )
+#endif
+
+static void
+usage()
+{
+  std::cout << "usage: module_sram [options]\n\n"
+            << "  -k <xclbin>              xclbin to create hw context from\n"
+            << "  -e <elf>                 elf with control code\n"
+            << "  -d <device>              device index (default 0)\n"
+            << "  -m <private|shared>      buffer mode (default private)\n"
+            << "  -n <instances>           max number of instances (default 512)\n"
+            << "  -h                       print this help\n";
+}
+
+// Write an xrt.ini for the requested mode and point XRT at it. This
+// must be done before the first XRT API call.
+static std::unique_ptr<xrt_core::test_util::ini_file>
+configure(const std::string& mode)
+{
+  if (mode == "private")
+    return nullptr;
+
+  if (mode != "shared")
+    throw std::runtime_error("Unknown mode: " + mode);
+
+  return std::make_unique<xrt_core::test_util::ini_file>
+    ("module_sram", "[Runtime]\nshare_module_buffers=true\n");
+}
+
+struct bo_usage
+{
+  uint64_t bytes = 0;
+  uint64_t count = 0;
+};
+
+// Buffer objects allocated in all memory banks of the device
+static bo_usage
+allocated_bos(const xrt::device& device)
+{
+  std::stringstream json{device.get_info<xrt::info::device::memory>()};
+  boost::property_tree::ptree pt;
+  boost::property_tree::read_json(json, pt);
+
+  auto memories = pt.get_child_optional("board.memory.memories");
+  if (!memories)
+    throw std::runtime_error("Device does not report buffer object usage");
+
+  bo_usage usage;
+  for (const auto& [key, memory] : *memories) {
+    usage.bytes += memory.get<uint64_t>("extended_info.usage.allocated_bytes", 0);
+    usage.count += memory.get<uint64_t>("extended_info.usage.buffer_objects_count", 0);
+  }
+  return usage;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  std::string elf_fnm;
+  std::string mode = "private";
+  unsigned int device_index = 0;
+  unsigned int max_instances = 512;
+
+  std::string cur;
+  for (auto& arg : std::vector<std::string>(argv + 1, argv + argc)) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-e")
+      elf_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-m")
+      mode = arg;
+    else if (cur == "-n")
+      max_instances = std::stoi(arg);
+    else
+      throw std::runtime_error("Unknown option value " + cur + " " + arg);
+  }
+
+  if (xclbin_fnm.empty() || elf_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin or elf specified");
+
+  auto ini = configure(mode);
+
+  xrt::device device{device_index};
+  xrt::xclbin xclbin{xclbin_fnm};
+  device.register_xclbin(xclbin);
+  xrt::hw_context hwctx{device, xclbin.get_uuid()};
+  xrt::elf elf{elf_fnm};
+  xrt::module parent{elf};
+
+  std::cout << "mode(" << mode << ")\n";
+  for (unsigned int instances = 1; instances <= max_instances; instances *= 2) {
+    std::vector<xrt::module> modules;
+    modules.reserve(instances);
+
+    auto before = allocated_bos(device);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (unsigned int i = 0; i < instances; ++i)
+      modules.emplace_back(parent, hwctx);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto after = allocated_bos(device);
+    auto bytes = after.bytes - before.bytes;
+    auto bos = after.count - before.count;
+
+    auto us = std::chrono::duration<double, std::micro>(end - start).count();
+    std::cout << "instances: " << instances
+              << ", create: " << us / instances << " us/instance"
+              << ", bo footprint: " << bytes / 1024 << " KB in " << bos << " bos"
+              << " (" << bytes / instances << " bytes/instance)\n";
+  }
+
+  return 0;
+}
+
+int
+main(int argc, char** argv)
+{
+  return xrt_core::test_util::run_main([argc, argv] { return run(argc, argv); });
+}
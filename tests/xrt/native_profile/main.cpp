@@ -0,0 +1,139 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure the overhead of native XRT API profiling hooks on
+// xrt::run::start and xrt::bo::sync.
+//
+// The profiling configuration is resolved once per process, so each
+// mode is run as a separate invocation:
+//
+//  % native_profile -k verify.xclbin -m off
+//  % native_profile -k verify.xclbin -m native
+//  % native_profile -k verify.xclbin -m sync
+//
+// Mode 'sync' enables native trace for xrt::bo::sync only, in which
+// case xrt::run::start should perform as in mode 'off'.
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+
+#include "core/common/test_util.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+# pragma warning( disable : 4996 )
+#endif
+
+static void
+usage()
+{
+  std::cout << "usage: native_profile [options]\n\n"
+            << "  -k <xclbin>              xclbin with hello kernel\n"
+            << "  -d <device>              device index (default 0)\n"
+            << "  -m <off|native|sync>     profiling mode (default off)\n"
+            << "  -i <iterations>          iterations per benchmark (default 100000)\n"
+            << "  -h                       print this help\n";
+}
+
+// Write an xrt.ini for the requested mode and point XRT at it. This
+// must be done before the first XRT API call.
+static std::unique_ptr<xrt_core::test_util::ini_file>
+configure(const std::string& mode)
+{
+  if (mode == "off")
+    return nullptr;
+
+  std::string ini = "[Debug]\n";
+  if (mode == "native")
+    ini += "native_xrt_trace=true\n";
+  else if (mode == "sync")
+    ini += "native_xrt_trace=true\n"
+           "native_xrt_trace_categories=sync\n";
+  else
+    throw std::runtime_error("Unknown mode: " + mode);
+
+  return std::make_unique<xrt_core::test_util::ini_file>("native_profile", ini);
+}
+
+template <typename Function>
+static double
+time_ns_per_call(unsigned int iterations, Function&& fcn)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+    fcn();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  std::string mode = "off";
+  unsigned int device_index = 0;
+  unsigned int iterations = 100000;
+
+  std::string cur;
+  for (auto& arg : std::vector<std::string>(argv + 1, argv + argc)) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-m")
+      mode = arg;
+    else if (cur == "-i")
+      iterations = std::stoi(arg);
+    else
+      throw std::runtime_error("Unknown option value " + cur + " " + arg);
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  auto ini = configure(mode);
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel hello{device, uuid, "hello"};
+  xrt::bo bo(device, 4096, hello.group_id(0));
+  xrt::run run{hello};
+  run.set_arg(0, bo);
+
+  auto start = time_ns_per_call(iterations, [&run] {
+    run.start();
+    run.wait();
+  });
+
+  auto sync = time_ns_per_call(iterations, [&bo] {
+    bo.sync(XCL_BO_SYNC_BO_TO_DEVICE, 64, 0);
+  });
+
+  std::cout << "mode(" << mode << ")\n"
+            << "xrt::run::start+wait: " << start << " ns/call\n"
+            << "xrt::bo::sync:        " << sync << " ns/call\n";
+
+  return 0;
+}
+
+int
+main(int argc, char** argv)
+{
+  return xrt_core::test_util::run_main([argc, argv] { return run(argc, argv); });
+}
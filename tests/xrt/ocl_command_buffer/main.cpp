@@ -0,0 +1,224 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure host side cost per kernel command of replaying a recorded
+// cl_khr_command_buffer versus enqueuing the same NDRange commands
+// individually.
+//
+// Uses the 'simple' kernel of 02_simple:
+//
+//  % ocl_command_buffer -k simple.xclbin -n 16
+//
+// Use the noop shim (XCL_EMULATION_MODE=noop) to measure host side
+// overhead only.
+#include <CL/cl.h>
+#include <CL/cl_ext_xilinx.h>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+# pragma warning( disable : 4996 )
+#endif
+
+static constexpr size_t COUNT = 1024;
+
+static void
+usage()
+{
+  std::cout << "usage: ocl_command_buffer [options]\n\n"
+            << "  -k <xclbin>              xclbin with simple kernel\n"
+            << "  -n <commands>            kernel commands per iteration (default 16)\n"
+            << "  -i <iterations>          iterations per benchmark (default 1000)\n"
+            << "  -h                       print this help\n";
+}
+
+static void
+throw_if_error(cl_int errcode, const std::string& msg)
+{
+  if (errcode)
+    throw std::runtime_error(msg + " errcode '" + std::to_string(errcode) + "'");
+}
+
+template <typename FunctionType>
+static FunctionType
+get_extension_function(cl_platform_id platform, const char* name)
+{
+  auto fcn = clGetExtensionFunctionAddressForPlatform(platform, name);
+  if (!fcn)
+    throw std::runtime_error(std::string("No extension function ") + name);
+  return reinterpret_cast<FunctionType>(fcn);
+}
+
+template <typename Function>
+static double
+time_ns_per_command(unsigned int iterations, unsigned int commands, Function&& fcn)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+    fcn();
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / (iterations * commands);
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int commands = 16;
+  unsigned int iterations = 1000;
+
+  std::string cur;
+  for (auto& arg : std::vector<std::string>(argv + 1, argv + argc)) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-n")
+      commands = std::stoi(arg);
+    else if (cur == "-i")
+      iterations = std::stoi(arg);
+    else
+      throw std::runtime_error("Unknown option value " + cur + " " + arg);
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  cl_int err = CL_SUCCESS;
+  cl_platform_id platform = nullptr;
+  throw_if_error(clGetPlatformIDs(1, &platform, nullptr), "clGetPlatformIDs");
+  cl_device_id device = nullptr;
+  throw_if_error(clGetDeviceIDs(platform, CL_DEVICE_TYPE_ACCELERATOR, 1, &device, nullptr), "clGetDeviceIDs");
+
+  auto create_command_buffer = get_extension_function<decltype(&clCreateCommandBufferKHR)>(platform, "clCreateCommandBufferKHR");
+  auto command_ndrange_kernel = get_extension_function<decltype(&clCommandNDRangeKernelKHR)>(platform, "clCommandNDRangeKernelKHR");
+  auto finalize_command_buffer = get_extension_function<decltype(&clFinalizeCommandBufferKHR)>(platform, "clFinalizeCommandBufferKHR");
+  auto enqueue_command_buffer = get_extension_function<decltype(&clEnqueueCommandBufferKHR)>(platform, "clEnqueueCommandBufferKHR");
+  auto release_command_buffer = get_extension_function<decltype(&clReleaseCommandBufferKHR)>(platform, "clReleaseCommandBufferKHR");
+  auto get_command_buffer_info = get_extension_function<decltype(&clGetCommandBufferInfoKHR)>(platform, "clGetCommandBufferInfoKHR");
+
+  auto context = clCreateContext(nullptr, 1, &device, nullptr, nullptr, &err);
+  throw_if_error(err, "clCreateContext");
+  auto queue = clCreateCommandQueue(context, device, 0, &err);
+  throw_if_error(err, "clCreateCommandQueue");
+
+  std::ifstream stream(xclbin_fnm, std::ios::binary);
+  std::vector<char> xclbin{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+  auto size = xclbin.size();
+  auto data = reinterpret_cast<const unsigned char*>(xclbin.data());
+  auto program = clCreateProgramWithBinary(context, 1, &device, &size, &data, nullptr, &err);
+  throw_if_error(err, "clCreateProgramWithBinary");
+  auto kernel = clCreateKernel(program, "simple", &err);
+  throw_if_error(err, "clCreateKernel");
+
+  auto s1 = clCreateBuffer(context, CL_MEM_READ_WRITE, COUNT * sizeof(int), nullptr, &err);
+  throw_if_error(err, "clCreateBuffer");
+  auto s2 = clCreateBuffer(context, CL_MEM_READ_WRITE, COUNT * sizeof(int), nullptr, &err);
+  throw_if_error(err, "clCreateBuffer");
+  int foo = 0x10;
+  throw_if_error(clSetKernelArg(kernel, 0, sizeof(cl_mem), &s1), "clSetKernelArg");
+  throw_if_error(clSetKernelArg(kernel, 1, sizeof(cl_mem), &s2), "clSetKernelArg");
+  throw_if_error(clSetKernelArg(kernel, 2, sizeof(int), &foo), "clSetKernelArg");
+
+  size_t global = 1;
+  auto enqueue = time_ns_per_command(iterations, commands, [&] {
+    for (unsigned int c = 0; c < commands; ++c)
+      throw_if_error(clEnqueueNDRangeKernel(queue, kernel, 1, nullptr, &global, nullptr, 0, nullptr, nullptr), "clEnqueueNDRangeKernel");
+    throw_if_error(clFinish(queue), "clFinish");
+  });
+
+  cl_command_buffer_properties_khr props[] = {
+    CL_COMMAND_BUFFER_FLAGS_KHR, CL_COMMAND_BUFFER_SIMULTANEOUS_USE_KHR, 0
+  };
+  auto cb = create_command_buffer(1, &queue, props, &err);
+  throw_if_error(err, "clCreateCommandBufferKHR");
+  for (unsigned int c = 0; c < commands; ++c)
+    throw_if_error(command_ndrange_kernel(cb, nullptr, nullptr, kernel, 1, nullptr, &global, nullptr,
+                                          0, nullptr, nullptr, nullptr), "clCommandNDRangeKernelKHR");
+  throw_if_error(finalize_command_buffer(cb), "clFinalizeCommandBufferKHR");
+
+  auto replay = time_ns_per_command(iterations, commands, [&] {
+    throw_if_error(enqueue_command_buffer(0, nullptr, cb, 0, nullptr, nullptr), "clEnqueueCommandBufferKHR");
+    throw_if_error(clFinish(queue), "clFinish");
+  });
+
+  // A finalized command buffer cannot be recorded into
+  if (command_ndrange_kernel(cb, nullptr, nullptr, kernel, 1, nullptr, &global, nullptr,
+                             0, nullptr, nullptr, nullptr) != CL_INVALID_OPERATION)
+    throw std::runtime_error("clCommandNDRangeKernelKHR recorded into finalized command buffer");
+
+  // A command buffer without simultaneous use is pending from enqueue
+  // until its event completes and cannot be enqueued meanwhile
+  auto get_state = [&](cl_command_buffer_khr command_buffer) {
+    cl_command_buffer_state_khr state = 0;
+    throw_if_error(get_command_buffer_info(command_buffer, CL_COMMAND_BUFFER_STATE_KHR, sizeof(state), &state, nullptr),
+                   "clGetCommandBufferInfoKHR");
+    return state;
+  };
+  auto once = create_command_buffer(1, &queue, nullptr, &err);
+  throw_if_error(err, "clCreateCommandBufferKHR");
+  throw_if_error(command_ndrange_kernel(once, nullptr, nullptr, kernel, 1, nullptr, &global, nullptr,
+                                        0, nullptr, nullptr, nullptr), "clCommandNDRangeKernelKHR");
+  throw_if_error(finalize_command_buffer(once), "clFinalizeCommandBufferKHR");
+  auto gate = clCreateUserEvent(context, &err);
+  throw_if_error(err, "clCreateUserEvent");
+  throw_if_error(enqueue_command_buffer(0, nullptr, once, 1, &gate, nullptr), "clEnqueueCommandBufferKHR");
+  if (get_state(once) != CL_COMMAND_BUFFER_STATE_PENDING_KHR)
+    throw std::runtime_error("enqueued command buffer is not pending");
+  if (enqueue_command_buffer(0, nullptr, once, 0, nullptr, nullptr) != CL_INVALID_OPERATION)
+    throw std::runtime_error("pending command buffer enqueued again");
+  throw_if_error(clSetUserEventStatus(gate, CL_COMPLETE), "clSetUserEventStatus");
+  throw_if_error(clFinish(queue), "clFinish");
+  if (get_state(once) != CL_COMMAND_BUFFER_STATE_EXECUTABLE_KHR)
+    throw std::runtime_error("completed command buffer is not executable");
+  clReleaseEvent(gate);
+  release_command_buffer(once);
+
+  std::cout << "commands per iteration: " << commands << '\n'
+            << "clEnqueueNDRangeKernel+clFinish:    " << enqueue << " ns/command\n"
+            << "clEnqueueCommandBufferKHR+clFinish: " << replay << " ns/command\n";
+
+  release_command_buffer(cb);
+  clReleaseMemObject(s1);
+  clReleaseMemObject(s2);
+  clReleaseKernel(kernel);
+  clReleaseProgram(program);
+  clReleaseCommandQueue(queue);
+  clReleaseContext(context);
+
+  return 0;
+}
+
+int
+main(int argc, char** argv)
+{
+  try {
+    if (auto ret = run(argc, argv))
+      return ret;
+
+    std::cout << "PASSED TEST\n";
+    return 0;
+  }
+  catch (const std::exception& ex) {
+    std::cout << "TEST FAILED: " << ex.what() << '\n';
+  }
+  catch (...) {
+    std::cout << "TEST FAILED\n";
+  }
+
+  return 1;
+}
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure xrt::queue enqueue to completion throughput for a range of
+// worker counts and latency of dependencies between queues.
+//
+//  % queue [-n <tasks>] [-l <dependencies>]
+//
+// No device is required.
+#include "xrt/experimental/xrt_queue.h"
+
+#include "core/common/test_util.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+# pragma warning( disable : 4996 )
+#endif
+
+using clock_type = std::chrono::high_resolution_clock;
+
+static void
+usage()
+{
+  std::cout << "usage: queue [options]\n\n"
+            << "  -n <tasks>               tasks per throughput run (default 1000000)\n"
+            << "  -l <dependencies>        cross queue dependencies (default 10000)\n"
+            << "  -h                       print this help\n";
+}
+
+// Enqueue tasks and wait for all to complete
+static void
+throughput(unsigned int workers, unsigned int tasks)
+{
+  xrt::queue q{workers};
+  std::atomic<unsigned int> executed {0};
+  std::vector<unsigned int> order;
+  order.reserve(tasks);
+
+  auto start = clock_type::now();
+  xrt::queue::event last;
+  for (unsigned int i = 0; i < tasks; ++i) {
+    last = q.enqueue([&executed, &order, workers, i] {
+      if (workers == 1)
+        order.push_back(i);
+      ++executed;
+    });
+  }
+  last.wait();
+  while (executed < tasks)
+    std::this_thread::yield();
+  auto end = clock_type::now();
+
+  // single worker queue executes in order of enqueuing
+  for (unsigned int i = 0; i < order.size(); ++i)
+    if (order[i] != i)
+      throw std::runtime_error("tasks executed out of order");
+
+  auto ns = std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << "workers: " << workers << ", " << tasks << " tasks, "
+            << ns / tasks << " ns/task (enqueue to completion)\n";
+}
+
+// Latency from completion of a task in one queue to start of a task
+// that depends on it in another queue
+static void
+dependency_latency(unsigned int dependencies)
+{
+  xrt::queue q0;
+  xrt::queue q1;
+  clock_type::time_point done;
+  clock_type::time_point started;
+  double total_ns = 0;
+  for (unsigned int i = 0; i < dependencies; ++i) {
+    auto ev = q0.enqueue([&done] { done = clock_type::now(); });
+    q1.enqueue_after(ev, [&started] { started = clock_type::now(); }).wait();
+    total_ns += std::chrono::duration<double, std::nano>(started - done).count();
+  }
+
+  std::cout << "cross queue dependency: " << dependencies << " dependencies, "
+            << total_ns / dependencies << " ns from completion to start\n";
+}
+
+// A task waiting for an event does not occupy a worker
+static void
+dependency_without_worker()
+{
+  xrt::queue q0{1};
+  std::promise<void> gate;
+  std::shared_future<void> gate_future{gate.get_future()};
+
+  bool dependent_done = false;
+  auto dependent = q0.enqueue_after(gate_future, [&dependent_done] { dependent_done = true; });
+
+  // in order single worker queue, later task runs after dependent
+  bool later_done = false;
+  auto later = q0.enqueue([&dependent_done, &later_done] { later_done = dependent_done; });
+
+  // independent queue with two workers completes tasks while a task
+  // of the queue waits for the gate
+  xrt::queue q1{2};
+  auto waiting = q1.enqueue_after(gate_future, [] {});
+  q1.enqueue([] {}).wait();
+  q1.enqueue([] {}).wait();
+
+  if (waiting.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    throw std::runtime_error("task started before its dependency completed");
+
+  gate.set_value();
+  dependent.wait();
+  later.wait();
+  waiting.wait();
+  if (!later_done)
+    throw std::runtime_error("task started before earlier dependent task");
+
+  std::cout << "dependency without worker: ok\n";
+}
+
+// A deferred future dependency is run by the worker that waits for it
+static void
+deferred_dependency()
+{
+  xrt::queue q;
+  bool deferred_done = false;
+  std::shared_future<void> deferred = std::async(std::launch::deferred, [&deferred_done] { deferred_done = true; });
+
+  bool dependent_saw = false;
+  auto dependent = q.enqueue_after(deferred, [&deferred_done, &dependent_saw] { dependent_saw = deferred_done; });
+  if (dependent.wait_for(std::chrono::seconds(10)) != std::future_status::ready)
+    throw std::runtime_error("task waiting for deferred future did not complete");
+  if (!dependent_saw)
+    throw std::runtime_error("task started before deferred dependency ran");
+
+  std::cout << "deferred dependency: ok\n";
+}
+
+static int
+run(int argc, char** argv)
+{
+  unsigned int tasks = 1000000;
+  unsigned int dependencies = 10000;
+
+  std::string cur;
+  for (auto& arg : std::vector<std::string>(argv + 1, argv + argc)) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-n")
+      tasks = std::stoi(arg);
+    else if (cur == "-l")
+      dependencies = std::stoi(arg);
+    else
+      throw std::runtime_error("Unknown option value " + cur + " " + arg);
+  }
+
+  for (unsigned int workers : {1, 2, 4})
+    throughput(workers, tasks);
+
+  dependency_latency(dependencies);
+  dependency_without_worker();
+  deferred_dependency();
+  return 0;
+}
+
+int
+main(int argc, char** argv)
+{
+  return xrt_core::test_util::run_main([argc, argv] { return run(argc, argv); });
+}
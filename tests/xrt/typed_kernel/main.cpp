@@ -0,0 +1,183 @@
+// SPDX-License-Identifier: Apache-2.0
+// Copyright (C) 2024 Advanced Micro Devices, Inc. All rights reserved.
+
+// Measure argument binding cost of relaunching a kernel with new
+// arguments, comparing xrt::run::set_arg, xrt::run::operator() and
+// xrt::typed_kernel.
+//
+// Uses the 'simple' kernel of 02_simple, all arguments are rebound
+// on every launch:
+//
+//  % typed_kernel -k simple.xclbin
+//
+// The output of the kernel is verified after the measurements.  Use
+// the noop shim (XCL_EMULATION_MODE=noop) to measure host side
+// overhead only, the output is not verified with the noop shim.
+#include "xrt/xrt_bo.h"
+#include "xrt/xrt_device.h"
+#include "xrt/xrt_kernel.h"
+#include "xrt/experimental/xrt_ext.h"
+#include "xrt/experimental/xrt_kernel.h"
+
+#include "core/common/test_util.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+# pragma warning( disable : 4996 )
+#endif
+
+static constexpr size_t COUNT = 1024;
+
+static void
+usage()
+{
+  std::cout << "usage: typed_kernel [options]\n\n"
+            << "  -k <xclbin>              xclbin with simple kernel\n"
+            << "  -d <device>              device index (default 0)\n"
+            << "  -i <iterations>          iterations per benchmark (default 100000)\n"
+            << "  -h                       print this help\n";
+}
+
+template <typename Function>
+static double
+time_ns_per_call(unsigned int iterations, Function&& fcn)
+{
+  auto start = std::chrono::high_resolution_clock::now();
+  for (unsigned int i = 0; i < iterations; ++i)
+    fcn(i);
+  auto end = std::chrono::high_resolution_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+// Check the output of the simple kernel launched through a typed
+// kernel, s1[i] = s2[i] + i * foo
+static void
+verify(xrt::typed_kernel<xrt::bo, xrt::bo, int>& typed, xrt::bo& bo0, xrt::bo& bo1, int foo)
+{
+  auto s1 = bo0.map<int*>();
+  auto s2 = bo1.map<int*>();
+  for (int i = 0; i < static_cast<int>(COUNT); ++i) {
+    s1[i] = 0;
+    s2[i] = i * 3;
+  }
+  bo0.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+  bo1.sync(XCL_BO_SYNC_BO_TO_DEVICE);
+
+  typed(bo0, bo1, foo).wait();
+
+  bo0.sync(XCL_BO_SYNC_BO_FROM_DEVICE);
+  for (int i = 0; i < static_cast<int>(COUNT); ++i) {
+    if (s1[i] != s2[i] + i * foo)
+      throw std::runtime_error("typed_kernel output mismatch at index " + std::to_string(i));
+  }
+}
+
+static bool
+is_noop()
+{
+  auto mode = std::getenv("XCL_EMULATION_MODE");
+  return mode && std::string(mode) == "noop";
+}
+
+static int
+run(int argc, char** argv)
+{
+  std::string xclbin_fnm;
+  unsigned int device_index = 0;
+  unsigned int iterations = 100000;
+
+  std::string cur;
+  for (auto& arg : std::vector<std::string>(argv + 1, argv + argc)) {
+    if (arg == "-h") {
+      usage();
+      return 1;
+    }
+
+    if (arg[0] == '-') {
+      cur = arg;
+      continue;
+    }
+
+    if (cur == "-k")
+      xclbin_fnm = arg;
+    else if (cur == "-d")
+      device_index = std::stoi(arg);
+    else if (cur == "-i")
+      iterations = std::stoi(arg);
+    else
+      throw std::runtime_error("Unknown option value " + cur + " " + arg);
+  }
+
+  if (xclbin_fnm.empty())
+    throw std::runtime_error("FAILED_TEST\nNo xclbin specified");
+
+  xrt::device device{device_index};
+  auto uuid = device.load_xclbin(xclbin_fnm);
+  xrt::kernel simple{device, uuid, "simple"};
+
+  // Two sets of buffers, alternated per launch
+  std::vector<xrt::bo> bo0;
+  std::vector<xrt::bo> bo1;
+  for (int i = 0; i < 2; ++i) {
+    bo0.emplace_back(device, COUNT * sizeof(int), simple.group_id(0));
+    bo1.emplace_back(device, COUNT * sizeof(int), simple.group_id(1));
+  }
+
+  xrt::run run{simple};
+  auto set_arg = time_ns_per_call(iterations, [&](unsigned int i) {
+    run.set_arg(0, bo0[i & 1]);
+    run.set_arg(1, bo1[i & 1]);
+    run.set_arg(2, static_cast<int>(i));
+    run.start();
+    run.wait();
+  });
+
+  auto run_op = time_ns_per_call(iterations, [&](unsigned int i) {
+    run(bo0[i & 1], bo1[i & 1], static_cast<int>(i));
+    run.wait();
+  });
+
+  xrt::typed_kernel<xrt::bo, xrt::bo, int> typed{simple};
+  auto typed_op = time_ns_per_call(iterations, [&](unsigned int i) {
+    typed(bo0[i & 1], bo1[i & 1], static_cast<int>(i)).wait();
+  });
+
+  // A signature that does not match the kernel must be rejected
+  bool rejected = false;
+  try {
+    xrt::typed_kernel<xrt::bo, int, int> bad{simple};
+  }
+  catch (const std::exception&) {
+    rejected = true;
+  }
+  if (!rejected)
+    throw std::runtime_error("typed_kernel accepted mismatched signature");
+
+  // Buffer objects derived from xrt::bo are global arguments
+  xrt::typed_kernel<xrt::ext::bo, xrt::ext::bo, int> ext{simple};
+
+  // Both buffer sets, such that rebinding is verified too
+  if (!is_noop()) {
+    verify(typed, bo0[0], bo1[0], 0x10);
+    verify(typed, bo0[1], bo1[1], 0x20);
+    verify(typed, bo0[0], bo1[0], 0x30);
+  }
+
+  std::cout << "xrt::run::set_arg+start+wait:       " << set_arg << " ns/call\n"
+            << "xrt::run::operator()+wait:          " << run_op << " ns/call\n"
+            << "xrt::typed_kernel::operator()+wait: " << typed_op << " ns/call\n";
+
+  return 0;
+}
+
+int
+main(int argc, char** argv)
+{
+  return xrt_core::test_util::run_main([argc, argv] { return run(argc, argv); });
+}